@@ -0,0 +1,382 @@
+// aurora_bench: runs a fixed number of frames through Engine::run and reports
+// frame-time percentiles plus a per-stage breakdown as JSON.
+//
+//   aurora_bench [--frames N] [--warmup N] [--headless] [--width W] [--height H] [--frames-in-flight N]
+//                [--draws N] [--entities N] [--nodes N] [--move-percent P] [--record-threads N] [--job-workers N] [--single-threaded] [--render-packets N] [--no-cull] [--gpu-driven] [--bindless] [--materials N] [--out file.json] [--trace trace.json]
+//
+// --draws fills the draw list with N small triangles on a grid; compare record_ms across
+// --record-threads 1..cores to see how command recording scales. sort_ms is the render
+// queue's key sort and instance fill, draw_calls what was left after instancing. --nodes builds a binary
+// transform hierarchy of N drawn nodes and re-rotates --move-percent of them every frame;
+// transform_ms and transforms_changed show the cost of the incremental update. cull_ms is the
+// frustum test of every draw, draws_visible what was left of draws_tested; --no-cull skips it.
+// --gpu-driven culls in a compute shader and draws indirectly: record_ms should stay flat as
+// --draws grows, and draws_tested/draws_visible then come from the GPU. render_graph lists
+// the mean CPU/GPU time of every render graph pass, barriers the barriers it derived per frame
+// and the transient attachment memory with what aliasing saved. descriptor_sets counts the
+// sets allocated per frame; descriptors reports pools created, how often a frame outgrew its
+// pools, and set layouts created versus served from the layout cache. --bindless binds
+// resources through one descriptor-indexed table (ignored without descriptor indexing).
+// Pipelines compile on job threads: pipeline_cache.max_ms is the slowest compile (the hitch
+// it would have caused), and the pipeline_fallbacks series counts per frame the pipeline
+// lookups that found theirs still compiling (should be 0 after startup). --materials spreads
+// the --draws over N materials cycling through the shader feature combinations: one pipeline
+// (shader variant) per combination, deduplicated for the rest; compare draw_calls and
+// record_ms with and without.
+#include <aurora/Engine.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    uint32_t frames = 1000;
+    uint32_t warmup = 60;
+    bool headless = false;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t framesInFlight = 2;
+    uint32_t draws = 0;         // 0 = engine default (one triangle)
+    uint32_t entities = 0;      // renderable ECS entities, drawn after the draw list
+    uint32_t nodes = 0;         // drawn transform hierarchy nodes (16 binary trees)
+    double movePercent = 3.0;   // share of nodes whose local rotation changes per frame
+    uint32_t recordThreads = 0; // 0 = one per job thread
+    uint32_t jobWorkers = 0;    // 0 = cores - 1
+    bool renderThread = true;
+    uint32_t renderPackets = 2;
+    bool frustumCulling = true;
+    bool gpuDriven = false;
+    bool bindless = false;
+    uint32_t materials = 0;     // 0 = every draw uses the default material
+    std::string outPath;
+    std::string tracePath;
+};
+
+struct Series {
+    const char* name;
+    std::vector<double> samples;
+};
+
+class BenchGame : public aurora::IGame {
+public:
+    explicit BenchGame(const Options& opt) : opt_(opt) {
+        for (auto* s : all()) s->samples.reserve(opt.frames);
+    }
+
+    void onInit(aurora::Engine& engine) override {
+        for (uint32_t i = 0; i < opt_.entities; ++i) {
+            aurora::ecs::Transform t;
+            t.position[0] = std::fmod(static_cast<float>(i) * 0.618034f, 2.0f) - 1.0f;
+            t.position[1] = std::fmod(static_cast<float>(i) * 0.414214f, 2.0f) - 1.0f;
+            t.scale = 0.01f;
+            engine.world().create(t, aurora::ecs::MeshRenderer{});
+        }
+        buildHierarchy(engine);
+        if (opt_.draws == 0) return;
+        std::vector<uint32_t> materials(opt_.materials);
+        for (uint32_t i = 0; i < opt_.materials; ++i) {
+            aurora::MaterialDesc m;
+            m.features = i % 8; // every combination of the three features
+            m.baseColor[0] = 0.5f + 0.5f * static_cast<float>(i % 3) / 2.0f;
+            m.baseColor[2] = 0.5f + 0.5f * static_cast<float>(i % 5) / 4.0f;
+            materials[i] = engine.createMaterial(m);
+        }
+        auto& list = engine.drawList();
+        list.reserve(opt_.draws);
+        const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(opt_.draws))));
+        const float cell = 2.0f / static_cast<float>(side);
+        for (uint32_t i = 0; i < opt_.draws; ++i) {
+            aurora::DrawCommand d;
+            d.position[0] = -1.0f + cell * (static_cast<float>(i % side) + 0.5f);
+            d.position[1] = -1.0f + cell * (static_cast<float>(i / side) + 0.5f);
+            d.scale = cell;
+            if (!materials.empty()) d.material = materials[i % materials.size()];
+            list.add(d);
+        }
+    }
+    void onUpdate(aurora::Engine& engine, float) override {
+        moveNodes(engine);
+        // frameMs covers the previous iteration, so skip one extra frame after warmup
+        if (++frame_ > opt_.warmup + 1) {
+            const auto& t = engine.getFrameTimings();
+            cpu_.samples.push_back(t.frameMs);
+            fence_.samples.push_back(t.fenceWaitMs);
+            acquire_.samples.push_back(t.acquireMs);
+            submit_.samples.push_back(t.submitMs);
+            present_.samples.push_back(t.presentMs);
+            record_.samples.push_back(t.recordMs);
+            sort_.samples.push_back(t.sortMs);
+            drawCalls_.samples.push_back(static_cast<double>(t.drawCalls));
+            packetWait_.samples.push_back(t.packetWaitMs);
+            transform_.samples.push_back(t.transformMs);
+            transformsChanged_.samples.push_back(static_cast<double>(t.transformsChanged));
+            cull_.samples.push_back(t.cullMs);
+            drawsTested_.samples.push_back(static_cast<double>(t.drawsTested));
+            drawsVisible_.samples.push_back(static_cast<double>(t.drawsVisible));
+            barriers_.samples.push_back(static_cast<double>(t.barriers));
+            descriptorSets_.samples.push_back(static_cast<double>(t.descriptorSets));
+            pipelineFallbacks_.samples.push_back(static_cast<double>(t.pipelineFallbacks));
+            for (uint32_t i = 0; i < t.renderPassCount; ++i) {
+                PassTotals& p = passes_[t.renderPasses[i].name];
+                p.cpuMs += t.renderPasses[i].cpuMs;
+                p.gpuMs += t.renderPasses[i].gpuMs;
+                ++p.frames;
+            }
+            passesCulled_ = t.passesCulled;
+            transientBytes_ = t.transientBytes;
+            transientBytesSaved_ = t.transientBytesSaved;
+            descriptorPools_ = t.descriptorPools;
+            descriptorPoolGrowths_ = t.descriptorPoolGrowths;
+            descriptorLayouts_ = t.descriptorLayouts;
+            descriptorLayoutHits_ = t.descriptorLayoutHits;
+        }
+        if (cpu_.samples.size() >= opt_.frames) engine.requestExit();
+    }
+    void onShutdown(aurora::Engine&) override {}
+
+    std::vector<Series*> all() {
+        return { &cpu_, &fence_, &acquire_, &submit_, &present_, &record_, &sort_, &drawCalls_, &packetWait_, &transform_, &transformsChanged_,
+                 &cull_, &drawsTested_, &drawsVisible_, &barriers_, &descriptorSets_,
+                 &pipelineFallbacks_ };
+    }
+    size_t recorded() const { return cpu_.samples.size(); }
+
+    void writeRenderGraph(std::ostream& os) const {
+        os << "\"render_graph\":{\"passes\":[";
+        bool first = true;
+        for (const auto& [name, p] : passes_) {
+            const double n = static_cast<double>(std::max<uint32_t>(p.frames, 1));
+            os << (first ? "" : ",") << "{\"name\":\"" << name << "\",\"frames\":" << p.frames
+               << ",\"cpu_ms\":" << p.cpuMs / n << ",\"gpu_ms\":" << p.gpuMs / n << "}";
+            first = false;
+        }
+        os << "],\"passes_culled\":" << passesCulled_
+           << ",\"transient_bytes\":" << transientBytes_
+           << ",\"transient_bytes_saved\":" << transientBytesSaved_ << "}";
+    }
+
+    void writeDescriptors(std::ostream& os, bool bindless) const {
+        os << "\"descriptors\":{\"pools\":" << descriptorPools_
+           << ",\"pool_growths\":" << descriptorPoolGrowths_
+           << ",\"layouts\":" << descriptorLayouts_
+           << ",\"layout_hits\":" << descriptorLayoutHits_
+           << ",\"bindless\":" << (bindless ? "true" : "false") << "}";
+    }
+
+private:
+    static constexpr uint32_t kTrees = 16;
+
+    // Nodes 0..15 are roots and node j parents nodes 2j + 16 and 2j + 17: binary trees about
+    // log2(nodes / 16) levels deep, with small scales so every node stays on screen
+    void buildHierarchy(aurora::Engine& engine) {
+        using namespace aurora;
+        nodes_.reserve(opt_.nodes);
+        for (uint32_t i = 0; i < opt_.nodes; ++i) {
+            scene::LocalTransform local;
+            scene::Node parent;
+            if (i < kTrees) {
+                local.position = {-0.9f + 1.8f * static_cast<float>(i % 4) / 3.0f, -0.9f + 1.8f * static_cast<float>(i / 4) / 3.0f, 0.0f};
+                local.scale = math::Vec3(0.05f);
+            } else {
+                parent = nodes_[(i - kTrees) / 2];
+                local.position = {(i & 1) ? 0.6f : -0.6f, 0.8f, 0.0f};
+                local.scale = math::Vec3(0.9f);
+            }
+            nodes_.push_back(engine.transforms().create(local, parent));
+            engine.world().create(ecs::SceneNode{nodes_.back()}, ecs::MeshRenderer{});
+        }
+    }
+    void moveNodes(aurora::Engine& engine) {
+        using namespace aurora;
+        if (nodes_.empty()) return;
+        const auto moving = static_cast<uint32_t>(static_cast<double>(nodes_.size()) * opt_.movePercent / 100.0);
+        const math::Quat rot = math::Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 0.3f * std::sin(static_cast<float>(frame_) * 0.05f));
+        for (uint32_t k = 0; k < moving; ++k) {
+            rng_ = rng_ * 1664525u + 1013904223u;
+            engine.transforms().setRotation(nodes_[rng_ % nodes_.size()], rot);
+        }
+    }
+
+    struct PassTotals {
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+        uint32_t frames = 0;
+    };
+
+    std::vector<aurora::scene::Node> nodes_;
+    uint32_t rng_ = 12345;
+    Options opt_;
+    uint32_t frame_ = 0;
+    Series cpu_{"cpu_frame_ms", {}};
+    Series fence_{"fence_wait_ms", {}};
+    Series acquire_{"acquire_ms", {}};
+    Series submit_{"queue_submit_ms", {}};
+    Series present_{"queue_present_ms", {}};
+    Series record_{"record_ms", {}};
+    Series sort_{"sort_ms", {}};
+    Series drawCalls_{"draw_calls", {}};
+    Series packetWait_{"packet_wait_ms", {}};
+    Series transform_{"transform_ms", {}};
+    Series transformsChanged_{"transforms_changed", {}};
+    Series cull_{"cull_ms", {}};
+    Series drawsTested_{"draws_tested", {}};
+    Series drawsVisible_{"draws_visible", {}};
+    Series barriers_{"barriers", {}};
+    Series descriptorSets_{"descriptor_sets", {}};
+    Series pipelineFallbacks_{"pipeline_fallbacks", {}};
+    std::map<std::string, PassTotals> passes_; // by pass name
+    uint32_t passesCulled_ = 0;                // of the last frame
+    uint64_t transientBytes_ = 0;
+    uint64_t transientBytesSaved_ = 0;
+    uint32_t descriptorPools_ = 0;       // created so far
+    uint32_t descriptorPoolGrowths_ = 0; // so far
+    uint32_t descriptorLayouts_ = 0;
+    uint64_t descriptorLayoutHits_ = 0;
+};
+
+// Nearest-rank percentile on a sorted sample set
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.5);
+    rank = std::clamp<size_t>(rank, 1, sorted.size());
+    return sorted[rank - 1];
+}
+
+void writeSeries(std::ostream& os, const Series& s) {
+    std::vector<double> v = s.samples;
+    std::sort(v.begin(), v.end());
+    double sum = 0.0;
+    for (double x : v) sum += x;
+    double mean = v.empty() ? 0.0 : sum / static_cast<double>(v.size());
+    os << "\"" << s.name << "\":{"
+       << "\"mean\":" << mean
+       << ",\"p50\":" << percentile(v, 50.0)
+       << ",\"p95\":" << percentile(v, 95.0)
+       << ",\"p99\":" << percentile(v, 99.0)
+       << ",\"max\":" << (v.empty() ? 0.0 : v.back())
+       << "}";
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* a = argv[i];
+        const char* v = nullptr;
+        if (std::strcmp(a, "--headless") == 0) { opt.headless = true; continue; }
+        if (std::strcmp(a, "--frames") == 0 && (v = next())) { opt.frames = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--warmup") == 0 && (v = next())) { opt.warmup = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--width") == 0 && (v = next())) { opt.width = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--height") == 0 && (v = next())) { opt.height = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--frames-in-flight") == 0 && (v = next())) { opt.framesInFlight = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--draws") == 0 && (v = next())) { opt.draws = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--entities") == 0 && (v = next())) { opt.entities = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--nodes") == 0 && (v = next())) { opt.nodes = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--move-percent") == 0 && (v = next())) { opt.movePercent = std::strtod(v, nullptr); continue; }
+        if (std::strcmp(a, "--record-threads") == 0 && (v = next())) { opt.recordThreads = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--job-workers") == 0 && (v = next())) { opt.jobWorkers = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--single-threaded") == 0) { opt.renderThread = false; continue; }
+        if (std::strcmp(a, "--render-packets") == 0 && (v = next())) { opt.renderPackets = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--no-cull") == 0) { opt.frustumCulling = false; continue; }
+        if (std::strcmp(a, "--gpu-driven") == 0) { opt.gpuDriven = true; continue; }
+        if (std::strcmp(a, "--bindless") == 0) { opt.bindless = true; continue; }
+        if (std::strcmp(a, "--materials") == 0 && (v = next())) { opt.materials = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)); continue; }
+        if (std::strcmp(a, "--out") == 0 && (v = next())) { opt.outPath = v; continue; }
+        if (std::strcmp(a, "--trace") == 0 && (v = next())) { opt.tracePath = v; continue; }
+        std::cerr << "usage: aurora_bench [--frames N] [--warmup N] [--headless] [--width W] [--height H] [--frames-in-flight N] [--draws N] [--entities N] [--nodes N] [--move-percent P] [--record-threads N] [--job-workers N] [--single-threaded] [--render-packets N] [--no-cull] [--gpu-driven] [--bindless] [--materials N] [--out file.json] [--trace trace.json]\n";
+        return false;
+    }
+    if (opt.frames == 0) opt.frames = 1;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    aurora::EngineConfig cfg;
+    cfg.title = "Aurora Bench";
+    cfg.width = opt.width;
+    cfg.height = opt.height;
+    cfg.headless = opt.headless;
+    cfg.framesInFlight = opt.framesInFlight;
+    cfg.recordThreads = opt.recordThreads;
+    cfg.jobWorkers = opt.jobWorkers;
+    cfg.renderThread = opt.renderThread;
+    cfg.renderPackets = opt.renderPackets;
+    cfg.frustumCulling = opt.frustumCulling;
+    cfg.gpuDriven = opt.gpuDriven;
+    cfg.bindless = opt.bindless;
+    cfg.profiling = !opt.tracePath.empty();
+
+    BenchGame game(opt);
+    aurora::PipelineCacheStats cacheStats;
+    try {
+        aurora::Engine engine(cfg);
+        engine.run(game);
+        cacheStats = engine.getPipelineCacheStats();
+        if (!opt.tracePath.empty()) engine.writeTrace(opt.tracePath);
+    } catch (const std::exception& e) {
+        std::cerr << "aurora_bench: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::ostringstream json;
+    json << "{\"frames\":" << game.recorded()
+         << ",\"warmup\":" << opt.warmup
+         << ",\"headless\":" << (opt.headless ? "true" : "false")
+         << ",\"width\":" << opt.width
+         << ",\"height\":" << opt.height
+         << ",\"frames_in_flight\":" << opt.framesInFlight
+         << ",\"draws\":" << opt.draws
+         << ",\"entities\":" << opt.entities
+         << ",\"nodes\":" << opt.nodes
+         << ",\"move_percent\":" << opt.movePercent
+         << ",\"record_threads\":" << opt.recordThreads
+         << ",\"job_workers\":" << opt.jobWorkers
+         << ",\"render_thread\":" << (opt.renderThread ? "true" : "false")
+         << ",\"render_packets\":" << opt.renderPackets
+         << ",\"frustum_culling\":" << (opt.frustumCulling ? "true" : "false")
+         << ",\"gpu_driven\":" << (opt.gpuDriven ? "true" : "false")
+         << ",\"materials\":" << opt.materials
+         << ",\"pipeline_cache\":{\"loaded_from_disk\":" << (cacheStats.loadedFromDisk ? "true" : "false")
+         << ",\"loaded_bytes\":" << cacheStats.loadedBytes
+         << ",\"pipelines\":" << cacheStats.pipelinesCreated
+         << ",\"hits\":" << cacheStats.cacheHits
+         << ",\"misses\":" << cacheStats.cacheMisses
+         << ",\"hit_ms\":" << cacheStats.hitMs
+         << ",\"miss_ms\":" << cacheStats.missMs
+         << ",\"total_ms\":" << cacheStats.totalMs
+         << ",\"max_ms\":" << cacheStats.maxMs
+         << ",\"state_requests\":" << cacheStats.stateRequests
+         << ",\"state_deduplicated\":" << cacheStats.stateDeduplicated << "}";
+    json << ",";
+    game.writeRenderGraph(json);
+    json << ",";
+    game.writeDescriptors(json, opt.bindless);
+    for (auto* s : game.all()) {
+        json << ",";
+        writeSeries(json, *s);
+    }
+    json << "}";
+
+    // Engine logs go to stdout too; the JSON is always the last line
+    std::cout << json.str() << std::endl;
+    if (!opt.outPath.empty()) {
+        std::ofstream f(opt.outPath);
+        if (!f) { std::cerr << "aurora_bench: cannot write " << opt.outPath << "\n"; return 1; }
+        f << json.str() << "\n";
+    }
+    // Closing the window early leaves fewer samples than requested
+    return game.recorded() >= opt.frames ? 0 : 3;
+}
@@ -0,0 +1,215 @@
+// math_bench: times the aurora::math batch kernels against their scalar reference versions
+// and prints one JSON line with ns per item and the speedup for each kernel and size.
+//
+//   math_bench [--count N] [--min-ms MS] [--out file.json]
+//
+// The SIMD backend is fixed at compile time (CMake option AURORA_SIMD); "backend" in the
+// output says which one was measured. Before timing, each SIMD kernel's output is compared with
+// the scalar one; a mismatch is reported and the bench exits with status 3 without posting numbers.
+#include <aurora/math/Batch.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace aurora::math;
+
+namespace {
+
+struct Options {
+    std::vector<size_t> counts = {4096, 1u << 20}; // L1/L2-resident and memory-bound
+    double minMs = 200.0;
+    std::string outPath;
+};
+
+// Runs fn until minMs has passed; returns nanoseconds per item
+double timeKernel(const std::function<void()>& fn, size_t items, double minMs) {
+    using clock = std::chrono::steady_clock;
+    fn(); // warm caches and page in outputs
+    size_t reps = 0;
+    auto start = clock::now();
+    double elapsedMs = 0.0;
+    do {
+        fn();
+        ++reps;
+        elapsedMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    } while (elapsedMs < minMs);
+    return elapsedMs * 1e6 / (static_cast<double>(reps) * static_cast<double>(items));
+}
+
+struct Data {
+    explicit Data(size_t n) : x(n), y(n), z(n), r(n), ox(n), oy(n), oz(n), qx(n), qy(n), qz(n), qw(n),
+                              sx(n), sy(n), sz(n), visible(n), indices(n), a(n), b(n), m(n) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = u(rng) * 100.0f;
+            y[i] = u(rng) * 100.0f;
+            z[i] = u(rng) * 100.0f - 50.0f;
+            r[i] = 0.5f + 0.5f * u(rng);
+            Quat q = normalize(Quat{u(rng), u(rng), u(rng), u(rng)});
+            qx[i] = q.x; qy[i] = q.y; qz[i] = q.z; qw[i] = q.w;
+            sx[i] = 1.0f + u(rng) * 0.5f; sy[i] = 1.0f + u(rng) * 0.5f; sz[i] = 1.0f + u(rng) * 0.5f;
+        }
+        TrsStreams trs = streams();
+        scalar::composeTrs(trs, a.data(), n);
+        scalar::composeTrs(trs, b.data(), n);
+    }
+    TrsStreams streams() const {
+        return {x.data(), y.data(), z.data(), qx.data(), qy.data(), qz.data(), qw.data(), sx.data(), sy.data(), sz.data()};
+    }
+    std::vector<float> x, y, z, r, ox, oy, oz, qx, qy, qz, qw, sx, sy, sz;
+    std::vector<uint8_t> visible;
+    std::vector<uint32_t> indices;
+    std::vector<Mat4> a, b, m;
+};
+
+// Matrix and point outputs may differ by FMA contraction and reassociation, so compare them
+// relative to the value's magnitude
+constexpr float kTolerance = 1e-4f;
+
+// A sphere whose distance to some plane is within rounding of -radius can land on either side
+bool onPlaneEdge(const Frustum& frustum, const Data& d, size_t i) {
+    for (const Plane& p : frustum.planes) {
+        const float margin = p.distance({d.x[i], d.y[i], d.z[i]}) + d.r[i];
+        const float scale = std::fabs(p.normal.x * d.x[i]) + std::fabs(p.normal.y * d.y[i]) + std::fabs(p.normal.z * d.z[i]) +
+                            std::fabs(p.d) + d.r[i];
+        if (std::fabs(margin) <= kTolerance * std::max(1.0f, scale)) return true;
+    }
+    return false;
+}
+
+// Number of items whose SIMD result differs from the scalar one beyond rounding
+size_t countMismatches(const std::vector<float>& expected, const std::vector<float>& actual, bool visibility,
+                       const Frustum& frustum, const Data& d) {
+    if (expected.size() != actual.size()) return std::max(expected.size(), actual.size());
+    size_t bad = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (visibility) {
+            if (expected[i] != actual[i] && !onPlaneEdge(frustum, d, i)) ++bad;
+        } else if (!(std::fabs(expected[i] - actual[i]) <= kTolerance * std::max(1.0f, std::fabs(expected[i])))) {
+            ++bad;
+        }
+    }
+    return bad;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* a = argv[i];
+        const char* v = nullptr;
+        if (std::strcmp(a, "--count") == 0 && (v = next())) { opt.counts = {static_cast<size_t>(std::strtoull(v, nullptr, 10))}; continue; }
+        if (std::strcmp(a, "--min-ms") == 0 && (v = next())) { opt.minMs = std::strtod(v, nullptr); continue; }
+        if (std::strcmp(a, "--out") == 0 && (v = next())) { opt.outPath = v; continue; }
+        std::cerr << "usage: math_bench [--count N] [--min-ms MS] [--out file.json]\n";
+        return false;
+    }
+    for (size_t& c : opt.counts) c = c == 0 ? 1 : c;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    const Frustum frustum = Frustum::fromMatrix(Mat4::perspective(radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f) *
+                                                Mat4::lookAt({0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}));
+    const Mat4 xform = Mat4::trs({1.0f, 2.0f, 3.0f}, Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.7f), Vec3(2.0f));
+
+    std::ostringstream json;
+    json << "{\"backend\":\"" << aurora::simd::kBackend << "\",\"width\":" << aurora::simd::kWidth << ",\"kernels\":[";
+    bool first = true;
+    size_t checksum = 0;
+    for (size_t n : opt.counts) {
+        Data d(n);
+        const TrsStreams trs = d.streams();
+        size_t lastCount = 0;
+        struct Kernel {
+            const char* name;
+            std::function<void()> scalarFn, simdFn;
+            std::function<std::vector<float>()> output; // flattened result of the last run
+            bool visibility;                             // output is one 0/1 flag per sphere
+        };
+        auto points = [&] {
+            std::vector<float> out(d.ox);
+            out.insert(out.end(), d.oy.begin(), d.oy.end());
+            out.insert(out.end(), d.oz.begin(), d.oz.end());
+            return out;
+        };
+        auto matrices = [&] {
+            const float* f = &d.m[0].cols[0].x;
+            return std::vector<float>(f, f + n * 16);
+        };
+        auto flags = [&] { return std::vector<float>(d.visible.begin(), d.visible.end()); };
+        auto culled = [&] {
+            std::vector<float> out(n, 0.0f);
+            for (size_t i = 0; i < lastCount; ++i) out[std::min<size_t>(d.indices[i], n - 1)] += 1.0f;
+            return out;
+        };
+        const Kernel kernels[] = {
+            {"transform_points",
+             [&] { scalar::transformPoints(xform, d.x.data(), d.y.data(), d.z.data(), d.ox.data(), d.oy.data(), d.oz.data(), n); },
+             [&] { transformPoints(xform, d.x.data(), d.y.data(), d.z.data(), d.ox.data(), d.oy.data(), d.oz.data(), n); },
+             points, false},
+            {"multiply_matrices",
+             [&] { scalar::multiplyMatrices(d.a.data(), d.b.data(), d.m.data(), n); },
+             [&] { multiplyMatrices(d.a.data(), d.b.data(), d.m.data(), n); },
+             matrices, false},
+            {"compose_trs",
+             [&] { scalar::composeTrs(trs, d.m.data(), n); },
+             [&] { composeTrs(trs, d.m.data(), n); },
+             matrices, false},
+            {"frustum_spheres",
+             [&] { checksum += lastCount = scalar::testSpheres(frustum, d.x.data(), d.y.data(), d.z.data(), d.r.data(), d.visible.data(), n); },
+             [&] { checksum += lastCount = testSpheres(frustum, d.x.data(), d.y.data(), d.z.data(), d.r.data(), d.visible.data(), n); },
+             flags, true},
+            {"cull_spheres",
+             [&] { checksum += lastCount = scalar::cullSpheres(frustum, d.x.data(), d.y.data(), d.z.data(), d.r.data(), 0, d.indices.data(), n); },
+             [&] { checksum += lastCount = cullSpheres(frustum, d.x.data(), d.y.data(), d.z.data(), d.r.data(), 0, d.indices.data(), n); },
+             culled, true},
+        };
+        for (const Kernel& k : kernels) {
+            k.scalarFn();
+            const std::vector<float> expected = k.output();
+            k.simdFn();
+            const size_t bad = countMismatches(expected, k.output(), k.visibility, frustum, d);
+            if (bad != 0) {
+                std::cerr << "math_bench: " << k.name << " n=" << n << ": " << aurora::simd::kBackend << " output differs from scalar for "
+                          << bad << " item(s)\n";
+                return 3;
+            }
+            const double scalarNs = timeKernel(k.scalarFn, n, opt.minMs);
+            const double simdNs = timeKernel(k.simdFn, n, opt.minMs);
+            std::cerr << k.name << " n=" << n << ": scalar " << scalarNs << " ns/item, " << aurora::simd::kBackend
+                      << " " << simdNs << " ns/item (" << scalarNs / simdNs << "x)\n";
+            json << (first ? "" : ",") << "{\"name\":\"" << k.name << "\",\"count\":" << n
+                 << ",\"scalar_ns\":" << scalarNs << ",\"simd_ns\":" << simdNs << ",\"speedup\":" << scalarNs / simdNs << "}";
+            first = false;
+        }
+        checksum += static_cast<size_t>(d.ox[n / 2] + d.m[n / 2].cols[3].x);
+    }
+    json << "],\"checksum\":" << checksum << "}";
+
+    std::cout << json.str() << std::endl;
+    if (!opt.outPath.empty()) {
+        std::ofstream f(opt.outPath);
+        if (!f) {
+            std::cerr << "math_bench: cannot write " << opt.outPath << "\n";
+            return 1;
+        }
+        f << json.str() << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+namespace io { class FileSystem; }
+
+namespace aurora {
+
+class Engine;
+
+enum class AssetState : uint8_t {
+    Queued,   // waiting for an I/O thread
+    Loading,  // bytes being read from the file system
+    Decoding, // waiting for / running on a decode thread
+    Ready,    // decoded; becomes Resident at the next AssetStreamer::pump
+    Resident,
+    Failed,   // missing file or decoder threw; get() keeps returning the placeholder. The path
+              // stays cached as Failed while any handle to it lives, so load() returns the same
+              // failed asset instead of retrying; release every handle to retry.
+};
+
+// Raw file contents; built-in asset type for data without a dedicated decoder
+struct AssetBlob {
+    std::vector<uint8_t> bytes;
+};
+
+namespace detail { struct AssetRecord; }
+
+// Untyped part of AssetHandle
+class AssetHandleBase {
+public:
+    AssetHandleBase() = default;
+
+    bool valid() const { return record_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+    AssetState state() const;
+    bool isResident() const { return state() == AssetState::Resident; }
+    const std::string& path() const;
+
+    // Higher loads sooner. Only affects work that has not started yet (e.g. set from camera
+    // distance every frame); thread-safe.
+    void setPriority(float priority);
+    float priority() const;
+
+protected:
+    explicit AssetHandleBase(std::shared_ptr<detail::AssetRecord> record) : record_(std::move(record)) {}
+    // Resident payload, otherwise the type's placeholder (may be null)
+    const void* resolve() const;
+
+    std::shared_ptr<detail::AssetRecord> record_;
+    friend class AssetStreamer;
+};
+
+// Reference-counted handle. Copies share the asset; once the last handle is gone the asset is
+// unloaded, and queued work for it is dropped. Resolve with get() on the game thread.
+template<typename T>
+class AssetHandle : public AssetHandleBase {
+public:
+    AssetHandle() = default;
+    const T* get() const { return static_cast<const T*>(resolve()); }
+    const T* operator->() const { return get(); }
+
+private:
+    explicit AssetHandle(std::shared_ptr<detail::AssetRecord> record) : AssetHandleBase(std::move(record)) {}
+    friend class AssetStreamer;
+};
+
+// Background asset streaming: an I/O stage reads files through the engine's virtual file
+// system and a decode stage runs the registered decoder for the asset type, both fed from
+// priority queues. Decoded assets are published and their callbacks run in pump(), which
+// Engine::run calls on the game thread before IGame::onUpdate, so handles only change
+// between frames.
+class AssetStreamer {
+public:
+    struct Stats {
+        uint32_t queued = 0;   // not yet read
+        uint32_t inFlight = 0; // reading or decoding
+        uint32_t resident = 0;
+        uint32_t failed = 0;
+        uint32_t trackedPaths = 0; // path entries held before this call swept the released ones
+        uint64_t bytesRead = 0;
+        double ioMs = 0.0;
+        double decodeMs = 0.0;
+    };
+
+    template<typename T>
+    using Decoder = std::function<std::shared_ptr<T>(const uint8_t* data, size_t size)>;
+
+    // The engine owns one (Engine::assets()); tools and tests may run their own over any file
+    // system. Thread counts of 0 are treated as 1.
+    AssetStreamer(io::FileSystem& files, uint32_t ioThreads, uint32_t decodeThreads);
+    ~AssetStreamer();
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    // Decoders run on decode threads and may throw to fail the asset. The placeholder is what
+    // handles of this type resolve to until they are resident. Register before loading.
+    template<typename T>
+    void registerType(Decoder<T> decoder, std::shared_ptr<const T> placeholder = nullptr) {
+        registerTypeErased(std::type_index(typeid(T)),
+                           [d = std::move(decoder)](const uint8_t* data, size_t size) -> std::shared_ptr<const void> {
+                               return d(data, size);
+                           },
+                           std::move(placeholder));
+    }
+
+    // Loading a path that is already loaded (or loading, or failed) returns the same asset; a
+    // higher priority is kept. onReady runs in pump() once the asset is resident or failed.
+    template<typename T>
+    AssetHandle<T> load(const std::string& path, float priority = 0.0f,
+                        std::function<void(const AssetHandle<T>&)> onReady = {}) {
+        std::function<void(const std::shared_ptr<detail::AssetRecord>&)> cb;
+        if (onReady) {
+            cb = [f = std::move(onReady)](const std::shared_ptr<detail::AssetRecord>& r) { f(AssetHandle<T>(r)); };
+        }
+        return AssetHandle<T>(loadErased(path, std::type_index(typeid(T)), priority, std::move(cb)));
+    }
+
+    // Game thread: publish finished assets and run their callbacks. Stops after budgetMs
+    // (at least one callback runs); the rest carry over to the next call.
+    void pump(double budgetMs);
+    // Blocks until nothing is queued or in flight, then pumps everything (loading screens, tests)
+    void waitIdle();
+
+    Stats stats() const;
+
+private:
+    friend class Engine;
+    friend class AssetHandleBase;
+    friend struct detail::AssetRecord;
+    struct Impl;
+
+    using ErasedDecoder = std::function<std::shared_ptr<const void>(const uint8_t*, size_t)>;
+    void registerTypeErased(std::type_index type, ErasedDecoder decoder, std::shared_ptr<const void> placeholder);
+    std::shared_ptr<detail::AssetRecord> loadErased(const std::string& path, std::type_index type, float priority,
+                                                    std::function<void(const std::shared_ptr<detail::AssetRecord>&)> onReady);
+
+    std::shared_ptr<Impl> impl_; // records hold weak references for setPriority
+};
+
+} // namespace aurora
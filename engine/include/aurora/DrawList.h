@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aurora {
+
+// One mesh draw. Mesh 0 is the built-in triangle; position/scale place it in clip space
+// until a camera exists. With object set, the world matrix of that scene node
+// (scene::Node::index) places it instead and position/scale are ignored. material is an id
+// from Engine::createMaterial (0 = aurora::kDefaultMaterial).
+struct DrawCommand {
+    static constexpr uint32_t kNoObject = UINT32_MAX;
+
+    float position[3] = {0.0f, 0.0f, 0.0f};
+    float scale = 1.0f;
+    uint32_t mesh = 0;
+    uint32_t object = kNoObject;
+    uint32_t material = 0;
+};
+
+// Retained list of draws, rendered every frame until the game changes it (see
+// Engine::drawList). The renderer sorts the draws by state (pipeline, material, mesh) and then
+// front to back, and draws each run of equal state as one instanced draw call; submission
+// order is not kept. An empty list draws the built-in triangle.
+class DrawList {
+public:
+    void clear() { commands_.clear(); }
+    void reserve(size_t count) { commands_.reserve(count); }
+    void add(const DrawCommand& cmd) { commands_.push_back(cmd); }
+    // Appends count default draws and returns them for filling in place (e.g. by parallel
+    // jobs); valid until the list changes again
+    DrawCommand* append(size_t count) {
+        size_t first = commands_.size();
+        commands_.resize(first + count);
+        return commands_.data() + first;
+    }
+
+    size_t size() const { return commands_.size(); }
+    bool empty() const { return commands_.empty(); }
+    const std::vector<DrawCommand>& commands() const { return commands_; }
+
+private:
+    std::vector<DrawCommand> commands_;
+};
+
+} // namespace aurora
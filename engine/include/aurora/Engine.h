@@ -4,6 +4,16 @@
 #include <string>
 #include <memory>
 
+#include "aurora/Assets.h"
+#include "aurora/DrawList.h"
+#include "aurora/JobSystem.h"
+#include "aurora/Material.h"
+#include "aurora/ecs/CommandBuffer.h"
+#include "aurora/ecs/Components.h"
+#include "aurora/ecs/World.h"
+#include "aurora/scene/FrustumCuller.h"
+#include "aurora/scene/TransformHierarchy.h"
+
 namespace aurora {
 
 class IGame;
@@ -12,6 +22,125 @@ struct EngineConfig {
     uint32_t height = 720;
     std::string title = "Aurora";
     bool enableValidation = false; // future toggle
+    // No window/surface: render into offscreen images (CI / render farm / perf runs).
+    // The loop then runs until IGame calls Engine::requestExit().
+    bool headless = false;
+    // Start with CPU/GPU profiling zones enabled (see Engine::writeTrace)
+    bool profiling = false;
+    // Frames the CPU may record ahead of the GPU: 2 = lower input latency, 3 = more
+    // throughput when GPU-bound. Independent of the swapchain image count.
+    uint32_t framesInFlight = 2;
+    // Persistent VkPipelineCache: loaded at startup if it matches the GPU/driver, written
+    // back on shutdown. Empty disables persistence.
+    std::string pipelineCachePath = "aurora_pipeline.cache";
+    // Store mesh vertices quantized (16-bit positions in the mesh bounds, octahedral
+    // normals, 8-bit color): 16 bytes instead of 40. Disable if precision artifacts show.
+    bool quantizeVertices = true;
+    // Asset pack (build it with aurora_pack; the CMake `pack` target writes build/aurora.pak).
+    // Files missing from the pack are read from loose directories. Empty = loose files only.
+    std::string packPath = "aurora.pak";
+    // Asset streaming (see Engine::assets): background reader and decoder threads, and the
+    // game-thread time per frame spent publishing finished assets and running callbacks
+    uint32_t assetIoThreads = 1;
+    uint32_t assetDecodeThreads = 2;
+    double assetCallbackBudgetMs = 2.0;
+    // Worker threads of the job system (see Engine::jobs); the main thread also runs jobs
+    // while it waits. 0 = hardware concurrency - 1.
+    uint32_t jobWorkers = 0;
+    // Max ranges the main pass is split into for parallel recording into secondary command
+    // buffers; 0 = one per job system thread. Small draw lists are recorded inline regardless.
+    uint32_t recordThreads = 0;
+    // Record and submit on a dedicated render thread while the game thread builds the next
+    // frame; false renders on the game thread after each update. Either way IGame::onUpdate
+    // runs on the game thread before the frame's transforms and draws are taken from the
+    // world, and sees the timings of the last frame finished. renderPackets is the number
+    // of frames in the hand-off ring (min 2): 2 lets the game run one frame ahead of the
+    // frame being drawn, 3 two frames, trading input latency for smoother pacing.
+    bool renderThread = true;
+    uint32_t renderPackets = 2;
+    // Test the bounding sphere of every draw (draw list and scene) against the view frustum
+    // and submit only the visible ones. Until a camera exists the frustum is the clip volume.
+    bool frustumCulling = true;
+    // GPU-driven rendering: a compute shader culls the draws and writes indirect draw commands
+    // that the main pass consumes with vkCmdDrawIndexedIndirectCount, so recording costs the
+    // same for 10 or 100k draws. Replaces the CPU frustum culling. Needs Vulkan 1.2
+    // drawIndirectCount, multiDrawIndirect and drawIndirectFirstInstance; otherwise ignored.
+    bool gpuDriven = false;
+    // Bindless descriptors: every texture and storage buffer lives in one descriptor-indexed
+    // table bound once per pass, and draws select theirs by a pushed material index instead
+    // of binding a set per material. Needs Vulkan 1.2 descriptor indexing with
+    // update-after-bind; otherwise ignored.
+    bool bindless = false;
+};
+
+// One executed render graph pass of a frame (see FrameTimings::renderPasses)
+struct RenderPassTiming {
+    const char* name = ""; // static string
+    double cpuMs = 0.0;    // recording, barriers included
+    double gpuMs = 0.0;    // timestamps; lags by the frames in flight, 0 without timestamp support
+};
+
+// Per-frame CPU timings in milliseconds (see Engine::getFrameTimings)
+struct FrameTimings {
+    double frameMs = 0.0;     // wall time between the starts of the last two loop iterations
+    double fenceWaitMs = 0.0; // vkWaitForFences for the frame slot
+    double acquireMs = 0.0;   // vkAcquireNextImageKHR (0 when headless)
+    double submitMs = 0.0;    // vkQueueSubmit
+    double presentMs = 0.0;   // vkQueuePresentKHR (0 when headless)
+    double recordMs = 0.0;    // main pass command recording (parallel when there are many batches)
+    double sortMs = 0.0;      // render thread: sort keys, radix sort and instance data of the draws
+    uint32_t drawCalls = 0;   // instanced draw calls of the main pass after batching
+    double packetWaitMs = 0.0; // game thread waiting for a free render packet (render thread only)
+    double transformMs = 0.0; // TransformHierarchy::update plus collecting changed matrices
+    uint32_t transformsChanged = 0; // world matrices recomputed and sent to the GPU this frame
+    double cullMs = 0.0;       // frustum test of all draws plus gathering the visible ones
+    // Draws before / after culling (equal with culling off). GPU-driven: the GPU's counts of
+    // the frame that last used the same frame slot, read back after its fence.
+    uint32_t drawsTested = 0;
+    uint32_t drawsVisible = 0;
+    // Render graph of the frame: passes in execution order, passes culled because nothing
+    // used their output, barriers it derived, and memory of transient attachments (saved =
+    // what aliasing images with disjoint lifetimes avoided allocating)
+    static constexpr uint32_t kMaxRenderPasses = 16;
+    RenderPassTiming renderPasses[kMaxRenderPasses];
+    uint32_t renderPassCount = 0;
+    uint32_t passesCulled = 0;
+    uint32_t barriers = 0;
+    uint64_t transientBytes = 0;
+    uint64_t transientBytesSaved = 0;
+    // Descriptors: sets allocated this frame (from per-frame pools reset wholesale), pools
+    // created so far and how often a frame outgrew its pools, set layouts created and layout
+    // requests served from the cache
+    uint32_t descriptorSets = 0;
+    uint32_t descriptorPools = 0;
+    uint32_t descriptorPoolGrowths = 0;
+    uint32_t descriptorLayouts = 0;
+    uint64_t descriptorLayoutHits = 0;
+    // Live bindless table entries (EngineConfig::bindless)
+    uint32_t bindlessTextures = 0;
+    uint32_t bindlessBuffers = 0;
+    // Pipelines compiling on job threads, and pipeline lookups of this frame whose pipeline
+    // was not ready yet (its draws used a fallback pipeline or were skipped, never waited)
+    uint32_t pipelinesCompiling = 0;
+    uint32_t pipelineFallbacks = 0;
+};
+
+// Pipeline cache effectiveness (see Engine::getPipelineCacheStats)
+struct PipelineCacheStats {
+    bool loadedFromDisk = false; // startup blob matched this device/driver and was used
+    size_t loadedBytes = 0;
+    uint32_t pipelinesCreated = 0;
+    // Hit/miss split requires VK_EXT_pipeline_creation_feedback; otherwise both are 0
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+    double hitMs = 0.0;
+    double missMs = 0.0;
+    double totalMs = 0.0; // all pipeline creation time so far
+    double maxMs = 0.0;   // slowest single pipeline: the hitch it would have been on a frame
+    // Pipeline state requests (one per material/pass combination asked for) and those that
+    // matched an existing pipeline instead of compiling a new one
+    uint64_t stateRequests = 0;
+    uint64_t stateDeduplicated = 0;
 };
 
 class Engine {
@@ -23,9 +152,37 @@ public:
     Engine& operator=(const Engine&) = delete;
 
     void run(IGame& game);
+    // Ask the loop to stop after the current frame (only way to end a headless run)
+    void requestExit() { exitRequested_ = true; }
+    bool isHeadless() const { return headless_; }
 
     // timing
     float getDeltaTime() const { return deltaTime_; }
+    // Timings of the most recently completed frame
+    const FrameTimings& getFrameTimings() const { return frameTimings_; }
+    PipelineCacheStats getPipelineCacheStats() const;
+
+    // Shared work-stealing job system; create jobs from the game thread or from other jobs
+    JobSystem& jobs();
+    // Background asset loading; callbacks run on the game thread before IGame::onUpdate
+    AssetStreamer& assets();
+    // Scene: entities with ecs::Transform (or ecs::SceneNode) and ecs::MeshRenderer are drawn
+    // every frame after the draw list. Mutate it on the game thread (IGame callbacks) only.
+    ecs::World& world();
+    // Node transforms for ecs::SceneNode. Updated after IGame::onUpdate each frame; only
+    // world matrices that changed are uploaded. Game thread only.
+    scene::TransformHierarchy& transforms();
+    // Draws rendered each frame (retained; edit it in IGame::onUpdate)
+    DrawList& drawList();
+    // New material for DrawCommand::material / ecs::MeshRenderer::material. Materials with the
+    // same features share a pipeline; a new feature combination compiles its shader variant in
+    // the background, and its draws use the default material's pipeline until it is ready.
+    // Materials live as long as the engine; throws std::runtime_error past 1024.
+    uint32_t createMaterial(const MaterialDesc& desc);
+
+    // profiling (aurora::Profiler): toggle zone capture, dump captured zones as Chrome trace JSON
+    void setProfilingEnabled(bool enabled);
+    bool writeTrace(const std::string& path) const;
 
 private:
     void init(const EngineConfig& cfg);
@@ -35,7 +192,11 @@ private:
 private:
     struct Impl; // PIMPL hides Vulkan/window details
     std::unique_ptr<Impl> impl_;
+    double assetCallbackBudgetMs_ = 2.0;
     float deltaTime_ = 0.f;
+    FrameTimings frameTimings_;
+    bool exitRequested_ = false;
+    bool headless_ = false;
 };
 
 class IGame {
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aurora {
+
+class JobSystem;
+
+// Counts unfinished jobs. Pass it to JobSystem::run as the signal of a batch, then wait on it
+// or make later jobs depend on it. Reusable once it reaches zero.
+class JobCounter {
+public:
+    JobCounter() = default;
+    // Waits for jobs still finishing their decrement, so a counter can live on the stack
+    ~JobCounter();
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return value_.load(std::memory_order_acquire) == 0; }
+    uint32_t pending() const { return value_.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    struct Job;
+    std::atomic<uint32_t> value_{0};
+    std::atomic<uint32_t> finishing_{0}; // jobs between their decrement and their last access
+    std::mutex mutex_;
+    std::vector<Job*> continuations_; // jobs waiting for this counter to reach zero
+};
+
+// Work-stealing job system. Every worker (and the thread that created the system) owns a
+// Chase-Lev deque: it pushes and pops at the bottom, idle threads steal from the top. Jobs
+// started from other threads go through a shared injection queue. wait() executes jobs
+// instead of blocking, so the main thread takes part while it waits.
+class JobSystem {
+public:
+    using Job = JobCounter::Job;
+
+    // workerCount 0 = hardware concurrency - 1 (the creating thread is the extra one)
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queue fn. signal (optional) is incremented now and decremented when fn returns.
+    // With dependsOn, fn is held back until that counter reaches zero. Jobs must not throw.
+    void run(std::function<void()> fn, JobCounter* signal = nullptr, JobCounter* dependsOn = nullptr);
+
+    // Runs jobs on this thread until counter reaches zero
+    void wait(JobCounter& counter);
+
+    // body(first, last) over [begin, end) split into ranges of at least minGrain. Ranges are
+    // split lazily in halves, so idle threads steal large pieces and busy ones keep small
+    // ones; the grain adapts to the item count and thread count. Blocks (helping) until done.
+    template<typename F>
+    void parallelFor(uint32_t begin, uint32_t end, F&& body, uint32_t minGrain = 1) {
+        if (begin >= end) return;
+        std::function<void(uint32_t, uint32_t)> fn(std::forward<F>(body));
+        parallelForImpl(begin, end, fn, minGrain);
+    }
+
+    // Workers plus the creating thread
+    uint32_t threadCount() const { return static_cast<uint32_t>(queues_.size()); }
+    // Index of the calling thread in [0, threadCount()), or UINT32_MAX for foreign threads
+    uint32_t currentThreadIndex() const;
+
+private:
+    class Deque;
+
+    void parallelForImpl(uint32_t begin, uint32_t end, const std::function<void(uint32_t, uint32_t)>& body,
+                         uint32_t minGrain);
+    void schedule(Job* job);
+    Job* findJob(uint32_t self);
+    void execute(Job* job);
+    void workerMain(uint32_t index);
+
+    std::vector<std::unique_ptr<Deque>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex injectMutex_;
+    std::vector<Job*> injected_;
+
+    // Sleep/wake for idle workers
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<int64_t> queued_{0};
+    std::atomic<uint32_t> sleeping_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace aurora
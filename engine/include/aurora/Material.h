@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace aurora {
+
+// Shader features of a material (MaterialDesc::features). Each one is a specialization
+// constant of the mesh shaders: every distinct combination is its own pipeline, compiled
+// with the disabled code removed, so no fragment tests these flags at run time.
+enum MaterialFeature : uint32_t {
+    kMaterialVertexColor = 1u << 0, // multiply the base color by the mesh's vertex color
+    kMaterialLit = 1u << 1,         // Lambert diffuse plus ambient from a fixed directional light
+    kMaterialAlphaTest = 1u << 2,   // discard fragments whose alpha is below alphaCutoff
+};
+
+// Material 0 always exists: vertex color, unlit, white (see Engine::createMaterial)
+constexpr uint32_t kDefaultMaterial = 0;
+
+struct MaterialDesc {
+    uint32_t features = kMaterialVertexColor;
+    float baseColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float alphaCutoff = 0.5f; // kMaterialAlphaTest only
+};
+
+} // namespace aurora
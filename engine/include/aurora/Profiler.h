@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace aurora {
+
+// One completed zone. Names must outlive the profiler (string literals).
+struct ProfileEvent {
+    const char* name = nullptr;
+    const char* category = nullptr; // "cpu" / "gpu"
+    uint32_t tid = 0;
+    uint64_t startUs = 0;
+    uint64_t durationUs = 0;
+};
+
+// Process-wide zone recorder. Events go into a fixed-size ring so a long session keeps
+// the most recent history; writeChromeTrace dumps it in trace_event format
+// (open with chrome://tracing or https://ui.perfetto.dev).
+class Profiler {
+public:
+    static constexpr size_t kMaxEvents = 1u << 18;
+    static constexpr uint32_t kGpuTrackId = 0xFFFFu;
+
+    static Profiler& get();
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+
+    // Microseconds on the profiler clock (steady, process-relative)
+    uint64_t nowUs() const;
+
+    void recordCpu(const char* name, uint64_t startUs, uint64_t endUs);
+    // GPU zones live on their own track; times already converted to the profiler clock
+    void recordGpu(const char* name, uint64_t startUs, uint64_t durationUs);
+
+    void clear();
+    std::vector<ProfileEvent> snapshot() const;
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    Profiler();
+    void push(const ProfileEvent& ev);
+    static uint32_t currentThreadId();
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    std::vector<ProfileEvent> events_;
+    size_t head_ = 0;   // next write slot
+    bool wrapped_ = false;
+    uint64_t epochNs_ = 0;
+};
+
+// RAII CPU zone; records nothing when the profiler is disabled at construction
+class ScopedZone {
+public:
+    explicit ScopedZone(const char* name)
+        : name_(Profiler::get().isEnabled() ? name : nullptr),
+          startUs_(name_ ? Profiler::get().nowUs() : 0) {}
+    ~ScopedZone() {
+        if (name_) Profiler::get().recordCpu(name_, startUs_, Profiler::get().nowUs());
+    }
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    const char* name_;
+    uint64_t startUs_;
+};
+
+} // namespace aurora
+
+#define AURORA_PROFILE_CONCAT_INNER(a, b) a##b
+#define AURORA_PROFILE_CONCAT(a, b) AURORA_PROFILE_CONCAT_INNER(a, b)
+#ifdef AURORA_DISABLE_PROFILER
+#define AURORA_PROFILE_ZONE(name) do {} while(0)
+#else
+// Times the enclosing scope: AURORA_PROFILE_ZONE("Renderer::drawFrame");
+#define AURORA_PROFILE_ZONE(name) ::aurora::ScopedZone AURORA_PROFILE_CONCAT(auroraZone_, __LINE__)(name)
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aurora/ecs/World.h"
+
+namespace aurora::ecs {
+
+// Deferred structural changes, recorded during iteration and applied by World::playback.
+// Component values are moved into an arena that never reallocates, so any nothrow-movable
+// component can be recorded. One buffer per thread: recording is not synchronized.
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+    ~CommandBuffer() { clear(); }
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    CommandBuffer(CommandBuffer&& other) noexcept
+        : commands_(std::move(other.commands_)), blocks_(std::move(other.blocks_)), used_(other.used_) {
+        other.used_ = kBlockBytes;
+    }
+    CommandBuffer& operator=(CommandBuffer&& other) noexcept {
+        if (this != &other) {
+            clear();
+            commands_ = std::move(other.commands_);
+            blocks_ = std::move(other.blocks_);
+            used_ = other.used_;
+            other.used_ = kBlockBytes;
+        }
+        return *this;
+    }
+
+    template<typename... Cs>
+    void create(Cs&&... components) {
+        commands_.push_back({Op::Create, Entity{}, nullptr, nullptr, static_cast<uint32_t>(sizeof...(Cs))});
+        (record(Op::Add, Entity{}, std::forward<Cs>(components)), ...);
+    }
+    void destroy(Entity e) { commands_.push_back({Op::Destroy, e, nullptr, nullptr, 0}); }
+    template<typename T>
+    void add(Entity e, T value = T{}) { record(Op::Add, e, std::move(value)); }
+    template<typename T>
+    void remove(Entity e) { commands_.push_back({Op::Remove, e, &componentInfo<T>(), nullptr, 0}); }
+
+    bool empty() const { return commands_.empty(); }
+    size_t size() const { return commands_.size(); }
+    // Drops unplayed commands
+    void clear();
+
+private:
+    friend class World;
+    static constexpr size_t kBlockBytes = 64 * 1024;
+
+    enum class Op : uint8_t { Create, Destroy, Add, Remove };
+    struct Command {
+        Op op;
+        Entity entity;
+        const ComponentInfo* info;
+        void* value;    // Add: constructed component owned by the buffer
+        uint32_t count; // Create: number of Add commands that follow for the new entity
+    };
+
+    template<typename T>
+    void record(Op op, Entity e, T&& value) {
+        using U = std::decay_t<T>;
+        const ComponentInfo& info = componentInfo<U>();
+        void* mem = allocate(info.size, info.align);
+        new (mem) U(std::forward<T>(value));
+        commands_.push_back({op, e, &info, mem, 0});
+    }
+    void* allocate(size_t size, size_t align);
+
+    std::vector<Command> commands_;
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    size_t used_ = kBlockBytes; // bytes used in blocks_.back()
+};
+
+} // namespace aurora::ecs
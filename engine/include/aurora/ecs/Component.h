@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace aurora::ecs {
+
+// Stable per-type id, computed at compile time from the type's name. Equal across translation
+// units and runs of the same build, so ids can key caches and serialized data.
+using ComponentId = uint64_t;
+
+// Type-erased description of a component type: what archetype chunks need to lay out,
+// move and destroy values they only know as bytes.
+struct ComponentInfo {
+    ComponentId id = 0;
+    uint32_t size = 0;
+    uint32_t align = 0;
+    std::string_view name;
+    bool trivial = false; // relocate with memcpy, nothing to destroy
+    void (*construct)(void* dst) = nullptr;
+    void (*moveConstruct)(void* dst, void* src) = nullptr; // src is destroyed separately
+    void (*destroy)(void* p) = nullptr;
+};
+
+namespace detail {
+template<typename T>
+constexpr std::string_view typeSignature() {
+#if defined(_MSC_VER)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+constexpr uint64_t fnv1a(std::string_view s) {
+    uint64_t h = 1469598103934665603ull;
+    for (char c : s) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+} // namespace detail
+
+template<typename T>
+constexpr ComponentId componentId() {
+    return detail::fnv1a(detail::typeSignature<std::remove_cv_t<T>>());
+}
+
+// Components are plain values: default-constructible and nothrow-movable (chunks relocate
+// them when entities change archetype). Trivially copyable types take the memcpy path.
+template<typename T>
+const ComponentInfo& componentInfo() {
+    using U = std::remove_cv_t<T>;
+    static_assert(std::is_default_constructible_v<U>, "ECS components must be default-constructible");
+    static_assert(std::is_nothrow_move_constructible_v<U>, "ECS components must be nothrow move-constructible");
+    static_assert(alignof(U) <= 64, "ECS components may be aligned to at most 64 bytes");
+    static const ComponentInfo info{
+        componentId<U>(),
+        static_cast<uint32_t>(sizeof(U)),
+        static_cast<uint32_t>(alignof(U)),
+        detail::typeSignature<U>(),
+        std::is_trivially_copyable_v<U> && std::is_trivially_destructible_v<U>,
+        [](void* dst) { new (dst) U(); },
+        [](void* dst, void* src) { new (dst) U(std::move(*static_cast<U*>(src))); },
+        [](void* p) { static_cast<U*>(p)->~U(); },
+    };
+    return info;
+}
+
+} // namespace aurora::ecs
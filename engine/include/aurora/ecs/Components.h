@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "aurora/scene/TransformHierarchy.h"
+
+namespace aurora::ecs {
+
+// Built-in components the engine reads when building each frame's draws.
+
+// Placement in clip space until a camera exists (same convention as aurora::DrawCommand)
+struct Transform {
+    float position[3] = {0.0f, 0.0f, 0.0f};
+    float scale = 1.0f;
+};
+
+// Placement by a node of Engine::transforms(): the node's world matrix (parent chain included)
+// positions the entity's mesh. Takes precedence over Transform.
+struct SceneNode {
+    scene::Node node;
+};
+
+// Entities with a Transform or SceneNode and a MeshRenderer are drawn every frame
+struct MeshRenderer {
+    uint32_t mesh = 0;     // 0 = built-in triangle
+    uint32_t material = 0; // Engine::createMaterial id, 0 = aurora::kDefaultMaterial
+};
+
+} // namespace aurora::ecs
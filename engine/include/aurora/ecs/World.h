@@ -0,0 +1,320 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aurora/JobSystem.h"
+#include "aurora/ecs/Component.h"
+
+namespace aurora::ecs {
+
+class World;
+class CommandBuffer;
+template<typename... Cs> class Query;
+
+// Generational handle: a destroyed entity's index is reused with the next generation, so stale
+// handles fail World::alive instead of aliasing the new entity.
+struct Entity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+    bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+// All entities with exactly one set of component types. Storage is a list of 16 KB chunks,
+// each holding up to chunkCapacity() entities in SoA layout: the entity ids, then one
+// contiguous array per component. Entities are kept dense (every chunk full except the last),
+// so iterating a component touches memory strictly linearly.
+class Archetype {
+public:
+    static constexpr size_t kChunkBytes = 16 * 1024;
+
+    // Component ids in ascending order
+    const std::vector<ComponentId>& signature() const { return signature_; }
+    // Column of a component, or -1 if the archetype does not have it
+    int32_t columnIndex(ComponentId id) const;
+
+    size_t size() const { return count_; }
+    uint32_t chunkCapacity() const { return capacity_; }
+    uint32_t chunkCount() const { return static_cast<uint32_t>(chunks_.size()); }
+    uint32_t chunkSize(uint32_t chunk) const {
+        return chunk + 1 < chunks_.size() ? capacity_ : static_cast<uint32_t>(count_ - size_t(chunk) * capacity_);
+    }
+    Entity* entities(uint32_t chunk) const { return reinterpret_cast<Entity*>(chunks_[chunk]); }
+    void* column(uint32_t column, uint32_t chunk) const { return chunks_[chunk] + columns_[column].offset; }
+
+private:
+    friend class World;
+    struct Column {
+        const ComponentInfo* info = nullptr;
+        uint32_t offset = 0; // byte offset of the array inside a chunk
+    };
+
+    void* slot(uint32_t column, size_t row) const {
+        return chunks_[row / capacity_] + columns_[column].offset + (row % capacity_) * columns_[column].info->size;
+    }
+    Entity& entityAt(size_t row) const { return entities(static_cast<uint32_t>(row / capacity_))[row % capacity_]; }
+
+    std::vector<ComponentId> signature_;
+    std::vector<Column> columns_; // parallel to signature_
+    uint32_t capacity_ = 0;
+    std::vector<uint8_t*> chunks_;
+    size_t count_ = 0;
+    // Cached transitions for add/remove of one component
+    std::unordered_map<ComponentId, Archetype*> addEdges_;
+    std::unordered_map<ComponentId, Archetype*> removeEdges_;
+};
+
+// One chunk's worth of a query: count entities and one array per queried component, indexed
+// in parallel. index numbers the chunks of one iteration in order (stable until the next
+// structural change), e.g. to compute output offsets in a first pass.
+template<typename... Cs>
+struct ChunkView {
+    uint32_t index = 0;
+    uint32_t count = 0;
+    const Entity* entities = nullptr;
+    std::tuple<Cs*...> columns;
+
+    template<typename T>
+    T* column() const { return std::get<T*>(columns); }
+};
+
+// Entity/component storage. Structural changes (create, destroy, add, remove) move entities
+// between archetypes and are not allowed while a query iterates; record them into a
+// CommandBuffer and play it back afterwards. Not thread-safe except for parallel query
+// iteration, which may read and write component values.
+class World {
+public:
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    Entity create();
+    template<typename... Cs>
+    Entity create(Cs&&... components) {
+        std::tuple<std::decay_t<Cs>...> values(std::forward<Cs>(components)...);
+        std::array<const ComponentInfo*, sizeof...(Cs)> infos{&componentInfo<std::decay_t<Cs>>()...};
+        std::array<void*, sizeof...(Cs)> ptrs = std::apply([](auto&... v) { return std::array<void*, sizeof...(Cs)>{&v...}; }, values);
+        return createErased(infos.data(), ptrs.data(), sizeof...(Cs));
+    }
+    // Destroying a dead entity is a no-op
+    void destroy(Entity e);
+    bool alive(Entity e) const;
+
+    // Adds the component, or replaces its value if the entity already has it
+    template<typename T>
+    T& add(Entity e, T value = T{}) {
+        return *static_cast<T*>(addErased(e, componentInfo<T>(), &value));
+    }
+    template<typename T>
+    void remove(Entity e) { removeErased(e, componentId<T>()); }
+    // Null if the entity is dead or lacks the component. Valid until the next structural change.
+    template<typename T>
+    T* get(Entity e) { return static_cast<T*>(getErased(e, componentId<T>())); }
+    template<typename T>
+    const T* get(Entity e) const { return static_cast<const T*>(getErased(e, componentId<T>())); }
+    template<typename T>
+    bool has(Entity e) const { return getErased(e, componentId<T>()) != nullptr; }
+
+    // Entities having all of Cs (const Cs are read-only). Keep the query around: matching
+    // archetypes are cached and only archetypes created since the last use are checked.
+    template<typename... Cs>
+    Query<Cs...> query() { return Query<Cs...>(*this); }
+
+    // Applies and clears the buffer's commands in recording order. Commands on entities that
+    // died in the meantime are dropped.
+    void playback(CommandBuffer& commands);
+
+    size_t entityCount() const { return alive_; }
+    size_t archetypeCount() const { return archetypes_.size(); }
+    const Archetype& archetype(size_t i) const { return *archetypes_[i]; }
+
+private:
+    template<typename...> friend class Query;
+    friend class CommandBuffer;
+
+    struct Record {
+        Archetype* archetype = nullptr;
+        size_t row = 0;
+        uint32_t generation = 0;
+    };
+
+    // Queries hold one while iterating; structural changes check it
+    struct IterationScope {
+        explicit IterationScope(const World& w) : world(w) { world.iterating_.fetch_add(1, std::memory_order_relaxed); }
+        ~IterationScope() { world.iterating_.fetch_sub(1, std::memory_order_relaxed); }
+        const World& world;
+    };
+
+    // values[i] may be null (default-construct); others are moved from and left to the caller
+    Entity createErased(const ComponentInfo* const* infos, void* const* values, size_t count);
+    void* addErased(Entity e, const ComponentInfo& info, void* value);
+    void removeErased(Entity e, ComponentId id);
+    void* getErased(Entity e, ComponentId id) const;
+
+    Archetype* archetypeFor(std::vector<const ComponentInfo*> infos);
+    Archetype* withComponent(Archetype* from, const ComponentInfo& info);
+    Archetype* withoutComponent(Archetype* from, ComponentId id);
+    size_t pushRow(Archetype& a, Entity e);
+    void eraseRow(Archetype& a, size_t row);
+    void moveEntity(Entity e, Archetype* to);
+    void checkStructural() const;
+
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::map<std::vector<ComponentId>, Archetype*> archetypeIndex_;
+    Archetype* empty_ = nullptr;
+    std::vector<Record> records_;
+    std::vector<uint32_t> freeIndices_;
+    size_t alive_ = 0;
+    mutable std::atomic<uint32_t> iterating_{0};
+};
+
+template<typename... Cs>
+class Query {
+public:
+    explicit Query(World& world) : world_(&world) {}
+
+    // Also require that matching entities lack every Ex
+    template<typename... Ex>
+    Query& exclude() {
+        (excluded_.push_back(componentId<Ex>()), ...);
+        matches_.clear();
+        seen_ = 0;
+        return *this;
+    }
+
+    // fn(Cs&...) or fn(Entity, Cs&...) per entity, chunk by chunk
+    template<typename F>
+    void each(F&& fn) {
+        eachChunk([&](const ChunkView<Cs...>& v) {
+            for (uint32_t i = 0; i < v.count; ++i) {
+                if constexpr (std::is_invocable_v<F&, Entity, Cs&...>) {
+                    fn(v.entities[i], std::get<Cs*>(v.columns)[i]...);
+                } else {
+                    fn(std::get<Cs*>(v.columns)[i]...);
+                }
+            }
+        });
+    }
+
+    // fn(const ChunkView<Cs...>&): whole SoA arrays at a time (SIMD loops, bulk copies)
+    template<typename F>
+    void eachChunk(F&& fn) {
+        refresh();
+        World::IterationScope scope(*world_);
+        uint32_t index = 0;
+        for (const Match& m : matches_) {
+            for (uint32_t c = 0; c < m.archetype->chunkCount(); ++c) fn(view(m, c, index++));
+        }
+    }
+
+    // Chunks are distributed over the job system; fn runs concurrently for different chunks
+    // and returns once all are done. Record structural changes into one CommandBuffer per
+    // job thread (JobSystem::currentThreadIndex).
+    template<typename F>
+    void parallelEachChunk(JobSystem& jobs, F&& fn) {
+        refresh();
+        World::IterationScope scope(*world_);
+        chunks_.clear();
+        for (const Match& m : matches_) {
+            for (uint32_t c = 0; c < m.archetype->chunkCount(); ++c) chunks_.push_back({&m, c});
+        }
+        jobs.parallelFor(0, static_cast<uint32_t>(chunks_.size()), [&](uint32_t first, uint32_t last) {
+            for (uint32_t i = first; i < last; ++i) fn(view(*chunks_[i].match, chunks_[i].chunk, i));
+        });
+    }
+
+    template<typename F>
+    void parallelEach(JobSystem& jobs, F&& fn) {
+        parallelEachChunk(jobs, [&](const ChunkView<Cs...>& v) {
+            for (uint32_t i = 0; i < v.count; ++i) {
+                if constexpr (std::is_invocable_v<F&, Entity, Cs&...>) {
+                    fn(v.entities[i], std::get<Cs*>(v.columns)[i]...);
+                } else {
+                    fn(std::get<Cs*>(v.columns)[i]...);
+                }
+            }
+        });
+    }
+
+    size_t count() {
+        refresh();
+        size_t n = 0;
+        for (const Match& m : matches_) n += m.archetype->size();
+        return n;
+    }
+
+    uint32_t chunkCount() {
+        refresh();
+        uint32_t n = 0;
+        for (const Match& m : matches_) n += m.archetype->chunkCount();
+        return n;
+    }
+
+private:
+    struct Match {
+        Archetype* archetype = nullptr;
+        std::array<uint32_t, sizeof...(Cs)> columns{};
+    };
+    struct ChunkRef {
+        const Match* match;
+        uint32_t chunk;
+    };
+
+    // Check archetypes created since the last call; archetypes are never destroyed, so
+    // earlier matches stay valid
+    void refresh() {
+        const size_t total = world_->archetypeCount();
+        for (; seen_ < total; ++seen_) {
+            Archetype* a = world_->archetypes_[seen_].get();
+            Match m{a, {}};
+            bool ok = true;
+            size_t k = 0;
+            ((ok = ok && bindColumn(*a, componentId<Cs>(), m.columns[k++])), ...);
+            for (ComponentId ex : excluded_) ok = ok && a->columnIndex(ex) < 0;
+            if (ok) matches_.push_back(m);
+        }
+    }
+
+    static bool bindColumn(const Archetype& a, ComponentId id, uint32_t& column) {
+        int32_t c = a.columnIndex(id);
+        if (c < 0) return false;
+        column = static_cast<uint32_t>(c);
+        return true;
+    }
+
+    ChunkView<Cs...> view(const Match& m, uint32_t chunk, uint32_t index) const {
+        return viewImpl(m, chunk, index, std::index_sequence_for<Cs...>{});
+    }
+
+    template<size_t... I>
+    ChunkView<Cs...> viewImpl(const Match& m, uint32_t chunk, uint32_t index, std::index_sequence<I...>) const {
+        ChunkView<Cs...> v;
+        v.index = index;
+        v.count = m.archetype->chunkSize(chunk);
+        v.entities = m.archetype->entities(chunk);
+        v.columns = std::tuple<Cs*...>(static_cast<Cs*>(m.archetype->column(m.columns[I], chunk))...);
+        return v;
+    }
+
+    World* world_;
+    std::vector<ComponentId> excluded_;
+    std::vector<Match> matches_;
+    size_t seen_ = 0;
+    std::vector<ChunkRef> chunks_;
+};
+
+} // namespace aurora::ecs
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "aurora/math/Math.h"
+
+// Batch kernels over structure-of-arrays data (one array per component), the layout ECS
+// chunks store. The aurora::math versions use the compile-time SIMD backend (simd::kBackend),
+// processing simd::kWidth items per step with a scalar tail; aurora::math::scalar has the
+// reference versions. Inputs and outputs may be unaligned but must not overlap.
+namespace aurora::math {
+
+// Translation, rotation (unit quaternion) and scale streams for composeTrs
+struct TrsStreams {
+    const float* tx; const float* ty; const float* tz;
+    const float* qx; const float* qy; const float* qz; const float* qw;
+    const float* sx; const float* sy; const float* sz;
+};
+
+// out = m * (x, y, z, 1), w dropped (affine m)
+void transformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+                     float* outX, float* outY, float* outZ, size_t count);
+// out[i] = a[i] * b[i]
+void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+// out[i] = Mat4::trs(t[i], q[i], s[i])
+void composeTrs(const TrsStreams& in, Mat4* out, size_t count);
+// visible[i] = 1 if sphere i intersects the frustum, else 0. Returns the number visible.
+size_t testSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   uint8_t* visible, size_t count);
+// Writes firstIndex + i for every sphere i that intersects the frustum to visibleOut, in
+// order, and returns how many were written. visibleOut needs room for count indices.
+size_t cullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   uint32_t firstIndex, uint32_t* visibleOut, size_t count);
+
+namespace scalar {
+void transformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+                     float* outX, float* outY, float* outZ, size_t count);
+void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+void composeTrs(const TrsStreams& in, Mat4* out, size_t count);
+size_t testSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   uint8_t* visible, size_t count);
+size_t cullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   uint32_t firstIndex, uint32_t* visibleOut, size_t count);
+} // namespace scalar
+
+} // namespace aurora::math
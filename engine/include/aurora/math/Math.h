@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cmath>
+
+#include "aurora/math/Simd.h"
+
+// Vectors, quaternions and 4x4 matrices. Conventions: right-handed view space looking down -Z,
+// column vectors (p' = M * p), column-major storage, Vulkan clip space (depth 0..1, Y down).
+namespace aurora::math {
+
+inline constexpr float kPi = 3.14159265358979323846f;
+constexpr float radians(float degrees) { return degrees * (kPi / 180.0f); }
+
+struct Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+
+    constexpr Vec3() = default;
+    constexpr Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+    constexpr explicit Vec3(float s) : x(s), y(s), z(s) {}
+
+    Vec3& operator+=(const Vec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    Vec3& operator-=(const Vec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+};
+
+constexpr Vec3 operator+(const Vec3& a, const Vec3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+constexpr Vec3 operator-(const Vec3& a, const Vec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+constexpr Vec3 operator-(const Vec3& a) { return {-a.x, -a.y, -a.z}; }
+constexpr Vec3 operator*(const Vec3& a, const Vec3& b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+constexpr Vec3 operator*(const Vec3& a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+constexpr Vec3 operator*(float s, const Vec3& a) { return a * s; }
+constexpr Vec3 operator/(const Vec3& a, float s) { return {a.x / s, a.y / s, a.z / s}; }
+
+constexpr float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+constexpr Vec3 cross(const Vec3& a, const Vec3& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+inline float length(const Vec3& a) { return std::sqrt(dot(a, a)); }
+// Zero vector stays zero
+inline Vec3 normalize(const Vec3& a) {
+    float len = length(a);
+    return len > 0.0f ? a / len : Vec3{};
+}
+constexpr Vec3 lerp(const Vec3& a, const Vec3& b, float t) { return a + (b - a) * t; }
+constexpr Vec3 min(const Vec3& a, const Vec3& b) {
+    return {a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z};
+}
+constexpr Vec3 max(const Vec3& a, const Vec3& b) {
+    return {a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z};
+}
+
+struct alignas(16) Vec4 {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+
+    constexpr Vec4() = default;
+    constexpr Vec4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+    constexpr Vec4(const Vec3& v, float w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+
+    constexpr Vec3 xyz() const { return {x, y, z}; }
+    float& operator[](int i) { return (&x)[i]; }
+    const float& operator[](int i) const { return (&x)[i]; }
+};
+
+constexpr Vec4 operator+(const Vec4& a, const Vec4& b) { return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+constexpr Vec4 operator-(const Vec4& a, const Vec4& b) { return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+constexpr Vec4 operator*(const Vec4& a, float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+constexpr float dot(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+// Unit quaternion rotation; q * r applies r first
+struct Quat {
+    float x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f;
+
+    constexpr Quat() = default;
+    constexpr Quat(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+    static Quat fromAxisAngle(const Vec3& axis, float radians) {
+        Vec3 a = normalize(axis) * std::sin(radians * 0.5f);
+        return {a.x, a.y, a.z, std::cos(radians * 0.5f)};
+    }
+};
+
+constexpr Quat operator*(const Quat& a, const Quat& b) {
+    return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+constexpr Quat conjugate(const Quat& q) { return {-q.x, -q.y, -q.z, q.w}; }
+inline Quat normalize(const Quat& q) {
+    float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return len > 0.0f ? Quat{q.x / len, q.y / len, q.z / len, q.w / len} : Quat{};
+}
+constexpr Vec3 rotate(const Quat& q, const Vec3& v) {
+    // v + 2w(u x v) + 2u x (u x v), u = q.xyz
+    Vec3 u{q.x, q.y, q.z};
+    Vec3 t = cross(u, v) * 2.0f;
+    return v + t * q.w + cross(u, t);
+}
+// Shortest-path spherical interpolation
+Quat slerp(const Quat& a, const Quat& b, float t);
+
+struct alignas(16) Mat4 {
+    Vec4 cols[4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+
+    static constexpr Mat4 identity() { return {}; }
+    static Mat4 translation(const Vec3& t);
+    static Mat4 scale(const Vec3& s);
+    static Mat4 rotation(const Quat& q);
+    // translation * rotation * scale in one step
+    static Mat4 trs(const Vec3& t, const Quat& r, const Vec3& s);
+    // fovY in radians; maps view depth [-zNear, -zFar] to [0, 1] and flips Y for Vulkan
+    static Mat4 perspective(float fovY, float aspect, float zNear, float zFar);
+    static Mat4 orthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+    static Mat4 lookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+
+    Vec4& operator[](int col) { return cols[col]; }
+    const Vec4& operator[](int col) const { return cols[col]; }
+    float at(int row, int col) const { return cols[col][row]; }
+};
+
+Mat4 transpose(const Mat4& m);
+// General inverse (cofactors); a singular matrix returns identity
+Mat4 inverse(const Mat4& m);
+
+// Reference implementations, also the scalar backend
+namespace scalar {
+inline Vec4 transform(const Mat4& m, const Vec4& v) {
+    return {m.cols[0].x * v.x + m.cols[1].x * v.y + m.cols[2].x * v.z + m.cols[3].x * v.w,
+            m.cols[0].y * v.x + m.cols[1].y * v.y + m.cols[2].y * v.z + m.cols[3].y * v.w,
+            m.cols[0].z * v.x + m.cols[1].z * v.y + m.cols[2].z * v.z + m.cols[3].z * v.w,
+            m.cols[0].w * v.x + m.cols[1].w * v.y + m.cols[2].w * v.z + m.cols[3].w * v.w};
+}
+inline Mat4 multiply(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+    for (int c = 0; c < 4; ++c) r.cols[c] = transform(a, b.cols[c]);
+    return r;
+}
+} // namespace scalar
+
+// One column of a * b is a's columns weighted by b's column: four broadcasts, four multiply-adds
+#if defined(AURORA_SIMD_X86)
+namespace detail {
+inline __m128 madd4(__m128 a, __m128 b, __m128 c) {
+#if defined(AURORA_SIMD_BACKEND_AVX2)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+inline __m128 transform4(const Mat4& m, __m128 v) {
+    __m128 r = _mm_mul_ps(_mm_load_ps(&m.cols[0].x), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+    r = madd4(_mm_load_ps(&m.cols[1].x), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+    r = madd4(_mm_load_ps(&m.cols[2].x), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+    return madd4(_mm_load_ps(&m.cols[3].x), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+}
+} // namespace detail
+
+inline Vec4 operator*(const Mat4& m, const Vec4& v) {
+    Vec4 r;
+    _mm_store_ps(&r.x, detail::transform4(m, _mm_load_ps(&v.x)));
+    return r;
+}
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+    for (int c = 0; c < 4; ++c) _mm_store_ps(&r.cols[c].x, detail::transform4(a, _mm_load_ps(&b.cols[c].x)));
+    return r;
+}
+#elif defined(AURORA_SIMD_BACKEND_NEON)
+namespace detail {
+inline float32x4_t transform4(const Mat4& m, float32x4_t v) {
+    float32x4_t r = vmulq_n_f32(vld1q_f32(&m.cols[0].x), vgetq_lane_f32(v, 0));
+    r = vmlaq_n_f32(r, vld1q_f32(&m.cols[1].x), vgetq_lane_f32(v, 1));
+    r = vmlaq_n_f32(r, vld1q_f32(&m.cols[2].x), vgetq_lane_f32(v, 2));
+    return vmlaq_n_f32(r, vld1q_f32(&m.cols[3].x), vgetq_lane_f32(v, 3));
+}
+} // namespace detail
+
+inline Vec4 operator*(const Mat4& m, const Vec4& v) {
+    Vec4 r;
+    vst1q_f32(&r.x, detail::transform4(m, vld1q_f32(&v.x)));
+    return r;
+}
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+    for (int c = 0; c < 4; ++c) vst1q_f32(&r.cols[c].x, detail::transform4(a, vld1q_f32(&b.cols[c].x)));
+    return r;
+}
+#else
+inline Vec4 operator*(const Mat4& m, const Vec4& v) { return scalar::transform(m, v); }
+inline Mat4 operator*(const Mat4& a, const Mat4& b) { return scalar::multiply(a, b); }
+#endif
+
+inline Vec3 transformPoint(const Mat4& m, const Vec3& p) { return (m * Vec4(p, 1.0f)).xyz(); }
+inline Vec3 transformVector(const Mat4& m, const Vec3& v) { return (m * Vec4(v, 0.0f)).xyz(); }
+
+// Points p with dot(normal, p) + d >= 0 are on the inside
+struct Plane {
+    Vec3 normal;
+    float d = 0.0f;
+
+    constexpr float distance(const Vec3& p) const { return dot(normal, p) + d; }
+};
+
+// Six inward-facing, normalized planes of a view-projection matrix
+struct Frustum {
+    enum Side { Left, Right, Bottom, Top, Near, Far, kCount };
+    Plane planes[kCount];
+
+    static Frustum fromMatrix(const Mat4& viewProj);
+    bool intersectsSphere(const Vec3& center, float radius) const {
+        for (const Plane& p : planes) {
+            if (p.distance(center) < -radius) return false;
+        }
+        return true;
+    }
+};
+
+} // namespace aurora::math
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+
+// Compile-time SIMD backend. CMake's AURORA_SIMD option (SSE4 / AVX2 / NATIVE / SCALAR) sets the
+// compiler flags; the widest instruction set they enable is used. Define AURORA_SIMD_SCALAR to
+// force the scalar path (reference results, debugging).
+#if defined(AURORA_SIMD_SCALAR)
+#define AURORA_SIMD_BACKEND_SCALAR 1
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define AURORA_SIMD_BACKEND_AVX2 1
+#define AURORA_SIMD_X86 1
+#elif defined(__SSE4_1__) || defined(AURORA_SIMD_SSE4)
+#define AURORA_SIMD_BACKEND_SSE4 1
+#define AURORA_SIMD_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define AURORA_SIMD_BACKEND_NEON 1
+#else
+#define AURORA_SIMD_BACKEND_SCALAR 1
+#endif
+
+#if defined(AURORA_SIMD_X86)
+#include <immintrin.h>
+#elif defined(AURORA_SIMD_BACKEND_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace aurora::simd {
+
+#if defined(AURORA_SIMD_BACKEND_AVX2)
+inline constexpr const char* kBackend = "avx2";
+#elif defined(AURORA_SIMD_BACKEND_SSE4)
+inline constexpr const char* kBackend = "sse4";
+#elif defined(AURORA_SIMD_BACKEND_NEON)
+inline constexpr const char* kBackend = "neon";
+#else
+inline constexpr const char* kBackend = "scalar";
+#endif
+
+// Float: kWidth float lanes in the backend's widest register. Mask: per-lane comparison
+// results. Loads and stores are unaligned. The scalar backend emulates 4 lanes so the same
+// kernels compile everywhere.
+#if defined(AURORA_SIMD_BACKEND_AVX2)
+
+inline constexpr int kWidth = 8;
+struct Float { __m256 v; };
+struct Mask { __m256 v; };
+
+inline Float load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, Float a) { _mm256_storeu_ps(p, a.v); }
+inline Float set1(float s) { return {_mm256_set1_ps(s)}; }
+inline Float operator+(Float a, Float b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Float madd(Float a, Float b, Float c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; } // a * b + c
+inline Float min(Float a, Float b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline Float max(Float a, Float b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline Mask operator>=(Float a, Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline Mask operator<(Float a, Float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline Mask operator&(Mask a, Mask b) { return {_mm256_and_ps(a.v, b.v)}; }
+inline Mask operator|(Mask a, Mask b) { return {_mm256_or_ps(a.v, b.v)}; }
+inline Mask allTrue() { return {_mm256_castsi256_ps(_mm256_set1_epi32(-1))}; }
+// Bit i set = lane i true
+inline uint32_t bits(Mask m) { return static_cast<uint32_t>(_mm256_movemask_ps(m.v)); }
+
+#elif defined(AURORA_SIMD_BACKEND_SSE4)
+
+inline constexpr int kWidth = 4;
+struct Float { __m128 v; };
+struct Mask { __m128 v; };
+
+inline Float load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, Float a) { _mm_storeu_ps(p, a.v); }
+inline Float set1(float s) { return {_mm_set1_ps(s)}; }
+inline Float operator+(Float a, Float b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float madd(Float a, Float b, Float c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+inline Float min(Float a, Float b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Float max(Float a, Float b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Mask operator>=(Float a, Float b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+inline Mask operator<(Float a, Float b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline Mask operator&(Mask a, Mask b) { return {_mm_and_ps(a.v, b.v)}; }
+inline Mask operator|(Mask a, Mask b) { return {_mm_or_ps(a.v, b.v)}; }
+inline Mask allTrue() { return {_mm_castsi128_ps(_mm_set1_epi32(-1))}; }
+inline uint32_t bits(Mask m) { return static_cast<uint32_t>(_mm_movemask_ps(m.v)); }
+
+#elif defined(AURORA_SIMD_BACKEND_NEON)
+
+inline constexpr int kWidth = 4;
+struct Float { float32x4_t v; };
+struct Mask { uint32x4_t v; };
+
+inline Float load(const float* p) { return {vld1q_f32(p)}; }
+inline void store(float* p, Float a) { vst1q_f32(p, a.v); }
+inline Float set1(float s) { return {vdupq_n_f32(s)}; }
+inline Float operator+(Float a, Float b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float operator-(Float a, Float b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float operator*(Float a, Float b) { return {vmulq_f32(a.v, b.v)}; }
+#if defined(__aarch64__) || defined(_M_ARM64)
+inline Float madd(Float a, Float b, Float c) { return {vfmaq_f32(c.v, a.v, b.v)}; }
+#else
+inline Float madd(Float a, Float b, Float c) { return {vmlaq_f32(c.v, a.v, b.v)}; }
+#endif
+inline Float min(Float a, Float b) { return {vminq_f32(a.v, b.v)}; }
+inline Float max(Float a, Float b) { return {vmaxq_f32(a.v, b.v)}; }
+inline Mask operator>=(Float a, Float b) { return {vcgeq_f32(a.v, b.v)}; }
+inline Mask operator<(Float a, Float b) { return {vcltq_f32(a.v, b.v)}; }
+inline Mask operator&(Mask a, Mask b) { return {vandq_u32(a.v, b.v)}; }
+inline Mask operator|(Mask a, Mask b) { return {vorrq_u32(a.v, b.v)}; }
+inline Mask allTrue() { return {vdupq_n_u32(0xFFFFFFFFu)}; }
+inline uint32_t bits(Mask m) {
+    return (vgetq_lane_u32(m.v, 0) & 1u) | (vgetq_lane_u32(m.v, 1) & 2u) | (vgetq_lane_u32(m.v, 2) & 4u) |
+           (vgetq_lane_u32(m.v, 3) & 8u);
+}
+
+#else
+
+inline constexpr int kWidth = 4;
+struct Float { float v[4]; };
+struct Mask { bool v[4]; };
+
+inline Float load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, Float a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+inline Float set1(float s) { return {{s, s, s, s}}; }
+#define AURORA_SIMD_LANEWISE(expr) Float r; for (int i = 0; i < 4; ++i) r.v[i] = (expr); return r
+inline Float operator+(Float a, Float b) { AURORA_SIMD_LANEWISE(a.v[i] + b.v[i]); }
+inline Float operator-(Float a, Float b) { AURORA_SIMD_LANEWISE(a.v[i] - b.v[i]); }
+inline Float operator*(Float a, Float b) { AURORA_SIMD_LANEWISE(a.v[i] * b.v[i]); }
+inline Float madd(Float a, Float b, Float c) { AURORA_SIMD_LANEWISE(a.v[i] * b.v[i] + c.v[i]); }
+inline Float min(Float a, Float b) { AURORA_SIMD_LANEWISE(a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+inline Float max(Float a, Float b) { AURORA_SIMD_LANEWISE(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+#undef AURORA_SIMD_LANEWISE
+inline Mask operator>=(Float a, Float b) { return {{a.v[0] >= b.v[0], a.v[1] >= b.v[1], a.v[2] >= b.v[2], a.v[3] >= b.v[3]}}; }
+inline Mask operator<(Float a, Float b) { return {{a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]}}; }
+inline Mask operator&(Mask a, Mask b) { return {{a.v[0] && b.v[0], a.v[1] && b.v[1], a.v[2] && b.v[2], a.v[3] && b.v[3]}}; }
+inline Mask operator|(Mask a, Mask b) { return {{a.v[0] || b.v[0], a.v[1] || b.v[1], a.v[2] || b.v[2], a.v[3] || b.v[3]}}; }
+inline Mask allTrue() { return {{true, true, true, true}}; }
+inline uint32_t bits(Mask m) {
+    return uint32_t(m.v[0]) | uint32_t(m.v[1]) << 1 | uint32_t(m.v[2]) << 2 | uint32_t(m.v[3]) << 3;
+}
+
+#endif
+
+} // namespace aurora::simd
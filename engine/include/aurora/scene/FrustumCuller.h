@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "aurora/math/Math.h"
+
+namespace aurora {
+class JobSystem;
+}
+
+namespace aurora::scene {
+
+// Bounding spheres of candidate draws in structure-of-arrays form (one array per component),
+// tested against the six planes of a frustum simd::kWidth spheres per step (8 with AVX2, see
+// math::cullSpheres). cull() splits the spheres into fixed blocks that run in parallel, each
+// writing the indices of its visible spheres to its own part of the output, then packs the
+// parts together: visible() lists the visible spheres in ascending index order, ready to pick
+// the draws to submit.
+//
+// Fill with resize() + the component arrays (or set()), then cull(); one thread at a time.
+class FrustumCuller {
+public:
+    struct Stats {
+        uint32_t tested = 0;
+        uint32_t visible = 0;
+        double ms = 0.0; // wall time of the last cull()
+    };
+
+    // Contents are unspecified after a resize; write every sphere before culling
+    void resize(size_t count);
+    size_t size() const { return radius_.size(); }
+
+    float* centerX() { return x_.data(); }
+    float* centerY() { return y_.data(); }
+    float* centerZ() { return z_.data(); }
+    float* radius() { return radius_.data(); }
+    void set(size_t i, const math::Vec3& center, float radius) {
+        x_[i] = center.x;
+        y_[i] = center.y;
+        z_[i] = center.z;
+        radius_[i] = radius;
+    }
+
+    // jobs may be null (single-threaded). Returns visible().
+    const std::vector<uint32_t>& cull(const math::Frustum& frustum, JobSystem* jobs);
+    const std::vector<uint32_t>& visible() const { return visible_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    std::vector<float> x_, y_, z_, radius_;
+    std::vector<uint32_t> visible_;
+    std::vector<uint32_t> blockVisible_; // visible count per block
+    Stats stats_;
+};
+
+} // namespace aurora::scene
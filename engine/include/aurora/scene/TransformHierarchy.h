@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "aurora/math/Math.h"
+
+namespace aurora {
+class JobSystem;
+}
+
+namespace aurora::scene {
+
+// Generational handle of a hierarchy node (same scheme as ecs::Entity). index is stable for the
+// node's lifetime and doubles as its object id on the GPU (DrawCommand::object).
+struct Node {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+    bool operator==(const Node& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Node& o) const { return !(*this == o); }
+};
+
+// Transform relative to the parent node (or to the world for roots)
+struct LocalTransform {
+    math::Vec3 position;
+    math::Quat rotation;
+    math::Vec3 scale{1.0f};
+};
+
+// Parent/child transforms with incremental local-to-world updates. Node data lives in flat
+// arrays sorted by depth (all roots, then all depth-1 nodes, ...), each node storing its
+// parent's array position, so one pass per level computes world = parent world * local with
+// the parent already final. Setting a local transform only flags that node; update() skips
+// levels above the shallowest flagged node, and below it recomputes exactly the flagged nodes
+// and the descendants of recomputed ones, the nodes of a level in parallel. Structural changes
+// (create, destroy, setParent) re-sort the arrays on the next update.
+//
+// Not thread-safe: mutate and update from one thread (the game thread).
+class TransformHierarchy {
+public:
+    // Per update(): what was touched, for profiling and the bench
+    struct UpdateStats {
+        uint32_t dirtyNodes = 0;    // nodes flagged by setters or structural changes
+        uint32_t recomputed = 0;    // world matrices rewritten (dirty nodes + their subtrees)
+        uint32_t levelsVisited = 0; // depth levels scanned; the rest were skipped
+        bool resorted = false;      // structural changes re-sorted the arrays
+    };
+
+    TransformHierarchy() = default;
+    TransformHierarchy(const TransformHierarchy&) = delete;
+    TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+    // parent may be invalid (new root). Throws if parent is a dead node.
+    Node create(const LocalTransform& local = {}, Node parent = {});
+    // Destroys the node and all its descendants
+    void destroy(Node node);
+    bool alive(Node node) const;
+
+    // Moves node (with its subtree) under parent, or makes it a root when parent is invalid.
+    // The local transform is kept, so the world transform changes. Throws on cycles.
+    void setParent(Node node, Node parent);
+    Node parent(Node node) const;
+
+    const LocalTransform& local(Node node) const;
+    void setLocal(Node node, const LocalTransform& local);
+    void setPosition(Node node, const math::Vec3& position);
+    void setRotation(Node node, const math::Quat& rotation);
+    void setScale(Node node, const math::Vec3& scale);
+
+    // Local-to-world matrix as of the last update(); node must be alive
+    const math::Mat4& world(Node node) const { return world_[slotOf_[node.index]]; }
+
+    // Brings every world matrix up to date. jobs = null runs on the calling thread.
+    void update(JobSystem* jobs = nullptr);
+    // Nodes whose world matrix was rewritten by the last update(), in no particular order;
+    // this is what has to be sent to the GPU
+    const std::vector<Node>& changed() const { return changed_; }
+    const UpdateStats& lastUpdateStats() const { return stats_; }
+
+    size_t size() const { return liveCount_; }
+    // One past the highest node index in use: the object capacity a GPU buffer needs
+    uint32_t indexCapacity() const { return static_cast<uint32_t>(generation_.size()); }
+    // Number of depth levels (as of the last update)
+    uint32_t depthCount() const { return levelStart_.empty() ? 0 : static_cast<uint32_t>(levelStart_.size() - 1); }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    uint32_t slotOf(Node node, const char* what) const;
+    void markDirty(uint32_t slot);
+    void link(uint32_t index, uint32_t parentIndex);
+    void unlink(uint32_t index);
+    void resort();
+    void updateLevel(uint32_t begin, uint32_t end, std::vector<Node>& changed);
+
+    // Per node index (stable): generation, tree links, array position
+    std::vector<uint32_t> generation_;
+    std::vector<uint32_t> parentOf_;
+    std::vector<uint32_t> firstChild_;
+    std::vector<uint32_t> nextSibling_;
+    std::vector<uint32_t> prevSibling_;
+    std::vector<uint32_t> slotOf_;
+    std::vector<uint32_t> freeIndices_;
+    uint32_t firstRoot_ = kNone; // roots form one sibling list
+
+    // Per array position, sorted by depth once resorted: the data update() streams through
+    std::vector<uint32_t> nodeAt_;     // node index, kNone for destroyed nodes awaiting resort
+    std::vector<uint32_t> parentSlot_; // kNone for roots
+    std::vector<LocalTransform> local_;
+    std::vector<math::Mat4> world_;
+    std::vector<uint8_t> dirty_;       // 1 = world needs recomputing (set by setters, and by
+                                       // update() for recomputed nodes so children follow)
+    std::vector<uint32_t> levelStart_; // level d occupies [levelStart_[d], levelStart_[d + 1])
+
+    std::vector<Node> dirtyNodes_;     // flagged since the last update; validated by generation
+    bool layoutDirty_ = false;
+    size_t liveCount_ = 0;
+
+    std::vector<Node> changed_;
+    std::vector<std::vector<Node>> changedPerThread_;
+    UpdateStats stats_;
+};
+
+} // namespace aurora::scene
@@ -0,0 +1,390 @@
+#include "aurora/Assets.h"
+#include "aurora/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "io/FileSystem.h"
+
+namespace aurora {
+
+namespace detail {
+struct AssetRecord {
+    AssetRecord(std::string p, std::type_index t) : path(std::move(p)), type(t) {}
+
+    const std::string path;
+    const std::type_index type;
+    std::atomic<AssetState> state{AssetState::Queued};
+    std::atomic<float> priority{0.0f};
+    std::shared_ptr<const void> placeholder;
+    std::weak_ptr<AssetStreamer::Impl> owner;
+
+    // Game thread only: set when pump publishes the asset
+    std::shared_ptr<const void> payload;
+
+    // Guarded by Impl::mutex
+    io::FileData bytes;                   // between the I/O and decode stages
+    std::shared_ptr<const void> decoded;  // between the decode stage and pump
+    bool failed = false;
+    bool decodeClaimed = false;
+    bool published = false;
+    std::vector<std::function<void(const std::shared_ptr<AssetRecord>&)>> callbacks;
+};
+}
+
+using detail::AssetRecord;
+
+namespace {
+// Queues are max-heaps with lazy re-prioritization: setPriority pushes a fresh entry and
+// entries whose priority no longer matches the record are skipped when popped.
+template<typename Ref>
+struct QueueEntry {
+    float priority = 0.0f;
+    uint64_t seq = 0; // FIFO among equal priorities
+    Ref record;
+};
+
+template<typename Ref>
+struct QueueOrder {
+    bool operator()(const QueueEntry<Ref>& a, const QueueEntry<Ref>& b) const {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.seq > b.seq;
+    }
+};
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+struct AssetStreamer::Impl {
+    struct TypeInfo {
+        ErasedDecoder decoder;
+        std::shared_ptr<const void> placeholder;
+    };
+
+    explicit Impl(io::FileSystem& fs) : files(fs) {}
+
+    io::FileSystem& files;
+
+    mutable std::mutex mutex;
+    std::condition_variable ioCv;
+    std::condition_variable decodeCv;
+    std::condition_variable idleCv;
+    bool stopping = false;
+
+    std::unordered_map<std::type_index, TypeInfo> types;
+    std::unordered_map<std::string, std::weak_ptr<AssetRecord>> records;
+    // Entries of released assets are swept when records grows to this, then it is set to
+    // twice what survived, so a load costs amortized O(1) however many paths come and go
+    size_t recordsPruneAt = kMinRecordsPruneAt;
+    static constexpr size_t kMinRecordsPruneAt = 64;
+    // Queued assets are only weakly referenced so releasing every handle cancels the load;
+    // once reading has started the asset is carried through to pump
+    std::vector<QueueEntry<std::weak_ptr<AssetRecord>>> ioQueue;
+    std::vector<QueueEntry<std::shared_ptr<AssetRecord>>> decodeQueue;
+    std::deque<std::shared_ptr<AssetRecord>> completed;
+    uint64_t nextSeq = 0;
+    uint32_t inFlight = 0;
+
+    uint64_t bytesRead = 0;
+    double ioMs = 0.0;
+    double decodeMs = 0.0;
+
+    std::vector<std::thread> threads;
+
+    // mutex held
+    void pruneRecords() {
+        std::erase_if(records, [](const auto& entry) { return entry.second.expired(); });
+        recordsPruneAt = std::max(kMinRecordsPruneAt, records.size() * 2);
+    }
+
+    void pushIo(const std::shared_ptr<AssetRecord>& r) {
+        ioQueue.push_back({r->priority.load(std::memory_order_relaxed), nextSeq++, r});
+        std::push_heap(ioQueue.begin(), ioQueue.end(), QueueOrder<std::weak_ptr<AssetRecord>>{});
+        ioCv.notify_one();
+    }
+
+    void pushDecode(const std::shared_ptr<AssetRecord>& r) {
+        decodeQueue.push_back({r->priority.load(std::memory_order_relaxed), nextSeq++, r});
+        std::push_heap(decodeQueue.begin(), decodeQueue.end(), QueueOrder<std::shared_ptr<AssetRecord>>{});
+        decodeCv.notify_one();
+    }
+
+    // Caller holds mutex. Null when only stale entries were left.
+    std::shared_ptr<AssetRecord> popIo() {
+        while (!ioQueue.empty()) {
+            std::pop_heap(ioQueue.begin(), ioQueue.end(), QueueOrder<std::weak_ptr<AssetRecord>>{});
+            auto entry = std::move(ioQueue.back());
+            ioQueue.pop_back();
+            std::shared_ptr<AssetRecord> r = entry.record.lock();
+            if (!r || r->state.load() != AssetState::Queued || r->priority.load() != entry.priority) continue;
+            r->state = AssetState::Loading;
+            ++inFlight;
+            return r;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<AssetRecord> popDecode() {
+        while (!decodeQueue.empty()) {
+            std::pop_heap(decodeQueue.begin(), decodeQueue.end(), QueueOrder<std::shared_ptr<AssetRecord>>{});
+            auto entry = std::move(decodeQueue.back());
+            decodeQueue.pop_back();
+            const std::shared_ptr<AssetRecord>& r = entry.record;
+            if (r->decodeClaimed || r->priority.load() != entry.priority) continue;
+            r->decodeClaimed = true;
+            return r;
+        }
+        return nullptr;
+    }
+
+    // Caller holds mutex
+    void finish(const std::shared_ptr<AssetRecord>& r, bool failed) {
+        r->failed = failed;
+        r->bytes = {};
+        r->state = AssetState::Ready;
+        completed.push_back(r);
+        --inFlight;
+        idleCv.notify_all();
+    }
+
+    void ioMain() {
+        for (;;) {
+            std::shared_ptr<AssetRecord> r;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ioCv.wait(lock, [this] { return stopping || !ioQueue.empty(); });
+                if (stopping) return;
+                r = popIo();
+                if (!r) {
+                    idleCv.notify_all(); // stale entries drained
+                    continue;
+                }
+            }
+            AURORA_PROFILE_ZONE("AssetStreamer::read");
+            auto start = std::chrono::steady_clock::now();
+            io::FileData data;
+            bool ok = true;
+            try {
+                data = files.read(r->path);
+            } catch (const std::exception& e) {
+                std::cerr << "AssetStreamer: " << e.what() << std::endl;
+                ok = false;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ioMs += msSince(start);
+            if (!ok) {
+                finish(r, true);
+            } else {
+                bytesRead += data.size();
+                r->bytes = std::move(data);
+                r->state = AssetState::Decoding;
+                pushDecode(r);
+            }
+            // Drop this thread's reference before unlocking, so a waiter woken by finish (or
+            // by the decode stage) finds only the handles' references on released assets
+            r.reset();
+        }
+    }
+
+    void decodeMain() {
+        for (;;) {
+            std::shared_ptr<AssetRecord> r;
+            ErasedDecoder decoder;
+            io::FileData data;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                decodeCv.wait(lock, [this] { return stopping || !decodeQueue.empty(); });
+                if (stopping) return;
+                r = popDecode();
+                if (!r) continue;
+                decoder = types.at(r->type).decoder;
+                data = r->bytes;
+            }
+            AURORA_PROFILE_ZONE("AssetStreamer::decode");
+            auto start = std::chrono::steady_clock::now();
+            std::shared_ptr<const void> result;
+            bool ok = true;
+            try {
+                result = decoder(data.data(), data.size());
+                ok = result != nullptr;
+                if (!ok) std::cerr << "AssetStreamer: decoder returned nothing for " << r->path << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "AssetStreamer: decoding " << r->path << " failed: " << e.what() << std::endl;
+                ok = false;
+            }
+            data = {};
+            std::lock_guard<std::mutex> lock(mutex);
+            decodeMs += msSince(start);
+            r->decoded = std::move(result);
+            finish(r, !ok);
+            r.reset();
+        }
+    }
+};
+
+AssetState AssetHandleBase::state() const {
+    return record_ ? record_->state.load(std::memory_order_acquire) : AssetState::Failed;
+}
+
+const std::string& AssetHandleBase::path() const {
+    static const std::string empty;
+    return record_ ? record_->path : empty;
+}
+
+float AssetHandleBase::priority() const {
+    return record_ ? record_->priority.load(std::memory_order_relaxed) : 0.0f;
+}
+
+void AssetHandleBase::setPriority(float priority) {
+    if (!record_) return;
+    std::shared_ptr<AssetStreamer::Impl> impl = record_->owner.lock();
+    if (!impl) return;
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    if (record_->priority.load() == priority) return;
+    record_->priority = priority;
+    AssetState s = record_->state.load();
+    if (s == AssetState::Queued) impl->pushIo(record_);
+    else if (s == AssetState::Decoding && !record_->decodeClaimed) impl->pushDecode(record_);
+}
+
+const void* AssetHandleBase::resolve() const {
+    if (!record_) return nullptr;
+    return record_->payload ? record_->payload.get() : record_->placeholder.get();
+}
+
+AssetStreamer::AssetStreamer(io::FileSystem& files, uint32_t ioThreads, uint32_t decodeThreads)
+    : impl_(std::make_shared<Impl>(files)) {
+    registerType<AssetBlob>([](const uint8_t* data, size_t size) {
+        auto blob = std::make_shared<AssetBlob>();
+        blob->bytes.assign(data, data + size);
+        return blob;
+    }, std::make_shared<const AssetBlob>());
+
+    Impl* impl = impl_.get();
+    for (uint32_t i = 0; i < std::max(ioThreads, 1u); ++i) impl->threads.emplace_back([impl] { impl->ioMain(); });
+    for (uint32_t i = 0; i < std::max(decodeThreads, 1u); ++i) impl->threads.emplace_back([impl] { impl->decodeMain(); });
+}
+
+AssetStreamer::~AssetStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->stopping = true;
+    }
+    impl_->ioCv.notify_all();
+    impl_->decodeCv.notify_all();
+    for (auto& t : impl_->threads) t.join();
+    // Unfinished assets keep resolving to their placeholder; queued work is dropped
+    impl_->decodeQueue.clear();
+    impl_->completed.clear();
+}
+
+void AssetStreamer::registerTypeErased(std::type_index type, ErasedDecoder decoder, std::shared_ptr<const void> placeholder) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->types[type] = Impl::TypeInfo{std::move(decoder), std::move(placeholder)};
+}
+
+std::shared_ptr<AssetRecord> AssetStreamer::loadErased(const std::string& path, std::type_index type, float priority,
+                                                       std::function<void(const std::shared_ptr<AssetRecord>&)> onReady) {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    auto typeIt = impl_->types.find(type);
+    if (typeIt == impl_->types.end()) {
+        throw std::runtime_error("AssetStreamer: no decoder registered for the type requested for " + path);
+    }
+
+    std::shared_ptr<AssetRecord> r = impl_->records[path].lock();
+    if (r) {
+        if (r->type != type) throw std::runtime_error("AssetStreamer: " + path + " is already loaded as another type");
+        if (onReady) {
+            r->callbacks.push_back(std::move(onReady));
+            // Already delivered: run the new callback at the next pump
+            if (r->published) impl_->completed.push_back(r);
+        }
+        lock.unlock();
+        if (priority > r->priority.load()) AssetHandleBase(r).setPriority(priority);
+        return r;
+    }
+
+    r = std::make_shared<AssetRecord>(path, type);
+    r->priority = priority;
+    r->placeholder = typeIt->second.placeholder;
+    r->owner = impl_;
+    if (onReady) r->callbacks.push_back(std::move(onReady));
+    impl_->records[path] = r;
+    if (impl_->records.size() >= impl_->recordsPruneAt) impl_->pruneRecords();
+    impl_->pushIo(r);
+    return r;
+}
+
+void AssetStreamer::pump(double budgetMs) {
+    AURORA_PROFILE_ZONE("AssetStreamer::pump");
+    auto start = std::chrono::steady_clock::now();
+    for (bool first = true; first || msSince(start) < budgetMs; first = false) {
+        std::shared_ptr<AssetRecord> r;
+        std::vector<std::function<void(const std::shared_ptr<AssetRecord>&)>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(impl_->mutex);
+            if (impl_->completed.empty()) break;
+            r = std::move(impl_->completed.front());
+            impl_->completed.pop_front();
+            if (!r->published) {
+                r->published = true;
+                r->payload = std::move(r->decoded);
+                r->state = r->failed ? AssetState::Failed : AssetState::Resident;
+            }
+            callbacks.swap(r->callbacks);
+        }
+        for (auto& cb : callbacks) cb(r);
+    }
+}
+
+void AssetStreamer::waitIdle() {
+    {
+        auto idle = [this] {
+            return impl_->inFlight == 0 && std::none_of(impl_->ioQueue.begin(), impl_->ioQueue.end(), [](const auto& e) {
+                auto r = e.record.lock();
+                return r && r->state.load() == AssetState::Queued;
+            });
+        };
+        // Polls as well: releasing the last handle of a queued asset does not signal
+        std::unique_lock<std::mutex> lock(impl_->mutex);
+        while (!idle()) impl_->idleCv.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    pump(1e30);
+}
+
+AssetStreamer::Stats AssetStreamer::stats() const {
+    Stats s;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    s.trackedPaths = static_cast<uint32_t>(impl_->records.size());
+    for (auto it = impl_->records.begin(); it != impl_->records.end();) {
+        std::shared_ptr<AssetRecord> r = it->second.lock();
+        if (!r) {
+            it = impl_->records.erase(it);
+            continue;
+        }
+        switch (r->state.load()) {
+        case AssetState::Queued: ++s.queued; break;
+        case AssetState::Resident: ++s.resident; break;
+        case AssetState::Failed: ++s.failed; break;
+        default: ++s.inFlight; break;
+        }
+        ++it;
+    }
+    s.bytesRead = impl_->bytesRead;
+    s.ioMs = impl_->ioMs;
+    s.decodeMs = impl_->decodeMs;
+    return s;
+}
+
+} // namespace aurora
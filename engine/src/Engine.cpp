@@ -1,23 +1,206 @@
 #include "aurora/Engine.h"
+#include "aurora/Profiler.h"
+#include <algorithm>
 #include <stdexcept>
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 // Reuse existing App internals for now (will migrate later)
 #include "App.h" // temporary reuse; will be removed once Vulkan moved behind PIMPL
+#include "vulkan/VkObjects.h"
+#include "RenderThread.h"
 
 namespace aurora {
 
 struct Engine::Impl {
+    std::unique_ptr<JobSystem> jobs; // outlives app: the command recorder runs on it
     App* app = nullptr; // temp bridge
+    std::unique_ptr<AssetStreamer> assets;
+    DrawList drawList;
+    ecs::World world;
+    ecs::Query<const ecs::Transform, const ecs::MeshRenderer> renderables{world};
+    ecs::Query<const ecs::SceneNode, const ecs::MeshRenderer> nodeRenderables{world};
+    scene::TransformHierarchy transforms;
+    DrawList frameList; // drawList + scene, rendered by single-threaded frames
+    // Frustum culling: all draws of the frame with their bounds, before culling
+    bool culling = true;
+    bool gpuDriven = false; // the renderer culls; drawsTested/Visible come from its readback
+    DrawList candidates;
+    scene::FrustumCuller culler;
+    math::Frustum frustum = math::Frustum::fromMatrix(math::Mat4::identity()); // clip volume
+    math::Vec3 meshCenter; // bounding sphere of the drawn mesh
+    float meshRadius = 0.0f;
+    // Changed world matrices for single-threaded frames (packets carry their own)
+    std::vector<uint32_t> objectIds;
+    std::vector<math::Mat4> objectWorlds;
+    uint32_t renderPackets = 0; // 0 = render on the game thread
+
+    void buildDrawList(DrawList& out, FrameTimings& timings);
+    void cullDrawList(DrawList& out, FrameTimings& timings);
+    void updateTransforms(std::vector<uint32_t>& ids, std::vector<math::Mat4>& worlds, FrameTimings& timings);
 };
 
-Engine::Engine(const EngineConfig& cfg) : impl_(new Impl()) {
+// The retained list followed by every renderable entity, in chunk order. Chunks are copied in
+// parallel into slots reserved by a sequential prefix pass over the chunk sizes. With culling,
+// the draws go to candidates with their bounding spheres and only the visible ones to out.
+void Engine::Impl::buildDrawList(DrawList& out, FrameTimings& timings) {
+    AURORA_PROFILE_ZONE("Engine::buildDrawList");
+    DrawList& list = culling ? candidates : out;
+    list = drawList;
+    using View = ecs::ChunkView<const ecs::Transform, const ecs::MeshRenderer>;
+    using NodeView = ecs::ChunkView<const ecs::SceneNode, const ecs::MeshRenderer>;
+    std::vector<size_t> offsets(renderables.chunkCount());
+    std::vector<size_t> nodeOffsets(nodeRenderables.chunkCount());
+    size_t total = 0;
+    renderables.eachChunk([&](const View& v) {
+        offsets[v.index] = total;
+        total += v.count;
+    });
+    nodeRenderables.eachChunk([&](const NodeView& v) {
+        nodeOffsets[v.index] = total;
+        total += v.count;
+    });
+    // No draws at all shows the built-in triangle (see DrawList); it is culled like any draw
+    if (total == 0 && list.empty()) list.add(DrawCommand{});
+    const size_t retained = list.size();
+    DrawCommand* dst = list.append(total);
+    if (culling) culler.resize(list.size());
+    float* cx = culler.centerX();
+    float* cy = culler.centerY();
+    float* cz = culler.centerZ();
+    float* cr = culler.radius();
+    // Clip-space draws: the mesh sphere scaled about the origin, then moved
+    auto placedBounds = [&](const DrawCommand* d, size_t first, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const size_t k = first + i;
+            cx[k] = meshCenter.x * d[i].scale + d[i].position[0];
+            cy[k] = meshCenter.y * d[i].scale + d[i].position[1];
+            cz[k] = meshCenter.z * d[i].scale + d[i].position[2];
+            cr[k] = meshRadius * std::fabs(d[i].scale);
+        }
+    };
+    if (culling) {
+        const DrawCommand* src = list.commands().data();
+        jobs->parallelFor(0, static_cast<uint32_t>(retained), [&](uint32_t first, uint32_t last) {
+            placedBounds(src + first, first, last - first);
+        }, 4096);
+    }
+    renderables.parallelEachChunk(*jobs, [&](const View& v) {
+        const ecs::Transform* t = v.column<const ecs::Transform>();
+        const ecs::MeshRenderer* m = v.column<const ecs::MeshRenderer>();
+        DrawCommand* d = dst + offsets[v.index];
+        for (uint32_t i = 0; i < v.count; ++i) {
+            d[i].position[0] = t[i].position[0];
+            d[i].position[1] = t[i].position[1];
+            d[i].position[2] = t[i].position[2];
+            d[i].scale = t[i].scale;
+            d[i].mesh = m[i].mesh;
+            d[i].material = m[i].material;
+        }
+        if (culling) placedBounds(d, retained + offsets[v.index], v.count);
+    });
+    // Placed by the object buffer on the GPU; only the node index is copied
+    nodeRenderables.parallelEachChunk(*jobs, [&](const NodeView& v) {
+        const ecs::SceneNode* n = v.column<const ecs::SceneNode>();
+        const ecs::MeshRenderer* m = v.column<const ecs::MeshRenderer>();
+        DrawCommand* d = dst + nodeOffsets[v.index];
+        for (uint32_t i = 0; i < v.count; ++i) {
+            d[i].object = n[i].node.index;
+            d[i].mesh = m[i].mesh;
+            d[i].material = m[i].material;
+        }
+        if (!culling) return;
+        // The mesh sphere through the node's world matrix, radius scaled by its largest axis
+        const size_t first = retained + nodeOffsets[v.index];
+        for (uint32_t i = 0; i < v.count; ++i) {
+            if (!transforms.alive(n[i].node)) {
+                // Stale node: never drawn
+                culler.set(first + i, {}, -std::numeric_limits<float>::infinity());
+                continue;
+            }
+            const math::Mat4& w = transforms.world(n[i].node);
+            const float s = std::max({math::length(w.cols[0].xyz()), math::length(w.cols[1].xyz()),
+                                      math::length(w.cols[2].xyz())});
+            culler.set(first + i, math::transformPoint(w, meshCenter), meshRadius * s);
+        }
+    });
+    if (culling) {
+        cullDrawList(out, timings);
+    } else if (!gpuDriven) {
+        timings.cullMs = 0.0;
+        timings.drawsTested = timings.drawsVisible = static_cast<uint32_t>(out.size());
+    }
+}
+
+// Frustum test of the candidates' spheres, then a parallel gather of the visible draws in
+// their original order
+void Engine::Impl::cullDrawList(DrawList& out, FrameTimings& timings) {
+    AURORA_PROFILE_ZONE("Engine::cullDrawList");
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::vector<uint32_t>& visible = culler.cull(frustum, jobs.get());
+    out.clear();
+    DrawCommand* dst = out.append(visible.size());
+    const DrawCommand* src = candidates.commands().data();
+    jobs->parallelFor(0, static_cast<uint32_t>(visible.size()), [&](uint32_t first, uint32_t last) {
+        for (uint32_t i = first; i < last; ++i) dst[i] = src[visible[i]];
+    }, 4096);
+    timings.cullMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    timings.drawsTested = culler.stats().tested;
+    timings.drawsVisible = culler.stats().visible;
+}
+
+// Brings node world matrices up to date and collects the ones that changed for the renderer
+void Engine::Impl::updateTransforms(std::vector<uint32_t>& ids, std::vector<math::Mat4>& worlds,
+                                    FrameTimings& timings) {
+    AURORA_PROFILE_ZONE("Engine::updateTransforms");
+    auto start = std::chrono::high_resolution_clock::now();
+    transforms.update(jobs.get());
+    const auto& changed = transforms.changed();
+    ids.resize(changed.size());
+    worlds.resize(changed.size());
+    for (size_t i = 0; i < changed.size(); ++i) {
+        ids[i] = changed[i].index;
+        worlds[i] = transforms.world(changed[i]);
+    }
+    timings.transformMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    timings.transformsChanged = static_cast<uint32_t>(changed.size());
+}
+
+Engine::Engine(const EngineConfig& cfg)
+    : impl_(new Impl()), assetCallbackBudgetMs_(cfg.assetCallbackBudgetMs), headless_(cfg.headless) {
+    // enable before App construction so initVulkan is captured
+    if (cfg.profiling) Profiler::get().setEnabled(true);
+    // Created on the game thread, which becomes job system thread 0
+    impl_->jobs.reset(new JobSystem(cfg.jobWorkers));
     // Map to existing App for now
-    impl_->app = new App(static_cast<int>(cfg.width), static_cast<int>(cfg.height), cfg.title.c_str());
+    AppConfig appCfg;
+    appCfg.width = static_cast<int>(cfg.width);
+    appCfg.height = static_cast<int>(cfg.height);
+    appCfg.title = cfg.title.c_str();
+    appCfg.headless = cfg.headless;
+    appCfg.framesInFlight = cfg.framesInFlight;
+    appCfg.pipelineCachePath = cfg.pipelineCachePath;
+    appCfg.quantizeVertices = cfg.quantizeVertices;
+    appCfg.packPath = cfg.packPath;
+    appCfg.recordThreads = cfg.recordThreads;
+    appCfg.gpuDriven = cfg.gpuDriven;
+    appCfg.bindless = cfg.bindless;
+    appCfg.jobs = impl_->jobs.get();
+    impl_->app = new App(appCfg);
+    impl_->app->setDrawList(&impl_->frameList);
+    impl_->renderables.exclude<ecs::SceneNode>();
+    impl_->renderPackets = cfg.renderThread ? std::max(cfg.renderPackets, 2u) : 0;
+    impl_->gpuDriven = impl_->app->isGpuDriven();
+    impl_->culling = cfg.frustumCulling && !impl_->gpuDriven;
+    impl_->app->meshBounds(0, impl_->meshCenter, impl_->meshRadius);
+    impl_->assets.reset(new AssetStreamer(impl_->app->fileSystem(), cfg.assetIoThreads, cfg.assetDecodeThreads));
 }
 
 Engine::~Engine() {
+    // Streaming threads read through the App's file system
+    impl_->assets.reset();
     if (impl_->app) {
         delete impl_->app;
         impl_->app = nullptr;
@@ -28,16 +211,79 @@ void Engine::run(IGame& game) {
     game.onInit(*this);
     using clock = std::chrono::high_resolution_clock;
     auto prev = clock::now();
+    exitRequested_ = false;
+    std::unique_ptr<RenderThread> render;
+    if (impl_->renderPackets) render.reset(new RenderThread(*impl_->app, impl_->renderPackets));
+    uint64_t frameNumber = 0;
+    auto copyTimings = [this](const RenderTimings& rt) {
+        frameTimings_.frameMs = static_cast<double>(deltaTime_) * 1000.0;
+        frameTimings_.fenceWaitMs = rt.fenceWaitMs;
+        frameTimings_.acquireMs = rt.acquireMs;
+        frameTimings_.submitMs = rt.submitMs;
+        frameTimings_.presentMs = rt.presentMs;
+        frameTimings_.recordMs = rt.recordMs;
+        frameTimings_.sortMs = rt.sortMs;
+        frameTimings_.drawCalls = rt.drawCalls;
+        frameTimings_.renderPassCount = std::min<uint32_t>(rt.graphPassCount, FrameTimings::kMaxRenderPasses);
+        for (uint32_t i = 0; i < frameTimings_.renderPassCount; ++i) {
+            frameTimings_.renderPasses[i] = {rt.graphPasses[i].name, rt.graphPasses[i].cpuMs, rt.graphPasses[i].gpuMs};
+        }
+        frameTimings_.passesCulled = rt.graphPassesCulled;
+        frameTimings_.barriers = rt.graphBarriers;
+        frameTimings_.transientBytes = rt.transientBytes;
+        frameTimings_.transientBytesSaved = rt.transientBytesSaved;
+        frameTimings_.descriptorSets = rt.descriptorSets;
+        frameTimings_.descriptorPools = rt.descriptorPools;
+        frameTimings_.descriptorPoolGrowths = rt.descriptorPoolGrowths;
+        frameTimings_.descriptorLayouts = rt.descriptorLayouts;
+        frameTimings_.descriptorLayoutHits = rt.descriptorLayoutHits;
+        frameTimings_.bindlessTextures = rt.bindlessTextures;
+        frameTimings_.bindlessBuffers = rt.bindlessBuffers;
+        frameTimings_.pipelinesCompiling = rt.pipelinesCompiling;
+        frameTimings_.pipelineFallbacks = rt.pipelineFallbacks;
+        if (impl_->gpuDriven) {
+            frameTimings_.cullMs = 0.0;
+            frameTimings_.drawsTested = rt.gpuDrawsTested;
+            frameTimings_.drawsVisible = rt.gpuDrawsVisible;
+        }
+    };
     // Manual frame loop
-    while (true) {
+    while (!exitRequested_) {
         auto now = clock::now();
         std::chrono::duration<float> dt = now - prev;
         prev = now;
         deltaTime_ = dt.count();
         try {
+            if (render) {
+                // Game thread simulates frame N+1 while the render thread draws frame N
+                if (!impl_->app->pumpEvents()) break;
+                copyTimings(render->lastTimings());
+                impl_->assets->pump(assetCallbackBudgetMs_);
+                {
+                    AURORA_PROFILE_ZONE("IGame::onUpdate");
+                    game.onUpdate(*this, deltaTime_);
+                }
+                auto waitStart = clock::now();
+                RenderPacket& packet = render->acquire();
+                frameTimings_.packetWaitMs = std::chrono::duration<double, std::milli>(clock::now() - waitStart).count();
+                packet.frame = frameNumber++;
+                impl_->updateTransforms(packet.objectIds, packet.objectWorlds, frameTimings_);
+                impl_->buildDrawList(packet.drawList, frameTimings_);
+                render->submit(packet);
+                continue;
+            }
+            // Same order as above: the update, then the frame's transforms and draws
+            impl_->assets->pump(assetCallbackBudgetMs_);
+            {
+                AURORA_PROFILE_ZONE("IGame::onUpdate");
+                game.onUpdate(*this, deltaTime_);
+            }
+            impl_->updateTransforms(impl_->objectIds, impl_->objectWorlds, frameTimings_);
+            impl_->app->updateObjects(impl_->objectIds.data(), impl_->objectWorlds.data(), impl_->objectIds.size());
+            impl_->buildDrawList(impl_->frameList, frameTimings_);
             // Advance one engine frame (Vulkan + window). Break if window closed.
             if (!impl_->app->frame()) break;
-            game.onUpdate(*this, deltaTime_);
+            copyTimings(impl_->app->lastFrameTimings());
         } catch (const std::exception& e) {
             std::cerr << "Engine loop exception: " << e.what() << std::endl;
             break;
@@ -46,9 +292,69 @@ void Engine::run(IGame& game) {
             break;
         }
     }
+    if (render) {
+        try {
+            render->stop();
+        } catch (const std::exception& e) {
+            std::cerr << "Render thread exception: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Render thread unknown exception" << std::endl;
+        }
+        // Single-threaded frames (and teardown) read the engine's list again
+        impl_->app->setDrawList(&impl_->frameList);
+    }
     game.onShutdown(*this);
 }
 
+JobSystem& Engine::jobs() {
+    return *impl_->jobs;
+}
+
+AssetStreamer& Engine::assets() {
+    return *impl_->assets;
+}
+
+ecs::World& Engine::world() {
+    return impl_->world;
+}
+
+scene::TransformHierarchy& Engine::transforms() {
+    return impl_->transforms;
+}
+
+DrawList& Engine::drawList() {
+    return impl_->drawList;
+}
+
+uint32_t Engine::createMaterial(const MaterialDesc& desc) {
+    return impl_->app->createMaterial(desc);
+}
+
+PipelineCacheStats Engine::getPipelineCacheStats() const {
+    const ::PipelineCacheStats s = impl_->app->pipelineCacheStats();
+    PipelineCacheStats out;
+    out.loadedFromDisk = s.loadedFromDisk;
+    out.loadedBytes = s.loadedBytes;
+    out.pipelinesCreated = s.pipelinesCreated;
+    out.cacheHits = s.cacheHits;
+    out.cacheMisses = s.cacheMisses;
+    out.hitMs = s.hitMs;
+    out.missMs = s.missMs;
+    out.totalMs = s.totalMs;
+    out.maxMs = s.maxMs;
+    out.stateRequests = s.stateRequests;
+    out.stateDeduplicated = s.stateDeduplicated;
+    return out;
+}
+
+void Engine::setProfilingEnabled(bool enabled) {
+    Profiler::get().setEnabled(enabled);
+}
+
+bool Engine::writeTrace(const std::string& path) const {
+    return Profiler::get().writeChromeTrace(path);
+}
+
 void Engine::init(const EngineConfig&) {}
 void Engine::shutdown() {}
 void Engine::mainLoop(IGame&) {}
@@ -0,0 +1,241 @@
+#include "aurora/JobSystem.h"
+#include "aurora/Profiler.h"
+
+#include <algorithm>
+#include <random>
+
+namespace aurora {
+
+struct JobCounter::Job {
+    std::function<void()> fn;
+    JobCounter* signal = nullptr;
+};
+
+JobCounter::~JobCounter() {
+    while (finishing_.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+}
+
+namespace {
+// Which system/deque the current thread owns (threads belong to at most one system)
+thread_local const JobSystem* tlsSystem = nullptr;
+thread_local uint32_t tlsIndex = UINT32_MAX;
+}
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli: "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013). Fixed capacity: when full the owner runs the
+// job inline instead.
+class JobSystem::Deque {
+public:
+    static constexpr int64_t kCapacity = 4096;
+
+    bool push(Job* job) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= kCapacity) return false;
+        buffer_[static_cast<size_t>(b & (kCapacity - 1))].store(job, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only
+    Job* pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = buffer_[static_cast<size_t>(b & (kCapacity - 1))].load(std::memory_order_acquire);
+        if (t == b) {
+            // Last item: race the thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Any thread
+    Job* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = buffer_[static_cast<size_t>(t & (kCapacity - 1))].load(std::memory_order_acquire);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Job*> buffer_[kCapacity];
+};
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 1;
+    }
+    for (uint32_t i = 0; i <= workerCount; ++i) queues_.push_back(std::make_unique<Deque>());
+    tlsSystem = this;
+    tlsIndex = 0;
+    for (uint32_t i = 1; i <= workerCount; ++i) {
+        workers_.emplace_back([this, i] { workerMain(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    sleepCv_.notify_all();
+    for (auto& w : workers_) w.join();
+    // Anything still queued never ran; release it
+    for (auto& q : queues_) {
+        while (Job* job = q->steal()) delete job;
+    }
+    for (Job* job : injected_) delete job;
+    if (tlsSystem == this) {
+        tlsSystem = nullptr;
+        tlsIndex = UINT32_MAX;
+    }
+}
+
+uint32_t JobSystem::currentThreadIndex() const {
+    return tlsSystem == this ? tlsIndex : UINT32_MAX;
+}
+
+void JobSystem::run(std::function<void()> fn, JobCounter* signal, JobCounter* dependsOn) {
+    Job* job = new Job{std::move(fn), signal};
+    if (signal) signal->value_.fetch_add(1, std::memory_order_relaxed);
+    if (dependsOn) {
+        std::lock_guard<std::mutex> lock(dependsOn->mutex_);
+        if (!dependsOn->done()) {
+            dependsOn->continuations_.push_back(job);
+            return;
+        }
+    }
+    schedule(job);
+}
+
+void JobSystem::schedule(Job* job) {
+    uint32_t self = currentThreadIndex();
+    if (self != UINT32_MAX) {
+        if (!queues_[self]->push(job)) {
+            execute(job); // deque full: no point queueing more behind it
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        injected_.push_back(job);
+    }
+    queued_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        sleepCv_.notify_one();
+    }
+}
+
+JobSystem::Job* JobSystem::findJob(uint32_t self) {
+    Job* job = nullptr;
+    if (self != UINT32_MAX) job = queues_[self]->pop();
+    if (!job) {
+        // Steal from a random victim first so thieves spread out
+        thread_local std::minstd_rand rng(std::random_device{}());
+        const uint32_t n = static_cast<uint32_t>(queues_.size());
+        const uint32_t start = static_cast<uint32_t>(rng() % n);
+        for (uint32_t k = 0; k < n && !job; ++k) {
+            uint32_t victim = (start + k) % n;
+            if (victim != self) job = queues_[victim]->steal();
+        }
+    }
+    if (!job) {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        if (!injected_.empty()) {
+            job = injected_.back();
+            injected_.pop_back();
+        }
+    }
+    if (job) queued_.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+void JobSystem::execute(Job* job) {
+    job->fn();
+    JobCounter* signal = job->signal;
+    delete job;
+    if (!signal) return;
+    // A waiter may destroy the counter as soon as it reads zero; finishing_ holds it off
+    // until this job is done with the counter's mutex
+    signal->finishing_.fetch_add(1, std::memory_order_relaxed);
+    std::vector<Job*> ready;
+    if (signal->value_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(signal->mutex_);
+        ready.swap(signal->continuations_);
+    }
+    signal->finishing_.fetch_sub(1, std::memory_order_release);
+    for (Job* next : ready) schedule(next);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    AURORA_PROFILE_ZONE("JobSystem::wait");
+    const uint32_t self = currentThreadIndex();
+    uint32_t idleSpins = 0;
+    while (!counter.done()) {
+        if (Job* job = findJob(self)) {
+            execute(job);
+            idleSpins = 0;
+        } else if (++idleSpins < 64) {
+            std::this_thread::yield();
+        } else {
+            // Remaining jobs are running elsewhere; don't burn the core
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void JobSystem::workerMain(uint32_t index) {
+    tlsSystem = this;
+    tlsIndex = index;
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        if (Job* job = findJob(index)) {
+            execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        sleepCv_.wait(lock, [this] { return stopping_.load() || queued_.load(std::memory_order_seq_cst) > 0; });
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void JobSystem::parallelForImpl(uint32_t begin, uint32_t end, const std::function<void(uint32_t, uint32_t)>& body,
+                                uint32_t minGrain) {
+    AURORA_PROFILE_ZONE("JobSystem::parallelFor");
+    const uint32_t count = end - begin;
+    // ~8 ranges per thread leaves room for stealing to even out uneven items
+    const uint32_t grain = std::max({minGrain, 1u, count / (threadCount() * 8)});
+    if (count <= grain || threadCount() == 1) {
+        body(begin, end);
+        return;
+    }
+    JobCounter counter;
+    // Split off the upper half until the range is one grain; the halves split again wherever
+    // they get stolen
+    std::function<void(uint32_t, uint32_t)> split = [&](uint32_t first, uint32_t last) {
+        while (last - first > grain) {
+            uint32_t mid = first + (last - first) / 2;
+            run([&split, mid, last] { split(mid, last); }, &counter);
+            last = mid;
+        }
+        body(first, last);
+    };
+    split(begin, end);
+    wait(counter);
+}
+
+} // namespace aurora
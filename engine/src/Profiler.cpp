@@ -0,0 +1,103 @@
+#include "aurora/Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace aurora {
+
+namespace {
+uint64_t steadyNs() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void writeEscaped(std::ostream& os, const char* s) {
+    for (; s && *s; ++s) {
+        if (*s == '"' || *s == '\\') os << '\\';
+        os << *s;
+    }
+}
+}
+
+Profiler& Profiler::get() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() : epochNs_(steadyNs()) {}
+
+uint64_t Profiler::nowUs() const {
+    return (steadyNs() - epochNs_) / 1000u;
+}
+
+uint32_t Profiler::currentThreadId() {
+    // Small sequential ids read better in trace viewers than hashed std::thread::id
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t id = next.fetch_add(1);
+    return id;
+}
+
+void Profiler::push(const ProfileEvent& ev) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() < kMaxEvents) {
+        events_.push_back(ev);
+        head_ = events_.size() % kMaxEvents;
+        if (head_ == 0) wrapped_ = true;
+        return;
+    }
+    events_[head_] = ev;
+    head_ = (head_ + 1) % kMaxEvents;
+    wrapped_ = true;
+}
+
+void Profiler::recordCpu(const char* name, uint64_t startUs, uint64_t endUs) {
+    if (!enabled_) return;
+    push({name, "cpu", currentThreadId(), startUs, endUs > startUs ? endUs - startUs : 0});
+}
+
+void Profiler::recordGpu(const char* name, uint64_t startUs, uint64_t durationUs) {
+    if (!enabled_) return;
+    push({name, "gpu", kGpuTrackId, startUs, durationUs});
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    head_ = 0;
+    wrapped_ = false;
+}
+
+std::vector<ProfileEvent> Profiler::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!wrapped_) return events_;
+    // oldest first
+    std::vector<ProfileEvent> out;
+    out.reserve(events_.size());
+    out.insert(out.end(), events_.begin() + static_cast<std::ptrdiff_t>(head_), events_.end());
+    out.insert(out.end(), events_.begin(), events_.begin() + static_cast<std::ptrdiff_t>(head_));
+    return out;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    auto events = snapshot();
+    std::ofstream f(path);
+    if (!f) {
+        std::cerr << "Profiler: cannot open " << path << std::endl;
+        return false;
+    }
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << kGpuTrackId << ",\"args\":{\"name\":\"GPU\"}}";
+    for (const auto& ev : events) {
+        f << ",\n{\"name\":\"";
+        writeEscaped(f, ev.name);
+        f << "\",\"cat\":\"" << ev.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ev.tid
+          << ",\"ts\":" << ev.startUs << ",\"dur\":" << ev.durationUs << "}";
+    }
+    f << "\n]}\n";
+    std::cout << "Profiler: wrote " << events.size() << " events to " << path << std::endl;
+    return static_cast<bool>(f);
+}
+
+} // namespace aurora
@@ -0,0 +1,108 @@
+#include "RenderThread.h"
+#include "aurora/Profiler.h"
+
+#include <algorithm>
+
+#include "App.h"
+
+namespace aurora {
+
+RenderThread::RenderThread(App& app, uint32_t packetCount) : app_(app) {
+    packetCount = std::max(packetCount, 2u);
+    for (uint32_t i = 0; i < packetCount; ++i) {
+        packets_.push_back(std::make_unique<RenderPacket>());
+        free_.push_back(packets_.back().get());
+    }
+    thread_ = std::thread([this] { threadMain(); });
+}
+
+RenderThread::~RenderThread() {
+    try {
+        stop();
+    } catch (...) {
+        // Already reported through acquire(), or the engine is unwinding anyway
+    }
+}
+
+RenderPacket& RenderThread::acquire() {
+    AURORA_PROFILE_ZONE("RenderThread::acquire");
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !free_.empty() || error_; });
+    if (error_) {
+        errorReported_ = true;
+        std::rethrow_exception(error_);
+    }
+    RenderPacket* packet = free_.front();
+    free_.pop_front();
+    return *packet;
+}
+
+void RenderThread::submit(RenderPacket& packet) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(&packet);
+    }
+    cv_.notify_all();
+}
+
+void RenderThread::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!errorReported_) error = error_;
+        errorReported_ = true;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+RenderTimings RenderThread::lastTimings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timings_;
+}
+
+void RenderThread::threadMain() {
+    for (;;) {
+        RenderPacket* packet = nullptr;
+        std::deque<RenderPacket*> dropped;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !ready_.empty() || stopping_; });
+            if (stopping_) {
+                dropped.swap(ready_);
+            } else {
+                packet = ready_.front();
+                ready_.pop_front();
+            }
+        }
+        try {
+            // Dropped frames are not drawn, but frames rendered later build on their object changes
+            for (RenderPacket* p : dropped) {
+                app_.updateObjects(p->objectIds.data(), p->objectWorlds.data(), p->objectIds.size());
+            }
+            if (!packet) return;
+            app_.updateObjects(packet->objectIds.data(), packet->objectWorlds.data(), packet->objectIds.size());
+            app_.setDrawList(&packet->drawList);
+            app_.renderFrame();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            cv_.notify_all();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timings_ = app_.lastFrameTimings();
+            free_.push_back(packet);
+        }
+        cv_.notify_all();
+    }
+}
+
+} // namespace aurora
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "aurora/DrawList.h"
+#include "aurora/math/Math.h"
+#include "vulkan/VkObjects.h"
+
+class App;
+
+namespace aurora {
+
+// Everything the render thread needs for one frame, built by the game thread. The game keeps
+// editing Engine::drawList() while an older packet is drawn.
+struct RenderPacket {
+    uint64_t frame = 0; // game frame that produced it
+    DrawList drawList;
+    // World matrices that changed since the previous packet (DrawCommand::object ids)
+    std::vector<uint32_t> objectIds;
+    std::vector<math::Mat4> objectWorlds;
+};
+
+// Runs App::renderFrame on its own thread. Packets cycle through a fixed ring: the game
+// thread acquires a free one, fills it and submits it; the render thread draws submitted
+// packets in order and hands them back. With N packets the game runs at most N - 1 frames
+// ahead of the frame being drawn, so acquire() is where a GPU- or render-bound game waits.
+class RenderThread {
+public:
+    RenderThread(App& app, uint32_t packetCount);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Game thread. Blocks while every packet is queued or being drawn; rethrows a render
+    // thread failure.
+    RenderPacket& acquire();
+    void submit(RenderPacket& packet);
+    // Finishes the packet being drawn, drops queued ones (keeping their object updates) and joins. Rethrows a render thread
+    // failure that acquire() has not reported yet.
+    void stop();
+
+    // Stage timings of the most recently drawn frame
+    RenderTimings lastTimings() const;
+
+private:
+    void threadMain();
+
+    App& app_;
+    std::vector<std::unique_ptr<RenderPacket>> packets_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<RenderPacket*> free_;
+    std::deque<RenderPacket*> ready_;
+    RenderTimings timings_;
+    std::exception_ptr error_;
+    bool errorReported_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace aurora
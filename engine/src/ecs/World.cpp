@@ -0,0 +1,324 @@
+#include "aurora/ecs/World.h"
+#include "aurora/ecs/CommandBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace aurora::ecs {
+
+namespace {
+constexpr size_t kChunkAlign = 64;
+
+size_t alignUp(size_t v, size_t a) { return (v + a - 1) & ~(a - 1); }
+
+// Moves one value between slots, leaving src destroyed
+void relocate(const ComponentInfo& info, void* dst, void* src) {
+    if (info.trivial) {
+        std::memcpy(dst, src, info.size);
+    } else {
+        info.moveConstruct(dst, src);
+        info.destroy(src);
+    }
+}
+}
+
+int32_t Archetype::columnIndex(ComponentId id) const {
+    auto it = std::lower_bound(signature_.begin(), signature_.end(), id);
+    if (it == signature_.end() || *it != id) return -1;
+    return static_cast<int32_t>(it - signature_.begin());
+}
+
+World::World() {
+    empty_ = archetypeFor({});
+}
+
+World::~World() {
+    for (auto& a : archetypes_) {
+        for (size_t row = 0; row < a->count_; ++row) {
+            for (uint32_t c = 0; c < a->columns_.size(); ++c) {
+                if (!a->columns_[c].info->trivial) a->columns_[c].info->destroy(a->slot(c, row));
+            }
+        }
+        for (uint8_t* chunk : a->chunks_) ::operator delete(chunk, std::align_val_t(kChunkAlign));
+    }
+}
+
+void World::checkStructural() const {
+    if (iterating_.load(std::memory_order_relaxed) != 0) {
+        throw std::runtime_error("ecs::World: structural change during query iteration; record it in a CommandBuffer");
+    }
+}
+
+Archetype* World::archetypeFor(std::vector<const ComponentInfo*> infos) {
+    std::sort(infos.begin(), infos.end(), [](const ComponentInfo* a, const ComponentInfo* b) { return a->id < b->id; });
+    std::vector<ComponentId> signature;
+    signature.reserve(infos.size());
+    for (const ComponentInfo* info : infos) {
+        if (!signature.empty() && signature.back() == info->id) {
+            throw std::runtime_error("ecs::World: component type listed twice: " + std::string(info->name));
+        }
+        signature.push_back(info->id);
+    }
+    auto it = archetypeIndex_.find(signature);
+    if (it != archetypeIndex_.end()) return it->second;
+
+    auto a = std::make_unique<Archetype>();
+    a->signature_ = signature;
+    // Capacity: entity id + one value of every column per row, plus worst-case alignment
+    // padding after the entity array (rounded up to the chunk alignment) and before each column
+    size_t rowBytes = sizeof(Entity);
+    size_t padding = kChunkAlign - 1;
+    for (const ComponentInfo* info : infos) {
+        if (info->align > kChunkAlign) {
+            throw std::runtime_error("ecs::World: component alignment exceeds the chunk alignment: " + std::string(info->name));
+        }
+        rowBytes += info->size;
+        padding += info->align - 1;
+    }
+    if (padding + rowBytes > Archetype::kChunkBytes) {
+        throw std::runtime_error("ecs::World: archetype row does not fit in a chunk");
+    }
+    a->capacity_ = static_cast<uint32_t>((Archetype::kChunkBytes - padding) / rowBytes);
+    size_t offset = alignUp(sizeof(Entity) * a->capacity_, kChunkAlign);
+    for (const ComponentInfo* info : infos) {
+        offset = alignUp(offset, info->align);
+        a->columns_.push_back({info, static_cast<uint32_t>(offset)});
+        offset += size_t(info->size) * a->capacity_;
+    }
+    Archetype* raw = a.get();
+    archetypes_.push_back(std::move(a));
+    archetypeIndex_.emplace(std::move(signature), raw);
+    return raw;
+}
+
+Archetype* World::withComponent(Archetype* from, const ComponentInfo& info) {
+    auto it = from->addEdges_.find(info.id);
+    if (it != from->addEdges_.end()) return it->second;
+    std::vector<const ComponentInfo*> infos;
+    for (const auto& col : from->columns_) infos.push_back(col.info);
+    infos.push_back(&info);
+    Archetype* to = archetypeFor(std::move(infos));
+    from->addEdges_[info.id] = to;
+    to->removeEdges_[info.id] = from;
+    return to;
+}
+
+Archetype* World::withoutComponent(Archetype* from, ComponentId id) {
+    auto it = from->removeEdges_.find(id);
+    if (it != from->removeEdges_.end()) return it->second;
+    std::vector<const ComponentInfo*> infos;
+    for (const auto& col : from->columns_) {
+        if (col.info->id != id) infos.push_back(col.info);
+    }
+    Archetype* to = archetypeFor(std::move(infos));
+    from->removeEdges_[id] = to;
+    to->addEdges_[id] = from;
+    return to;
+}
+
+size_t World::pushRow(Archetype& a, Entity e) {
+    if (a.count_ == size_t(a.chunks_.size()) * a.capacity_) {
+        a.chunks_.push_back(static_cast<uint8_t*>(::operator new(Archetype::kChunkBytes, std::align_val_t(kChunkAlign))));
+    }
+    size_t row = a.count_++;
+    a.entityAt(row) = e;
+    return row;
+}
+
+void World::eraseRow(Archetype& a, size_t row) {
+    // Components at row are already destroyed or moved out; fill the hole with the last row
+    size_t last = a.count_ - 1;
+    if (row != last) {
+        for (uint32_t c = 0; c < a.columns_.size(); ++c) relocate(*a.columns_[c].info, a.slot(c, row), a.slot(c, last));
+        Entity moved = a.entityAt(last);
+        a.entityAt(row) = moved;
+        records_[moved.index].row = row;
+    }
+    a.count_ = last;
+    if (a.count_ == size_t(a.chunks_.size() - 1) * a.capacity_) {
+        ::operator delete(a.chunks_.back(), std::align_val_t(kChunkAlign));
+        a.chunks_.pop_back();
+    }
+}
+
+void World::moveEntity(Entity e, Archetype* to) {
+    Record& rec = records_[e.index];
+    Archetype* from = rec.archetype;
+    const size_t fromRow = rec.row;
+    const size_t toRow = pushRow(*to, e);
+    // Shared columns move over; the ones the destination lacks are destroyed
+    for (uint32_t c = 0; c < from->columns_.size(); ++c) {
+        const ComponentInfo& info = *from->columns_[c].info;
+        int32_t dst = to->columnIndex(info.id);
+        if (dst >= 0) {
+            relocate(info, to->slot(static_cast<uint32_t>(dst), toRow), from->slot(c, fromRow));
+        } else if (!info.trivial) {
+            info.destroy(from->slot(c, fromRow));
+        }
+    }
+    eraseRow(*from, fromRow);
+    rec.archetype = to;
+    rec.row = toRow;
+}
+
+Entity World::create() {
+    return createErased(nullptr, nullptr, 0);
+}
+
+Entity World::createErased(const ComponentInfo* const* infos, void* const* values, size_t count) {
+    checkStructural();
+    Archetype* a = count == 0 ? empty_ : archetypeFor(std::vector<const ComponentInfo*>(infos, infos + count));
+    Entity e;
+    if (!freeIndices_.empty()) {
+        e.index = freeIndices_.back();
+        freeIndices_.pop_back();
+    } else {
+        e.index = static_cast<uint32_t>(records_.size());
+        records_.emplace_back();
+    }
+    e.generation = records_[e.index].generation;
+    const size_t row = pushRow(*a, e);
+    for (size_t i = 0; i < count; ++i) {
+        void* dst = a->slot(static_cast<uint32_t>(a->columnIndex(infos[i]->id)), row);
+        if (values && values[i]) {
+            infos[i]->moveConstruct(dst, values[i]);
+        } else {
+            infos[i]->construct(dst);
+        }
+    }
+    records_[e.index].archetype = a;
+    records_[e.index].row = row;
+    ++alive_;
+    return e;
+}
+
+bool World::alive(Entity e) const {
+    return e.index < records_.size() && records_[e.index].generation == e.generation && records_[e.index].archetype;
+}
+
+void World::destroy(Entity e) {
+    checkStructural();
+    if (!alive(e)) return;
+    Record& rec = records_[e.index];
+    Archetype& a = *rec.archetype;
+    for (uint32_t c = 0; c < a.columns_.size(); ++c) {
+        if (!a.columns_[c].info->trivial) a.columns_[c].info->destroy(a.slot(c, rec.row));
+    }
+    eraseRow(a, rec.row);
+    rec.archetype = nullptr;
+    ++rec.generation;
+    freeIndices_.push_back(e.index);
+    --alive_;
+}
+
+void* World::addErased(Entity e, const ComponentInfo& info, void* value) {
+    if (!alive(e)) throw std::runtime_error("ecs::World::add on a dead entity");
+    Archetype* a = records_[e.index].archetype;
+    int32_t col = a->columnIndex(info.id);
+    if (col >= 0) {
+        // Replace in place: no structural change
+        void* dst = a->slot(static_cast<uint32_t>(col), records_[e.index].row);
+        info.destroy(dst);
+        info.moveConstruct(dst, value);
+        return dst;
+    }
+    checkStructural();
+    Archetype* to = withComponent(a, info);
+    moveEntity(e, to);
+    void* dst = to->slot(static_cast<uint32_t>(to->columnIndex(info.id)), records_[e.index].row);
+    info.moveConstruct(dst, value);
+    return dst;
+}
+
+void World::removeErased(Entity e, ComponentId id) {
+    if (!alive(e)) return;
+    Archetype* a = records_[e.index].archetype;
+    if (a->columnIndex(id) < 0) return;
+    checkStructural();
+    moveEntity(e, withoutComponent(a, id));
+}
+
+void* World::getErased(Entity e, ComponentId id) const {
+    if (!alive(e)) return nullptr;
+    const Record& rec = records_[e.index];
+    int32_t col = rec.archetype->columnIndex(id);
+    return col < 0 ? nullptr : rec.archetype->slot(static_cast<uint32_t>(col), rec.row);
+}
+
+void World::playback(CommandBuffer& buffer) {
+    checkStructural();
+    using Op = CommandBuffer::Op;
+    auto& cmds = buffer.commands_;
+    std::vector<const ComponentInfo*> infos;
+    std::vector<void*> values;
+    for (size_t i = 0; i < cmds.size(); ++i) {
+        CommandBuffer::Command& cmd = cmds[i];
+        switch (cmd.op) {
+        case Op::Create: {
+            // The component commands that follow belong to the new entity: one archetype lookup
+            infos.clear();
+            values.clear();
+            for (uint32_t k = 1; k <= cmd.count; ++k) {
+                infos.push_back(cmds[i + k].info);
+                values.push_back(cmds[i + k].value);
+            }
+            createErased(infos.data(), values.data(), infos.size());
+            for (uint32_t k = 1; k <= cmd.count; ++k) {
+                cmds[i + k].info->destroy(cmds[i + k].value);
+                cmds[i + k].value = nullptr;
+            }
+            i += cmd.count;
+            break;
+        }
+        case Op::Destroy:
+            destroy(cmd.entity);
+            break;
+        case Op::Add:
+            if (alive(cmd.entity)) addErased(cmd.entity, *cmd.info, cmd.value);
+            cmd.info->destroy(cmd.value);
+            cmd.value = nullptr;
+            break;
+        case Op::Remove:
+            removeErased(cmd.entity, cmd.info->id);
+            break;
+        }
+    }
+    buffer.clear();
+}
+
+void CommandBuffer::clear() {
+    for (Command& cmd : commands_) {
+        if (cmd.value) cmd.info->destroy(cmd.value);
+    }
+    commands_.clear();
+    // Keep the first block for reuse
+    if (blocks_.size() > 1) blocks_.resize(1);
+    used_ = blocks_.empty() ? kBlockBytes : 0;
+}
+
+void* CommandBuffer::allocate(size_t size, size_t align) {
+    if (size + align > kBlockBytes) {
+        // Oversized value: own block, placed before the current one so that stays the bump target
+        auto block = std::make_unique<std::byte[]>(size + align);
+        void* p = reinterpret_cast<void*>(alignUp(reinterpret_cast<uintptr_t>(block.get()), align));
+        blocks_.insert(blocks_.empty() ? blocks_.end() : blocks_.end() - 1, std::move(block));
+        return p;
+    }
+    if (!blocks_.empty()) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(blocks_.back().get());
+        uintptr_t p = alignUp(base + used_, align);
+        if (p + size <= base + kBlockBytes) {
+            used_ = p + size - base;
+            return reinterpret_cast<void*>(p);
+        }
+    }
+    blocks_.push_back(std::make_unique<std::byte[]>(kBlockBytes));
+    uintptr_t base = reinterpret_cast<uintptr_t>(blocks_.back().get());
+    uintptr_t p = alignUp(base, align);
+    used_ = p + size - base;
+    return reinterpret_cast<void*>(p);
+}
+
+} // namespace aurora::ecs
@@ -0,0 +1,141 @@
+#include "aurora/math/Math.h"
+
+namespace aurora::math {
+
+Quat slerp(const Quat& a, const Quat& b, float t) {
+    float cosTheta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    Quat end = b;
+    if (cosTheta < 0.0f) {
+        cosTheta = -cosTheta;
+        end = {-b.x, -b.y, -b.z, -b.w};
+    }
+    float wa = 1.0f - t;
+    float wb = t;
+    // Nearly parallel: sin(theta) ~ 0, fall back to normalized lerp
+    if (cosTheta < 0.9995f) {
+        float theta = std::acos(cosTheta);
+        float sinTheta = std::sin(theta);
+        wa = std::sin((1.0f - t) * theta) / sinTheta;
+        wb = std::sin(t * theta) / sinTheta;
+    }
+    return normalize(Quat{a.x * wa + end.x * wb, a.y * wa + end.y * wb, a.z * wa + end.z * wb, a.w * wa + end.w * wb});
+}
+
+Mat4 Mat4::translation(const Vec3& t) {
+    Mat4 m;
+    m.cols[3] = {t, 1.0f};
+    return m;
+}
+
+Mat4 Mat4::scale(const Vec3& s) {
+    Mat4 m;
+    m.cols[0].x = s.x;
+    m.cols[1].y = s.y;
+    m.cols[2].z = s.z;
+    return m;
+}
+
+Mat4 Mat4::rotation(const Quat& q) {
+    return trs({}, q, Vec3(1.0f));
+}
+
+Mat4 Mat4::trs(const Vec3& t, const Quat& q, const Vec3& s) {
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    Mat4 m;
+    m.cols[0] = {(1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f};
+    m.cols[1] = {2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f};
+    m.cols[2] = {2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f};
+    m.cols[3] = {t, 1.0f};
+    return m;
+}
+
+Mat4 Mat4::perspective(float fovY, float aspect, float zNear, float zFar) {
+    const float f = 1.0f / std::tan(fovY * 0.5f);
+    Mat4 m;
+    m.cols[0] = {f / aspect, 0.0f, 0.0f, 0.0f};
+    m.cols[1] = {0.0f, -f, 0.0f, 0.0f};
+    m.cols[2] = {0.0f, 0.0f, zFar / (zNear - zFar), -1.0f};
+    m.cols[3] = {0.0f, 0.0f, zNear * zFar / (zNear - zFar), 0.0f};
+    return m;
+}
+
+Mat4 Mat4::orthographic(float left, float right, float bottom, float top, float zNear, float zFar) {
+    Mat4 m;
+    m.cols[0] = {2.0f / (right - left), 0.0f, 0.0f, 0.0f};
+    m.cols[1] = {0.0f, -2.0f / (top - bottom), 0.0f, 0.0f};
+    m.cols[2] = {0.0f, 0.0f, 1.0f / (zNear - zFar), 0.0f};
+    m.cols[3] = {-(right + left) / (right - left), (top + bottom) / (top - bottom), zNear / (zNear - zFar), 1.0f};
+    return m;
+}
+
+Mat4 Mat4::lookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    const Vec3 f = normalize(target - eye);
+    const Vec3 s = normalize(cross(f, up));
+    const Vec3 u = cross(s, f);
+    Mat4 m;
+    m.cols[0] = {s.x, u.x, -f.x, 0.0f};
+    m.cols[1] = {s.y, u.y, -f.y, 0.0f};
+    m.cols[2] = {s.z, u.z, -f.z, 0.0f};
+    m.cols[3] = {-dot(s, eye), -dot(u, eye), dot(f, eye), 1.0f};
+    return m;
+}
+
+Mat4 transpose(const Mat4& m) {
+    Mat4 r;
+    for (int c = 0; c < 4; ++c) {
+        for (int row = 0; row < 4; ++row) r.cols[c][row] = m.cols[row][c];
+    }
+    return r;
+}
+
+Mat4 inverse(const Mat4& m) {
+    // Cofactor expansion over 2x2 sub-determinants of the upper and lower row pairs
+    const float a00 = m.at(0, 0), a01 = m.at(0, 1), a02 = m.at(0, 2), a03 = m.at(0, 3);
+    const float a10 = m.at(1, 0), a11 = m.at(1, 1), a12 = m.at(1, 2), a13 = m.at(1, 3);
+    const float a20 = m.at(2, 0), a21 = m.at(2, 1), a22 = m.at(2, 2), a23 = m.at(2, 3);
+    const float a30 = m.at(3, 0), a31 = m.at(3, 1), a32 = m.at(3, 2), a33 = m.at(3, 3);
+
+    const float s0 = a00 * a11 - a10 * a01, s1 = a00 * a12 - a10 * a02, s2 = a00 * a13 - a10 * a03;
+    const float s3 = a01 * a12 - a11 * a02, s4 = a01 * a13 - a11 * a03, s5 = a02 * a13 - a12 * a03;
+    const float c5 = a22 * a33 - a32 * a23, c4 = a21 * a33 - a31 * a23, c3 = a21 * a32 - a31 * a22;
+    const float c2 = a20 * a33 - a30 * a23, c1 = a20 * a32 - a30 * a22, c0 = a20 * a31 - a30 * a21;
+
+    const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (std::fabs(det) < 1e-20f) return Mat4::identity();
+    const float inv = 1.0f / det;
+
+    // Rows of the inverse, stored transposed into the columns
+    const float r[4][4] = {
+        {(a11 * c5 - a12 * c4 + a13 * c3), (-a01 * c5 + a02 * c4 - a03 * c3),
+         (a31 * s5 - a32 * s4 + a33 * s3), (-a21 * s5 + a22 * s4 - a23 * s3)},
+        {(-a10 * c5 + a12 * c2 - a13 * c1), (a00 * c5 - a02 * c2 + a03 * c1),
+         (-a30 * s5 + a32 * s2 - a33 * s1), (a20 * s5 - a22 * s2 + a23 * s1)},
+        {(a10 * c4 - a11 * c2 + a13 * c0), (-a00 * c4 + a01 * c2 - a03 * c0),
+         (a30 * s4 - a31 * s2 + a33 * s0), (-a20 * s4 + a21 * s2 - a23 * s0)},
+        {(-a10 * c3 + a11 * c1 - a12 * c0), (a00 * c3 - a01 * c1 + a02 * c0),
+         (-a30 * s3 + a31 * s1 - a32 * s0), (a20 * s3 - a21 * s1 + a22 * s0)},
+    };
+    Mat4 out;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) out.cols[col][row] = r[row][col] * inv;
+    }
+    return out;
+}
+
+Frustum Frustum::fromMatrix(const Mat4& m) {
+    // Gribb/Hartmann: clip-space bounds -w <= x,y <= w and 0 <= z <= w as row combinations
+    auto row = [&](int r) { return Vec4{m.at(r, 0), m.at(r, 1), m.at(r, 2), m.at(r, 3)}; };
+    const Vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+    const Vec4 raw[kCount] = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2};
+    Frustum f;
+    for (int i = 0; i < kCount; ++i) {
+        float len = length(raw[i].xyz());
+        float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        f.planes[i] = {raw[i].xyz() * inv, raw[i].w * inv};
+    }
+    return f;
+}
+
+} // namespace aurora::math
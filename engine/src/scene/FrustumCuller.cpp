@@ -0,0 +1,65 @@
+#include "aurora/scene/FrustumCuller.h"
+#include "aurora/JobSystem.h"
+#include "aurora/Profiler.h"
+#include "aurora/math/Batch.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace aurora::scene {
+
+namespace {
+// Spheres per block: 16 KB of each component array, a multiple of every SIMD width. Blocks
+// are the unit of parallelism and of output packing.
+constexpr uint32_t kBlockSize = 4096;
+// Below this many blocks the whole test runs inline; job overhead would dominate
+constexpr uint32_t kParallelMinBlocks = 4;
+}
+
+void FrustumCuller::resize(size_t count) {
+    x_.resize(count);
+    y_.resize(count);
+    z_.resize(count);
+    radius_.resize(count);
+}
+
+const std::vector<uint32_t>& FrustumCuller::cull(const math::Frustum& frustum, JobSystem* jobs) {
+    AURORA_PROFILE_ZONE("FrustumCuller::cull");
+    const auto start = std::chrono::high_resolution_clock::now();
+    const auto count = static_cast<uint32_t>(size());
+    const uint32_t blocks = (count + kBlockSize - 1) / kBlockSize;
+    // Block b writes its indices starting at b * kBlockSize, so blocks never share output
+    visible_.resize(count);
+    blockVisible_.assign(blocks, 0);
+    auto cullBlocks = [&](uint32_t first, uint32_t last) {
+        for (uint32_t b = first; b < last; ++b) {
+            const uint32_t begin = b * kBlockSize;
+            const uint32_t n = std::min(kBlockSize, count - begin);
+            blockVisible_[b] = static_cast<uint32_t>(math::cullSpheres(
+                frustum, x_.data() + begin, y_.data() + begin, z_.data() + begin, radius_.data() + begin, begin,
+                visible_.data() + begin, n));
+        }
+    };
+    if (jobs && blocks >= kParallelMinBlocks) jobs->parallelFor(0, blocks, cullBlocks);
+    else cullBlocks(0, blocks);
+
+    // Pack the blocks' runs; each moves towards the front, never past an unread one. A run
+    // already in place (every earlier block fully visible) is left alone: std::copy must not
+    // start its output inside the input.
+    uint32_t visible = blocks ? blockVisible_[0] : 0;
+    for (uint32_t b = 1; b < blocks; ++b) {
+        if (visible != b * kBlockSize) {
+            const uint32_t* run = visible_.data() + b * kBlockSize;
+            std::copy(run, run + blockVisible_[b], visible_.data() + visible);
+        }
+        visible += blockVisible_[b];
+    }
+    visible_.resize(visible);
+
+    stats_.tested = count;
+    stats_.visible = visible;
+    stats_.ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return visible_;
+}
+
+} // namespace aurora::scene
@@ -0,0 +1,262 @@
+#include "aurora/scene/TransformHierarchy.h"
+#include "aurora/JobSystem.h"
+#include "aurora/Profiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace aurora::scene {
+
+namespace {
+// Levels smaller than this are updated inline; job overhead would dominate
+constexpr uint32_t kParallelMinNodes = 4096;
+constexpr uint32_t kMinGrain = 1024;
+}
+
+bool TransformHierarchy::alive(Node node) const {
+    return node.index < generation_.size() && generation_[node.index] == node.generation &&
+           slotOf_[node.index] != kNone;
+}
+
+uint32_t TransformHierarchy::slotOf(Node node, const char* what) const {
+    if (!alive(node)) throw std::runtime_error(std::string("scene::TransformHierarchy::") + what + " on a dead node");
+    return slotOf_[node.index];
+}
+
+void TransformHierarchy::markDirty(uint32_t slot) {
+    if (dirty_[slot]) return;
+    dirty_[slot] = 1;
+    const uint32_t index = nodeAt_[slot];
+    dirtyNodes_.push_back({index, generation_[index]});
+}
+
+void TransformHierarchy::link(uint32_t index, uint32_t parentIndex) {
+    uint32_t& head = parentIndex == kNone ? firstRoot_ : firstChild_[parentIndex];
+    parentOf_[index] = parentIndex;
+    prevSibling_[index] = kNone;
+    nextSibling_[index] = head;
+    if (head != kNone) prevSibling_[head] = index;
+    head = index;
+}
+
+void TransformHierarchy::unlink(uint32_t index) {
+    const uint32_t prev = prevSibling_[index], next = nextSibling_[index];
+    if (prev != kNone) nextSibling_[prev] = next;
+    else if (parentOf_[index] == kNone) firstRoot_ = next;
+    else firstChild_[parentOf_[index]] = next;
+    if (next != kNone) prevSibling_[next] = prev;
+    parentOf_[index] = prevSibling_[index] = nextSibling_[index] = kNone;
+}
+
+Node TransformHierarchy::create(const LocalTransform& local, Node parent) {
+    uint32_t parentIndex = kNone;
+    if (parent.valid()) {
+        slotOf(parent, "create");
+        parentIndex = parent.index;
+    }
+    uint32_t index;
+    if (!freeIndices_.empty()) {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(generation_.size());
+        generation_.push_back(0);
+        parentOf_.push_back(kNone);
+        firstChild_.push_back(kNone);
+        nextSibling_.push_back(kNone);
+        prevSibling_.push_back(kNone);
+        slotOf_.push_back(kNone);
+    }
+    // Appended out of depth order; update() re-sorts before it walks the levels
+    const uint32_t slot = static_cast<uint32_t>(nodeAt_.size());
+    slotOf_[index] = slot;
+    nodeAt_.push_back(index);
+    parentSlot_.push_back(kNone);
+    local_.push_back(local);
+    world_.emplace_back();
+    dirty_.push_back(0);
+    link(index, parentIndex);
+    markDirty(slot);
+    layoutDirty_ = true;
+    ++liveCount_;
+    return {index, generation_[index]};
+}
+
+void TransformHierarchy::destroy(Node node) {
+    slotOf(node, "destroy");
+    unlink(node.index);
+    std::vector<uint32_t> stack{node.index};
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        for (uint32_t c = firstChild_[index]; c != kNone; c = nextSibling_[c]) stack.push_back(c);
+        // The slot stays behind as a hole until the next re-sort drops it
+        nodeAt_[slotOf_[index]] = kNone;
+        slotOf_[index] = kNone;
+        parentOf_[index] = firstChild_[index] = nextSibling_[index] = prevSibling_[index] = kNone;
+        ++generation_[index];
+        freeIndices_.push_back(index);
+        --liveCount_;
+    }
+    layoutDirty_ = true;
+}
+
+void TransformHierarchy::setParent(Node node, Node parent) {
+    const uint32_t slot = slotOf(node, "setParent");
+    uint32_t parentIndex = kNone;
+    if (parent.valid()) {
+        slotOf(parent, "setParent");
+        for (uint32_t a = parent.index; a != kNone; a = parentOf_[a]) {
+            if (a == node.index) throw std::runtime_error("scene::TransformHierarchy::setParent would create a cycle");
+        }
+        parentIndex = parent.index;
+    }
+    if (parentOf_[node.index] == parentIndex) return;
+    unlink(node.index);
+    link(node.index, parentIndex);
+    markDirty(slot);
+    layoutDirty_ = true;
+}
+
+Node TransformHierarchy::parent(Node node) const {
+    slotOf(node, "parent");
+    const uint32_t p = parentOf_[node.index];
+    return p == kNone ? Node{} : Node{p, generation_[p]};
+}
+
+const LocalTransform& TransformHierarchy::local(Node node) const {
+    return local_[slotOf(node, "local")];
+}
+
+void TransformHierarchy::setLocal(Node node, const LocalTransform& local) {
+    const uint32_t slot = slotOf(node, "setLocal");
+    local_[slot] = local;
+    markDirty(slot);
+}
+
+void TransformHierarchy::setPosition(Node node, const math::Vec3& position) {
+    const uint32_t slot = slotOf(node, "setPosition");
+    local_[slot].position = position;
+    markDirty(slot);
+}
+
+void TransformHierarchy::setRotation(Node node, const math::Quat& rotation) {
+    const uint32_t slot = slotOf(node, "setRotation");
+    local_[slot].rotation = rotation;
+    markDirty(slot);
+}
+
+void TransformHierarchy::setScale(Node node, const math::Vec3& scale) {
+    const uint32_t slot = slotOf(node, "setScale");
+    local_[slot].scale = scale;
+    markDirty(slot);
+}
+
+// Breadth-first from the roots: yields the depth order directly, with siblings adjacent
+void TransformHierarchy::resort() {
+    AURORA_PROFILE_ZONE("TransformHierarchy::resort");
+    std::vector<uint32_t> order;
+    order.reserve(liveCount_);
+    for (uint32_t r = firstRoot_; r != kNone; r = nextSibling_[r]) order.push_back(r);
+    levelStart_.assign(1, 0);
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t end = order.size();
+        levelStart_.push_back(static_cast<uint32_t>(end));
+        for (size_t i = begin; i < end; ++i) {
+            for (uint32_t c = firstChild_[order[i]]; c != kNone; c = nextSibling_[c]) order.push_back(c);
+        }
+        begin = end;
+    }
+
+    const size_t n = order.size();
+    std::vector<LocalTransform> local(n);
+    std::vector<math::Mat4> world(n);
+    std::vector<uint8_t> dirty(n);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t old = slotOf_[order[i]];
+        local[i] = local_[old];
+        world[i] = world_[old];
+        dirty[i] = dirty_[old];
+    }
+    for (size_t i = 0; i < n; ++i) slotOf_[order[i]] = static_cast<uint32_t>(i);
+    parentSlot_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t p = parentOf_[order[i]];
+        parentSlot_[i] = p == kNone ? kNone : slotOf_[p];
+    }
+    nodeAt_ = std::move(order);
+    local_ = std::move(local);
+    world_ = std::move(world);
+    dirty_ = std::move(dirty);
+}
+
+void TransformHierarchy::updateLevel(uint32_t begin, uint32_t end, std::vector<Node>& changed) {
+    for (uint32_t s = begin; s < end; ++s) {
+        const uint32_t p = parentSlot_[s];
+        if (!dirty_[s] && (p == kNone || !dirty_[p])) continue;
+        const LocalTransform& l = local_[s];
+        const math::Mat4 m = math::Mat4::trs(l.position, l.rotation, l.scale);
+        world_[s] = p == kNone ? m : world_[p] * m;
+        // Flag it for its children on the next level; cleared when the update ends
+        dirty_[s] = 1;
+        changed.push_back({nodeAt_[s], generation_[nodeAt_[s]]});
+    }
+}
+
+void TransformHierarchy::update(JobSystem* jobs) {
+    AURORA_PROFILE_ZONE("TransformHierarchy::update");
+    stats_ = {};
+    changed_.clear();
+    if (layoutDirty_) {
+        resort();
+        layoutDirty_ = false;
+        stats_.resorted = true;
+    }
+
+    // Levels holding flagged nodes; everything above the shallowest one is untouched
+    const uint32_t levels = depthCount();
+    std::vector<uint8_t> levelFlagged(levels, 0);
+    uint32_t firstLevel = levels;
+    for (Node n : dirtyNodes_) {
+        if (!alive(n)) continue;
+        const uint32_t slot = slotOf_[n.index];
+        const uint32_t level = static_cast<uint32_t>(
+            std::upper_bound(levelStart_.begin(), levelStart_.end(), slot) - levelStart_.begin() - 1);
+        levelFlagged[level] = 1;
+        firstLevel = std::min(firstLevel, level);
+        ++stats_.dirtyNodes;
+    }
+    dirtyNodes_.clear();
+
+    // One output list per job thread, plus one for a caller outside the job system
+    const uint32_t threads = jobs ? jobs->threadCount() : 0;
+    changedPerThread_.resize(threads + 1);
+    for (auto& list : changedPerThread_) list.clear();
+    size_t changedSoFar = 0;
+    bool previousLevelChanged = false;
+    for (uint32_t level = firstLevel; level < levels; ++level) {
+        // A level needs a pass if it holds flagged nodes or children of recomputed ones
+        if (!levelFlagged[level] && !previousLevelChanged) continue;
+        const uint32_t begin = levelStart_[level], end = levelStart_[level + 1];
+        ++stats_.levelsVisited;
+        if (jobs && end - begin >= kParallelMinNodes) {
+            jobs->parallelFor(begin, end, [this, jobs, threads](uint32_t first, uint32_t last) {
+                const uint32_t t = jobs->currentThreadIndex();
+                updateLevel(first, last, changedPerThread_[t < threads ? t : threads]);
+            }, kMinGrain);
+        } else {
+            updateLevel(begin, end, changedPerThread_[threads]);
+        }
+        size_t total = 0;
+        for (const auto& list : changedPerThread_) total += list.size();
+        previousLevelChanged = total > changedSoFar;
+        changedSoFar = total;
+    }
+
+    for (const auto& list : changedPerThread_) changed_.insert(changed_.end(), list.begin(), list.end());
+    for (Node n : changed_) dirty_[slotOf_[n.index]] = 0;
+    stats_.recomputed = static_cast<uint32_t>(changed_.size());
+}
+
+} // namespace aurora::scene
@@ -1,5 +1,6 @@
 #include <aurora/Engine.h>
 #include <iostream>
+#include <cstring>
 
 class MinimalGame : public aurora::IGame {
 public:
@@ -7,15 +8,22 @@ public:
         std::cout << "MinimalGame::onInit\n"; (void)engine;
     }
     void onUpdate(aurora::Engine& engine, float dt) override {
-        (void)engine; (void)dt; // will add logic later
+        (void)dt; // will add logic later
+        // Headless runs have no window to close; stop after a fixed number of frames
+        if (engine.isHeadless() && ++frames_ >= 300) engine.requestExit();
     }
     void onShutdown(aurora::Engine& engine) override {
         std::cout << "MinimalGame::onShutdown\n"; (void)engine;
     }
+private:
+    int frames_ = 0;
 };
 
-int main() {
+int main(int argc, char** argv) {
     aurora::EngineConfig cfg; cfg.title = "Aurora Minimal Game"; cfg.width=1280; cfg.height=720;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) cfg.headless = true;
+    }
     aurora::Engine engine(cfg);
     MinimalGame game;
     engine.run(game);
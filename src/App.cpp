@@ -10,6 +10,8 @@
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 
 // Optional verbose logging toggle
 #ifdef AURORA_VERBOSE_LOG
@@ -31,10 +33,45 @@
 #include "vulkan/Renderer.h"
 #include "window/Window.h"
 #include "render/Mesh.h"
+#include "render/MeshOptimizer.h"
+#include "io/FileSystem.h"
 #include "vulkan/BufferUtils.h"
+#include "vulkan/Offscreen.h"
+#include "vulkan/PipelineCache.h"
+#include "vulkan/MemoryAllocator.h"
+#include "vulkan/UploadManager.h"
+#include "vulkan/FrameAllocator.h"
+#include "vulkan/ObjectBuffer.h"
+#include "vulkan/CommandRecorder.h"
+#include "vulkan/GpuDrivenPass.h"
+#include "vulkan/RenderGraph.h"
+#include "vulkan/DescriptorAllocator.h"
+#include "vulkan/BindlessTable.h"
+#include "vulkan/PipelineStateCache.h"
+#include "vulkan/MaterialTable.h"
+#include <aurora/JobSystem.h>
+#include <aurora/Profiler.h>
 
-    App::App(int width, int height, const char* title) {
-        window_ = new Window(width, height, title);
+namespace {
+// Wall clock in seconds; independent of GLFW so headless runs never touch it
+double nowSeconds() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+}
+
+    App::App(int width, int height, const char* title)
+        : App(AppConfig{width, height, title}) {}
+
+    App::App(const AppConfig& cfg)
+        : headless_(cfg.headless), width_(cfg.width), height_(cfg.height),
+          framesInFlight_(std::clamp(cfg.framesInFlight, 1u, 3u)), pipelineCachePath_(cfg.pipelineCachePath),
+          quantizeVertices_(cfg.quantizeVertices), packPath_(cfg.packPath),
+          recordThreads_(cfg.recordThreads), gpuDriven_(cfg.gpuDriven), bindless_(cfg.bindless), jobs_(cfg.jobs) {
+        if (!jobs_) jobs_ = ownedJobs_ = new aurora::JobSystem();
+        if (!headless_) {
+            window_ = new Window(cfg.width, cfg.height, cfg.title);
+        }
         initVulkan();
     }
 
@@ -44,53 +81,94 @@
             delete window_;
             window_ = nullptr;
         }
+        delete ownedJobs_;
+        ownedJobs_ = jobs_ = nullptr;
     }
 
     // helpers and swapchain responsibilities moved to vulkan::SwapchainManager and vkutils
 
     void App::initVulkan() {
+        AURORA_PROFILE_ZONE("App::initVulkan");
         vk_ = new VkObjects();
+        files_ = new io::FileSystem();
+        // Same search order the shader loader always used: build tree first, then source tree
+        for (const char* root : {"build", ".", "../build", ".."}) files_->addLooseRoot(root);
+        if (!packPath_.empty()) {
+            for (const char* root : {"build", ".", "../build"}) {
+                if (files_->mountPack((std::filesystem::path(root) / packPath_).string())) break;
+            }
+        }
+        vk_->files = files_;
+        vk_->headless = headless_;
+        vk_->maxFramesInFlight = framesInFlight_;
+        vk_->pipelineCachePath = pipelineCachePath_;
+        vk_->vertexFormat = quantizeVertices_ ? render::VertexFormat::Quantized : render::VertexFormat::Float32;
+        vk_->gpuDriven = gpuDriven_; // cleared by device creation if unsupported
+        vk_->bindless = bindless_;   // likewise
     std::cout << "App: creating Vulkan instance..." << std::endl;
     vulkan::InstanceManager::createInstance(vk_);
     std::cout << "App: instance created" << std::endl;
-    createSurface();
-    std::cout << "App: surface created" << std::endl;
+    if (!headless_) {
+        createSurface();
+        std::cout << "App: surface created" << std::endl;
+    }
     vulkan::DeviceManager::pickPhysicalDevice(vk_);
     std::cout << "App: physical device selected" << std::endl;
     vulkan::DeviceManager::createLogicalDevice(vk_);
     std::cout << "App: logical device created" << std::endl;
-    vulkan::SwapchainManager::createSwapchain(vk_, window_->getNativeWindow());
-    std::cout << "App: swapchain created" << std::endl;
-    vulkan::SwapchainManager::createImageViews(vk_);
-    std::cout << "App: image views created" << std::endl;
+    vk_->allocator = new vulkan::MemoryAllocator(vk_->device, vk_->physicalDevice);
+    vk_->uploads = new vulkan::UploadManager(vk_, vk_->maxFramesInFlight);
+    vk_->frameAllocator = new vulkan::FrameAllocator(vk_, vk_->maxFramesInFlight);
+    vk_->descriptorLayouts = new vulkan::DescriptorLayoutCache(vk_->device);
+    vk_->descriptors = new vulkan::DescriptorAllocator(vk_, vk_->maxFramesInFlight);
+    if (vk_->bindless) vk_->bindlessTable = new vulkan::BindlessTable(vk_);
+    bindless_ = vk_->bindless;
+    // Before the pipeline: its layout includes the object buffer's (and bindless) set layouts
+    vk_->objects = new vulkan::ObjectBuffer(vk_);
+    vulkan::PipelineCache::create(vk_);
+    vk_->pipelines = new vulkan::PipelineStateCache(vk_);
+    // Before the pipelines are requested (createGraphicsPipeline); after the bindless table
+    vk_->materials = new vulkan::MaterialTable(vk_);
+    if (headless_) {
+        vulkan::OffscreenTargets::createTargets(vk_, static_cast<uint32_t>(width_), static_cast<uint32_t>(height_));
+        std::cout << "App: offscreen targets created (headless)" << std::endl;
+    } else {
+        vulkan::SwapchainManager::createSwapchain(vk_, window_->getNativeWindow());
+        std::cout << "App: swapchain created" << std::endl;
+        vulkan::SwapchainManager::createImageViews(vk_);
+        std::cout << "App: image views created" << std::endl;
+    }
 
     // swapchain format/extent are set by SwapchainManager
         vulkan::Renderer::createRenderPass(vk_);
         std::cout << "App: render pass created" << std::endl;
+        // Compiles on a job thread while the rest of the renderer is set up
         vulkan::Renderer::createGraphicsPipeline(vk_);
-        std::cout << "App: graphics pipeline created" << std::endl;
-    vulkan::SwapchainManager::createFramebuffers(vk_);
-    std::cout << "App: framebuffers created" << std::endl;
+        std::cout << "App: graphics pipeline requested" << std::endl;
         vulkan::Renderer::createCommandPool(vk_);
         std::cout << "App: command pool created" << std::endl;
         vulkan::Renderer::createCommandBuffers(vk_);
-        std::cout << "App: command buffers created" << std::endl;
+        // After the GPU profiler's query pool: the graph times its passes only when it exists
+        vk_->graph = new vulkan::RenderGraph(vk_, vk_->maxFramesInFlight);
+        vk_->recorder = new vulkan::CommandRecorder(vk_, vk_->maxFramesInFlight, *jobs_, recordThreads_);
+        std::cout << "App: command buffers created (up to " << vk_->recorder->maxPartitions() << " recording jobs)" << std::endl;
         vulkan::Renderer::createSyncObjects(vk_);
     std::cout << "App: sync objects created" << std::endl;
 
-    // Create triangle vertex buffer via Mesh abstraction
-    auto tri = render::Mesh::makeTriangle();
-    vk_->vertexCount = static_cast<uint32_t>(tri.vertices().size());
-    VkDeviceSize sizeBytes = sizeof(Vertex) * tri.vertices().size();
-    vkbuf::createBuffer(vk_->device, vk_->physicalDevice, sizeBytes,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        vk_->vertexBuffer, vk_->vertexBufferMemory);
-    // Upload data
-    void* mapped = nullptr;
-    vkMapMemory(vk_->device, vk_->vertexBufferMemory, 0, sizeBytes, 0, &mapped);
-    std::memcpy(mapped, tri.vertices().data(), sizeBytes);
-    vkUnmapMemory(vk_->device, vk_->vertexBufferMemory);
+    // Triangle mesh in device-local memory; copied in by the first frame's upload batch
+    render::Mesh triangle = render::Mesh::makeTriangle();
+    render::optimizeMesh(triangle);
+    vk_->mesh = triangle.upload(vk_, vk_->vertexFormat);
+    if (vk_->gpuDriven) {
+        vk_->gpuPass = new vulkan::GpuDrivenPass(vk_);
+        std::cout << "App: GPU-driven pass created (compute culling + indirect draws)" << std::endl;
+    }
+    gpuDriven_ = vk_->gpuDriven;
+    // The first frame should not come up empty
+    if (!vk_->pipelines->wait(vk_->materials->pipeline(aurora::kDefaultMaterial))) {
+        throw std::runtime_error("Failed to create graphics pipeline");
+    }
+    std::cout << "App: graphics pipeline ready" << std::endl;
     }
 
     void App::createSurface() {
@@ -108,16 +186,34 @@
 
     void App::cleanupVulkan() {
         if (!vk_) return;
-        // Destroy sync objects
-        for (auto s : vk_->renderFinishedSemaphores) if (s) vkDestroySemaphore(vk_->device, s, nullptr);
-        for (auto s : vk_->imageAvailableSemaphores) if (s) vkDestroySemaphore(vk_->device, s, nullptr);
-        for (auto f : vk_->inFlightFences) if (f) vkDestroyFence(vk_->device, f, nullptr);
-
-        // Destroy command pool
-        if (vk_->commandPool) vkDestroyCommandPool(vk_->device, vk_->commandPool, nullptr);
+        // Frames in flight may still be executing
+        if (vk_->device) vkDeviceWaitIdle(vk_->device);
+        delete vk_->recorder; vk_->recorder = nullptr;
+        delete vk_->gpuPass; vk_->gpuPass = nullptr;
+        delete vk_->graph; vk_->graph = nullptr;
+        // Waits for background compiles, which use the render pass and pipeline layout
+        delete vk_->pipelines; vk_->pipelines = nullptr;
+        delete vk_->materials; vk_->materials = nullptr;
+        // Sync objects, command pool, query pool, pipeline and render pass
+        vulkan::Renderer::cleanupRenderer(vk_);
 
     // Destroy swapchain and related
     vulkan::SwapchainManager::cleanupSwapchain(vk_);
+    if (vk_->headless) vulkan::OffscreenTargets::destroyImages(vk_);
+    // Written back last so it also holds pipelines rebuilt during the session
+    vulkan::PipelineCache::destroy(vk_);
+    render::Mesh::destroy(vk_, vk_->mesh);
+    delete vk_->objects; vk_->objects = nullptr;
+    delete vk_->bindlessTable; vk_->bindlessTable = nullptr;
+    delete vk_->descriptors; vk_->descriptors = nullptr;
+    delete vk_->descriptorLayouts; vk_->descriptorLayouts = nullptr; // after every user of a layout
+    delete vk_->uploads; vk_->uploads = nullptr;
+    delete vk_->frameAllocator; vk_->frameAllocator = nullptr;
+    if (vk_->allocator) {
+        vk_->allocator->logStats();
+        delete vk_->allocator;
+        vk_->allocator = nullptr;
+    }
 
         // Destroy debug messenger (managed by InstanceManager)
     #ifdef AURORA_ENABLE_VALIDATION
@@ -128,52 +224,62 @@
         if (vk_->surface) vkDestroySurfaceKHR(vk_->instance, vk_->surface, nullptr);
         if (vk_->instance) vkDestroyInstance(vk_->instance, nullptr);
         delete vk_; vk_ = nullptr;
+        if (files_) {
+            files_->logStats();
+            delete files_;
+            files_ = nullptr;
+        }
     }
 
     void App::mainLoop() {
-        lastFPSTime_ = glfwGetTime();
+        if (!window_) throw std::runtime_error("App::run requires a window; drive headless apps through frame()");
+        lastFPSTime_ = nowSeconds();
         frameCount_ = 0;
         std::cout << "App: entering mainLoop" << std::endl;
         while (!window_->shouldClose()) {
             window_->pollEvents();
             // If window was resized, recreate swapchain-dependent resources
-            if (window_->wasResized()) {
-                recreateResources();
+            if (window_->wasResized() && !recreateResources()) {
+                continue;
             }
             vulkan::Renderer::drawFrame(vk_, window_->getNativeWindow());
 
             // FPS counting
             frameCount_++;
-            double now = glfwGetTime();
+            double now = nowSeconds();
             double elapsed = now - lastFPSTime_;
             if (elapsed >= 1.0) {
                 fps_ = static_cast<int>(frameCount_ / elapsed + 0.5);
                 frameCount_ = 0;
                 lastFPSTime_ = now;
                 // update window title with FPS (Window encapsulates GLFW)
-                std::string title = "Aurora3D - FPS: " + std::to_string(fps_);
+                std::string title = "Aurora3D - FPS: " + std::to_string(fps_.load());
                 window_->setTitle(title);
             }
         }
     }
 
-    void App::recreateResources() {
-        if (!vk_ || !vk_->device) return;
+    bool App::recreateResources() {
+        AURORA_PROFILE_ZONE("App::recreateResources");
+        if (!vk_ || !vk_->device || !window_) return true;
     std::cout << "App: recreating resources due to resize" << std::endl;
-    // wait and recreate swapchain and renderer resources
-    vulkan::SwapchainManager::recreateSwapchain(vk_, window_->getNativeWindow());
+    // recreate swapchain and renderer resources without waiting for frames in flight
+    if (!vulkan::SwapchainManager::recreateSwapchain(vk_, window_->getNativeWindow())) {
+        return false;
+    }
     std::cout << "App: swapchain recreation returned" << std::endl;
         try {
             vulkan::Renderer::recreate(vk_, window_->getNativeWindow());
             std::cout << "App: renderer recreation returned" << std::endl;
         } catch (const std::exception &e) {
             std::cerr << "App: exception during Renderer::recreate: " << e.what() << std::endl;
-            return;
+            return false;
         } catch (...) {
             std::cerr << "App: unknown exception during Renderer::recreate" << std::endl;
-            return;
+            return false;
         }
         window_->clearResizedFlag();
+        return true;
     }
 
     void App::run() {
@@ -189,26 +295,81 @@
     }
 
     bool App::frame() {
+        AURORA_PROFILE_ZONE("App::frame");
+        if (!pumpEvents()) return false;
+        renderFrame();
+        return true;
+    }
+
+    bool App::pumpEvents() {
+        if (!window_) return true;
         if (window_->shouldClose()) return false;
+        {
+            AURORA_PROFILE_ZONE("Window::pollEvents");
+            window_->pollEvents();
+        }
+        // The title can only be set from the main thread
+        int fps = fps_.load(std::memory_order_relaxed);
+        if (fps != shownFps_) {
+            shownFps_ = fps;
+            window_->setTitle("Aurora3D - FPS: " + std::to_string(fps));
+        }
+        return true;
+    }
+
+    void App::renderFrame() {
+        AURORA_PROFILE_ZONE("App::renderFrame");
         if (lastFPSTime_ == 0.0) {
-            lastFPSTime_ = glfwGetTime();
+            lastFPSTime_ = nowSeconds();
         }
-        window_->pollEvents();
-        if (window_->wasResized()) {
-            recreateResources();
+        if (window_ && window_->wasResized() && !recreateResources()) {
+            return; // minimized: nothing to draw into this frame
         }
-        vulkan::Renderer::drawFrame(vk_, window_->getNativeWindow());
+        vulkan::Renderer::drawFrame(vk_, window_ ? window_->getNativeWindow() : nullptr);
         frameCount_++;
-        double now = glfwGetTime();
+        double now = nowSeconds();
         double elapsed = now - lastFPSTime_;
         if (elapsed >= 1.0) {
-            fps_ = static_cast<int>(frameCount_ / elapsed + 0.5);
+            fps_.store(static_cast<int>(frameCount_ / elapsed + 0.5), std::memory_order_relaxed);
             frameCount_ = 0;
             lastFPSTime_ = now;
-            std::string title = "Aurora3D - FPS: " + std::to_string(fps_);
-            window_->setTitle(title);
+            if (!window_) {
+                AURORA_LOG_VERBOSE("App: headless FPS: " << fps_.load());
+            }
         }
-        return true;
+    }
+
+    const RenderTimings& App::lastFrameTimings() const {
+        return vk_->lastFrameTimings;
+    }
+
+    void App::setDrawList(const aurora::DrawList* list) {
+        vk_->drawList = list;
+    }
+
+    uint32_t App::createMaterial(const aurora::MaterialDesc& desc) {
+        return vk_->materials->create(desc);
+    }
+
+    void App::updateObjects(const uint32_t* objects, const aurora::math::Mat4* worlds, size_t count) {
+        vk_->objects->set(objects, worlds, count);
+    }
+
+    void App::meshBounds(uint32_t, aurora::math::Vec3& center, float& radius) const {
+        // Every mesh id draws the built-in mesh for now (see Renderer::recordMainPassBatches)
+        const render::GpuMesh& mesh = vk_->mesh;
+        center = {mesh.boundsCenter[0], mesh.boundsCenter[1], mesh.boundsCenter[2]};
+        radius = mesh.boundsRadius;
+    }
+
+    PipelineCacheStats App::pipelineCacheStats() const {
+        PipelineCacheStats stats = vulkan::PipelineCache::stats(vk_);
+        if (vk_->pipelines) {
+            const vulkan::PipelineStateCache::Stats states = vk_->pipelines->stats();
+            stats.stateRequests = states.requests;
+            stats.stateDeduplicated = states.deduplicated;
+        }
+        return stats;
     }
 
     void App::resetFrameStats() {
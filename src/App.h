@@ -1,14 +1,48 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
+#include <cstdint>
 
 struct VkObjects;
+struct RenderTimings;
+struct PipelineCacheStats;
 class Window;
+namespace io { class FileSystem; }
+namespace aurora { class DrawList; class JobSystem; struct MaterialDesc; }
+namespace aurora::math { struct Mat4; struct Vec3; }
+
+struct AppConfig {
+    int width = 1280;
+    int height = 720;
+    const char* title = "Aurora3D";
+    // Skip window/surface/swapchain and render into offscreen images (CI, render farm)
+    bool headless = false;
+    // Frames the CPU may record ahead of the GPU (clamped to 1..3). 2 = lower latency, 3 = more throughput
+    uint32_t framesInFlight = 2;
+    // On-disk VkPipelineCache blob; empty keeps the cache in memory only
+    std::string pipelineCachePath = "aurora_pipeline.cache";
+    // 16-byte quantized vertices instead of 40-byte float ones
+    bool quantizeVertices = true;
+    // Asset pack mounted into the virtual file system; looked up in build/, . and ../build/
+    // like loose files. Loose files are used for anything the pack does not contain.
+    std::string packPath = "aurora.pak";
+    // Max parallel ranges when recording the main pass; 0 = one per job system thread
+    uint32_t recordThreads = 0;
+    // Cull and draw the draw list on the GPU (vulkan::GpuDrivenPass) when the device supports it
+    bool gpuDriven = false;
+    // Bind textures/buffers through one descriptor-indexed table (vulkan::BindlessTable) when
+    // the device supports it
+    bool bindless = false;
+    // Job system for parallel work (must outlive the App); null = the App creates its own
+    aurora::JobSystem* jobs = nullptr;
+};
 
 class App {
 public:
     App(int width, int height, const char* title);
+    explicit App(const AppConfig& cfg);
     ~App();
 
     App(const App&) = delete;
@@ -17,7 +51,30 @@ public:
     void run();
     // New: perform a single frame (returns false when window requests close)
     bool frame();
+    // frame() in two halves for a separate render thread. pumpEvents polls the window and
+    // must run on the main thread (returns false when the window requests close);
+    // renderFrame records, submits and presents and may run on any one thread.
+    bool pumpEvents();
+    void renderFrame();
     void resetFrameStats();
+    bool isHeadless() const { return headless_; }
+    // AppConfig::gpuDriven was requested and the device supports it
+    bool isGpuDriven() const { return gpuDriven_; }
+    // AppConfig::bindless was requested and the device supports it
+    bool isBindless() const { return bindless_; }
+    // Renderer timings (fence/acquire/submit/present) of the last frame() call
+    const RenderTimings& lastFrameTimings() const;
+    PipelineCacheStats pipelineCacheStats() const;
+    io::FileSystem& fileSystem() { return *files_; }
+    // Rendered every frame; must outlive the App
+    void setDrawList(const aurora::DrawList* list);
+    // Id for DrawCommand::material; any thread. Its pipeline is requested by the next frame.
+    uint32_t createMaterial(const aurora::MaterialDesc& desc);
+    // World matrices for DrawCommand::object, uploaded with the next rendered frame. Call from
+    // the thread that renders.
+    void updateObjects(const uint32_t* objects, const aurora::math::Mat4* worlds, size_t count);
+    // Bounding sphere of DrawCommand::mesh in mesh space. Fixed after construction.
+    void meshBounds(uint32_t mesh, aurora::math::Vec3& center, float& radius) const;
 
 private:
     void initWindow(int width, int height, const char* title);
@@ -36,14 +93,29 @@ private:
     void createSyncObjects();
     void mainLoop();
     void cleanupVulkan();
-    void recreateResources();
+    // false while the window is minimized: the resize stays pending and the frame is skipped
+    bool recreateResources();
 
 private:
     Window* window_ = nullptr;
+    bool headless_ = false;
+    int width_ = 0;
+    int height_ = 0;
+    uint32_t framesInFlight_ = 2;
+    std::string pipelineCachePath_;
+    bool quantizeVertices_ = true;
+    std::string packPath_;
+    uint32_t recordThreads_ = 0;
+    bool gpuDriven_ = false;
+    bool bindless_ = false;
+    aurora::JobSystem* jobs_ = nullptr;
+    aurora::JobSystem* ownedJobs_ = nullptr;
+    io::FileSystem* files_ = nullptr;
 
     VkObjects* vk_ = nullptr;
-    // Simple FPS counter (updated in mainLoop)
+    // Simple FPS counter (updated in mainLoop / renderFrame, shown by pumpEvents)
     size_t frameCount_ = 0;
     double lastFPSTime_ = 0.0;
-    int fps_ = 0;
+    std::atomic<int> fps_{0};
+    int shownFps_ = 0;
 };
@@ -0,0 +1,98 @@
+#include "io/Compression.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(AURORA_HAS_LZ4)
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#if defined(AURORA_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace io {
+
+bool codecAvailable(Codec codec) {
+    switch (codec) {
+    case Codec::None: return true;
+#if defined(AURORA_HAS_LZ4)
+    case Codec::LZ4: return true;
+#endif
+#if defined(AURORA_HAS_ZSTD)
+    case Codec::Zstd: return true;
+#endif
+    default: return false;
+    }
+}
+
+const char* codecName(Codec codec) {
+    switch (codec) {
+    case Codec::None: return "none";
+    case Codec::LZ4: return "lz4";
+    case Codec::Zstd: return "zstd";
+    }
+    return "unknown";
+}
+
+void decompress(Codec codec, const void* src, size_t srcSize, void* dst, size_t dstSize) {
+    switch (codec) {
+    case Codec::None:
+        if (srcSize != dstSize) throw std::runtime_error("decompress: stored size mismatch");
+        std::memcpy(dst, src, dstSize);
+        return;
+#if defined(AURORA_HAS_LZ4)
+    case Codec::LZ4: {
+        int n = LZ4_decompress_safe(static_cast<const char*>(src), static_cast<char*>(dst),
+                                    static_cast<int>(srcSize), static_cast<int>(dstSize));
+        if (n < 0 || static_cast<size_t>(n) != dstSize) throw std::runtime_error("decompress: corrupt LZ4 chunk");
+        return;
+    }
+#endif
+#if defined(AURORA_HAS_ZSTD)
+    case Codec::Zstd: {
+        size_t n = ZSTD_decompress(dst, dstSize, src, srcSize);
+        if (ZSTD_isError(n) || n != dstSize) throw std::runtime_error("decompress: corrupt zstd chunk");
+        return;
+    }
+#endif
+    default:
+        break;
+    }
+    throw std::runtime_error(std::string("decompress: codec '") + codecName(codec) + "' not compiled in");
+}
+
+std::vector<uint8_t> compress(Codec codec, const void* src, size_t size, int level) {
+    std::vector<uint8_t> out;
+    switch (codec) {
+#if defined(AURORA_HAS_LZ4)
+    case Codec::LZ4: {
+        out.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(size))));
+        int n = level > 0
+            ? LZ4_compress_HC(static_cast<const char*>(src), reinterpret_cast<char*>(out.data()), static_cast<int>(size),
+                              static_cast<int>(out.size()), level)
+            : LZ4_compress_default(static_cast<const char*>(src), reinterpret_cast<char*>(out.data()), static_cast<int>(size),
+                                   static_cast<int>(out.size()));
+        out.resize(n > 0 ? static_cast<size_t>(n) : 0);
+        break;
+    }
+#endif
+#if defined(AURORA_HAS_ZSTD)
+    case Codec::Zstd: {
+        out.resize(ZSTD_compressBound(size));
+        size_t n = ZSTD_compress(out.data(), out.size(), src, size, level > 0 ? level : ZSTD_CLEVEL_DEFAULT);
+        out.resize(ZSTD_isError(n) ? 0 : n);
+        break;
+    }
+#endif
+    default:
+        (void)src;
+        (void)level;
+        break;
+    }
+    if (out.size() >= size) out.clear();
+    return out;
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "io/PackFormat.h"
+
+namespace io {
+// Codecs are optional: LZ4 / zstd support is compiled in when CMake finds the libraries
+// (AURORA_HAS_LZ4 / AURORA_HAS_ZSTD). Codec::None is always available.
+bool codecAvailable(Codec codec);
+const char* codecName(Codec codec);
+
+// Decode exactly dstSize bytes. Throws std::runtime_error on corrupt input or a missing codec.
+void decompress(Codec codec, const void* src, size_t srcSize, void* dst, size_t dstSize);
+
+// Compress one block; empty result when the codec is unavailable or the data did not shrink
+std::vector<uint8_t> compress(Codec codec, const void* src, size_t size, int level);
+}
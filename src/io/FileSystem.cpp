@@ -0,0 +1,291 @@
+#include "io/FileSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#include "io/Compression.h"
+#include "io/MappedFile.h"
+#include <aurora/Profiler.h>
+
+namespace io {
+
+namespace {
+bool inRange(uint64_t offset, uint64_t size, uint64_t limit) {
+    return offset <= limit && size <= limit - offset;
+}
+
+// Shared between the reading thread and the workers helping with one compressed entry
+struct DecodeJob {
+    const uint8_t* base = nullptr;
+    const PackChunk* chunks = nullptr;
+    uint32_t chunkCount = 0;
+    Codec codec = Codec::None;
+    uint8_t* dst = nullptr;
+    std::vector<uint64_t> dstOffsets;
+
+    std::atomic<uint32_t> next{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t done = 0;
+    std::exception_ptr error;
+
+    // Decode chunks until none are left to claim
+    void run() {
+        for (;;) {
+            uint32_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= chunkCount) return;
+            std::exception_ptr err;
+            try {
+                const PackChunk& c = chunks[i];
+                Codec chunkCodec = c.storedSize == c.rawSize ? Codec::None : codec;
+                decompress(chunkCodec, base + c.offset, c.storedSize, dst + dstOffsets[i], c.rawSize);
+            } catch (...) {
+                err = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (err && !error) error = err;
+            if (++done == chunkCount) cv.notify_all();
+        }
+    }
+};
+}
+
+FileSystem::FileSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 1;
+    }
+    workers_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        workers_.emplace_back([this] { workerMain(); });
+    }
+}
+
+FileSystem::~FileSystem() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopping_ = true;
+    }
+    queueCv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+bool FileSystem::mountPack(const std::string& path) {
+    AURORA_PROFILE_ZONE("FileSystem::mountPack");
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file) return false;
+
+    // Validate everything reads will index into, so a truncated pack fails here and not mid-frame
+    const uint64_t size = file->size();
+    if (size < sizeof(PackHeader)) throw std::runtime_error("FileSystem: " + path + " is too small to be a pack");
+    Pack pack;
+    pack.file = file;
+    pack.header = reinterpret_cast<const PackHeader*>(file->data());
+    const PackHeader& h = *pack.header;
+    if (h.magic != kPackMagic) throw std::runtime_error("FileSystem: " + path + " is not a pack");
+    if (h.version != kPackVersion) throw std::runtime_error("FileSystem: " + path + " has unsupported pack version");
+    if (!inRange(h.tocOffset, uint64_t(h.entryCount) * sizeof(PackEntry), size) ||
+        !inRange(h.chunkTableOffset, uint64_t(h.chunkCount) * sizeof(PackChunk), size) ||
+        !inRange(h.namesOffset, h.namesSize, size) ||
+        h.tocOffset % alignof(PackEntry) != 0 || h.chunkTableOffset % alignof(PackChunk) != 0) {
+        throw std::runtime_error("FileSystem: " + path + " has a corrupt table of contents");
+    }
+    pack.entries = reinterpret_cast<const PackEntry*>(file->data() + h.tocOffset);
+    pack.chunks = reinterpret_cast<const PackChunk*>(file->data() + h.chunkTableOffset);
+    pack.names = reinterpret_cast<const char*>(file->data() + h.namesOffset);
+    Codec missingCodec = Codec::None;
+    for (uint32_t i = 0; i < h.entryCount; ++i) {
+        const PackEntry& e = pack.entries[i];
+        bool ok = inRange(e.offset, e.storedSize, size) && inRange(e.nameOffset, e.nameLength, h.namesSize) &&
+                  (i == 0 || pack.entries[i - 1].pathHash <= e.pathHash);
+        if (ok && static_cast<Codec>(e.codec) != Codec::None) {
+            ok = inRange(e.firstChunk, e.chunkCount, h.chunkCount);
+            uint64_t raw = 0;
+            for (uint32_t c = 0; ok && c < e.chunkCount; ++c) {
+                const PackChunk& chunk = pack.chunks[e.firstChunk + c];
+                ok = inRange(chunk.offset, chunk.storedSize, size);
+                raw += chunk.rawSize;
+            }
+            ok = ok && raw == e.rawSize;
+        } else if (ok) {
+            ok = e.storedSize == e.rawSize;
+        }
+        if (!ok) throw std::runtime_error("FileSystem: " + path + " has a corrupt entry");
+        if (!codecAvailable(static_cast<Codec>(e.codec))) missingCodec = static_cast<Codec>(e.codec);
+    }
+    if (missingCodec != Codec::None) {
+        std::cout << "FileSystem: " << path << " contains " << codecName(missingCodec)
+                  << " entries but the codec is not compiled in; reading them will fail" << std::endl;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mountMutex_);
+    packs_.push_back(std::move(pack));
+    std::cout << "FileSystem: mounted " << path << " (" << h.entryCount << " entries)" << std::endl;
+    return true;
+}
+
+void FileSystem::addLooseRoot(const std::string& dir) {
+    std::unique_lock<std::shared_mutex> lock(mountMutex_);
+    looseRoots_.push_back(dir);
+}
+
+const PackEntry* FileSystem::findEntry(const Pack& pack, std::string_view normalized) const {
+    const uint64_t hash = hashPath(normalized);
+    const PackEntry* end = pack.entries + pack.header->entryCount;
+    const PackEntry* it = std::lower_bound(pack.entries, end, hash,
+                                           [](const PackEntry& e, uint64_t h) { return e.pathHash < h; });
+    for (; it != end && it->pathHash == hash; ++it) {
+        if (std::string_view(pack.names + it->nameOffset, it->nameLength) == normalized) return it;
+    }
+    return nullptr;
+}
+
+bool FileSystem::exists(std::string_view path) const {
+    const std::string normalized = normalizePath(path);
+    std::shared_lock<std::shared_mutex> lock(mountMutex_);
+    for (auto it = packs_.rbegin(); it != packs_.rend(); ++it) {
+        if (findEntry(*it, normalized)) return true;
+    }
+    for (const auto& root : looseRoots_) {
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(std::filesystem::path(root) / normalized, ec)) return true;
+    }
+    return false;
+}
+
+FileData FileSystem::read(std::string_view path) {
+    AURORA_PROFILE_ZONE("FileSystem::read");
+    const std::string normalized = normalizePath(path);
+    std::vector<std::string> roots;
+    {
+        std::shared_lock<std::shared_mutex> lock(mountMutex_);
+        for (auto it = packs_.rbegin(); it != packs_.rend(); ++it) {
+            if (const PackEntry* e = findEntry(*it, normalized)) {
+                Pack pack = *it; // keeps the mapping alive without holding the lock while decoding
+                lock.unlock();
+                packReads_.fetch_add(1, std::memory_order_relaxed);
+                return readEntry(pack, *e);
+            }
+        }
+        roots = looseRoots_;
+    }
+
+    // Development fallback: loose files, mapped the same way
+    for (const auto& root : roots) {
+        std::shared_ptr<MappedFile> file = MappedFile::open((std::filesystem::path(root) / normalized).string());
+        if (!file) continue;
+        looseReads_.fetch_add(1, std::memory_order_relaxed);
+        bytesMapped_.fetch_add(file->size(), std::memory_order_relaxed);
+        FileData fd;
+        fd.data_ = file->data();
+        fd.size_ = file->size();
+        fd.mapped_ = true;
+        fd.owner_ = std::move(file);
+        return fd;
+    }
+    throw std::runtime_error("FileSystem: file not found: " + normalized);
+}
+
+FileData FileSystem::readEntry(const Pack& pack, const PackEntry& entry) {
+    const uint8_t* base = pack.file->data();
+    FileData fd;
+    if (static_cast<Codec>(entry.codec) == Codec::None) {
+        fd.data_ = base + entry.offset;
+        fd.size_ = static_cast<size_t>(entry.rawSize);
+        fd.mapped_ = true;
+        fd.owner_ = pack.file;
+        bytesMapped_.fetch_add(entry.rawSize, std::memory_order_relaxed);
+        return fd;
+    }
+
+    AURORA_PROFILE_ZONE("FileSystem::decompress");
+    auto start = std::chrono::steady_clock::now();
+    auto buffer = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(entry.rawSize));
+    auto job = std::make_shared<DecodeJob>();
+    job->base = base;
+    job->chunks = pack.chunks + entry.firstChunk;
+    job->chunkCount = entry.chunkCount;
+    job->codec = static_cast<Codec>(entry.codec);
+    job->dst = buffer->data();
+    job->dstOffsets.resize(entry.chunkCount);
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < entry.chunkCount; ++i) {
+        job->dstOffsets[i] = offset;
+        offset += job->chunks[i].rawSize;
+    }
+
+    // Helpers hold the job and the mapping; they may start after this thread already finished
+    if (entry.chunkCount > 1) {
+        size_t helpers = std::min<size_t>(entry.chunkCount - 1, workers_.size());
+        std::shared_ptr<MappedFile> keepAlive = pack.file;
+        for (size_t i = 0; i < helpers; ++i) {
+            post([job, keepAlive] { job->run(); });
+        }
+    }
+    job->run();
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->cv.wait(lock, [&] { return job->done == job->chunkCount; });
+        if (job->error) std::rethrow_exception(job->error);
+    }
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    decompressUs_.fetch_add(static_cast<uint64_t>(us), std::memory_order_relaxed);
+    bytesDecompressed_.fetch_add(entry.rawSize, std::memory_order_relaxed);
+    fd.data_ = buffer->data();
+    fd.size_ = buffer->size();
+    fd.owner_ = std::move(buffer);
+    return fd;
+}
+
+std::future<FileData> FileSystem::readAsync(std::string path) {
+    auto task = std::make_shared<std::packaged_task<FileData()>>([this, p = std::move(path)] { return read(p); });
+    std::future<FileData> result = task->get_future();
+    post([task] { (*task)(); });
+    return result;
+}
+
+void FileSystem::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.push_back(std::move(task));
+    }
+    queueCv_.notify_one();
+}
+
+void FileSystem::workerMain() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return; // stopping and drained
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
+
+FileSystem::Stats FileSystem::stats() const {
+    Stats s;
+    s.packReads = packReads_.load(std::memory_order_relaxed);
+    s.looseReads = looseReads_.load(std::memory_order_relaxed);
+    s.bytesMapped = bytesMapped_.load(std::memory_order_relaxed);
+    s.bytesDecompressed = bytesDecompressed_.load(std::memory_order_relaxed);
+    s.decompressUs = decompressUs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void FileSystem::logStats() const {
+    Stats s = stats();
+    std::cout << "FileSystem: " << s.packReads << " pack reads, " << s.looseReads << " loose reads, "
+              << (s.bytesMapped >> 10) << " KiB mapped, " << (s.bytesDecompressed >> 10) << " KiB decompressed in "
+              << s.decompressUs / 1000 << " ms" << std::endl;
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "io/PackFormat.h"
+
+namespace io {
+class MappedFile;
+
+// Contents of one file. Uncompressed pack entries and loose files are zero-copy views into
+// a memory mapping; compressed entries own their decoded bytes. Either way the data stays
+// valid for the lifetime of the FileData (copies share it).
+class FileData {
+public:
+    FileData() = default;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return {reinterpret_cast<const char*>(data_), size_}; }
+    // True when data() points into a file mapping rather than a decoded buffer
+    bool isMapped() const { return mapped_; }
+
+private:
+    friend class FileSystem;
+    std::shared_ptr<const void> owner_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+};
+
+// Virtual file system: mounted packs first (last mounted wins), then loose directories in
+// the order they were added. Thread-safe; compressed entries are decoded chunk-parallel on
+// the file system's worker threads, with the calling thread helping.
+class FileSystem {
+public:
+    struct Stats {
+        uint64_t packReads = 0;
+        uint64_t looseReads = 0;
+        uint64_t bytesMapped = 0;       // served zero-copy
+        uint64_t bytesDecompressed = 0;
+        uint64_t decompressUs = 0;      // wall time inside compressed reads
+    };
+
+    // workerCount 0 = hardware concurrency - 1 (at least 1)
+    explicit FileSystem(uint32_t workerCount = 0);
+    ~FileSystem();
+
+    FileSystem(const FileSystem&) = delete;
+    FileSystem& operator=(const FileSystem&) = delete;
+
+    // false when the file does not exist; throws std::runtime_error when it is not a valid pack
+    bool mountPack(const std::string& path);
+    void addLooseRoot(const std::string& dir);
+
+    bool exists(std::string_view path) const;
+    // Throws std::runtime_error when the file is in no pack and no loose root
+    FileData read(std::string_view path);
+    // Runs read() on a worker; exceptions surface from future::get()
+    std::future<FileData> readAsync(std::string path);
+
+    Stats stats() const;
+    void logStats() const;
+
+private:
+    struct Pack {
+        std::shared_ptr<MappedFile> file;
+        const PackHeader* header = nullptr;
+        const PackEntry* entries = nullptr;
+        const PackChunk* chunks = nullptr;
+        const char* names = nullptr;
+    };
+
+    const PackEntry* findEntry(const Pack& pack, std::string_view normalized) const;
+    FileData readEntry(const Pack& pack, const PackEntry& entry);
+    void post(std::function<void()> task);
+    void workerMain();
+
+    mutable std::shared_mutex mountMutex_;
+    std::vector<Pack> packs_;
+    std::vector<std::string> looseRoots_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> packReads_{0};
+    std::atomic<uint64_t> looseReads_{0};
+    std::atomic<uint64_t> bytesMapped_{0};
+    std::atomic<uint64_t> bytesDecompressed_{0};
+    std::atomic<uint64_t> decompressUs_{0};
+};
+}
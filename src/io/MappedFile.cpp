@@ -0,0 +1,85 @@
+#include "io/MappedFile.h"
+
+#include <filesystem>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+#if defined(_WIN32)
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    std::filesystem::path p(path);
+    HANDLE file = CreateFileW(p.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        DWORD err = GetLastError();
+        if (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND) return nullptr;
+        throw std::runtime_error("MappedFile: cannot open " + path);
+    }
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+    mf->path_ = path;
+    mf->file_ = file;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) throw std::runtime_error("MappedFile: cannot stat " + path);
+    mf->size_ = static_cast<size_t>(size.QuadPart);
+    if (mf->size_ == 0) return mf; // zero-length files cannot be mapped
+    mf->mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mf->mapping_) throw std::runtime_error("MappedFile: CreateFileMapping failed for " + path);
+    mf->data_ = static_cast<const uint8_t*>(MapViewOfFile(mf->mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!mf->data_) throw std::runtime_error("MappedFile: MapViewOfFile failed for " + path);
+    return mf;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+}
+#else
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT || errno == ENOTDIR) return nullptr;
+        throw std::runtime_error("MappedFile: cannot open " + path);
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return nullptr;
+    }
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+    mf->path_ = path;
+    mf->size_ = static_cast<size_t>(st.st_size);
+    if (mf->size_ > 0) {
+        void* p = mmap(nullptr, mf->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: mmap failed for " + path);
+        }
+        mf->data_ = static_cast<const uint8_t*>(p);
+    }
+    ::close(fd); // the mapping holds its own reference
+    return mf;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+}
+#endif
+
+}
@@ -0,0 +1,24 @@
+#include "io/PackFormat.h"
+
+namespace io {
+
+std::string normalizePath(std::string_view path) {
+    std::string out(path);
+    for (char& c : out) {
+        if (c == '\\') c = '/';
+    }
+    while (out.compare(0, 2, "./") == 0) out.erase(0, 2);
+    while (!out.empty() && out.front() == '/') out.erase(0, 1);
+    return out;
+}
+
+uint64_t hashPath(std::string_view normalizedPath) {
+    uint64_t h = 1469598103934665603ull;
+    for (char c : normalizedPath) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace io {
+// On-disk layout of an Aurora pack (.pak), little endian:
+//   PackHeader | entry data ... | PackEntry[entryCount] (sorted by pathHash) | PackChunk[chunkCount] | names
+// Entry data is 16-byte aligned so uncompressed entries can be used in place (SPIR-V, vertex data).
+// Compressed entries are split into independently compressed chunks that decode in parallel.
+constexpr uint32_t kPackMagic = 0x4B415041u; // "APAK"
+constexpr uint32_t kPackVersion = 1;
+constexpr uint64_t kPackDataAlignment = 16;
+constexpr uint32_t kPackDefaultChunkSize = 256u << 10;
+
+enum class Codec : uint8_t {
+    None = 0,
+    LZ4 = 1,
+    Zstd = 2,
+};
+
+struct PackHeader {
+    uint32_t magic = kPackMagic;
+    uint32_t version = kPackVersion;
+    uint32_t entryCount = 0;
+    uint32_t chunkCount = 0;
+    uint64_t tocOffset = 0;
+    uint64_t chunkTableOffset = 0;
+    uint64_t namesOffset = 0;
+    uint64_t namesSize = 0;
+};
+static_assert(sizeof(PackHeader) == 48, "PackHeader layout is part of the file format");
+
+struct PackEntry {
+    uint64_t pathHash = 0;
+    uint64_t offset = 0;     // absolute; start of the raw bytes for Codec::None
+    uint64_t storedSize = 0; // bytes in the file
+    uint64_t rawSize = 0;    // bytes after decompression
+    uint32_t firstChunk = 0; // into the chunk table (compressed entries only)
+    uint32_t chunkCount = 0;
+    uint32_t nameOffset = 0; // into the names blob; used to reject hash collisions
+    uint16_t nameLength = 0;
+    uint8_t codec = 0;       // io::Codec
+    uint8_t reserved = 0;
+};
+static_assert(sizeof(PackEntry) == 48, "PackEntry layout is part of the file format");
+
+// A chunk whose storedSize equals rawSize did not compress and is stored raw
+struct PackChunk {
+    uint64_t offset = 0; // absolute
+    uint32_t storedSize = 0;
+    uint32_t rawSize = 0;
+};
+static_assert(sizeof(PackChunk) == 16, "PackChunk layout is part of the file format");
+
+// Virtual paths use '/' separators and no leading "./"
+std::string normalizePath(std::string_view path);
+// FNV-1a 64 of the normalized path
+uint64_t hashPath(std::string_view normalizedPath);
+}
@@ -0,0 +1,136 @@
+#include "io/PackWriter.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "io/Compression.h"
+
+namespace io {
+
+void PackWriter::add(const std::string& path, std::vector<uint8_t> data) {
+    std::string normalized = normalizePath(path);
+    if (normalized.empty() || normalized.size() > UINT16_MAX) throw std::runtime_error("PackWriter: invalid path " + path);
+    for (const auto& in : inputs_) {
+        if (in.path == normalized) throw std::runtime_error("PackWriter: duplicate path " + normalized);
+    }
+    inputs_.push_back({std::move(normalized), std::move(data)});
+}
+
+size_t PackWriter::addDirectory(const std::string& dir, const std::string& prefix) {
+    namespace fs = std::filesystem;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end()); // deterministic output
+    for (const auto& file : files) {
+        std::ifstream in(file, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("PackWriter: cannot read " + file.string());
+        std::vector<uint8_t> data(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        std::string rel = fs::relative(file, dir).generic_string();
+        add(prefix.empty() ? rel : prefix + "/" + rel, std::move(data));
+    }
+    return files.size();
+}
+
+void PackWriter::write(const std::string& path, const Options& options) const {
+    if (options.codec != Codec::None && !codecAvailable(options.codec)) {
+        throw std::runtime_error(std::string("PackWriter: codec '") + codecName(options.codec) + "' not compiled in");
+    }
+    const uint32_t chunkSize = std::max<uint32_t>(options.chunkSize, 4096);
+
+    std::vector<uint8_t> blob(sizeof(PackHeader), 0);
+    auto align = [&](uint64_t a) { blob.resize(static_cast<size_t>((blob.size() + a - 1) / a * a), 0); };
+    auto append = [&](const void* p, size_t n) {
+        const auto* b = static_cast<const uint8_t*>(p);
+        blob.insert(blob.end(), b, b + n);
+    };
+
+    std::vector<PackEntry> entries;
+    std::vector<PackChunk> chunks;
+    std::string names;
+    uint64_t rawTotal = 0;
+    for (const auto& in : inputs_) {
+        PackEntry e;
+        e.pathHash = hashPath(in.path);
+        e.rawSize = in.data.size();
+        e.nameOffset = static_cast<uint32_t>(names.size());
+        e.nameLength = static_cast<uint16_t>(in.path.size());
+        names += in.path;
+        rawTotal += in.data.size();
+
+        // Try compressing chunk by chunk; keep the result only if the whole entry shrinks enough
+        std::vector<std::vector<uint8_t>> packed;
+        uint64_t packedSize = 0;
+        if (options.codec != Codec::None && in.data.size() >= options.minCompressSize) {
+            for (size_t off = 0; off < in.data.size(); off += chunkSize) {
+                size_t n = std::min<size_t>(chunkSize, in.data.size() - off);
+                std::vector<uint8_t> c = compress(options.codec, in.data.data() + off, n, options.level);
+                if (c.empty()) c.assign(in.data.begin() + static_cast<std::ptrdiff_t>(off),
+                                        in.data.begin() + static_cast<std::ptrdiff_t>(off + n)); // stored raw
+                packedSize += c.size();
+                packed.push_back(std::move(c));
+            }
+        }
+        bool useCodec = !packed.empty() &&
+                        static_cast<double>(packedSize) <= static_cast<double>(in.data.size()) * (1.0 - options.minSavings);
+
+        align(kPackDataAlignment);
+        e.offset = blob.size();
+        if (useCodec) {
+            e.codec = static_cast<uint8_t>(options.codec);
+            e.firstChunk = static_cast<uint32_t>(chunks.size());
+            e.chunkCount = static_cast<uint32_t>(packed.size());
+            size_t rawOff = 0;
+            for (const auto& c : packed) {
+                PackChunk pc;
+                pc.offset = blob.size();
+                pc.storedSize = static_cast<uint32_t>(c.size());
+                pc.rawSize = static_cast<uint32_t>(std::min<size_t>(chunkSize, in.data.size() - rawOff));
+                rawOff += pc.rawSize;
+                append(c.data(), c.size());
+                chunks.push_back(pc);
+            }
+            e.storedSize = packedSize;
+        } else {
+            e.codec = static_cast<uint8_t>(Codec::None);
+            e.storedSize = in.data.size();
+            append(in.data.data(), in.data.size());
+        }
+        entries.push_back(e);
+    }
+    std::sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b) { return a.pathHash < b.pathHash; });
+
+    PackHeader h;
+    h.entryCount = static_cast<uint32_t>(entries.size());
+    h.chunkCount = static_cast<uint32_t>(chunks.size());
+    align(kPackDataAlignment);
+    h.tocOffset = blob.size();
+    append(entries.data(), entries.size() * sizeof(PackEntry));
+    h.chunkTableOffset = blob.size();
+    append(chunks.data(), chunks.size() * sizeof(PackChunk));
+    h.namesOffset = blob.size();
+    h.namesSize = names.size();
+    append(names.data(), names.size());
+    std::copy_n(reinterpret_cast<const uint8_t*>(&h), sizeof(h), blob.begin());
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("PackWriter: cannot write " + tmp);
+        out.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+        if (!out) throw std::runtime_error("PackWriter: write failed for " + tmp);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) throw std::runtime_error("PackWriter: cannot rename " + tmp + " to " + path + ": " + ec.message());
+    std::cout << "PackWriter: " << path << ": " << entries.size() << " entries, " << (rawTotal >> 10) << " KiB raw, "
+              << (blob.size() >> 10) << " KiB packed (" << codecName(options.codec) << ")" << std::endl;
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "io/PackFormat.h"
+
+namespace io {
+// Builds a pack file (see PackFormat.h). Used by the aurora_pack tool; entries are held in
+// memory until write().
+class PackWriter {
+public:
+    struct Options {
+        Codec codec = Codec::None;
+        int level = 0;                      // 0 = codec default
+        uint32_t chunkSize = kPackDefaultChunkSize;
+        // Entries smaller than this, or that do not shrink by minSavings, are stored raw so
+        // they can be served zero-copy
+        uint32_t minCompressSize = 4096;
+        float minSavings = 0.1f;
+    };
+
+    // Throws std::runtime_error on duplicate paths
+    void add(const std::string& path, std::vector<uint8_t> data);
+    // Add every regular file under dir as prefix/<relative path>; returns the count added
+    size_t addDirectory(const std::string& dir, const std::string& prefix = {});
+
+    // Writes to path + ".tmp" and renames, so a failed build never leaves a truncated pack
+    void write(const std::string& path, const Options& options) const;
+
+private:
+    struct Input {
+        std::string path;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Input> inputs_;
+};
+}
@@ -1,15 +1,77 @@
 #include "render/Mesh.h"
 
+#include "vulkan/VkObjects.h"
+#include "vulkan/BufferUtils.h"
+#include "vulkan/UploadManager.h"
+
+#include <algorithm>
+#include <cmath>
+
 namespace render {
 Mesh Mesh::makeTriangle() {
     Mesh m;
     m.vertices_ = {
-        //   pos        color
-        {{ 0.0f, -0.5f }, {1.0f, 0.0f, 0.0f}},
-        {{ 0.5f,  0.5f }, {0.0f, 1.0f, 0.0f}},
-        {{-0.5f,  0.5f }, {0.0f, 0.0f, 1.0f}},
+        //   pos                  normal               color
+        {{ 0.0f, -0.5f, 0.0f }, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},
+        {{ 0.5f,  0.5f, 0.0f }, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},
+        {{-0.5f,  0.5f, 0.0f }, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 1.0f}},
     };
     m.indices_ = {0,1,2};
     return m;
 }
+
+GpuMesh Mesh::upload(VkObjects* vk, VertexFormat format) const {
+    GpuMesh gpu;
+    gpu.format = format;
+    gpu.vertexCount = static_cast<uint32_t>(vertices_.size());
+    gpu.indexCount = static_cast<uint32_t>(indices_.size());
+    if (!vertices_.empty()) {
+        // Sphere around the AABB center: not minimal, but one pass and never too small
+        float lo[3], hi[3];
+        for (int a = 0; a < 3; ++a) lo[a] = hi[a] = vertices_[0].pos[a];
+        for (const Vertex& v : vertices_) {
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::min(lo[a], v.pos[a]);
+                hi[a] = std::max(hi[a], v.pos[a]);
+            }
+        }
+        for (int a = 0; a < 3; ++a) gpu.boundsCenter[a] = 0.5f * (lo[a] + hi[a]);
+        float r2 = 0.0f;
+        for (const Vertex& v : vertices_) {
+            float d2 = 0.0f;
+            for (int a = 0; a < 3; ++a) d2 += (v.pos[a] - gpu.boundsCenter[a]) * (v.pos[a] - gpu.boundsCenter[a]);
+            r2 = std::max(r2, d2);
+        }
+        gpu.boundsRadius = std::sqrt(r2);
+
+        std::vector<uint8_t> encoded = encodeVertices(vertices_, format, gpu.pushConstants);
+        vkbuf::createBuffer(vk, encoded.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, gpu.vertexBuffer, gpu.vertexAlloc);
+        gpu.uploadTicket = vk->uploads->enqueue(gpu.vertexBuffer, 0, encoded.data(), encoded.size());
+    }
+    if (!indices_.empty()) {
+        // 16-bit indices halve index bandwidth; 0xFFFF stays free as the primitive restart value
+        const bool small = vertices_.size() < 0xFFFF;
+        std::vector<uint16_t> packed;
+        const void* src = indices_.data();
+        VkDeviceSize bytes = sizeof(uint32_t) * indices_.size();
+        gpu.indexType = VK_INDEX_TYPE_UINT32;
+        if (small) {
+            packed.assign(indices_.begin(), indices_.end());
+            src = packed.data();
+            bytes = sizeof(uint16_t) * packed.size();
+            gpu.indexType = VK_INDEX_TYPE_UINT16;
+        }
+        vkbuf::createBuffer(vk, bytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, gpu.indexBuffer, gpu.indexAlloc);
+        gpu.uploadTicket = vk->uploads->enqueue(gpu.indexBuffer, 0, src, bytes);
+    }
+    return gpu;
+}
+
+void Mesh::destroy(VkObjects* vk, GpuMesh& mesh) {
+    vkbuf::destroyBuffer(vk, mesh.vertexBuffer, mesh.vertexAlloc);
+    vkbuf::destroyBuffer(vk, mesh.indexBuffer, mesh.indexAlloc);
+    mesh = {};
+}
 }
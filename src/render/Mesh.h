@@ -2,24 +2,51 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <cstdint>
+#include <utility>
+
+#include "render/VertexFormat.h"
+#include "vulkan/MemoryAllocator.h"
 
 struct VkObjects; // forward
 
-struct Vertex {
-    float pos[2];
-    float color[3];
+namespace render {
+// Mesh data resident in DEVICE_LOCAL buffers. Contents arrive through the upload ring:
+// draw only once vk->uploads->isSubmitted(uploadTicket).
+struct GpuMesh {
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    vulkan::Allocation vertexAlloc;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    vulkan::Allocation indexAlloc;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32; // UINT16 whenever every index fits
+    VertexFormat format = VertexFormat::Float32;
+    MeshPushConstants pushConstants; // dequantization for format, pushed before each draw
+    uint64_t uploadTicket = 0; // last upload covering this mesh
+    // Bounding sphere of the vertex positions (mesh space), for culling
+    float boundsCenter[3] = {0.0f, 0.0f, 0.0f};
+    float boundsRadius = 0.0f;
 };
 
-namespace render {
 class Mesh {
 public:
     Mesh() = default;
+    Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
+        : vertices_(std::move(vertices)), indices_(std::move(indices)) {}
     ~Mesh() = default; // GPU resources managed externally for now
 
     const std::vector<Vertex>& vertices() const { return vertices_; }
     const std::vector<uint32_t>& indices() const { return indices_; }
+    std::vector<Vertex>& vertices() { return vertices_; }
+    std::vector<uint32_t>& indices() { return indices_; }
 
     static Mesh makeTriangle();
+
+    // Create device-local vertex/index buffers in the given encoding and queue their
+    // contents on vk->uploads. Run render::optimizeMesh first.
+    GpuMesh upload(VkObjects* vk, VertexFormat format) const;
+    // The GPU must no longer use the buffers (e.g. after vkDeviceWaitIdle)
+    static void destroy(VkObjects* vk, GpuMesh& mesh);
 private:
     std::vector<Vertex> vertices_;
     std::vector<uint32_t> indices_;
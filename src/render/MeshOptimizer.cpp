@@ -0,0 +1,268 @@
+#include "render/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace render {
+
+namespace {
+struct VertexHash {
+    size_t operator()(const Vertex& v) const {
+        // FNV-1a over the raw bytes: dedup is bitwise, matching VertexEq
+        const auto* p = reinterpret_cast<const unsigned char*>(&v);
+        uint64_t h = 1469598103934665603ull;
+        for (size_t i = 0; i < sizeof(Vertex); ++i) { h ^= p[i]; h *= 1099511628211ull; }
+        return static_cast<size_t>(h);
+    }
+};
+struct VertexEq {
+    bool operator()(const Vertex& a, const Vertex& b) const { return std::memcmp(&a, &b, sizeof(Vertex)) == 0; }
+};
+
+// Forsyth scoring parameters (values from the original paper)
+constexpr int kCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+float vertexScore(int cachePos, uint32_t remaining) {
+    if (remaining == 0) return -1.0f;
+    float score = 0.0f;
+    if (cachePos >= 0) {
+        if (cachePos < 3) score = kLastTriScore; // just used: avoid immediately reusing the same edge
+        else score = std::pow(1.0f - static_cast<float>(cachePos - 3) / static_cast<float>(kCacheSize - 3), kCacheDecayPower);
+    }
+    return score + kValenceBoostScale * std::pow(static_cast<float>(remaining), -kValenceBoostPower);
+}
+
+void sub(const float a[3], const float b[3], float out[3]) { for (int i = 0; i < 3; ++i) out[i] = a[i] - b[i]; }
+void cross(const float a[3], const float b[3], float out[3]) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+}
+
+size_t deduplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    if (indices.empty()) {
+        indices.resize(vertices.size());
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+    std::unordered_map<Vertex, uint32_t, VertexHash, VertexEq> unique;
+    unique.reserve(vertices.size());
+    std::vector<uint32_t> remap(vertices.size());
+    std::vector<Vertex> out;
+    out.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        auto [it, inserted] = unique.try_emplace(vertices[i], static_cast<uint32_t>(out.size()));
+        if (inserted) out.push_back(vertices[i]);
+        remap[i] = it->second;
+    }
+    for (auto& idx : indices) idx = remap[idx];
+    vertices = std::move(out);
+    return vertices.size();
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount < 2) return;
+
+    // Vertex -> triangles adjacency (CSR); the active prefix of each list shrinks as triangles are emitted
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (uint32_t idx : indices) ++remaining[idx];
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k) adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vScore[v] = vertexScore(-1, remaining[v]);
+    std::vector<float> tScore(triCount);
+    std::vector<char> emitted(triCount, 0);
+    for (size_t t = 0; t < triCount; ++t)
+        tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+
+    auto fullScan = [&]() {
+        size_t best = SIZE_MAX;
+        for (size_t t = 0; t < triCount; ++t)
+            if (!emitted[t] && (best == SIZE_MAX || tScore[t] > tScore[best])) best = t;
+        return best;
+    };
+
+    std::vector<uint32_t> out;
+    out.reserve(indices.size());
+    std::vector<uint32_t> cache, nextCache, evicted;
+    cache.reserve(kCacheSize + 3);
+    nextCache.reserve(kCacheSize + 3);
+    size_t best = fullScan();
+    while (best != SIZE_MAX) {
+        emitted[best] = 1;
+        const uint32_t tri[3] = { indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2] };
+        nextCache.assign(tri, tri + 3);
+        for (uint32_t v : tri) {
+            out.push_back(v);
+            // Drop the triangle from the vertex's active list
+            uint32_t begin = offsets[v], end = begin + remaining[v];
+            for (uint32_t i = begin; i < end; ++i) {
+                if (adjacency[i] == best) { std::swap(adjacency[i], adjacency[end - 1]); break; }
+            }
+            --remaining[v];
+        }
+        for (uint32_t v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) nextCache.push_back(v);
+        }
+        // Anything pushed out of the simulated cache loses its cache bonus
+        evicted.clear();
+        for (size_t i = kCacheSize; i < nextCache.size(); ++i) {
+            cachePos[nextCache[i]] = -1;
+            vScore[nextCache[i]] = vertexScore(-1, remaining[nextCache[i]]);
+            evicted.push_back(nextCache[i]);
+        }
+        if (nextCache.size() > static_cast<size_t>(kCacheSize)) nextCache.resize(kCacheSize);
+        for (size_t i = 0; i < nextCache.size(); ++i) {
+            uint32_t v = nextCache[i];
+            cachePos[v] = static_cast<int>(i);
+            vScore[v] = vertexScore(cachePos[v], remaining[v]);
+        }
+        std::swap(cache, nextCache);
+
+        // Only triangles touching the cache (or just evicted from it) changed score
+        best = SIZE_MAX;
+        float bestScore = -1.0f;
+        for (uint32_t v : evicted) {
+            for (uint32_t i = offsets[v], end = offsets[v] + remaining[v]; i < end; ++i) {
+                uint32_t t = adjacency[i];
+                tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+            }
+        }
+        for (uint32_t v : cache) {
+            for (uint32_t i = offsets[v], end = offsets[v] + remaining[v]; i < end; ++i) {
+                uint32_t t = adjacency[i];
+                tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+                if (tScore[t] > bestScore) { bestScore = tScore[t]; best = t; }
+            }
+        }
+        if (best == SIZE_MAX) best = fullScan(); // cache exhausted: jump to a new region
+    }
+    out.insert(out.end(), indices.begin() + static_cast<std::ptrdiff_t>(triCount * 3), indices.end());
+    indices = std::move(out);
+}
+
+void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount < 2) return;
+
+    // Cluster boundaries: triangles that miss a 16-entry FIFO cache on all three vertices.
+    // Reordering whole clusters keeps the cache behaviour of optimizeVertexCache.
+    constexpr uint32_t kFifoSize = 16;
+    std::vector<uint32_t> stamp(vertices.size(), 0);
+    uint32_t time = kFifoSize + 1;
+    std::vector<size_t> clusterStart;
+    for (size_t t = 0; t < triCount; ++t) {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = indices[t * 3 + k];
+            if (time - stamp[v] > kFifoSize) { stamp[v] = time++; ++misses; }
+        }
+        if (t == 0 || misses == 3) clusterStart.push_back(t);
+    }
+    clusterStart.push_back(triCount);
+    const size_t clusterCount = clusterStart.size() - 1;
+    if (clusterCount < 2) return;
+
+    float meshCentroid[3] = {0, 0, 0};
+    float meshArea = 0.0f;
+    std::vector<float> clusterCentroid(clusterCount * 3, 0.0f), clusterNormal(clusterCount * 3, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float area = 0.0f;
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+            const float* p0 = vertices[indices[t * 3]].pos;
+            const float* p1 = vertices[indices[t * 3 + 1]].pos;
+            const float* p2 = vertices[indices[t * 3 + 2]].pos;
+            float e1[3], e2[3], n[3];
+            sub(p1, p0, e1);
+            sub(p2, p0, e2);
+            cross(e1, e2, n);
+            float a = 0.5f * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int i = 0; i < 3; ++i) {
+                float centroid = (p0[i] + p1[i] + p2[i]) / 3.0f;
+                clusterCentroid[c * 3 + i] += centroid * a;
+                clusterNormal[c * 3 + i] += n[i]; // un-normalized: area weighted
+                meshCentroid[i] += centroid * a;
+            }
+            area += a;
+        }
+        for (int i = 0; i < 3; ++i) clusterCentroid[c * 3 + i] = area > 0.0f ? clusterCentroid[c * 3 + i] / area : 0.0f;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) for (float& m : meshCentroid) m /= meshArea;
+
+    // Clusters facing away from the mesh center are likely occluders: draw them first
+    std::vector<float> key(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const float* n = &clusterNormal[c * 3];
+        float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float d = 0.0f;
+        for (int i = 0; i < 3; ++i) d += (clusterCentroid[c * 3 + i] - meshCentroid[i]) * n[i];
+        key[c] = len > 0.0f ? d / len : 0.0f;
+    }
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key[a] > key[b]; });
+
+    std::vector<uint32_t> out;
+    out.reserve(indices.size());
+    for (size_t c : order) {
+        out.insert(out.end(), indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[c] * 3),
+                   indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[c + 1] * 3));
+    }
+    out.insert(out.end(), indices.begin() + static_cast<std::ptrdiff_t>(triCount * 3), indices.end());
+    indices = std::move(out);
+}
+
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+    std::vector<Vertex> out;
+    out.reserve(vertices.size());
+    for (auto& idx : indices) {
+        if (remap[idx] == UINT32_MAX) {
+            remap[idx] = static_cast<uint32_t>(out.size());
+            out.push_back(vertices[idx]);
+        }
+        idx = remap[idx];
+    }
+    vertices = std::move(out);
+}
+
+float computeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    const size_t triCount = indices.size() / 3;
+    if (!triCount) return 0.0f;
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0;
+    for (size_t i = 0; i < triCount * 3; ++i) {
+        uint32_t v = indices[i];
+        if (time - stamp[v] > cacheSize) { stamp[v] = time++; ++misses; }
+    }
+    return static_cast<float>(misses) / static_cast<float>(triCount);
+}
+
+void optimizeMesh(Mesh& mesh) {
+    std::vector<Vertex>& vertices = mesh.vertices();
+    std::vector<uint32_t>& indices = mesh.indices();
+    deduplicateVertices(vertices, indices);
+    optimizeVertexCache(indices, vertices.size());
+    optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(vertices, indices);
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "render/Mesh.h"
+
+namespace render {
+// Offline-style mesh processing, run once before upload. Order matters:
+// deduplicate -> vertex cache -> overdraw -> vertex fetch (optimizeMesh does all four).
+
+// Merge bit-identical vertices and rewrite indices; builds a 0..n-1 index list for
+// non-indexed meshes. Returns the new vertex count.
+size_t deduplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+// Reorder triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm)
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+// Reorder cache-coherent clusters so outward-facing ones draw first (Sander et al.,
+// "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"). Clusters split where
+// a triangle misses the cache on all three vertices, so vertex cache efficiency is kept.
+void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices);
+
+// Renumber vertices in first-use order for linear vertex fetch; drops unreferenced vertices
+void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+// Average cache misses per triangle for a FIFO cache of cacheSize (lower is better; 0.5-0.7 is good)
+float computeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+void optimizeMesh(Mesh& mesh);
+}
@@ -0,0 +1,115 @@
+#include "render/RenderQueue.h"
+
+#include <array>
+#include <utility>
+
+#include <aurora/Profiler.h>
+
+namespace render {
+
+namespace {
+// Below this an insertion sort beats building eight histograms
+constexpr size_t kInsertionSortMax = 32;
+constexpr uint32_t kDigits = 8;
+}
+
+uint64_t sortkey::make(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+    // NaN fails both comparisons and sorts first
+    const uint32_t maxDepth = (1u << kDepthBits) - 1;
+    uint32_t d = 0;
+    if (depth >= 1.0f) d = maxDepth;
+    else if (depth > 0.0f) d = static_cast<uint32_t>(depth * static_cast<float>(maxDepth) + 0.5f);
+    return (uint64_t(pass & ((1u << kPassBits) - 1)) << kPassShift) |
+           (uint64_t(pipeline & ((1u << kPipelineBits) - 1)) << kPipelineShift) |
+           (uint64_t(material & ((1u << kMaterialBits) - 1)) << kMaterialShift) |
+           (uint64_t(mesh & ((1u << kMeshBits) - 1)) << kMeshShift) | d;
+}
+
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values,
+               std::vector<uint64_t>& scratchKeys, std::vector<uint32_t>& scratchValues) {
+    const size_t n = keys.size();
+    if (n < 2) return;
+    if (n <= kInsertionSortMax) {
+        for (size_t i = 1; i < n; ++i) {
+            const uint64_t k = keys[i];
+            const uint32_t v = values[i];
+            size_t j = i;
+            for (; j > 0 && keys[j - 1] > k; --j) {
+                keys[j] = keys[j - 1];
+                values[j] = values[j - 1];
+            }
+            keys[j] = k;
+            values[j] = v;
+        }
+        return;
+    }
+
+    // Histograms of all digits in one read of the keys
+    std::array<std::array<uint32_t, 256>, kDigits> hist{};
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t k = keys[i];
+        for (uint32_t d = 0; d < kDigits; ++d) ++hist[d][(k >> (8 * d)) & 0xFF];
+    }
+
+    scratchKeys.resize(n);
+    scratchValues.resize(n);
+    uint64_t* srcKeys = keys.data();
+    uint32_t* srcValues = values.data();
+    uint64_t* dstKeys = scratchKeys.data();
+    uint32_t* dstValues = scratchValues.data();
+    bool inScratch = false;
+    for (uint32_t d = 0; d < kDigits; ++d) {
+        const uint32_t shift = 8 * d;
+        std::array<uint32_t, 256>& h = hist[d];
+        if (h[(srcKeys[0] >> shift) & 0xFF] == n) continue; // every key has the same digit
+        uint32_t offset = 0;
+        for (uint32_t& count : h) {
+            const uint32_t c = count;
+            count = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t slot = h[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[slot] = srcKeys[i];
+            dstValues[slot] = srcValues[i];
+        }
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+        inScratch = !inScratch;
+    }
+    if (inScratch) {
+        keys.swap(scratchKeys);
+        values.swap(scratchValues);
+    }
+}
+
+void RenderQueue::clear() {
+    keys_.clear();
+    draws_.clear();
+    batches_.clear();
+}
+
+void RenderQueue::reserve(size_t count) {
+    keys_.reserve(count);
+    draws_.reserve(count);
+}
+
+void RenderQueue::sort() {
+    AURORA_PROFILE_ZONE("RenderQueue::sort");
+    radixSort(keys_, draws_, scratchKeys_, scratchDraws_);
+}
+
+void RenderQueue::writeInstances(const aurora::DrawCommand* draws, aurora::DrawCommand* dst) {
+    batches_.clear();
+    const uint32_t n = static_cast<uint32_t>(keys_.size());
+    for (uint32_t i = 0; i < n; ++i) {
+        dst[i] = draws[draws_[i]];
+        if (batches_.empty() || ((keys_[i] ^ batches_.back().key) & sortkey::kStateMask)) {
+            batches_.push_back({keys_[i], i, 1});
+        } else {
+            ++batches_.back().instanceCount;
+        }
+    }
+}
+
+}
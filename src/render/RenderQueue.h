@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <aurora/DrawList.h>
+
+namespace render {
+// 64-bit draw sort key, most significant field first, so ascending key order groups draws by
+// pass, then pipeline, then material (descriptor set), then mesh, and orders each group front
+// to back. Everything above the depth bits is the draw's state: equal state = instanceable.
+//
+//   63..60 pass | 59..48 pipeline | 47..32 material | 31..16 mesh | 15..0 depth
+namespace sortkey {
+constexpr uint32_t kPassShift = 60, kPassBits = 4;
+constexpr uint32_t kPipelineShift = 48, kPipelineBits = 12;
+constexpr uint32_t kMaterialShift = 32, kMaterialBits = 16;
+constexpr uint32_t kMeshShift = 16, kMeshBits = 16;
+constexpr uint32_t kDepthBits = 16;
+constexpr uint64_t kStateMask = ~((1ull << kDepthBits) - 1); // all fields but depth
+
+// Ids wider than their field are truncated (and alias); depth is clip-space z in [0, 1]
+uint64_t make(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+inline uint32_t pass(uint64_t key) { return static_cast<uint32_t>(key >> kPassShift) & ((1u << kPassBits) - 1); }
+inline uint32_t pipeline(uint64_t key) { return static_cast<uint32_t>(key >> kPipelineShift) & ((1u << kPipelineBits) - 1); }
+inline uint32_t material(uint64_t key) { return static_cast<uint32_t>(key >> kMaterialShift) & ((1u << kMaterialBits) - 1); }
+inline uint32_t mesh(uint64_t key) { return static_cast<uint32_t>(key >> kMeshShift) & ((1u << kMeshBits) - 1); }
+}
+
+// Sorts (key, value) pairs by key, stable, with an LSD radix sort on 8-bit digits. Digits in
+// which every key agrees are skipped, so keys that differ only in a few fields cost only a
+// few passes. scratch is resized as needed and may be reused across calls.
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values,
+               std::vector<uint64_t>& scratchKeys, std::vector<uint32_t>& scratchValues);
+
+// A run of draws with identical state, drawn as one instanced draw call: instances
+// [firstInstance, firstInstance + instanceCount) of the instance buffer
+struct DrawBatch {
+    uint64_t key = 0; // first draw of the run; sortkey:: accessors give its state
+    uint32_t firstInstance = 0;
+    uint32_t instanceCount = 0;
+};
+
+// Per-frame render queue of the main pass: add() every draw with its key, sort(), then
+// writeInstances() copies the draws in key order into the instance buffer while batches()
+// lists the instanced draw calls. Reused across frames so its arrays stop reallocating.
+class RenderQueue {
+public:
+    void clear();
+    void reserve(size_t count);
+    // draw indexes the array later passed to writeInstances
+    void add(uint64_t key, uint32_t draw) {
+        keys_.push_back(key);
+        draws_.push_back(draw);
+    }
+    void sort();
+    // dst holds size() draws; also builds batches() by merging runs of equal state
+    void writeInstances(const aurora::DrawCommand* draws, aurora::DrawCommand* dst);
+
+    size_t size() const { return keys_.size(); }
+    bool empty() const { return keys_.empty(); }
+    const std::vector<DrawBatch>& batches() const { return batches_; }
+
+private:
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> draws_;
+    std::vector<uint64_t> scratchKeys_;
+    std::vector<uint32_t> scratchDraws_;
+    std::vector<DrawBatch> batches_;
+};
+}
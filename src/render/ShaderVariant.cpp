@@ -0,0 +1,54 @@
+#include "render/ShaderVariant.h"
+
+#include <cstddef>
+#include <iterator>
+
+#include <aurora/Material.h>
+
+namespace render {
+
+namespace {
+constexpr VkSpecializationMapEntry kSpecMap[kSpecConstantCount] = {
+    {kSpecOctahedralNormal, offsetof(SpecConstants, octahedralNormal), sizeof(VkBool32)},
+    {kSpecVertexColor, offsetof(SpecConstants, vertexColor), sizeof(VkBool32)},
+    {kSpecLit, offsetof(SpecConstants, lit), sizeof(VkBool32)},
+    {kSpecAlphaTest, offsetof(SpecConstants, alphaTest), sizeof(VkBool32)},
+    {kSpecAlphaCutoff, offsetof(SpecConstants, alphaCutoff), sizeof(float)},
+    {kSpecMaterialBuffer, offsetof(SpecConstants, materialBuffer), sizeof(uint32_t)},
+};
+
+// Suffixes in ShaderPermutation bit order; must match the aurora_add_shader lists
+constexpr const char* kPermutationNames[] = {"bindless"};
+}
+
+SpecConstants specConstants(VertexFormat format, const aurora::MaterialDesc& material, uint32_t materialBuffer) {
+    SpecConstants c;
+    c.octahedralNormal = format == VertexFormat::Quantized ? VK_TRUE : VK_FALSE;
+    c.vertexColor = (material.features & aurora::kMaterialVertexColor) ? VK_TRUE : VK_FALSE;
+    c.lit = (material.features & aurora::kMaterialLit) ? VK_TRUE : VK_FALSE;
+    if (material.features & aurora::kMaterialAlphaTest) {
+        c.alphaTest = VK_TRUE;
+        c.alphaCutoff = material.alphaCutoff;
+    }
+    c.materialBuffer = materialBuffer;
+    return c;
+}
+
+VkSpecializationInfo specializationInfo(const SpecConstants& constants) {
+    VkSpecializationInfo info{};
+    info.mapEntryCount = kSpecConstantCount;
+    info.pMapEntries = kSpecMap;
+    info.dataSize = sizeof(SpecConstants);
+    info.pData = &constants;
+    return info;
+}
+
+std::string shaderPath(const char* shader, uint32_t permutations) {
+    std::string path = std::string("shaders/") + shader;
+    for (uint32_t i = 0; i < std::size(kPermutationNames); ++i) {
+        if (permutations & (1u << i)) path += std::string(".") + kPermutationNames[i];
+    }
+    return path + ".spv";
+}
+
+}
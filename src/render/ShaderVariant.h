@@ -0,0 +1,56 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+
+#include "render/VertexFormat.h"
+
+namespace aurora { struct MaterialDesc; }
+
+namespace render {
+// Mesh shader variants come from two places:
+//  - specialization constants (constant_id in triangle.vert / triangle.frag): material features
+//    and the vertex encoding. One SPIR-V module covers every combination; the values are fixed
+//    when a pipeline is created, so the driver folds the branches on them away.
+//  - #define permutations, compiled by CMake (aurora_add_shader in CMakeLists.txt) into one
+//    module each, only for what a constant cannot change: resource declarations.
+
+// constant_id of each specialization constant
+enum SpecConstantId : uint32_t {
+    kSpecOctahedralNormal = 0, // vert: normals arrive octahedral encoded (VertexFormat::Quantized)
+    kSpecVertexColor = 1,      // frag: aurora::kMaterialVertexColor
+    kSpecLit = 2,              // frag: aurora::kMaterialLit
+    kSpecAlphaTest = 3,        // frag: aurora::kMaterialAlphaTest
+    kSpecAlphaCutoff = 4,      // frag: MaterialDesc::alphaCutoff
+    kSpecMaterialBuffer = 5,   // frag, bindless: table index of vulkan::MaterialTable's buffer
+    kSpecConstantCount
+};
+
+// Values of the specialization constants, laid out as VkSpecializationInfo::pData. Part of
+// vulkan::GraphicsPipelineDesc; values a variant does not use are left 0 so that equal
+// variants compare (and hash) equal.
+struct SpecConstants {
+    VkBool32 octahedralNormal = VK_FALSE;
+    VkBool32 vertexColor = VK_FALSE;
+    VkBool32 lit = VK_FALSE;
+    VkBool32 alphaTest = VK_FALSE;
+    float alphaCutoff = 0.0f;
+    uint32_t materialBuffer = 0;
+
+    bool operator==(const SpecConstants&) const = default;
+};
+
+// Constants of a material drawn with meshes in format. One VkSpecializationInfo serves both
+// stages: a stage ignores the ids it does not declare.
+SpecConstants specConstants(VertexFormat format, const aurora::MaterialDesc& material, uint32_t materialBuffer);
+// pData points at constants, which must outlive the pipeline creation
+VkSpecializationInfo specializationInfo(const SpecConstants& constants);
+
+// #define permutations (bit i = the i-th name in the shader's aurora_add_shader list)
+enum ShaderPermutation : uint32_t {
+    kPermutationBindless = 1u << 0, // AURORA_BINDLESS: material parameters from the bindless table
+};
+// Compiled module of shader (e.g. "triangle.frag") with the given permutations:
+// shaders/triangle.frag.spv, shaders/triangle.frag.bindless.spv, ...
+std::string shaderPath(const char* shader, uint32_t permutations);
+}
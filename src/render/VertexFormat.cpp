@@ -0,0 +1,121 @@
+#include "render/VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include <aurora/DrawList.h>
+
+namespace render {
+
+namespace {
+int16_t toSnorm16(float v) {
+    return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+}
+uint8_t toUnorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+float signNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+}
+
+void octEncode(const float n[3], float out[2]) {
+    float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    if (l1 <= 0.0f) { out[0] = 0.0f; out[1] = 0.0f; return; }
+    float x = n[0] / l1, y = n[1] / l1;
+    if (n[2] < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        float fx = (1.0f - std::fabs(y)) * signNotZero(x);
+        float fy = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    out[0] = x;
+    out[1] = y;
+}
+
+void octDecode(const float e[2], float out[3]) {
+    float x = e[0], y = e[1], z = 1.0f - std::fabs(x) - std::fabs(y);
+    float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    float len = std::sqrt(x * x + y * y + z * z);
+    out[0] = x / len;
+    out[1] = y / len;
+    out[2] = z / len;
+}
+
+uint32_t vertexStride(VertexFormat format) {
+    return format == VertexFormat::Quantized ? static_cast<uint32_t>(sizeof(QuantizedVertex))
+                                             : static_cast<uint32_t>(sizeof(Vertex));
+}
+
+VertexInputLayout vertexInputLayout(VertexFormat format) {
+    VertexInputLayout l;
+    l.bindingCount = 2;
+    l.bindings[0].binding = 0;
+    l.bindings[0].stride = vertexStride(format);
+    l.bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    l.bindings[1].binding = kInstanceBinding;
+    l.bindings[1].stride = static_cast<uint32_t>(sizeof(aurora::DrawCommand));
+    l.bindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    l.attributeCount = 5;
+    for (uint32_t i = 0; i < 3; ++i) { l.attributes[i].binding = 0; l.attributes[i].location = i; }
+    // position[3] and scale are adjacent floats: one vec4
+    l.attributes[3] = {3, kInstanceBinding, VK_FORMAT_R32G32B32A32_SFLOAT, static_cast<uint32_t>(offsetof(aurora::DrawCommand, position))};
+    l.attributes[4] = {4, kInstanceBinding, VK_FORMAT_R32_UINT, static_cast<uint32_t>(offsetof(aurora::DrawCommand, object))};
+    static_assert(offsetof(aurora::DrawCommand, scale) == offsetof(aurora::DrawCommand, position) + 3 * sizeof(float),
+                  "instance attribute 3 reads position and scale as one vec4");
+    if (format == VertexFormat::Quantized) {
+        l.attributes[0].format = VK_FORMAT_R16G16B16A16_SNORM; l.attributes[0].offset = offsetof(QuantizedVertex, pos);
+        l.attributes[1].format = VK_FORMAT_R16G16_SNORM;       l.attributes[1].offset = offsetof(QuantizedVertex, normal);
+        l.attributes[2].format = VK_FORMAT_R8G8B8A8_UNORM;     l.attributes[2].offset = offsetof(QuantizedVertex, color);
+    } else {
+        l.attributes[0].format = VK_FORMAT_R32G32B32_SFLOAT;    l.attributes[0].offset = offsetof(Vertex, pos);
+        l.attributes[1].format = VK_FORMAT_R32G32B32_SFLOAT;    l.attributes[1].offset = offsetof(Vertex, normal);
+        l.attributes[2].format = VK_FORMAT_R32G32B32A32_SFLOAT; l.attributes[2].offset = offsetof(Vertex, color);
+    }
+    return l;
+}
+
+std::vector<uint8_t> encodeVertices(const std::vector<Vertex>& vertices, VertexFormat format, MeshPushConstants& pc) {
+    pc = MeshPushConstants{};
+    std::vector<uint8_t> out(vertices.size() * vertexStride(format));
+    if (format == VertexFormat::Float32) {
+        if (!vertices.empty()) std::memcpy(out.data(), vertices.data(), out.size());
+        return out;
+    }
+
+    // Positions are stored relative to the AABB center, scaled per axis into [-1, 1]
+    float lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+    if (!vertices.empty()) {
+        for (int a = 0; a < 3; ++a) lo[a] = hi[a] = vertices[0].pos[a];
+    }
+    for (const auto& v : vertices) {
+        for (int a = 0; a < 3; ++a) { lo[a] = std::min(lo[a], v.pos[a]); hi[a] = std::max(hi[a], v.pos[a]); }
+    }
+    float center[3], scale[3];
+    for (int a = 0; a < 3; ++a) {
+        center[a] = 0.5f * (lo[a] + hi[a]);
+        scale[a] = 0.5f * (hi[a] - lo[a]);
+        if (scale[a] <= 0.0f) scale[a] = 1.0f; // flat axis: any scale reproduces the center
+        pc.posScale[a] = scale[a];
+        pc.posOffset[a] = center[a];
+    }
+    pc.flags = kMeshFlagOctahedralNormal;
+
+    auto* q = reinterpret_cast<QuantizedVertex*>(out.data());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        for (int a = 0; a < 3; ++a) q[i].pos[a] = toSnorm16((v.pos[a] - center[a]) / scale[a]);
+        q[i].pos[3] = 0;
+        float e[2];
+        octEncode(v.normal, e);
+        q[i].normal[0] = toSnorm16(e[0]);
+        q[i].normal[1] = toSnorm16(e[1]);
+        for (int c = 0; c < 4; ++c) q[i].color[c] = toUnorm8(v.color[c]);
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Full-precision source vertex; VertexFormat decides what the GPU actually gets
+struct Vertex {
+    float pos[3];
+    float normal[3];
+    float color[4];
+};
+
+namespace render {
+// GPU-side vertex encodings. Both feed the same shader inputs (vec4 position / normal /
+// color); MeshPushConstants carries the position dequantization and decode flags.
+enum class VertexFormat : uint8_t {
+    Float32,   // 40 bytes: float3 position, float3 normal, float4 color
+    Quantized, // 16 bytes: snorm16x4 position (mesh AABB), snorm16x2 octahedral normal, RGBA8 color
+};
+
+struct QuantizedVertex {
+    int16_t pos[4];    // w unused (keeps the attribute 8-byte aligned)
+    int16_t normal[2]; // octahedral
+    uint8_t color[4];
+};
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must stay tightly packed");
+
+// Matches the push_constant blocks in triangle.vert / triangle.frag; per mesh (placement is
+// per instance). The material part (from kMaterialOffset) is pushed at each material change:
+// the material id and its base color, or with bindless only the id, which indexes
+// vulkan::MaterialTable's parameter buffer in the bindless table.
+struct MeshPushConstants {
+    float posScale[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+    float posOffset[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    uint32_t flags = 0;
+    uint32_t material = 0;
+    uint32_t pad[2] = {};
+    float baseColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    static constexpr uint32_t kMaterialOffset = 36;
+    static constexpr uint32_t kMeshBytes = 36;     // up to material: what a mesh change pushes
+    static constexpr uint32_t kMaterialBytes = 28; // material to the end
+};
+static_assert(offsetof(MeshPushConstants, material) == MeshPushConstants::kMaterialOffset, "material offset");
+static_assert(offsetof(MeshPushConstants, baseColor) == 48 &&
+              sizeof(MeshPushConstants) == MeshPushConstants::kMaterialOffset + MeshPushConstants::kMaterialBytes,
+              "baseColor must be 16-byte aligned and last");
+// Stages of the mesh push constant range: the fragment stage reads the material part
+constexpr VkShaderStageFlags kMeshPushStages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+// Describes the mesh's encoding; the shaders take it from the OCTAHEDRAL_NORMAL constant
+// (render::kSpecOctahedralNormal) of the pipeline, which uses the same render::VertexFormat
+constexpr uint32_t kMeshFlagOctahedralNormal = 1u << 0;
+
+// Binding 0: vertices (locations 0-2). Binding 1: one aurora::DrawCommand per instance
+// (location 3 = position + scale, location 4 = object), see render::RenderQueue.
+constexpr uint32_t kInstanceBinding = 1;
+struct VertexInputLayout {
+    std::array<VkVertexInputBindingDescription, 2> bindings{};
+    std::array<VkVertexInputAttributeDescription, 5> attributes{};
+    uint32_t bindingCount = 0;
+    uint32_t attributeCount = 0;
+};
+
+VertexInputLayout vertexInputLayout(VertexFormat format);
+uint32_t vertexStride(VertexFormat format);
+
+// Encode vertices; fills pc with the matching dequantization parameters and flags
+std::vector<uint8_t> encodeVertices(const std::vector<Vertex>& vertices, VertexFormat format, MeshPushConstants& pc);
+
+// Unit vector <-> octahedral [-1,1]^2
+void octEncode(const float n[3], float out[2]);
+void octDecode(const float e[2], float out[3]);
+}
@@ -1,6 +1,51 @@
 #version 450
+
+// One source for every material. Features are specialization constants
+// (render::SpecConstantId) fixed per pipeline from aurora::MaterialDesc, so the tests on them
+// below are folded away when the pipeline is created. AURORA_BINDLESS is a build-time
+// permutation (triangle.frag.bindless.spv): the material parameters come from
+// vulkan::MaterialTable's buffer in the bindless table instead of the push constants.
+#ifdef AURORA_BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+layout(location = 0) in vec4 vColor;
+layout(location = 1) in vec3 vNormal;
 layout(location = 0) out vec4 outColor;
 
+layout(constant_id = 1) const bool VERTEX_COLOR = true;
+layout(constant_id = 2) const bool LIT = false;
+layout(constant_id = 3) const bool ALPHA_TEST = false;
+layout(constant_id = 4) const float ALPHA_CUTOFF = 0.5;
+
+// The material part of render::MeshPushConstants
+layout(push_constant) uniform MaterialConstants {
+    layout(offset = 36) uint material;
+    layout(offset = 48) vec4 baseColor;
+} pc;
+
+#ifdef AURORA_BINDLESS
+// vulkan::MaterialTable::Params by material id, in the table entry MATERIAL_BUFFER
+layout(constant_id = 5) const uint MATERIAL_BUFFER = 0u;
+struct MaterialParams {
+    vec4 baseColor;
+};
+layout(std430, set = 1, binding = 1) readonly buffer Materials {
+    MaterialParams params[];
+} materials[];
+#endif
+
+const vec3 LIGHT_DIR = normalize(vec3(0.3, 0.8, 0.5));
+const float AMBIENT = 0.25;
+
 void main() {
-    outColor = vec4(1.0, 0.5, 0.2, 1.0);
+#ifdef AURORA_BINDLESS
+    vec4 color = materials[MATERIAL_BUFFER].params[pc.material].baseColor;
+#else
+    vec4 color = pc.baseColor;
+#endif
+    if (VERTEX_COLOR) color *= vColor;
+    if (LIT) color.rgb *= AMBIENT + (1.0 - AMBIENT) * max(dot(normalize(vNormal), LIGHT_DIR), 0.0);
+    if (ALPHA_TEST && color.a < ALPHA_CUTOFF) discard;
+    outColor = color;
 }
@@ -1,10 +1,52 @@
 #version 450
 
+// Attribute formats come from render::vertexInputLayout: Float32 meshes feed raw floats,
+// Quantized meshes feed SNORM/UNORM values that are rescaled here.
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec4 inNormal;
+layout(location = 2) in vec4 inColor;
+// Per instance: the aurora::DrawCommand being drawn (render::RenderQueue instance buffer, or
+// the draw list itself on the GPU-driven path)
+layout(location = 3) in vec4 inPlacement; // xyz position, w scale
+layout(location = 4) in uint inObject;
+
+// Matches render::MeshPushConstants (the material part is read by triangle.frag)
+layout(push_constant) uniform MeshConstants {
+    vec4 posScale;
+    vec4 posOffset;
+    uint flags;
+} mesh;
+
+// Specialization constant (render::SpecConstantId): set from the pipeline's vertex format
+layout(constant_id = 0) const bool OCTAHEDRAL_NORMAL = true;
+
+// World matrices of scene nodes (vulkan::ObjectBuffer), indexed by inObject
+layout(std430, set = 0, binding = 0) readonly buffer Objects {
+    mat4 world[];
+} objects;
+
+const uint NO_OBJECT = 0xFFFFFFFFu;
+
+layout(location = 0) out vec4 vColor;
+layout(location = 1) out vec3 vNormal;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main() {
-    vec2 positions[3] = vec2[](
-        vec2(0.0, -0.5),
-        vec2(0.5, 0.5),
-        vec2(-0.5, 0.5)
-    );
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    vec3 pos = inPosition.xyz * mesh.posScale.xyz + mesh.posOffset.xyz;
+    vNormal = OCTAHEDRAL_NORMAL ? octDecode(inNormal.xy) : inNormal.xyz;
+    vColor = inColor;
+    if (inObject != NO_OBJECT) {
+        // The set binds the whole buffer, so length() is its capacity: an id past it
+        // collapses the draw instead of reading out of bounds
+        gl_Position = inObject < uint(objects.world.length()) ? objects.world[inObject] * vec4(pos, 1.0) : vec4(0.0);
+    } else {
+        gl_Position = vec4(pos * inPlacement.w + inPlacement.xyz, 1.0);
+    }
 }
@@ -0,0 +1,145 @@
+#include "vulkan/BindlessTable.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "vulkan/DescriptorAllocator.h"
+#include "vulkan/VkObjects.h"
+
+namespace vulkan {
+
+uint32_t BindlessTable::Array::take(const char* what) {
+    if (!free.empty()) {
+        const uint32_t index = free.back();
+        free.pop_back();
+        return index;
+    }
+    if (next == capacity) {
+        throw std::runtime_error(std::string("BindlessTable: no free ") + what + " index (" + std::to_string(capacity) + " in use)");
+    }
+    return next++;
+}
+
+void BindlessTable::Array::release(uint32_t index, uint64_t frameNumber) {
+    if (index >= next) throw std::runtime_error("BindlessTable: removing an index that was never added");
+    pending.emplace_back(index, frameNumber);
+}
+
+void BindlessTable::Array::recycle(uint64_t frameNumber, uint32_t framesInFlight) {
+    // Same rule as the other retired objects: maxFramesInFlight newer frames have waited their fences
+    size_t kept = 0;
+    for (const auto& p : pending) {
+        if (frameNumber >= p.second + framesInFlight) free.push_back(p.first);
+        else pending[kept++] = p;
+    }
+    pending.resize(kept);
+}
+
+BindlessTable::BindlessTable(VkObjects* vk) : vk_(vk) {
+    VkPhysicalDeviceVulkan12Properties props12{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES};
+    VkPhysicalDeviceProperties2 props{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    props.pNext = &props12;
+    vkGetPhysicalDeviceProperties2(vk->physicalDevice, &props);
+    // Leave room for the regular sets that bind alongside this one
+    textures_.capacity = std::min({kMaxTextures, props12.maxPerStageDescriptorUpdateAfterBindSampledImages / 2,
+                                   props12.maxDescriptorSetUpdateAfterBindSampledImages / 2});
+    buffers_.capacity = std::min({kMaxBuffers, props12.maxPerStageDescriptorUpdateAfterBindStorageBuffers / 2,
+                                  props12.maxDescriptorSetUpdateAfterBindStorageBuffers / 2});
+    if (textures_.capacity == 0 || buffers_.capacity == 0) {
+        throw std::runtime_error("BindlessTable: device reports no update-after-bind descriptors");
+    }
+
+    constexpr VkShaderStageFlags kStages = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    bindings[0].binding = kTextureBinding;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = textures_.capacity;
+    bindings[0].stageFlags = kStages;
+    bindings[1].binding = kBufferBinding;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = buffers_.capacity;
+    bindings[1].stageFlags = kStages;
+    const VkDescriptorBindingFlags flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                           VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                                           VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    const VkDescriptorBindingFlags bindingFlags[2] = {flags, flags};
+    setLayout_ = vk->descriptorLayouts->get(bindings, 2, bindingFlags,
+                                            VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+
+    VkDescriptorPoolSize sizes[2] = {{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textures_.capacity},
+                                     {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffers_.capacity}};
+    VkDescriptorPoolCreateInfo pci{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    pci.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pci.maxSets = 1;
+    pci.poolSizeCount = 2;
+    pci.pPoolSizes = sizes;
+    if (vkCreateDescriptorPool(vk->device, &pci, nullptr, &pool_) != VK_SUCCESS) {
+        throw std::runtime_error("BindlessTable: failed to create descriptor pool");
+    }
+    VkDescriptorSetAllocateInfo ai{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    ai.descriptorPool = pool_;
+    ai.descriptorSetCount = 1;
+    ai.pSetLayouts = &setLayout_;
+    if (vkAllocateDescriptorSets(vk->device, &ai, &set_) != VK_SUCCESS) {
+        vkDestroyDescriptorPool(vk->device, pool_, nullptr);
+        throw std::runtime_error("BindlessTable: failed to allocate descriptor set");
+    }
+    stats_.textureCapacity = textures_.capacity;
+    stats_.bufferCapacity = buffers_.capacity;
+    std::cout << "BindlessTable: " << textures_.capacity << " textures, " << buffers_.capacity << " buffers" << std::endl;
+}
+
+BindlessTable::~BindlessTable() {
+    // Caller guarantees the device is idle
+    vkDestroyDescriptorPool(vk_->device, pool_, nullptr); // frees the set
+}
+
+uint32_t BindlessTable::addTexture(VkImageView view, VkSampler sampler, VkImageLayout layout) {
+    const uint32_t index = textures_.take("texture");
+    VkDescriptorImageInfo info{sampler, view, layout};
+    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set_;
+    write.dstBinding = kTextureBinding;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &info;
+    vkUpdateDescriptorSets(vk_->device, 1, &write, 0, nullptr);
+    stats_.textures = textures_.live();
+    return index;
+}
+
+uint32_t BindlessTable::addBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    const uint32_t index = buffers_.take("buffer");
+    VkDescriptorBufferInfo info{buffer, offset, range};
+    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set_;
+    write.dstBinding = kBufferBinding;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &info;
+    vkUpdateDescriptorSets(vk_->device, 1, &write, 0, nullptr);
+    stats_.buffers = buffers_.live();
+    return index;
+}
+
+void BindlessTable::removeTexture(uint32_t index) {
+    // The stale descriptor stays in place: partially bound, and no draw indexes it any more
+    textures_.release(index, vk_->frameNumber);
+    stats_.textures = textures_.live();
+}
+
+void BindlessTable::removeBuffer(uint32_t index) {
+    buffers_.release(index, vk_->frameNumber);
+    stats_.buffers = buffers_.live();
+}
+
+void BindlessTable::beginFrame() {
+    textures_.recycle(vk_->frameNumber, vk_->maxFramesInFlight);
+    buffers_.recycle(vk_->frameNumber, vk_->maxFramesInFlight);
+}
+
+}
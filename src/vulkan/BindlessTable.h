@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct VkObjects;
+
+namespace vulkan {
+// Bindless resources (descriptor indexing): one long-lived descriptor set holding every
+// texture (binding 0, combined image samplers) and storage buffer (binding 1) in two large
+// arrays. Pipelines bind it once as set 1 and shaders pick entries by the index pushed per
+// material (MeshPushConstants::material) instead of binding a descriptor set per material.
+// Both arrays are partially bound and update-after-bind, so entries are written while frames
+// using other entries are in flight; an index given back by remove*() is reused only after
+// maxFramesInFlight frames. Requires the features enabled by DeviceManager when vk->bindless
+// is set. Used from the thread that renders.
+class BindlessTable {
+public:
+    static constexpr uint32_t kTextureBinding = 0;
+    static constexpr uint32_t kBufferBinding = 1;
+    // Upper bounds; clamped to the device's update-after-bind limits
+    static constexpr uint32_t kMaxTextures = 16384;
+    static constexpr uint32_t kMaxBuffers = 4096;
+
+    struct Stats {
+        uint32_t textures = 0; // live entries
+        uint32_t buffers = 0;
+        uint32_t textureCapacity = 0;
+        uint32_t bufferCapacity = 0;
+    };
+
+    explicit BindlessTable(VkObjects* vk);
+    ~BindlessTable();
+
+    BindlessTable(const BindlessTable&) = delete;
+    BindlessTable& operator=(const BindlessTable&) = delete;
+
+    // Return the array index; throw when the table is full
+    uint32_t addTexture(VkImageView view, VkSampler sampler,
+                        VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint32_t addBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    // The caller keeps the resource alive until no frame in flight can read it
+    void removeTexture(uint32_t index);
+    void removeBuffer(uint32_t index);
+
+    // After the frame's fence wait: indices removed maxFramesInFlight frames ago become free
+    void beginFrame();
+
+    VkDescriptorSetLayout setLayout() const { return setLayout_; }
+    VkDescriptorSet set() const { return set_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Array {
+        uint32_t capacity = 0;
+        uint32_t next = 0;                 // never handed out at and above
+        std::vector<uint32_t> free;        // reusable now
+        std::vector<std::pair<uint32_t, uint64_t>> pending; // index, frameNumber at removal
+        uint32_t take(const char* what);
+        void release(uint32_t index, uint64_t frameNumber);
+        void recycle(uint64_t frameNumber, uint32_t framesInFlight);
+        uint32_t live() const { return next - static_cast<uint32_t>(free.size() + pending.size()); }
+    };
+
+    VkObjects* vk_ = nullptr;
+    VkDescriptorSetLayout setLayout_ = VK_NULL_HANDLE; // owned by vk->descriptorLayouts
+    VkDescriptorPool pool_ = VK_NULL_HANDLE;
+    VkDescriptorSet set_ = VK_NULL_HANDLE;
+    Array textures_, buffers_;
+    Stats stats_;
+};
+}
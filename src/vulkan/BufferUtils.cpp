@@ -14,28 +14,25 @@ VkDeviceSize findMemoryTypeIndex(VkPhysicalDevice phys, uint32_t typeBits, VkMem
     throw std::runtime_error("Failed to find suitable memory type");
 }
 
-void createBuffer(VkDevice device,
-                  VkPhysicalDevice phys,
+void createBuffer(VkObjects* vk,
                   VkDeviceSize size,
                   VkBufferUsageFlags usage,
                   VkMemoryPropertyFlags props,
                   VkBuffer& outBuffer,
-                  VkDeviceMemory& outMemory) {
+                  vulkan::Allocation& outAlloc) {
     VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
     bci.size = size;
     bci.usage = usage;
     bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    if (vkCreateBuffer(device, &bci, nullptr, &outBuffer) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create buffer");
-    }
-    VkMemoryRequirements req; vkGetBufferMemoryRequirements(device, outBuffer, &req);
-    uint32_t memType = (uint32_t)findMemoryTypeIndex(phys, req.memoryTypeBits, props);
-    VkMemoryAllocateInfo mai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-    mai.allocationSize = req.size; mai.memoryTypeIndex = memType;
-    if (vkAllocateMemory(device, &mai, nullptr, &outMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory");
-    }
-    vkBindBufferMemory(device, outBuffer, outMemory, 0);
+    // Coherent host memory where available so uploads need no explicit flush
+    VkMemoryPropertyFlags preferred = (props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? VK_MEMORY_PROPERTY_HOST_COHERENT_BIT : 0;
+    outBuffer = vk->allocator->createBuffer(bci, props, preferred, outAlloc);
+}
+
+void destroyBuffer(VkObjects* vk, VkBuffer& buffer, vulkan::Allocation& alloc) {
+    if (!vk->allocator) return;
+    vk->allocator->destroyBuffer(buffer, alloc);
+    buffer = VK_NULL_HANDLE;
 }
 
 }
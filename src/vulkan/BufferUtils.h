@@ -1,26 +1,30 @@
 ﻿#pragma once
 #include <vulkan/vulkan.h>
 #include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <vector>
 
-struct VkObjects;
+#include "vulkan/VkObjects.h"
 
 namespace vkbuf {
 VkDeviceSize findMemoryTypeIndex(VkPhysicalDevice phys, uint32_t typeBits, VkMemoryPropertyFlags props);
 
-void createBuffer(VkDevice device,
-                  VkPhysicalDevice phys,
+// Sub-allocated through vk->allocator; host-visible memory comes back persistently mapped
+void createBuffer(VkObjects* vk,
                   VkDeviceSize size,
                   VkBufferUsageFlags usage,
                   VkMemoryPropertyFlags props,
                   VkBuffer& outBuffer,
-                  VkDeviceMemory& outMemory);
+                  vulkan::Allocation& outAlloc);
+void destroyBuffer(VkObjects* vk, VkBuffer& buffer, vulkan::Allocation& alloc);
 
+// Copies data to the start of a host-visible (mapped) allocation and flushes it. Throws if
+// the allocation is not mapped.
 template<typename T>
-void uploadToMappedMemory(VkDevice device, VkDeviceMemory memory, const std::vector<T>& data) {
-    void* mapped = nullptr;
-    vkMapMemory(device, memory, 0, sizeof(T)*data.size(), 0, &mapped);
-    std::memcpy(mapped, data.data(), sizeof(T)*data.size());
-    vkUnmapMemory(device, memory);
+void uploadToMappedMemory(VkObjects* vk, const vulkan::Allocation& alloc, const std::vector<T>& data) {
+    if (!alloc.mapped) throw std::runtime_error("uploadToMappedMemory: allocation is not host-visible");
+    std::memcpy(alloc.mapped, data.data(), sizeof(T)*data.size());
+    vk->allocator->flush(alloc, 0, sizeof(T)*data.size());
 }
 }
@@ -0,0 +1,111 @@
+#include "vulkan/CommandRecorder.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include "vulkan/VkObjects.h"
+#include <aurora/JobSystem.h>
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+CommandRecorder::CommandRecorder(VkObjects* vk, uint32_t frameCount, aurora::JobSystem& jobs, uint32_t maxPartitions)
+    : vk_(vk), jobs_(jobs) {
+    maxPartitions_ = maxPartitions == 0 ? jobs.threadCount() : maxPartitions;
+
+    // TRANSIENT: buffers live one frame; the whole pool is reset instead of single buffers
+    VkCommandPoolCreateInfo ci{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    ci.queueFamilyIndex = vk->graphicsQueueFamily;
+    ci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pools_.assign(frameCount, std::vector<VkCommandPool>(maxPartitions_, VK_NULL_HANDLE));
+    buffers_.assign(frameCount, std::vector<VkCommandBuffer>(maxPartitions_, VK_NULL_HANDLE));
+    for (uint32_t f = 0; f < frameCount; ++f) {
+        for (uint32_t p = 0; p < maxPartitions_; ++p) {
+            if (vkCreateCommandPool(vk->device, &ci, nullptr, &pools_[f][p]) != VK_SUCCESS) {
+                throw std::runtime_error("CommandRecorder: failed to create command pool");
+            }
+            VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            ai.commandPool = pools_[f][p];
+            ai.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            ai.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(vk->device, &ai, &buffers_[f][p]) != VK_SUCCESS) {
+                throw std::runtime_error("CommandRecorder: failed to allocate secondary command buffer");
+            }
+        }
+    }
+    executed_.reserve(maxPartitions_);
+}
+
+CommandRecorder::~CommandRecorder() {
+    // Destroying the pools frees their buffers
+    for (auto& frame : pools_) {
+        for (VkCommandPool pool : frame) {
+            if (pool) vkDestroyCommandPool(vk_->device, pool, nullptr);
+        }
+    }
+}
+
+void CommandRecorder::beginFrame(uint32_t frameIndex) {
+    for (VkCommandPool pool : pools_[frameIndex]) vkResetCommandPool(vk_->device, pool, 0);
+}
+
+uint32_t CommandRecorder::partitionCount(uint32_t itemCount) const {
+    uint32_t wanted = (itemCount + kMinItemsPerThread - 1) / kMinItemsPerThread;
+    return std::clamp(wanted, 1u, maxPartitions_);
+}
+
+const std::vector<VkCommandBuffer>& CommandRecorder::record(uint32_t frameIndex, VkFramebuffer framebuffer,
+                                                            uint32_t itemCount, const RecordFn& fn) {
+    AURORA_PROFILE_ZONE("CommandRecorder::record");
+    const uint32_t partitions = partitionCount(itemCount);
+
+    // Jobs must not throw: failures are carried back here and rethrown after the wait
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto recordGuarded = [&](uint32_t p) {
+        try {
+            recordRange(frameIndex, framebuffer, p, partitions, itemCount, fn);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    aurora::JobCounter counter;
+    for (uint32_t p = 1; p < partitions; ++p) {
+        jobs_.run([&recordGuarded, p] { recordGuarded(p); }, &counter);
+    }
+    recordGuarded(0);
+    jobs_.wait(counter);
+    if (error) std::rethrow_exception(error);
+
+    executed_.assign(buffers_[frameIndex].begin(), buffers_[frameIndex].begin() + partitions);
+    return executed_;
+}
+
+void CommandRecorder::recordRange(uint32_t frameIndex, VkFramebuffer framebuffer, uint32_t partition,
+                                  uint32_t partitions, uint32_t itemCount, const RecordFn& fn) {
+    AURORA_PROFILE_ZONE("CommandRecorder::recordRange");
+    const uint32_t first = static_cast<uint32_t>(uint64_t(itemCount) * partition / partitions);
+    const uint32_t end = static_cast<uint32_t>(uint64_t(itemCount) * (partition + 1) / partitions);
+    VkCommandBuffer cmd = buffers_[frameIndex][partition];
+
+    VkCommandBufferInheritanceInfo inherit{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    inherit.renderPass = vk_->renderPass;
+    inherit.subpass = 0;
+    inherit.framebuffer = framebuffer;
+    VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    bi.pInheritanceInfo = &inherit;
+    if (vkBeginCommandBuffer(cmd, &bi) != VK_SUCCESS) {
+        throw std::runtime_error("CommandRecorder: failed to begin secondary command buffer");
+    }
+    fn(cmd, first, end - first);
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+        throw std::runtime_error("CommandRecorder: failed to record secondary command buffer");
+    }
+}
+
+}
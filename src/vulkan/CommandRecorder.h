@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct VkObjects;
+namespace aurora { class JobSystem; }
+
+namespace vulkan {
+// Parallel recording of the main pass. [0, itemCount) is split into contiguous ranges
+// recorded as jobs on the engine's aurora::JobSystem (the calling thread takes the first
+// and helps with the rest). Each range has its own secondary command buffer and per-frame
+// pool, so no pool is ever touched by two threads at once. The buffers are returned in range
+// order, so vkCmdExecuteCommands replays the draws in exactly the submission order no
+// matter which thread finished first.
+class CommandRecorder {
+public:
+    // Below this many items per range the split costs more than it saves
+    static constexpr uint32_t kMinItemsPerThread = 512;
+
+    using RecordFn = std::function<void(VkCommandBuffer cmd, uint32_t first, uint32_t count)>;
+
+    // maxPartitions 0 = one per job system thread
+    CommandRecorder(VkObjects* vk, uint32_t frameCount, aurora::JobSystem& jobs, uint32_t maxPartitions);
+    ~CommandRecorder();
+
+    CommandRecorder(const CommandRecorder&) = delete;
+    CommandRecorder& operator=(const CommandRecorder&) = delete;
+
+    // After the frame's fence wait: recycles this frame's pools
+    void beginFrame(uint32_t frameIndex);
+
+    // Number of secondary buffers record() will use for itemCount items (1 = record inline)
+    uint32_t partitionCount(uint32_t itemCount) const;
+
+    // Records secondaries continuing vk->renderPass subpass 0 on framebuffer. fn runs once per
+    // range, concurrently, and must only touch its own command buffer.
+    const std::vector<VkCommandBuffer>& record(uint32_t frameIndex, VkFramebuffer framebuffer,
+                                               uint32_t itemCount, const RecordFn& fn);
+
+    uint32_t maxPartitions() const { return maxPartitions_; }
+
+private:
+    void recordRange(uint32_t frameIndex, VkFramebuffer framebuffer, uint32_t partition, uint32_t partitions,
+                     uint32_t itemCount, const RecordFn& fn);
+
+    VkObjects* vk_ = nullptr;
+    aurora::JobSystem& jobs_;
+    uint32_t maxPartitions_ = 1;
+    // [frame][partition]
+    std::vector<std::vector<VkCommandPool>> pools_;
+    std::vector<std::vector<VkCommandBuffer>> buffers_;
+    std::vector<VkCommandBuffer> executed_;
+};
+}
@@ -0,0 +1,199 @@
+#include "vulkan/DescriptorAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "vulkan/Utils.h"
+#include "vulkan/VkObjects.h"
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+namespace {
+// Descriptors per set in each per-frame pool, by type
+struct PoolRatio {
+    VkDescriptorType type;
+    float perSet;
+};
+constexpr PoolRatio kPoolRatios[] = {
+    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3.0f},
+    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f},
+    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+    {VK_DESCRIPTOR_TYPE_SAMPLER, 1.0f},
+};
+}
+
+// --- DescriptorLayoutCache
+
+DescriptorLayoutCache::~DescriptorLayoutCache() {
+    for (auto& [hash, list] : entries_) {
+        for (Entry& e : list) vkDestroyDescriptorSetLayout(device_, e.layout, nullptr);
+    }
+}
+
+bool DescriptorLayoutCache::equal(const Entry& a, const std::vector<Binding>& bindings, VkDescriptorSetLayoutCreateFlags flags) {
+    if (a.flags != flags || a.bindings.size() != bindings.size()) return false;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        const Binding& x = a.bindings[i];
+        const Binding& y = bindings[i];
+        if (x.binding.binding != y.binding.binding || x.binding.descriptorType != y.binding.descriptorType ||
+            x.binding.descriptorCount != y.binding.descriptorCount || x.binding.stageFlags != y.binding.stageFlags ||
+            x.flags != y.flags || x.immutableSamplers != y.immutableSamplers) {
+            return false;
+        }
+    }
+    return true;
+}
+
+VkDescriptorSetLayout DescriptorLayoutCache::get(const VkDescriptorSetLayoutBinding* bindings, uint32_t count,
+                                                 const VkDescriptorBindingFlags* bindingFlags,
+                                                 VkDescriptorSetLayoutCreateFlags flags) {
+    std::vector<Binding> key(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        key[i].binding = bindings[i];
+        key[i].flags = bindingFlags ? bindingFlags[i] : 0;
+        if (bindings[i].pImmutableSamplers) {
+            key[i].immutableSamplers.assign(bindings[i].pImmutableSamplers,
+                                            bindings[i].pImmutableSamplers + bindings[i].descriptorCount);
+        }
+        key[i].binding.pImmutableSamplers = nullptr; // points into key[i].immutableSamplers once stored
+    }
+    std::sort(key.begin(), key.end(), [](const Binding& a, const Binding& b) { return a.binding.binding < b.binding.binding; });
+    using vkutils::hashMix;
+    uint64_t hash = hashMix(vkutils::kHashSeed, flags);
+    for (const Binding& b : key) {
+        hash = hashMix(hash, b.binding.binding);
+        hash = hashMix(hash, static_cast<uint64_t>(b.binding.descriptorType));
+        hash = hashMix(hash, b.binding.descriptorCount);
+        hash = hashMix(hash, b.binding.stageFlags);
+        hash = hashMix(hash, b.flags);
+        for (VkSampler s : b.immutableSamplers) hash = hashMix(hash, reinterpret_cast<uint64_t>(s));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.requests;
+    std::vector<Entry>& list = entries_[hash];
+    for (const Entry& e : list) {
+        if (equal(e, key, flags)) {
+            ++stats_.hits;
+            return e.layout;
+        }
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> vkBindings(key.size());
+    std::vector<VkDescriptorBindingFlags> vkFlags(key.size());
+    bool anyFlags = false;
+    for (size_t i = 0; i < key.size(); ++i) {
+        vkBindings[i] = key[i].binding;
+        vkBindings[i].pImmutableSamplers = key[i].immutableSamplers.empty() ? nullptr : key[i].immutableSamplers.data();
+        vkFlags[i] = key[i].flags;
+        anyFlags = anyFlags || key[i].flags;
+    }
+    VkDescriptorSetLayoutBindingFlagsCreateInfo fci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+    fci.bindingCount = static_cast<uint32_t>(vkFlags.size());
+    fci.pBindingFlags = vkFlags.data();
+    VkDescriptorSetLayoutCreateInfo lci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    lci.pNext = anyFlags ? &fci : nullptr;
+    lci.flags = flags;
+    lci.bindingCount = static_cast<uint32_t>(vkBindings.size());
+    lci.pBindings = vkBindings.data();
+    Entry entry;
+    if (vkCreateDescriptorSetLayout(device_, &lci, nullptr, &entry.layout) != VK_SUCCESS) {
+        throw std::runtime_error("DescriptorLayoutCache: failed to create descriptor set layout");
+    }
+    entry.bindings = std::move(key);
+    entry.flags = flags;
+    list.push_back(std::move(entry));
+    ++stats_.layouts;
+    return list.back().layout;
+}
+
+DescriptorLayoutCache::Stats DescriptorLayoutCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// --- DescriptorAllocator
+
+DescriptorAllocator::DescriptorAllocator(VkObjects* vk, uint32_t frameCount) : vk_(vk), frames_(frameCount) {}
+
+DescriptorAllocator::~DescriptorAllocator() {
+    // Caller guarantees the device is idle
+    for (Frame& f : frames_) {
+        for (VkDescriptorPool p : f.used) vkDestroyDescriptorPool(vk_->device, p, nullptr);
+        if (f.current) vkDestroyDescriptorPool(vk_->device, f.current, nullptr);
+    }
+    for (VkDescriptorPool p : spare_) vkDestroyDescriptorPool(vk_->device, p, nullptr);
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameIndex) {
+    frame_ = frameIndex;
+    Frame& f = frames_[frameIndex];
+    stats_.setsAllocated = 0;
+    stats_.poolResets = 0;
+    if (f.current) f.used.push_back(f.current);
+    f.current = VK_NULL_HANDLE;
+    for (VkDescriptorPool p : f.used) {
+        vkResetDescriptorPool(vk_->device, p, 0);
+        spare_.push_back(p);
+        ++stats_.poolResets;
+    }
+    f.used.clear();
+}
+
+VkDescriptorPool DescriptorAllocator::takePool() {
+    if (!spare_.empty()) {
+        VkDescriptorPool p = spare_.back();
+        spare_.pop_back();
+        return p;
+    }
+    AURORA_PROFILE_ZONE("DescriptorAllocator::createPool");
+    VkDescriptorPoolSize sizes[std::size(kPoolRatios)];
+    for (size_t i = 0; i < std::size(kPoolRatios); ++i) {
+        sizes[i] = {kPoolRatios[i].type, static_cast<uint32_t>(kPoolRatios[i].perSet * static_cast<float>(setsPerPool_))};
+    }
+    VkDescriptorPoolCreateInfo pci{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    pci.maxSets = setsPerPool_;
+    pci.poolSizeCount = static_cast<uint32_t>(std::size(sizes));
+    pci.pPoolSizes = sizes;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(vk_->device, &pci, nullptr, &pool) != VK_SUCCESS) {
+        throw std::runtime_error("DescriptorAllocator: failed to create descriptor pool");
+    }
+    ++stats_.pools;
+    setsPerPool_ = std::min(setsPerPool_ * 2, kMaxSetsPerPool);
+    return pool;
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+    Frame& f = frames_[frame_];
+    VkDescriptorSetAllocateInfo ai{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    ai.descriptorSetCount = 1;
+    ai.pSetLayouts = &layout;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!f.current) {
+            // Replacing a full pool with no spare left creates one: the pools are growing
+            if (attempt > 0 && spare_.empty()) ++stats_.poolGrowths;
+            f.current = takePool();
+        }
+        ai.descriptorPool = f.current;
+        const VkResult res = vkAllocateDescriptorSets(vk_->device, &ai, &set);
+        if (res == VK_SUCCESS) {
+            ++stats_.setsAllocated;
+            ++stats_.setsAllocatedTotal;
+            return set;
+        }
+        if (res != VK_ERROR_OUT_OF_POOL_MEMORY && res != VK_ERROR_FRAGMENTED_POOL) break;
+        // This pool is full for the rest of the frame
+        f.used.push_back(f.current);
+        f.current = VK_NULL_HANDLE;
+    }
+    throw std::runtime_error("DescriptorAllocator: failed to allocate descriptor set");
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct VkObjects;
+
+namespace vulkan {
+// Owns every VkDescriptorSetLayout: get() returns the layout for a binding list, creating it
+// on first use. Keyed by a hash of the bindings (sorted by binding number, so declaration
+// order does not matter), compared in full on a hash match. Layouts live until the cache is
+// destroyed; callers never destroy them. Thread-safe (pipelines may be built off-thread).
+class DescriptorLayoutCache {
+public:
+    struct Stats {
+        uint32_t layouts = 0;  // distinct layouts created
+        uint64_t requests = 0; // get() calls
+        uint64_t hits = 0;     // served from the cache
+    };
+
+    explicit DescriptorLayoutCache(VkDevice device) : device_(device) {}
+    ~DescriptorLayoutCache();
+
+    DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+    DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+    // bindingFlags (null = none) is per binding, as in VkDescriptorSetLayoutBindingFlagsCreateInfo
+    VkDescriptorSetLayout get(const VkDescriptorSetLayoutBinding* bindings, uint32_t count,
+                              const VkDescriptorBindingFlags* bindingFlags = nullptr,
+                              VkDescriptorSetLayoutCreateFlags flags = 0);
+
+    Stats stats() const;
+
+private:
+    struct Binding {
+        VkDescriptorSetLayoutBinding binding{};
+        VkDescriptorBindingFlags flags = 0;
+        std::vector<VkSampler> immutableSamplers;
+    };
+    struct Entry {
+        std::vector<Binding> bindings; // sorted by binding number
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    };
+
+    static bool equal(const Entry& a, const std::vector<Binding>& bindings, VkDescriptorSetLayoutCreateFlags flags);
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::vector<Entry>> entries_; // by hash
+    Stats stats_;
+};
+
+// Descriptor sets that live for one frame. Each frame in flight draws sets from its own list
+// of pools; beginFrame resets them all with vkResetDescriptorPool (no per-set frees) once the
+// frame's fence has been waited on. A full pool is set aside and replaced by a spare one or a
+// new pool twice as large (up to kMaxSetsPerPool), so the pools grow to the busiest frame and
+// then stop allocating. Pool sizes per set follow kPoolRatios. Used from the thread that renders.
+class DescriptorAllocator {
+public:
+    static constexpr uint32_t kInitialSetsPerPool = 64;
+    static constexpr uint32_t kMaxSetsPerPool = 4096;
+
+    struct Stats {
+        uint32_t setsAllocated = 0;     // by the current frame
+        uint64_t setsAllocatedTotal = 0;
+        uint32_t pools = 0;             // created so far
+        uint32_t poolGrowths = 0;       // pools created because a frame filled its pool and no spare was left
+        uint32_t poolResets = 0;        // by the last beginFrame
+    };
+
+    DescriptorAllocator(VkObjects* vk, uint32_t frameCount);
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    // After the frame's fence wait: every set this slot allocated last time is invalid
+    void beginFrame(uint32_t frameIndex);
+    // Valid until the same frame slot begins again. Throws if even a fresh pool cannot hold it
+    // (a layout with more descriptors of one type than the pool ratios allow).
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Frame {
+        std::vector<VkDescriptorPool> used; // full pools, reset at beginFrame
+        VkDescriptorPool current = VK_NULL_HANDLE;
+    };
+
+    VkDescriptorPool takePool();
+
+    VkObjects* vk_ = nullptr;
+    std::vector<Frame> frames_;
+    std::vector<VkDescriptorPool> spare_; // reset, not owned by a frame
+    uint32_t frame_ = 0;
+    uint32_t setsPerPool_ = kInitialSetsPerPool;
+    Stats stats_;
+};
+}
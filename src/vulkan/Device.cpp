@@ -6,6 +6,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <vector>
+#include <cstring>
 
 #include <vulkan/vulkan_core.h>
 
@@ -26,7 +27,8 @@ void DeviceManager::pickPhysicalDevice(VkObjects* vk) {
 
         for (uint32_t i = 0; i < qCount; ++i) {
             VkBool32 present = VK_FALSE;
-            vkGetPhysicalDeviceSurfaceSupportKHR(dev, i, vk->surface, &present);
+            if (vk->headless) present = VK_TRUE; // nothing to present to
+            else vkGetPhysicalDeviceSurfaceSupportKHR(dev, i, vk->surface, &present);
             if ((qProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && present) {
                 vk->physicalDevice = dev;
                 vk->graphicsQueueFamily = i;
@@ -52,13 +54,78 @@ void DeviceManager::createLogicalDevice(VkObjects* vk) {
     qci.queueCount = 1;
     qci.pQueuePriorities = &priority;
 
-    const char* deviceExts[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    std::vector<const char*> deviceExts;
+    if (!vk->headless) deviceExts.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+    // Optional: lets PipelineCache tell cache hits from fresh compiles
+    uint32_t extCount = 0;
+    vkEnumerateDeviceExtensionProperties(vk->physicalDevice, nullptr, &extCount, nullptr);
+    std::vector<VkExtensionProperties> available(extCount);
+    vkEnumerateDeviceExtensionProperties(vk->physicalDevice, nullptr, &extCount, available.data());
+    vk->pipelineCreationFeedback = false;
+    for (const auto& ext : available) {
+        if (std::strcmp(ext.extensionName, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME) == 0) {
+            deviceExts.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+            vk->pipelineCreationFeedback = true;
+            break;
+        }
+    }
+
+    // GPU-driven rendering (vulkan::GpuDrivenPass) draws with vkCmdDrawIndexedIndirectCount
+    // (Vulkan 1.2 drawIndirectCount, many draws per call: multiDrawIndirect) and passes the
+    // draw index as firstInstance (drawIndirectFirstInstance). Without all three it stays off.
+    // Bindless (vulkan::BindlessTable) needs Vulkan 1.2 descriptor indexing: runtime-sized,
+    // partially bound arrays updated after bind, indexed non-uniformly.
+    VkPhysicalDeviceVulkan12Features features12{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    VkPhysicalDeviceFeatures2 features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    if (vk->gpuDriven || vk->bindless) {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(vk->physicalDevice, &props);
+        VkPhysicalDeviceVulkan12Features supported12{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+        VkPhysicalDeviceFeatures2 supported{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        if (props.apiVersion >= VK_API_VERSION_1_2) {
+            supported.pNext = &supported12;
+            vkGetPhysicalDeviceFeatures2(vk->physicalDevice, &supported);
+        }
+        const bool requestedGpuDriven = vk->gpuDriven;
+        vk->gpuDriven = vk->gpuDriven && supported12.drawIndirectCount && supported.features.multiDrawIndirect &&
+                        supported.features.drawIndirectFirstInstance;
+        if (vk->gpuDriven) {
+            features12.drawIndirectCount = VK_TRUE;
+            features.features.multiDrawIndirect = VK_TRUE;
+            features.features.drawIndirectFirstInstance = VK_TRUE;
+        } else if (requestedGpuDriven) {
+            std::cout << "GPU-driven rendering unsupported (needs Vulkan 1.2 drawIndirectCount, multiDrawIndirect, "
+                         "drawIndirectFirstInstance); drawing from the CPU" << std::endl;
+        }
+        const bool requestedBindless = vk->bindless;
+        vk->bindless = vk->bindless && supported12.descriptorIndexing && supported12.runtimeDescriptorArray &&
+                       supported12.descriptorBindingPartiallyBound &&
+                       supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                       supported12.descriptorBindingStorageBufferUpdateAfterBind &&
+                       supported12.descriptorBindingUpdateUnusedWhilePending &&
+                       supported12.shaderSampledImageArrayNonUniformIndexing;
+        if (vk->bindless) {
+            features12.descriptorIndexing = VK_TRUE;
+            features12.runtimeDescriptorArray = VK_TRUE;
+            features12.descriptorBindingPartiallyBound = VK_TRUE;
+            features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        } else if (requestedBindless) {
+            std::cout << "Bindless descriptors unsupported (needs Vulkan 1.2 descriptor indexing with "
+                         "update-after-bind); binding descriptor sets per material" << std::endl;
+        }
+        features.pNext = &features12;
+    }
 
     VkDeviceCreateInfo dci{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    if (vk->gpuDriven || vk->bindless) dci.pNext = &features;
     dci.queueCreateInfoCount = 1;
     dci.pQueueCreateInfos = &qci;
-    dci.enabledExtensionCount = 1;
-    dci.ppEnabledExtensionNames = deviceExts;
+    dci.enabledExtensionCount = static_cast<uint32_t>(deviceExts.size());
+    dci.ppEnabledExtensionNames = deviceExts.data();
 
     if (vkCreateDevice(vk->physicalDevice, &dci, nullptr, &vk->device) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create logical device");
@@ -0,0 +1,128 @@
+#include "FrameAllocator.h"
+
+#include <stdexcept>
+#include <algorithm>
+
+#include "vulkan/VkObjects.h"
+
+namespace vulkan {
+
+namespace {
+constexpr VkBufferUsageFlags kUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+}
+
+FrameAllocator::FrameAllocator(VkObjects* vk, uint32_t frameCount, VkDeviceSize bytesPerFrame)
+    : vk_(vk), overflow_(frameCount) {
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(vk->physicalDevice, &props);
+    uniformAlignment_ = std::max<VkDeviceSize>(1, props.limits.minUniformBufferOffsetAlignment);
+    storageAlignment_ = std::max<VkDeviceSize>(1, props.limits.minStorageBufferOffsetAlignment);
+    // Regions start on an alignment every allocation kind accepts
+    VkDeviceSize regionAlign = std::max({uniformAlignment_, storageAlignment_, props.limits.nonCoherentAtomSize, VkDeviceSize(16)});
+    bytesPerFrame_ = (bytesPerFrame + regionAlign - 1) / regionAlign * regionAlign;
+
+    VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bci.size = bytesPerFrame_ * frameCount;
+    bci.usage = kUsage;
+    bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // Device-local + host-visible (ReBAR / UMA) when available, else plain coherent host memory
+    buffer_ = vk->allocator->createBuffer(bci, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, alloc_);
+    if (!alloc_.mapped) {
+        vk->allocator->destroyBuffer(buffer_, alloc_);
+        throw std::runtime_error("Failed to map per-frame buffer");
+    }
+}
+
+FrameAllocator::~FrameAllocator() {
+    for (auto& frame : overflow_) {
+        for (Overflow& o : frame) vk_->allocator->destroyBuffer(o.buffer, o.alloc);
+    }
+    vk_->allocator->destroyBuffer(buffer_, alloc_);
+}
+
+void FrameAllocator::beginFrame(uint32_t frameIndex) {
+    frameIndex_ = frameIndex;
+    regionBase_ = bytesPerFrame_ * frameIndex;
+    cursor_.store(regionBase_, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    for (Overflow& o : overflow_[frameIndex]) o.used = 0;
+}
+
+void FrameAllocator::flush() {
+    VkDeviceSize used = bytesUsed();
+    if (used) vk_->allocator->flush(alloc_, regionBase_, used);
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    for (Overflow& o : overflow_[frameIndex_]) {
+        if (o.used) vk_->allocator->flush(o.alloc, 0, o.used);
+    }
+}
+
+VkDeviceSize FrameAllocator::overflowBytes() const {
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    VkDeviceSize bytes = 0;
+    for (const Overflow& o : overflow_[frameIndex_]) bytes += o.used;
+    return bytes;
+}
+
+FrameAllocator::Slice FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    alignment = std::max<VkDeviceSize>(1, alignment);
+    const VkDeviceSize regionEnd = regionBase_ + bytesPerFrame_;
+    VkDeviceSize cur = cursor_.load(std::memory_order_relaxed);
+    VkDeviceSize offset;
+    do {
+        offset = (cur + alignment - 1) / alignment * alignment;
+        if (offset + size > regionEnd) return allocateOverflow(size, alignment);
+    } while (!cursor_.compare_exchange_weak(cur, offset + size, std::memory_order_relaxed));
+
+    Slice s;
+    s.buffer = buffer_;
+    s.offset = offset;
+    s.size = size;
+    s.data = static_cast<char*>(alloc_.mapped) + offset;
+    return s;
+}
+
+// First fit in the frame's overflow buffers, else a new one. Buffers start at offset 0, which
+// satisfies every alignment.
+FrameAllocator::Slice FrameAllocator::allocateOverflow(VkDeviceSize size, VkDeviceSize alignment) {
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    std::vector<Overflow>& frame = overflow_[frameIndex_];
+    Overflow* target = nullptr;
+    VkDeviceSize offset = 0;
+    for (Overflow& o : frame) {
+        offset = (o.used + alignment - 1) / alignment * alignment;
+        if (offset + size <= o.size) {
+            target = &o;
+            break;
+        }
+    }
+    if (!target) {
+        Overflow o;
+        o.size = std::max(size, bytesPerFrame_);
+        VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bci.size = o.size;
+        bci.usage = kUsage;
+        bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        o.buffer = vk_->allocator->createBuffer(bci, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, o.alloc);
+        if (!o.alloc.mapped) {
+            vk_->allocator->destroyBuffer(o.buffer, o.alloc);
+            throw std::runtime_error("FrameAllocator: failed to map overflow buffer");
+        }
+        frame.push_back(o);
+        target = &frame.back();
+        offset = 0;
+    }
+    target->used = offset + size;
+
+    Slice s;
+    s.buffer = target->buffer;
+    s.offset = offset;
+    s.size = size;
+    s.data = static_cast<char*>(target->alloc.mapped) + offset;
+    return s;
+}
+
+} // namespace vulkan
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "vulkan/MemoryAllocator.h"
+
+struct VkObjects;
+
+namespace vulkan {
+// Transient per-frame GPU data (uniforms, instance data, dynamic vertices). One persistently
+// mapped buffer split into a region per frame in flight; allocation is a lock-free bump of
+// the current region's cursor, and beginFrame rewinds a region once its frame fence has
+// been waited on. A request the region cannot hold spills into overflow buffers owned by
+// that frame (created under a lock, at least bytesPerFrame each); they are kept and rewound
+// with the region, so a frame's capacity grows to its high-water mark instead of failing.
+// Results are buffer + offset pairs, usable as dynamic descriptor offsets, so callers must
+// not assume every slice of a frame shares one buffer.
+// Allocate only while the frame is being recorded (between beginFrame and submit).
+class FrameAllocator {
+public:
+    static constexpr VkDeviceSize kDefaultBytesPerFrame = 8ull << 20; // ~299k instances of 28 bytes before overflow
+
+    struct Slice {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* data = nullptr; // CPU write pointer, valid until the frame is submitted
+        uint32_t dynamicOffset() const { return static_cast<uint32_t>(offset); }
+        explicit operator bool() const { return buffer != VK_NULL_HANDLE; }
+    };
+
+    FrameAllocator(VkObjects* vk, uint32_t frameCount, VkDeviceSize bytesPerFrame = kDefaultBytesPerFrame);
+    ~FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    // After the frame's fence wait: this region is free again
+    void beginFrame(uint32_t frameIndex);
+    // Before queue submit: make writes visible (no-op on coherent memory)
+    void flush();
+
+    // Thread-safe. Lock-free unless the frame's region is exhausted.
+    Slice allocate(VkDeviceSize size, VkDeviceSize alignment);
+    Slice allocateUniform(VkDeviceSize size) { return allocate(size, uniformAlignment_); }
+    Slice allocateStorage(VkDeviceSize size) { return allocate(size, storageAlignment_); }
+
+    template<typename T>
+    Slice pushUniform(const T& value) {
+        Slice s = allocateUniform(sizeof(T));
+        std::memcpy(s.data, &value, sizeof(T));
+        return s;
+    }
+
+    VkBuffer buffer() const { return buffer_; }
+    VkDeviceSize bytesPerFrame() const { return bytesPerFrame_; }
+    // In the frame's region; overflowBytes() is what spilled past it this frame
+    VkDeviceSize bytesUsed() const { return cursor_.load(std::memory_order_relaxed) - regionBase_; }
+    VkDeviceSize overflowBytes() const;
+    VkDeviceSize uniformAlignment() const { return uniformAlignment_; }
+
+private:
+    struct Overflow {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        Allocation alloc;
+        VkDeviceSize size = 0;
+        VkDeviceSize used = 0;
+    };
+
+    Slice allocateOverflow(VkDeviceSize size, VkDeviceSize alignment);
+
+    VkObjects* vk_ = nullptr;
+    VkBuffer buffer_ = VK_NULL_HANDLE;
+    Allocation alloc_;
+    VkDeviceSize bytesPerFrame_ = 0;
+    VkDeviceSize uniformAlignment_ = 256;
+    VkDeviceSize storageAlignment_ = 256;
+    VkDeviceSize regionBase_ = 0;
+    std::atomic<VkDeviceSize> cursor_{0};
+    uint32_t frameIndex_ = 0;
+    mutable std::mutex overflowMutex_;
+    std::vector<std::vector<Overflow>> overflow_; // per frame in flight
+};
+}
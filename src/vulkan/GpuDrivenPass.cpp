@@ -0,0 +1,243 @@
+#include "vulkan/GpuDrivenPass.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include "vulkan/BufferUtils.h"
+#include "vulkan/DescriptorAllocator.h"
+#include "vulkan/MaterialTable.h"
+#include "vulkan/ObjectBuffer.h"
+#include "vulkan/PipelineCache.h"
+#include "vulkan/PipelineStateCache.h"
+#include "vulkan/Renderer.h"
+#include "vulkan/UploadManager.h"
+#include "vulkan/Utils.h"
+#include "vulkan/VkObjects.h"
+#include "io/FileSystem.h"
+#include <aurora/Profiler.h>
+#include <aurora/math/Math.h>
+
+namespace vulkan {
+
+namespace {
+// The draw list is copied verbatim; cull.comp declares the same struct
+static_assert(sizeof(aurora::DrawCommand) == 28 && offsetof(aurora::DrawCommand, scale) == 12 &&
+              offsetof(aurora::DrawCommand, mesh) == 16 && offsetof(aurora::DrawCommand, object) == 20 &&
+              offsetof(aurora::DrawCommand, material) == 24,
+              "aurora::DrawCommand no longer matches struct Draw in cull.comp");
+constexpr uint32_t kInitialCapacity = 1024;
+constexpr uint32_t kBindingCount = 3; // draws, commands, count
+}
+
+GpuDrivenPass::GpuDrivenPass(VkObjects* vk) : vk_(vk) {
+    VkDescriptorSetLayoutBinding bindings[kBindingCount]{};
+    for (uint32_t b = 0; b < kBindingCount; ++b) {
+        bindings[b].binding = b;
+        bindings[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[b].descriptorCount = 1;
+        bindings[b].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    setLayout_ = vk->descriptorLayouts->get(bindings, kBindingCount);
+
+    const uint32_t frames = vk->maxFramesInFlight;
+    slots_.resize(frames);
+    for (Slot& slot : slots_) {
+        vkbuf::createBuffer(vk, sizeof(uint32_t),
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, slot.count, slot.countAlloc);
+        // Coherent, so the CPU reads the copied count without an invalidate
+        VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bci.size = sizeof(uint32_t);
+        bci.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        slot.readback = vk->allocator->createBuffer(
+            bci, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0, slot.readbackAlloc);
+        grow(slot, kInitialCapacity);
+    }
+    createPipelines();
+}
+
+GpuDrivenPass::~GpuDrivenPass() {
+    // Caller guarantees the device is idle
+    destroyPipelines();
+    for (Slot& slot : slots_) {
+        destroyDrawBuffers(slot);
+        vkbuf::destroyBuffer(vk_, slot.count, slot.countAlloc);
+        vkbuf::destroyBuffer(vk_, slot.readback, slot.readbackAlloc);
+    }
+}
+
+void GpuDrivenPass::createPipelines() {
+    AURORA_PROFILE_ZONE("GpuDrivenPass::createPipelines");
+    // Set 0: object matrices (shared with the main pass), set 1: this pass's buffers
+    VkDescriptorSetLayout sets[] = {vk_->objects->setLayout(), setLayout_};
+    VkPushConstantRange cullRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants)};
+    VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    plci.setLayoutCount = 2;
+    plci.pSetLayouts = sets;
+    plci.pushConstantRangeCount = 1;
+    plci.pPushConstantRanges = &cullRange;
+    if (vkCreatePipelineLayout(vk_->device, &plci, nullptr, &cullLayout_) != VK_SUCCESS) {
+        throw std::runtime_error("GpuDrivenPass: failed to create cull pipeline layout");
+    }
+
+    io::FileData code = vk_->files->read("shaders/cull.comp.spv");
+    VkComputePipelineCreateInfo cci{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+    cci.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    cci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    cci.stage.module = vkutils::createShaderModule(vk_->device, code.data(), code.size());
+    cci.stage.pName = "main";
+    cci.layout = cullLayout_;
+    VkResult res = PipelineCache::createComputePipeline(vk_, cci, &cullPipeline_);
+    vkDestroyShaderModule(vk_->device, cci.stage.module, nullptr);
+    if (res != VK_SUCCESS) throw std::runtime_error("GpuDrivenPass: failed to create cull pipeline");
+}
+
+void GpuDrivenPass::destroyPipelines() {
+    if (cullPipeline_) vkDestroyPipeline(vk_->device, cullPipeline_, nullptr);
+    if (cullLayout_) vkDestroyPipelineLayout(vk_->device, cullLayout_, nullptr);
+    cullPipeline_ = VK_NULL_HANDLE;
+    cullLayout_ = VK_NULL_HANDLE;
+}
+
+void GpuDrivenPass::destroyDrawBuffers(Slot& slot) {
+    if (slot.draws) vk_->allocator->destroyBuffer(slot.draws, slot.drawsAlloc);
+    slot.draws = VK_NULL_HANDLE;
+    vkbuf::destroyBuffer(vk_, slot.commands, slot.commandsAlloc);
+    slot.capacity = 0;
+}
+
+// The slot's previous frame has completed (fence waited), so its buffers are free
+void GpuDrivenPass::grow(Slot& slot, uint32_t capacity) {
+    destroyDrawBuffers(slot);
+    VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bci.size = VkDeviceSize(capacity) * sizeof(aurora::DrawCommand);
+    bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT; // also the instance buffer
+    bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // Written by the CPU every frame: device-local + host-visible (ReBAR / UMA) when available
+    slot.draws = vk_->allocator->createBuffer(bci, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                              slot.drawsAlloc);
+    vkbuf::createBuffer(vk_, VkDeviceSize(capacity) * sizeof(VkDrawIndexedIndirectCommand),
+                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, slot.commands, slot.commandsAlloc);
+    slot.capacity = capacity;
+}
+
+void GpuDrivenPass::writeSet(Slot& slot) {
+    slot.set = vk_->descriptors->allocate(setLayout_);
+    VkDescriptorBufferInfo infos[kBindingCount] = {
+        {slot.draws, 0, VK_WHOLE_SIZE}, {slot.commands, 0, VK_WHOLE_SIZE}, {slot.count, 0, VK_WHOLE_SIZE}};
+    VkWriteDescriptorSet writes[kBindingCount]{};
+    for (uint32_t b = 0; b < kBindingCount; ++b) {
+        writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[b].dstSet = slot.set;
+        writes[b].dstBinding = b;
+        writes[b].descriptorCount = 1;
+        writes[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[b].pBufferInfo = &infos[b];
+    }
+    vkUpdateDescriptorSets(vk_->device, kBindingCount, writes, 0, nullptr);
+}
+
+void GpuDrivenPass::beginFrame(uint32_t frameIndex) {
+    const Slot& slot = slots_[frameIndex];
+    stats_ = {};
+    if (!slot.culled) return;
+    stats_.tested = slot.drawCount;
+    std::memcpy(&stats_.visible, slot.readbackAlloc.mapped, sizeof(uint32_t));
+}
+
+bool GpuDrivenPass::prepare(uint32_t frameIndex, const aurora::DrawCommand* draws, uint32_t count) {
+    AURORA_PROFILE_ZONE("GpuDrivenPass::prepare");
+    Slot& slot = slots_[frameIndex];
+    slot.culled = false;
+    slot.drawCount = 0;
+    const render::GpuMesh& mesh = vk_->mesh;
+    if (!mesh.indexBuffer || !vk_->uploads->isSubmitted(mesh.uploadTicket)) return false;
+
+    if (count > slot.capacity) grow(slot, std::max(count, slot.capacity * 2));
+    const VkDeviceSize bytes = VkDeviceSize(count) * sizeof(aurora::DrawCommand);
+    if (count) {
+        std::memcpy(slot.drawsAlloc.mapped, draws, bytes);
+        vk_->allocator->flush(slot.drawsAlloc, 0, bytes);
+    }
+    writeSet(slot);
+    slot.drawCount = count;
+    slot.culled = true;
+    return true;
+}
+
+GpuDrivenPass::Buffers GpuDrivenPass::buffers(uint32_t frameIndex) const {
+    const Slot& slot = slots_[frameIndex];
+    return {slot.commands, slot.count, slot.readback};
+}
+
+void GpuDrivenPass::recordReset(VkCommandBuffer cmd, uint32_t frameIndex) {
+    const Slot& slot = slots_[frameIndex];
+    if (!slot.culled) return;
+    vkCmdFillBuffer(cmd, slot.count, 0, sizeof(uint32_t), 0);
+}
+
+void GpuDrivenPass::recordCull(VkCommandBuffer cmd, uint32_t frameIndex) {
+    AURORA_PROFILE_ZONE("GpuDrivenPass::recordCull");
+    const Slot& slot = slots_[frameIndex];
+    if (!slot.culled || slot.drawCount == 0) return;
+    const render::GpuMesh& mesh = vk_->mesh;
+    // Until a camera exists draws are placed in clip space, so the frustum is the clip volume
+    static const aurora::math::Frustum kFrustum = aurora::math::Frustum::fromMatrix(aurora::math::Mat4::identity());
+    CullConstants pc{};
+    for (int p = 0; p < aurora::math::Frustum::kCount; ++p) {
+        pc.planes[p][0] = kFrustum.planes[p].normal.x;
+        pc.planes[p][1] = kFrustum.planes[p].normal.y;
+        pc.planes[p][2] = kFrustum.planes[p].normal.z;
+        pc.planes[p][3] = kFrustum.planes[p].d;
+    }
+    pc.meshBounds[0] = mesh.boundsCenter[0];
+    pc.meshBounds[1] = mesh.boundsCenter[1];
+    pc.meshBounds[2] = mesh.boundsCenter[2];
+    pc.meshBounds[3] = mesh.boundsRadius;
+    pc.drawCount = slot.drawCount;
+    pc.indexCount = mesh.indexCount;
+    pc.flags = vk_->objects->ready() ? kCullObjectsReady : 0u;
+    pc.objectCount = static_cast<uint32_t>(vk_->objects->worlds().size());
+
+    VkDescriptorSet sets[] = {vk_->objects->descriptorSet(), slot.set};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline_);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullLayout_, 0, 2, sets, 0, nullptr);
+    vkCmdPushConstants(cmd, cullLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+    vkCmdDispatch(cmd, (slot.drawCount + kWorkgroupSize - 1) / kWorkgroupSize, 1, 1);
+}
+
+void GpuDrivenPass::recordReadback(VkCommandBuffer cmd, uint32_t frameIndex) {
+    const Slot& slot = slots_[frameIndex];
+    if (!slot.culled) return;
+    VkBufferCopy region{0, 0, sizeof(uint32_t)};
+    vkCmdCopyBuffer(cmd, slot.count, slot.readback, 1, &region);
+}
+
+void GpuDrivenPass::recordDraws(VkCommandBuffer cmd, uint32_t frameIndex) {
+    const Slot& slot = slots_[frameIndex];
+    if (!slot.culled || slot.drawCount == 0) return;
+    // The default material's pipeline; the uncompacted draw list is the instance buffer and
+    // each command's firstInstance is its draw index
+    const render::GpuMesh& mesh = vk_->mesh;
+    VkPipeline pipeline = vk_->pipelines->get(vk_->materials->pipeline(aurora::kDefaultMaterial));
+    if (!pipeline) return; // still compiling
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    Renderer::bindMainPassSets(vk_, cmd);
+    VkBuffer buffers[] = {mesh.vertexBuffer, slot.draws};
+    VkDeviceSize offsets[] = {0, 0};
+    vkCmdBindVertexBuffers(cmd, 0, 2, buffers, offsets);
+    vkCmdBindIndexBuffer(cmd, mesh.indexBuffer, 0, mesh.indexType);
+    // Every draw uses the default material (the pushed struct's); per-material pipelines would
+    // need a command stream per pipeline
+    vkCmdPushConstants(cmd, vk_->pipelineLayout, render::kMeshPushStages, 0, sizeof(mesh.pushConstants), &mesh.pushConstants);
+    vkCmdDrawIndexedIndirectCount(cmd, slot.commands, 0, slot.count, 0, slot.drawCount,
+                                  sizeof(VkDrawIndexedIndirectCommand));
+}
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "vulkan/MemoryAllocator.h"
+#include <aurora/DrawList.h>
+
+struct VkObjects;
+
+namespace vulkan {
+// GPU-driven main pass: the frame's draw list is copied as-is into a storage buffer, a compute
+// shader (cull.comp) tests every draw's bounding sphere against the frustum and appends a
+// VkDrawIndexedIndirectCommand per visible draw plus a count, and the main pass draws them all
+// with one vkCmdDrawIndexedIndirectCount per mesh (one while only the built-in mesh exists).
+// The CPU cost no longer grows with the number of draws beyond one memcpy. The main pipeline
+// draws them: the draws buffer doubles as its instance buffer, indexed by firstInstance.
+// Visible draws are appended in completion order, not draw-list order.
+//
+// Buffers are per frame in flight and grow on demand; results of a frame slot are read back
+// after its fence wait (stats). Requires the features enabled by DeviceManager when
+// vk->gpuDriven is set. Used from the thread that renders.
+class GpuDrivenPass {
+public:
+    struct Stats {
+        uint32_t tested = 0;  // draws culled by the frame that last used this slot
+        uint32_t visible = 0; // of those, drawn
+    };
+
+    // After vk->objects, the render pass and the mesh exist
+    explicit GpuDrivenPass(VkObjects* vk);
+    ~GpuDrivenPass();
+
+    GpuDrivenPass(const GpuDrivenPass&) = delete;
+    GpuDrivenPass& operator=(const GpuDrivenPass&) = delete;
+
+    // Buffers the render graph tracks; valid until the next prepare() of the slot
+    struct Buffers {
+        VkBuffer commands = VK_NULL_HANDLE;
+        VkBuffer count = VK_NULL_HANDLE;
+        VkBuffer readback = VK_NULL_HANDLE;
+    };
+
+    // After the frame's fence wait: picks up that slot's results of its previous use
+    void beginFrame(uint32_t frameIndex);
+    // After vk->descriptors->beginFrame: copies draws into this slot (growing its buffers) and
+    // writes its descriptor set. Returns false if the mesh is not uploaded yet; the record
+    // calls below are then no-ops.
+    bool prepare(uint32_t frameIndex, const aurora::DrawCommand* draws, uint32_t count);
+    Buffers buffers(uint32_t frameIndex) const;
+    // The passes of a prepared slot, in this order. They record no barriers: the render graph
+    // derives them from the declared usages (reset: transfer write of count; cull: compute
+    // write of count and commands; readback: transfer read of count, write of readback).
+    void recordReset(VkCommandBuffer cmd, uint32_t frameIndex);
+    void recordCull(VkCommandBuffer cmd, uint32_t frameIndex);
+    void recordReadback(VkCommandBuffer cmd, uint32_t frameIndex);
+    // Inside the main pass with viewport/scissor set: the indirect draws of the cull
+    void recordDraws(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    const Stats& stats() const { return stats_; }
+
+    // Matches CullConstants in cull.comp
+    struct CullConstants {
+        float planes[6][4];
+        float meshBounds[4];
+        uint32_t drawCount;
+        uint32_t indexCount;
+        uint32_t flags;
+        uint32_t objectCount; // draws with an object id at or past it are skipped
+    };
+    static_assert(sizeof(CullConstants) <= 128, "push constants beyond the guaranteed 128 bytes");
+    static constexpr uint32_t kCullObjectsReady = 1u;
+    static constexpr uint32_t kWorkgroupSize = 64; // local_size_x of cull.comp
+
+private:
+    struct Slot {
+        VkBuffer draws = VK_NULL_HANDLE; // host-visible copy of the draw list
+        Allocation drawsAlloc;
+        VkBuffer commands = VK_NULL_HANDLE; // indirect commands written by the cull
+        Allocation commandsAlloc;
+        VkBuffer count = VK_NULL_HANDLE; // visible count written by the cull
+        Allocation countAlloc;
+        VkBuffer readback = VK_NULL_HANDLE; // count copied back for stats
+        Allocation readbackAlloc;
+        VkDescriptorSet set = VK_NULL_HANDLE; // from vk->descriptors, written by each prepare
+        uint32_t capacity = 0;
+        uint32_t drawCount = 0; // of the last prepare
+        bool culled = false;    // the last prepare succeeded (readback will be valid)
+    };
+
+    void createPipelines(); // the cull pipeline; drawing uses the main pipeline
+    void destroyPipelines();
+    void grow(Slot& slot, uint32_t capacity);
+    void destroyDrawBuffers(Slot& slot);
+    void writeSet(Slot& slot);
+
+    VkObjects* vk_ = nullptr;
+    VkDescriptorSetLayout setLayout_ = VK_NULL_HANDLE; // owned by vk->descriptorLayouts
+    VkPipelineLayout cullLayout_ = VK_NULL_HANDLE;
+    VkPipeline cullPipeline_ = VK_NULL_HANDLE;
+    std::vector<Slot> slots_;
+    Stats stats_;
+};
+}
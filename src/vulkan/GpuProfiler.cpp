@@ -0,0 +1,95 @@
+#include "GpuProfiler.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+namespace {
+const char* const kZoneNames[GpuProfiler::ZoneCount] = { "GPU frame" };
+}
+
+void GpuProfiler::createQueryPool(VkObjects* vk, uint32_t slotCount) {
+    destroyQueryPool(vk);
+
+    uint32_t qCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vk->physicalDevice, &qCount, nullptr);
+    std::vector<VkQueueFamilyProperties> qProps(qCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(vk->physicalDevice, &qCount, qProps.data());
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(vk->physicalDevice, &props);
+    if (vk->graphicsQueueFamily >= qCount || qProps[vk->graphicsQueueFamily].timestampValidBits == 0 ||
+        props.limits.timestampPeriod <= 0.0f) {
+        return; // GPU zones unavailable on this queue; CPU zones still work
+    }
+    uint32_t validBits = qProps[vk->graphicsQueueFamily].timestampValidBits;
+    vk->timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1ull);
+    vk->timestampPeriodNs = props.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo qci{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    qci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    qci.queryCount = slotCount * kQueriesPerSlot;
+    if (vkCreateQueryPool(vk->device, &qci, nullptr, &vk->timestampQueryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool");
+    }
+    vk->timestampSubmitUs.assign(slotCount, 0);
+}
+
+void GpuProfiler::destroyQueryPool(VkObjects* vk) {
+    if (vk->timestampQueryPool) {
+        vkDestroyQueryPool(vk->device, vk->timestampQueryPool, nullptr);
+        vk->timestampQueryPool = VK_NULL_HANDLE;
+    }
+    vk->timestampSubmitUs.clear();
+}
+
+void GpuProfiler::cmdResetSlot(VkObjects* vk, VkCommandBuffer cmd, uint32_t slot) {
+    if (!vk->timestampQueryPool) return;
+    vkCmdResetQueryPool(cmd, vk->timestampQueryPool, slot * kQueriesPerSlot, kQueriesPerSlot);
+}
+
+void GpuProfiler::cmdBeginZone(VkObjects* vk, VkCommandBuffer cmd, uint32_t slot, Zone zone) {
+    if (!vk->timestampQueryPool) return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, vk->timestampQueryPool, slot * kQueriesPerSlot + zone * 2);
+}
+
+void GpuProfiler::cmdEndZone(VkObjects* vk, VkCommandBuffer cmd, uint32_t slot, Zone zone) {
+    if (!vk->timestampQueryPool) return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, vk->timestampQueryPool, slot * kQueriesPerSlot + zone * 2 + 1);
+}
+
+void GpuProfiler::onSubmit(VkObjects* vk, uint32_t slot) {
+    if (!vk->timestampQueryPool || slot >= vk->timestampSubmitUs.size()) return;
+    auto& profiler = aurora::Profiler::get();
+    vk->timestampSubmitUs[slot] = profiler.isEnabled() ? profiler.nowUs() : 0;
+}
+
+void GpuProfiler::collect(VkObjects* vk, uint32_t slot) {
+    if (!vk->timestampQueryPool || slot >= vk->timestampSubmitUs.size()) return;
+    uint64_t submitUs = vk->timestampSubmitUs[slot];
+    if (submitUs == 0) return;
+    vk->timestampSubmitUs[slot] = 0;
+
+    uint64_t ticks[kQueriesPerSlot] = {};
+    // No WAIT bit: if the GPU is not done yet we drop this sample rather than stall the frame
+    VkResult res = vkGetQueryPoolResults(vk->device, vk->timestampQueryPool, slot * kQueriesPerSlot, kQueriesPerSlot,
+                                         sizeof(ticks), ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (res != VK_SUCCESS) return;
+
+    // GPU and CPU clocks are not calibrated against each other: zones are anchored at the
+    // CPU submit time, durations are exact.
+    auto& profiler = aurora::Profiler::get();
+    uint64_t frameBegin = ticks[ZoneFrame * 2] & vk->timestampMask;
+    for (uint32_t z = 0; z < ZoneCount; ++z) {
+        uint64_t begin = ticks[z * 2] & vk->timestampMask;
+        uint64_t end = ticks[z * 2 + 1] & vk->timestampMask;
+        if (end < begin || begin < frameBegin) continue;
+        double offsetUs = static_cast<double>(begin - frameBegin) * vk->timestampPeriodNs / 1000.0;
+        double durUs = static_cast<double>(end - begin) * vk->timestampPeriodNs / 1000.0;
+        profiler.recordGpu(kZoneNames[z], submitUs + static_cast<uint64_t>(offsetUs), static_cast<uint64_t>(durUs));
+    }
+}
+
+} // namespace vulkan
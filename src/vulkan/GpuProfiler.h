@@ -0,0 +1,27 @@
+#pragma once
+
+#include "vulkan/VkObjects.h"
+
+namespace vulkan {
+// GPU zones from VkQueryPool timestamps. Each frame in flight owns a fixed block of
+// queries; results are read back after that frame's fence wait (so they are ready without
+// blocking) and forwarded to aurora::Profiler on the GPU track. Per-pass zones come from
+// the render graph's own queries.
+struct GpuProfiler {
+    enum Zone : uint32_t { ZoneFrame = 0, ZoneCount };
+    static constexpr uint32_t kQueriesPerSlot = ZoneCount * 2;
+
+    static void createQueryPool(VkObjects* vk, uint32_t slotCount);
+    static void destroyQueryPool(VkObjects* vk);
+
+    // Recording helpers (no-ops when timestamps are unsupported)
+    static void cmdResetSlot(VkObjects* vk, VkCommandBuffer cmd, uint32_t slot);
+    static void cmdBeginZone(VkObjects* vk, VkCommandBuffer cmd, uint32_t slot, Zone zone);
+    static void cmdEndZone(VkObjects* vk, VkCommandBuffer cmd, uint32_t slot, Zone zone);
+
+    // Call right before submitting the slot's command buffer
+    static void onSubmit(VkObjects* vk, uint32_t slot);
+    // Forward finished results of the slot's previous submission to the profiler
+    static void collect(VkObjects* vk, uint32_t slot);
+};
+}
@@ -22,9 +22,13 @@ void InstanceManager::createInstance(VkObjects* vk) {
     appInfo.engineVersion = VK_MAKE_VERSION(0, 1, 0);
     appInfo.apiVersion = VK_API_VERSION_1_2;
 
-    uint32_t glfwExtCount = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
-    std::vector<const char*> extensions(glfwExts, glfwExts + glfwExtCount);
+    std::vector<const char*> extensions;
+    if (!vk->headless) {
+        // Surface extensions are only needed when presenting to a window
+        uint32_t glfwExtCount = 0;
+        const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
+        extensions.assign(glfwExts, glfwExts + glfwExtCount);
+    }
 
 #ifdef AURORA_ENABLE_VALIDATION
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -0,0 +1,88 @@
+#include "vulkan/MaterialTable.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "render/RenderQueue.h"
+#include "render/ShaderVariant.h"
+#include "vulkan/BindlessTable.h"
+#include "vulkan/PipelineStateCache.h"
+#include "vulkan/VkObjects.h"
+
+namespace vulkan {
+
+static_assert(MaterialTable::kMaxMaterials <= (1u << render::sortkey::kMaterialBits), "material ids must fit the sort key");
+
+MaterialTable::MaterialTable(VkObjects* vk) : vk_(vk), materials_(new Material[kMaxMaterials]) {
+    if (vk->bindlessTable) {
+        VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bci.size = VkDeviceSize(kMaxMaterials) * sizeof(Params);
+        bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        // Written once per material from the CPU, read by every fragment
+        paramsBuffer_ = vk->allocator->createBuffer(bci, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                    paramsAlloc_);
+        if (!paramsAlloc_.mapped) {
+            vk->allocator->destroyBuffer(paramsBuffer_, paramsAlloc_);
+            throw std::runtime_error("MaterialTable: failed to map material parameter buffer");
+        }
+        paramsEntry_ = vk->bindlessTable->addBuffer(paramsBuffer_);
+    }
+    create(aurora::MaterialDesc{});
+}
+
+MaterialTable::~MaterialTable() {
+    // The bindless entry goes with the table; pipelines belong to vk->pipelines
+    if (paramsBuffer_) vk_->allocator->destroyBuffer(paramsBuffer_, paramsAlloc_);
+}
+
+uint32_t MaterialTable::create(const aurora::MaterialDesc& desc) {
+    std::lock_guard<std::mutex> lock(createMutex_);
+    const uint32_t id = count_.load(std::memory_order_relaxed);
+    if (id == kMaxMaterials) {
+        throw std::runtime_error("MaterialTable: no free material id (" + std::to_string(kMaxMaterials) + " in use)");
+    }
+    materials_[id].desc = desc;
+    if (paramsAlloc_.mapped) {
+        // A new slot: no frame in flight reads it yet
+        Params params;
+        std::memcpy(params.baseColor, desc.baseColor, sizeof(params.baseColor));
+        const VkDeviceSize offset = VkDeviceSize(id) * sizeof(Params);
+        std::memcpy(static_cast<char*>(paramsAlloc_.mapped) + offset, &params, sizeof(Params));
+        vk_->allocator->flush(paramsAlloc_, offset, sizeof(Params));
+    }
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+void MaterialTable::request(uint32_t material) {
+    uint32_t fragPermutations = 0;
+    if (vk_->bindlessTable) fragPermutations |= render::kPermutationBindless;
+    GraphicsPipelineDesc desc;
+    desc.vertexShader = render::shaderPath("triangle.vert", 0);
+    desc.fragmentShader = render::shaderPath("triangle.frag", fragPermutations);
+    desc.constants = render::specConstants(vk_->vertexFormat, materials_[material].desc, paramsEntry_);
+    desc.vertexFormat = vk_->vertexFormat;
+    desc.layout = vk_->pipelineLayout;
+    desc.renderPass = vk_->renderPass;
+    const uint32_t fallback = material == aurora::kDefaultMaterial ? PipelineStateCache::kNone
+                                                                   : materials_[aurora::kDefaultMaterial].pipeline;
+    materials_[material].pipeline = vk_->pipelines->request(desc, fallback);
+}
+
+void MaterialTable::beginFrame() {
+    for (const uint32_t n = count(); requested_ < n; ++requested_) request(requested_);
+}
+
+void MaterialTable::requestPipelines() {
+    requested_ = 0;
+    beginFrame();
+}
+
+uint32_t MaterialTable::pipeline(uint32_t material) const {
+    return materials_[material < requested_ ? material : aurora::kDefaultMaterial].pipeline;
+}
+
+}
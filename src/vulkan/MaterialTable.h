@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "vulkan/MemoryAllocator.h"
+#include <aurora/Material.h>
+
+struct VkObjects;
+
+namespace vulkan {
+// Materials by id (aurora::DrawCommand::material) and the mesh pipeline of each. A material's
+// features pick its shader variant (render::specConstants); materials with equal features
+// share one pipeline through vk->pipelines. Pipelines are requested on the render thread, at
+// the next beginFrame after create(); until one is compiled its draws use the default
+// material's pipeline.
+// The parameters reach the fragment shader through the push constants at each material
+// change, or with bindless from one storage buffer in the bindless table (indexed by the
+// pushed material id), which only leaves the id to push.
+class MaterialTable {
+public:
+    // Fits the sort key's material field
+    static constexpr uint32_t kMaxMaterials = 1024;
+
+    // GPU layout of a material's parameters (struct MaterialParams in triangle.frag)
+    struct Params {
+        float baseColor[4];
+    };
+
+    // Creates aurora::kDefaultMaterial. Bindless: allocates the parameter buffer and adds it
+    // to vk->bindlessTable.
+    explicit MaterialTable(VkObjects* vk);
+    // Caller guarantees the device is idle
+    ~MaterialTable();
+
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    // Any thread. Returns the id; throws when kMaxMaterials exist.
+    uint32_t create(const aurora::MaterialDesc& desc);
+
+    // Render thread, each frame: requests the pipelines of materials created since
+    void beginFrame();
+    // (Re)requests every material's pipeline against vk->pipelineLayout / vk->renderPass; from
+    // Renderer::createGraphicsPipeline, on the render thread (or before it starts)
+    void requestPipelines();
+
+    // Render thread. Pipeline state id (vk->pipelines) of material; unknown ids and materials
+    // whose pipeline is not requested yet get the default material's.
+    uint32_t pipeline(uint32_t material) const;
+    // Any thread, for ids below count()
+    const aurora::MaterialDesc& desc(uint32_t material) const { return materials_[material].desc; }
+    uint32_t count() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    struct Material {
+        aurora::MaterialDesc desc;                   // immutable once published by count_
+        uint32_t pipeline = UINT32_MAX;              // render thread
+    };
+
+    void request(uint32_t material);
+
+    VkObjects* vk_ = nullptr;
+    std::unique_ptr<Material[]> materials_;          // kMaxMaterials slots, never reallocated
+    std::atomic<uint32_t> count_{0};
+    std::mutex createMutex_;
+    uint32_t requested_ = 0;                         // render thread: materials [0, requested_) have pipelines
+    // Bindless only: Params per material, persistently mapped
+    VkBuffer paramsBuffer_ = VK_NULL_HANDLE;
+    Allocation paramsAlloc_;
+    uint32_t paramsEntry_ = 0;                       // its bindless table index
+};
+}
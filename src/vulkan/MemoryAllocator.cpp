@@ -0,0 +1,624 @@
+#include "MemoryAllocator.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <bit>
+
+namespace vulkan {
+
+namespace {
+// TLSF geometry: first level = power of two, second level = 2^kSLBits linear subdivisions.
+// Sizes below kSmallSize share first level 0 in kSmallSize / kSLCount byte steps.
+constexpr uint32_t kSLBits = 4;
+constexpr uint32_t kSLCount = 1u << kSLBits;
+constexpr uint32_t kSmallLog2 = 8;
+constexpr VkDeviceSize kSmallSize = 1ull << kSmallLog2;
+constexpr VkDeviceSize kSmallStep = kSmallSize / kSLCount;
+constexpr uint32_t kFLCount = 32; // up to 2^(kFLCount + kSmallLog2 - 1) byte blocks
+// Tails smaller than this stay with the allocation instead of becoming free nodes
+constexpr VkDeviceSize kMinFragment = 64;
+
+VkDeviceSize alignUp(VkDeviceSize v, VkDeviceSize a) { return a <= 1 ? v : (v + a - 1) / a * a; }
+VkDeviceSize alignDown(VkDeviceSize v, VkDeviceSize a) { return a <= 1 ? v : v / a * a; }
+
+void mapping(VkDeviceSize size, uint32_t& fl, uint32_t& sl) {
+    if (size < kSmallSize) {
+        fl = 0;
+        sl = static_cast<uint32_t>(size / kSmallStep);
+        return;
+    }
+    uint32_t f = static_cast<uint32_t>(std::bit_width(size)) - 1;
+    fl = f - (kSmallLog2 - 1);
+    sl = static_cast<uint32_t>(size >> (f - kSLBits)) ^ kSLCount;
+}
+
+double toMiB(VkDeviceSize bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+}
+
+struct MemoryAllocator::Block {
+    uint32_t id = 0;
+    uint32_t memoryType = 0;
+    ResourceKind kind = ResourceKind::Linear;
+    bool dedicated = false;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    char* mapped = nullptr;
+    VkDeviceSize used = 0;
+    uint32_t allocationCount = 0;
+
+    // TLSF state (unused for dedicated blocks). nodes[0] is a null sentinel.
+    std::vector<Node> nodes;
+    std::vector<uint32_t> recycled;
+    uint32_t flBitmap = 0;
+    uint32_t slBitmap[kFLCount] = {};
+    uint32_t heads[kFLCount][kSLCount] = {};
+
+    uint32_t newNode() {
+        if (!recycled.empty()) {
+            uint32_t idx = recycled.back();
+            recycled.pop_back();
+            nodes[idx] = Node{};
+            return idx;
+        }
+        nodes.push_back(Node{});
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+    void recycle(uint32_t idx) {
+        nodes[idx] = Node{}; // size 0 marks a dead slot
+        recycled.push_back(idx);
+    }
+
+    void insertFree(uint32_t idx) {
+        uint32_t fl, sl;
+        mapping(nodes[idx].size, fl, sl);
+        Node& n = nodes[idx];
+        n.free = true;
+        n.prevFree = 0;
+        n.nextFree = heads[fl][sl];
+        if (n.nextFree) nodes[n.nextFree].prevFree = idx;
+        heads[fl][sl] = idx;
+        flBitmap |= 1u << fl;
+        slBitmap[fl] |= 1u << sl;
+    }
+    void removeFree(uint32_t idx) {
+        uint32_t fl, sl;
+        mapping(nodes[idx].size, fl, sl);
+        Node& n = nodes[idx];
+        if (n.prevFree) nodes[n.prevFree].nextFree = n.nextFree;
+        else heads[fl][sl] = n.nextFree;
+        if (n.nextFree) nodes[n.nextFree].prevFree = n.prevFree;
+        n.prevFree = n.nextFree = 0;
+        n.free = false;
+        if (!heads[fl][sl]) {
+            slBitmap[fl] &= ~(1u << sl);
+            if (!slBitmap[fl]) flBitmap &= ~(1u << fl);
+        }
+    }
+    // Good fit: round up to the next size class so any node in the found list is big enough
+    uint32_t findFree(VkDeviceSize request) const {
+        if (request < kSmallSize) request = alignUp(request, kSmallStep);
+        else request += (1ull << (std::bit_width(request) - 1 - kSLBits)) - 1;
+        uint32_t fl, sl;
+        mapping(request, fl, sl);
+        if (fl >= kFLCount) return 0;
+        uint32_t slMap = sl < kSLCount ? (slBitmap[fl] & (~0u << sl)) : 0;
+        if (!slMap) {
+            uint32_t flMap = fl + 1 < kFLCount ? (flBitmap & (~0u << (fl + 1))) : 0;
+            if (!flMap) return 0;
+            fl = static_cast<uint32_t>(std::countr_zero(flMap));
+            slMap = slBitmap[fl];
+        }
+        sl = static_cast<uint32_t>(std::countr_zero(slMap));
+        return heads[fl][sl];
+    }
+    // Insert a new node after idx in address order (caller shrinks idx)
+    uint32_t splitAfter(uint32_t idx, VkDeviceSize offset, VkDeviceSize length) {
+        uint32_t n = newNode();
+        Node& node = nodes[n];
+        node.offset = offset;
+        node.size = length;
+        node.prevPhys = idx;
+        node.nextPhys = nodes[idx].nextPhys;
+        if (node.nextPhys) nodes[node.nextPhys].prevPhys = n;
+        nodes[idx].nextPhys = n;
+        return n;
+    }
+};
+
+struct MemoryAllocator::LinearPool {
+    uint32_t memoryType = 0;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    VkDeviceSize head = 0;
+    char* mapped = nullptr;
+    ResourceKind lastKind = ResourceKind::Linear;
+    uint32_t allocationCount = 0;
+};
+
+MemoryAllocator::MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize preferredBlockSize)
+    : device_(device), preferredBlockSize_(preferredBlockSize) {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps_);
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    granularity_ = std::max<VkDeviceSize>(1, props.limits.bufferImageGranularity);
+    nonCoherentAtomSize_ = std::max<VkDeviceSize>(1, props.limits.nonCoherentAtomSize);
+    if (props.limits.maxMemoryAllocationCount) maxAllocationCount_ = props.limits.maxMemoryAllocationCount;
+}
+
+MemoryAllocator::~MemoryAllocator() {
+    uint32_t leaked = 0;
+    for (auto* b : blocks_) {
+        leaked += b->allocationCount;
+        if (b->mapped) vkUnmapMemory(device_, b->memory);
+        vkFreeMemory(device_, b->memory, nullptr);
+        delete b;
+    }
+    for (auto* p : linearPools_) {
+        if (!p) continue;
+        if (p->mapped) vkUnmapMemory(device_, p->memory);
+        vkFreeMemory(device_, p->memory, nullptr);
+        delete p;
+    }
+    if (leaked) std::cerr << "MemoryAllocator: " << leaked << " allocations still live at shutdown" << std::endl;
+}
+
+uint32_t MemoryAllocator::pickMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required,
+                                         VkMemoryPropertyFlags preferred, uint32_t skipMask) const {
+    uint32_t best = UINT32_MAX;
+    int bestScore = -1;
+    for (uint32_t i = 0; i < memProps_.memoryTypeCount; ++i) {
+        if (!(typeBits & (1u << i)) || (skipMask & (1u << i))) continue;
+        VkMemoryPropertyFlags flags = memProps_.memoryTypes[i].propertyFlags;
+        if ((flags & required) != required) continue;
+        int score = std::popcount(static_cast<uint32_t>(flags & preferred));
+        if (score > bestScore) { best = i; bestScore = score; }
+    }
+    return best;
+}
+
+VkDeviceSize MemoryAllocator::blockSizeFor(uint32_t memoryType) const {
+    // Small heaps (e.g. the 256 MiB BAR window) get proportionally smaller blocks
+    VkDeviceSize heapSize = memProps_.memoryHeaps[memProps_.memoryTypes[memoryType].heapIndex].size;
+    if (heapSize <= (1ull << 30)) return std::min(preferredBlockSize_, heapSize / 8);
+    return preferredBlockSize_;
+}
+
+MemoryAllocator::Block* MemoryAllocator::createBlock(uint32_t memoryType, VkDeviceSize size, ResourceKind kind, bool dedicated) {
+    if (deviceAllocations_ >= maxAllocationCount_) return nullptr;
+    VkMemoryAllocateInfo mai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    mai.allocationSize = size;
+    mai.memoryTypeIndex = memoryType;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(device_, &mai, nullptr, &memory) != VK_SUCCESS) return nullptr;
+
+    auto* b = new Block();
+    b->id = nextBlockId_++;
+    b->memoryType = memoryType;
+    b->kind = kind;
+    b->dedicated = dedicated;
+    b->memory = memory;
+    b->size = size;
+    if (memProps_.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void* ptr = nullptr;
+        if (vkMapMemory(device_, memory, 0, VK_WHOLE_SIZE, 0, &ptr) == VK_SUCCESS) b->mapped = static_cast<char*>(ptr);
+    }
+    if (!dedicated) {
+        b->nodes.resize(2);
+        b->nodes[1].offset = 0;
+        b->nodes[1].size = size;
+        b->insertFree(1);
+    }
+    blocks_.push_back(b);
+    ++deviceAllocations_;
+    return b;
+}
+
+void MemoryAllocator::destroyBlock(uint32_t blockId) {
+    auto it = std::find_if(blocks_.begin(), blocks_.end(), [&](Block* b) { return b->id == blockId; });
+    if (it == blocks_.end()) return;
+    Block* b = *it;
+    if (b->mapped) vkUnmapMemory(device_, b->memory);
+    vkFreeMemory(device_, b->memory, nullptr);
+    --deviceAllocations_;
+    delete b;
+    blocks_.erase(it);
+}
+
+MemoryAllocator::Block* MemoryAllocator::findBlock(uint32_t blockId) const {
+    for (auto* b : blocks_) if (b->id == blockId) return b;
+    return nullptr;
+}
+
+bool MemoryAllocator::allocateFromBlock(Block& b, VkDeviceSize size, VkDeviceSize alignment, void* userData, Allocation& out) {
+    alignment = std::max<VkDeviceSize>(1, alignment);
+    // Searching for size + alignment - 1 guarantees the aligned range fits in whatever we find
+    uint32_t idx = b.findFree(size + alignment - 1);
+    if (!idx) return false;
+    b.removeFree(idx);
+
+    VkDeviceSize aligned = alignUp(b.nodes[idx].offset, alignment);
+    VkDeviceSize pad = aligned - b.nodes[idx].offset;
+    if (pad) {
+        // Leading padding becomes its own free node; it coalesces back when we are freed
+        uint32_t body = b.splitAfter(idx, aligned, b.nodes[idx].size - pad);
+        b.nodes[idx].size = pad;
+        b.insertFree(idx);
+        idx = body;
+    }
+    VkDeviceSize tail = b.nodes[idx].size - size;
+    if (tail >= kMinFragment) {
+        uint32_t rest = b.splitAfter(idx, aligned + size, tail);
+        b.nodes[idx].size = size;
+        b.insertFree(rest);
+    }
+    Node& n = b.nodes[idx];
+    n.free = false;
+    n.allocSize = size;
+    n.alignment = alignment;
+    n.userData = userData;
+    b.used += n.size;
+    ++b.allocationCount;
+
+    out = {};
+    out.memory = b.memory;
+    out.offset = n.offset;
+    out.size = size;
+    out.mapped = b.mapped ? b.mapped + n.offset : nullptr;
+    out.memoryType = b.memoryType;
+    out.blockId = b.id;
+    out.node = idx;
+    return true;
+}
+
+bool MemoryAllocator::tryAllocate(uint32_t memoryType, const VkMemoryRequirements& req, ResourceKind kind,
+                                  void* userData, Allocation& out) {
+    VkDeviceSize blockSize = blockSizeFor(memoryType);
+    // Only segregate when the device actually has a granularity constraint
+    const bool anyKind = granularity_ <= 1;
+    if (req.size > blockSize / 2) {
+        Block* b = createBlock(memoryType, req.size, kind, true);
+        if (!b) return false;
+        b->used = req.size;
+        b->allocationCount = 1;
+        out = {};
+        out.memory = b->memory;
+        out.size = req.size;
+        out.mapped = b->mapped;
+        out.memoryType = memoryType;
+        out.blockId = b->id;
+        out.dedicated = true;
+        return true;
+    }
+    for (auto* b : blocks_) {
+        if (b->dedicated || b->memoryType != memoryType || (!anyKind && b->kind != kind)) continue;
+        if (allocateFromBlock(*b, req.size, req.alignment, userData, out)) return true;
+    }
+    Block* b = createBlock(memoryType, blockSize, kind, false);
+    return b && allocateFromBlock(*b, req.size, req.alignment, userData, out);
+}
+
+Allocation MemoryAllocator::allocate(const VkMemoryRequirements& req, VkMemoryPropertyFlags required,
+                                     VkMemoryPropertyFlags preferred, ResourceKind kind, void* userData) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Allocation out;
+    uint32_t tried = 0;
+    // Fall back to the next compatible type when the preferred heap is exhausted
+    for (;;) {
+        uint32_t type = pickMemoryType(req.memoryTypeBits, required, preferred | required, tried);
+        if (type == UINT32_MAX) break;
+        if (tryAllocate(type, req, kind, userData, out)) return out;
+        tried |= 1u << type;
+    }
+    throw std::runtime_error(tried ? "Out of device memory" : "Failed to find suitable memory type");
+}
+
+void MemoryAllocator::freeLocked(Allocation& alloc) {
+    if (!alloc.memory || alloc.linearPool) { alloc = {}; return; }
+    Block* b = findBlock(alloc.blockId);
+    if (!b) { alloc = {}; return; }
+    if (b->dedicated) {
+        destroyBlock(b->id);
+        alloc = {};
+        return;
+    }
+    uint32_t idx = alloc.node;
+    b->used -= b->nodes[idx].size;
+    --b->allocationCount;
+    b->nodes[idx].userData = nullptr;
+    // Coalesce with free neighbours
+    uint32_t next = b->nodes[idx].nextPhys;
+    if (next && b->nodes[next].free) {
+        b->removeFree(next);
+        b->nodes[idx].size += b->nodes[next].size;
+        b->nodes[idx].nextPhys = b->nodes[next].nextPhys;
+        if (b->nodes[idx].nextPhys) b->nodes[b->nodes[idx].nextPhys].prevPhys = idx;
+        b->recycle(next);
+    }
+    uint32_t prev = b->nodes[idx].prevPhys;
+    if (prev && b->nodes[prev].free) {
+        b->removeFree(prev);
+        b->nodes[prev].size += b->nodes[idx].size;
+        b->nodes[prev].nextPhys = b->nodes[idx].nextPhys;
+        if (b->nodes[prev].nextPhys) b->nodes[b->nodes[prev].nextPhys].prevPhys = prev;
+        b->recycle(idx);
+        idx = prev;
+    }
+    b->insertFree(idx);
+    uint32_t type = b->memoryType;
+    bool empty = b->allocationCount == 0;
+    alloc = {};
+    if (empty) releaseEmptyBlocks(type);
+}
+
+void MemoryAllocator::releaseEmptyBlocks(uint32_t memoryType) {
+    // Keep one empty block per type so alloc/free around a boundary does not thrash the driver
+    bool kept = false;
+    std::vector<uint32_t> victims;
+    for (auto* b : blocks_) {
+        if (b->dedicated || b->memoryType != memoryType || b->allocationCount) continue;
+        if (!kept) { kept = true; continue; }
+        victims.push_back(b->id);
+    }
+    for (uint32_t id : victims) destroyBlock(id);
+}
+
+void MemoryAllocator::free(Allocation& alloc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    freeLocked(alloc);
+}
+
+VkBuffer MemoryAllocator::createBuffer(const VkBufferCreateInfo& ci, VkMemoryPropertyFlags required,
+                                       VkMemoryPropertyFlags preferred, Allocation& out, void* userData) {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    if (vkCreateBuffer(device_, &ci, nullptr, &buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create buffer");
+    }
+    VkMemoryRequirements req; vkGetBufferMemoryRequirements(device_, buffer, &req);
+    try {
+        out = allocate(req, required, preferred, ResourceKind::Linear, userData);
+    } catch (...) {
+        vkDestroyBuffer(device_, buffer, nullptr);
+        throw;
+    }
+    vkBindBufferMemory(device_, buffer, out.memory, out.offset);
+    return buffer;
+}
+
+VkImage MemoryAllocator::createImage(const VkImageCreateInfo& ci, VkMemoryPropertyFlags required,
+                                     VkMemoryPropertyFlags preferred, Allocation& out, void* userData) {
+    VkImage image = VK_NULL_HANDLE;
+    if (vkCreateImage(device_, &ci, nullptr, &image) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create image");
+    }
+    VkMemoryRequirements req; vkGetImageMemoryRequirements(device_, image, &req);
+    ResourceKind kind = ci.tiling == VK_IMAGE_TILING_LINEAR ? ResourceKind::Linear : ResourceKind::Optimal;
+    try {
+        out = allocate(req, required, preferred, kind, userData);
+    } catch (...) {
+        vkDestroyImage(device_, image, nullptr);
+        throw;
+    }
+    vkBindImageMemory(device_, image, out.memory, out.offset);
+    return image;
+}
+
+void MemoryAllocator::destroyBuffer(VkBuffer buffer, Allocation& alloc) {
+    if (buffer) vkDestroyBuffer(device_, buffer, nullptr);
+    free(alloc);
+}
+
+void MemoryAllocator::destroyImage(VkImage image, Allocation& alloc) {
+    if (image) vkDestroyImage(device_, image, nullptr);
+    free(alloc);
+}
+
+void MemoryAllocator::flush(const Allocation& alloc, VkDeviceSize offset, VkDeviceSize size) {
+    if (!alloc.memory) return;
+    if (memProps_.memoryTypes[alloc.memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) return;
+    VkDeviceSize memorySize = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (alloc.linearPool) {
+            if (alloc.blockId && alloc.blockId <= linearPools_.size() && linearPools_[alloc.blockId - 1]) {
+                memorySize = linearPools_[alloc.blockId - 1]->size;
+            }
+        } else if (Block* b = findBlock(alloc.blockId)) {
+            memorySize = b->size;
+        }
+    }
+    if (!memorySize) return;
+    VkDeviceSize end = size == VK_WHOLE_SIZE ? alloc.offset + alloc.size : alloc.offset + offset + size;
+    VkMappedMemoryRange range{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+    range.memory = alloc.memory;
+    range.offset = alignDown(alloc.offset + offset, nonCoherentAtomSize_);
+    range.size = std::min(alignUp(end, nonCoherentAtomSize_), memorySize) - range.offset;
+    vkFlushMappedMemoryRanges(device_, 1, &range);
+}
+
+uint32_t MemoryAllocator::createLinearPool(VkDeviceSize size, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t type = pickMemoryType(~0u, required, preferred | required, 0);
+    if (type == UINT32_MAX) throw std::runtime_error("Failed to find suitable memory type");
+    if (deviceAllocations_ >= maxAllocationCount_) throw std::runtime_error("Too many device memory allocations");
+    VkMemoryAllocateInfo mai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    mai.allocationSize = size;
+    mai.memoryTypeIndex = type;
+    auto* p = new LinearPool();
+    if (vkAllocateMemory(device_, &mai, nullptr, &p->memory) != VK_SUCCESS) {
+        delete p;
+        throw std::runtime_error("Failed to allocate linear pool memory");
+    }
+    ++deviceAllocations_;
+    p->memoryType = type;
+    p->size = size;
+    if (memProps_.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void* ptr = nullptr;
+        if (vkMapMemory(device_, p->memory, 0, VK_WHOLE_SIZE, 0, &ptr) == VK_SUCCESS) p->mapped = static_cast<char*>(ptr);
+    }
+    linearPools_.push_back(p);
+    return static_cast<uint32_t>(linearPools_.size()); // ids are 1-based
+}
+
+Allocation MemoryAllocator::allocateLinear(uint32_t pool, const VkMemoryRequirements& req, ResourceKind kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pool || pool > linearPools_.size() || !linearPools_[pool - 1]) throw std::runtime_error("Invalid linear pool");
+    LinearPool& p = *linearPools_[pool - 1];
+    if (!(req.memoryTypeBits & (1u << p.memoryType))) throw std::runtime_error("Linear pool memory type incompatible with resource");
+    VkDeviceSize offset = alignUp(p.head, std::max<VkDeviceSize>(1, req.alignment));
+    // Switching between linear and optimal resources: move to the next granularity page
+    if (p.allocationCount && p.lastKind != kind) offset = alignUp(offset, granularity_);
+    if (offset + req.size > p.size) throw std::runtime_error("Linear pool exhausted");
+    p.head = offset + req.size;
+    p.lastKind = kind;
+    ++p.allocationCount;
+
+    Allocation out;
+    out.memory = p.memory;
+    out.offset = offset;
+    out.size = req.size;
+    out.mapped = p.mapped ? p.mapped + offset : nullptr;
+    out.memoryType = p.memoryType;
+    out.blockId = pool;
+    out.linearPool = true;
+    return out;
+}
+
+void MemoryAllocator::resetLinearPool(uint32_t pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pool || pool > linearPools_.size() || !linearPools_[pool - 1]) return;
+    linearPools_[pool - 1]->head = 0;
+    linearPools_[pool - 1]->allocationCount = 0;
+}
+
+void MemoryAllocator::destroyLinearPool(uint32_t pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pool || pool > linearPools_.size() || !linearPools_[pool - 1]) return;
+    LinearPool* p = linearPools_[pool - 1];
+    if (p->mapped) vkUnmapMemory(device_, p->memory);
+    vkFreeMemory(device_, p->memory, nullptr);
+    --deviceAllocations_;
+    delete p;
+    linearPools_[pool - 1] = nullptr;
+}
+
+std::vector<DefragMove> MemoryAllocator::planDefragmentation(VkDeviceSize maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<DefragMove> moves;
+    std::vector<Block*> candidates;
+    for (auto* b : blocks_) if (!b->dedicated && b->allocationCount) candidates.push_back(b);
+    // Evacuate the emptiest blocks first, into the fullest ones
+    std::sort(candidates.begin(), candidates.end(), [](Block* a, Block* b) { return a->used < b->used; });
+
+    VkDeviceSize budget = maxBytes;
+    std::vector<uint32_t> sources, targets;
+    auto contains = [](const std::vector<uint32_t>& v, uint32_t id) { return std::find(v.begin(), v.end(), id) != v.end(); };
+    for (size_t s = 0; s < candidates.size() && budget; ++s) {
+        Block* src = candidates[s];
+        // A block that already receives moves must stay put
+        if (src->used > budget || contains(targets, src->id)) continue;
+        // Only worth it when the whole block can be emptied; otherwise nothing is released
+        std::vector<DefragMove> blockMoves;
+        bool complete = true;
+        for (uint32_t idx = 1; idx < src->nodes.size() && complete; ++idx) {
+            const Node& n = src->nodes[idx];
+            if (n.free || n.size == 0) continue;
+            DefragMove mv;
+            mv.src.memory = src->memory;
+            mv.src.offset = n.offset;
+            mv.src.size = n.allocSize;
+            mv.src.mapped = src->mapped ? src->mapped + n.offset : nullptr;
+            mv.src.memoryType = src->memoryType;
+            mv.src.blockId = src->id;
+            mv.src.node = idx;
+            mv.userData = n.userData;
+            bool placed = false;
+            for (size_t d = candidates.size(); d-- > s + 1 && !placed;) {
+                Block* dst = candidates[d];
+                if (dst->memoryType != src->memoryType || dst->kind != src->kind) continue;
+                if (contains(sources, dst->id)) continue;
+                placed = allocateFromBlock(*dst, n.allocSize, n.alignment, n.userData, mv.dst);
+            }
+            if (!placed) complete = false;
+            else blockMoves.push_back(mv);
+        }
+        if (!complete) {
+            for (auto& mv : blockMoves) freeLocked(mv.dst);
+            continue;
+        }
+        sources.push_back(src->id);
+        for (auto& mv : blockMoves) if (!contains(targets, mv.dst.blockId)) targets.push_back(mv.dst.blockId);
+        budget -= src->used;
+        moves.insert(moves.end(), blockMoves.begin(), blockMoves.end());
+    }
+    return moves;
+}
+
+void MemoryAllocator::commitDefragmentation(std::vector<DefragMove>& moves) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& mv : moves) freeLocked(mv.src);
+    moves.clear();
+}
+
+void MemoryAllocator::cancelDefragmentation(std::vector<DefragMove>& moves) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& mv : moves) freeLocked(mv.dst);
+    moves.clear();
+}
+
+MemoryStats MemoryAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MemoryStats out;
+    out.heaps.resize(memProps_.memoryHeapCount);
+    std::vector<VkDeviceSize> freeBytes(memProps_.memoryHeapCount, 0);
+    for (auto* b : blocks_) {
+        MemoryHeapStats& h = out.heaps[memProps_.memoryTypes[b->memoryType].heapIndex];
+        ++h.blockCount;
+        h.allocationCount += b->allocationCount;
+        h.bytesReserved += b->size;
+        h.bytesUsed += b->used;
+        if (b->dedicated) continue;
+        for (size_t i = 1; i < b->nodes.size(); ++i) {
+            const Node& n = b->nodes[i];
+            if (!n.free) continue;
+            freeBytes[memProps_.memoryTypes[b->memoryType].heapIndex] += n.size;
+            h.largestFreeRange = std::max(h.largestFreeRange, n.size);
+        }
+    }
+    for (auto* p : linearPools_) {
+        if (!p) continue;
+        MemoryHeapStats& h = out.heaps[memProps_.memoryTypes[p->memoryType].heapIndex];
+        ++h.blockCount;
+        h.allocationCount += p->allocationCount;
+        h.bytesReserved += p->size;
+        h.bytesUsed += p->head;
+    }
+    VkDeviceSize totalFree = 0;
+    for (size_t i = 0; i < out.heaps.size(); ++i) {
+        MemoryHeapStats& h = out.heaps[i];
+        if (freeBytes[i]) h.fragmentation = 1.0 - static_cast<double>(h.largestFreeRange) / static_cast<double>(freeBytes[i]);
+        out.total.blockCount += h.blockCount;
+        out.total.allocationCount += h.allocationCount;
+        out.total.bytesReserved += h.bytesReserved;
+        out.total.bytesUsed += h.bytesUsed;
+        out.total.largestFreeRange = std::max(out.total.largestFreeRange, h.largestFreeRange);
+        totalFree += freeBytes[i];
+    }
+    if (totalFree) out.total.fragmentation = 1.0 - static_cast<double>(out.total.largestFreeRange) / static_cast<double>(totalFree);
+    out.deviceAllocationCount = deviceAllocations_;
+    return out;
+}
+
+void MemoryAllocator::logStats() const {
+    MemoryStats s = stats();
+    std::cout << "MemoryAllocator: " << s.deviceAllocationCount << " device allocations, "
+              << s.total.allocationCount << " sub-allocations" << std::endl;
+    for (size_t i = 0; i < s.heaps.size(); ++i) {
+        const MemoryHeapStats& h = s.heaps[i];
+        if (!h.blockCount) continue;
+        std::cout << "  heap " << i << ": " << toMiB(h.bytesUsed) << " / " << toMiB(h.bytesReserved)
+                  << " MiB used in " << h.blockCount << " blocks, fragmentation " << h.fragmentation << std::endl;
+    }
+}
+
+} // namespace vulkan
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vulkan {
+
+// Buffers and linear-tiling images vs. optimal-tiling images. Kept in separate blocks so
+// neighbours never violate bufferImageGranularity.
+enum class ResourceKind : uint8_t { Linear = 0, Optimal = 1 };
+
+// A sub-range of a VkDeviceMemory block. Plain value; pass back to MemoryAllocator::free.
+struct Allocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;     // host pointer to offset (host-visible memory only, persistently mapped)
+    uint32_t memoryType = 0;
+    uint32_t blockId = 0;       // internal: owning block (0 = none)
+    uint32_t node = 0;          // internal: TLSF node within the block
+    bool dedicated = false;     // owns its VkDeviceMemory outright
+    bool linearPool = false;    // from a LinearPool; released only by resetLinearPool
+};
+
+struct MemoryHeapStats {
+    uint32_t blockCount = 0;       // VkDeviceMemory objects, incl. dedicated allocations
+    uint32_t allocationCount = 0;
+    VkDeviceSize bytesReserved = 0; // sum of VkDeviceMemory sizes
+    VkDeviceSize bytesUsed = 0;     // sum of live allocation sizes
+    VkDeviceSize largestFreeRange = 0;
+    // 1 - largestFreeRange / freeBytes over TLSF blocks: 0 = one contiguous hole, ->1 = scattered
+    double fragmentation = 0.0;
+};
+
+struct MemoryStats {
+    std::vector<MemoryHeapStats> heaps; // indexed like VkPhysicalDeviceMemoryProperties::memoryHeaps
+    MemoryHeapStats total;
+    uint32_t deviceAllocationCount = 0; // live vkAllocateMemory calls (vs maxMemoryAllocationCount)
+};
+
+// Move proposed by planDefragmentation. The caller creates a new resource bound at dst,
+// copies src -> dst on the GPU, and once that work has completed calls commitDefragmentation.
+struct DefragMove {
+    Allocation src;
+    Allocation dst;
+    void* userData = nullptr; // as passed to allocate(), to find the owning resource
+};
+
+// Device memory sub-allocator. Each memory type gets large blocks (one vkAllocateMemory each)
+// carved up with a TLSF (two-level segregated fit) allocator: O(1) allocate/free with
+// immediate coalescing. Requests bigger than half a block get a dedicated allocation.
+// Linear pools are bump allocators for transient data, reset as a whole.
+// Host-visible blocks are mapped once at creation and stay mapped. Thread-safe.
+class MemoryAllocator {
+public:
+    static constexpr VkDeviceSize kDefaultBlockSize = 64ull << 20;
+
+    MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize preferredBlockSize = kDefaultBlockSize);
+    ~MemoryAllocator();
+
+    MemoryAllocator(const MemoryAllocator&) = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+    // required must be satisfied; preferred picks between otherwise compatible types. Throws on failure.
+    Allocation allocate(const VkMemoryRequirements& req, VkMemoryPropertyFlags required,
+                        VkMemoryPropertyFlags preferred, ResourceKind kind, void* userData = nullptr);
+    void free(Allocation& alloc);
+
+    // Convenience: create + allocate + bind. Destroy with destroyBuffer / destroyImage.
+    VkBuffer createBuffer(const VkBufferCreateInfo& ci, VkMemoryPropertyFlags required,
+                          VkMemoryPropertyFlags preferred, Allocation& out, void* userData = nullptr);
+    VkImage createImage(const VkImageCreateInfo& ci, VkMemoryPropertyFlags required,
+                        VkMemoryPropertyFlags preferred, Allocation& out, void* userData = nullptr);
+    void destroyBuffer(VkBuffer buffer, Allocation& alloc);
+    void destroyImage(VkImage image, Allocation& alloc);
+
+    // Non-coherent host memory: make CPU writes visible to the device (no-op when coherent)
+    void flush(const Allocation& alloc, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    // Linear pools: one block, bump allocation, no individual frees
+    uint32_t createLinearPool(VkDeviceSize size, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred);
+    Allocation allocateLinear(uint32_t pool, const VkMemoryRequirements& req, ResourceKind kind);
+    void resetLinearPool(uint32_t pool);
+    void destroyLinearPool(uint32_t pool);
+
+    // Defragmentation hooks: propose moving allocations out of the emptiest blocks into
+    // holes of fuller ones (up to maxBytes). dst ranges are reserved until commit/cancel.
+    std::vector<DefragMove> planDefragmentation(VkDeviceSize maxBytes);
+    // Frees every src (GPU copies must be complete) and releases blocks left empty
+    void commitDefragmentation(std::vector<DefragMove>& moves);
+    // Drops the reserved dst ranges, keeping the sources
+    void cancelDefragmentation(std::vector<DefragMove>& moves);
+
+    MemoryStats stats() const;
+    void logStats() const;
+
+    VkDeviceSize bufferImageGranularity() const { return granularity_; }
+
+private:
+    struct Node {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        uint32_t prevPhys = 0, nextPhys = 0; // neighbours by address (0 = none; index 0 is unused)
+        uint32_t prevFree = 0, nextFree = 0; // TLSF free-list links
+        VkDeviceSize allocSize = 0;  // requested size (size may include an absorbed tail)
+        VkDeviceSize alignment = 1;
+        bool free = false;
+        void* userData = nullptr;
+    };
+    struct Block;
+    struct LinearPool;
+
+    uint32_t pickMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred,
+                            uint32_t skipMask) const;
+    VkDeviceSize blockSizeFor(uint32_t memoryType) const;
+    Block* createBlock(uint32_t memoryType, VkDeviceSize size, ResourceKind kind, bool dedicated);
+    void destroyBlock(uint32_t blockId);
+    Block* findBlock(uint32_t blockId) const;
+    bool allocateFromBlock(Block& block, VkDeviceSize size, VkDeviceSize alignment, void* userData, Allocation& out);
+    bool tryAllocate(uint32_t memoryType, const VkMemoryRequirements& req, ResourceKind kind, void* userData, Allocation& out);
+    void freeLocked(Allocation& alloc);
+    void releaseEmptyBlocks(uint32_t memoryType);
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memProps_{};
+    VkDeviceSize preferredBlockSize_ = kDefaultBlockSize;
+    VkDeviceSize granularity_ = 1;
+    VkDeviceSize nonCoherentAtomSize_ = 1;
+    uint32_t maxAllocationCount_ = 4096;
+
+    mutable std::mutex mutex_;
+    std::vector<Block*> blocks_;        // TLSF and dedicated blocks
+    std::vector<LinearPool*> linearPools_;
+    uint32_t nextBlockId_ = 1;
+    uint32_t deviceAllocations_ = 0;
+};
+
+} // namespace vulkan
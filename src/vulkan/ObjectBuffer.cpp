@@ -0,0 +1,133 @@
+#include "vulkan/ObjectBuffer.h"
+
+#include <algorithm>
+
+#include "vulkan/BufferUtils.h"
+#include "vulkan/DescriptorAllocator.h"
+#include "vulkan/VkObjects.h"
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+namespace {
+// Unchanged ids between two changed ones are copied along when the gap is at most this many
+// objects (256 bytes): fewer, larger regions for clustered changes
+constexpr uint32_t kMaxGapObjects = 4;
+constexpr VkDeviceSize kObjectBytes = sizeof(aurora::math::Mat4);
+}
+
+ObjectBuffer::ObjectBuffer(VkObjects* vk, uint32_t initialCapacity) : vk_(vk) {
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT; // compute: GPU culling
+    setLayout_ = vk->descriptorLayouts->get(&binding, 1);
+    current_ = createStorage(std::max(initialCapacity, 1u));
+}
+
+ObjectBuffer::~ObjectBuffer() {
+    // Caller guarantees the device is idle
+    for (auto& s : retired_) destroyStorage(s);
+    destroyStorage(current_);
+}
+
+ObjectBuffer::Storage ObjectBuffer::createStorage(uint32_t capacity) {
+    Storage s;
+    s.capacity = capacity;
+    vkbuf::createBuffer(vk_, capacity * kObjectBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, s.buffer, s.alloc);
+    return s;
+}
+
+void ObjectBuffer::destroyStorage(Storage& s) {
+    vkbuf::destroyBuffer(vk_, s.buffer, s.alloc);
+    s = {};
+}
+
+void ObjectBuffer::set(uint32_t object, const aurora::math::Mat4& world) {
+    if (object >= shadow_.size()) {
+        shadow_.resize(size_t(object) + 1);
+        dirtyFlag_.resize(size_t(object) + 1, 0);
+    }
+    shadow_[object] = world;
+    if (!dirtyFlag_[object]) {
+        dirtyFlag_[object] = 1;
+        dirty_.push_back(object);
+    }
+}
+
+void ObjectBuffer::set(const uint32_t* objects, const aurora::math::Mat4* worlds, size_t count) {
+    for (size_t i = 0; i < count; ++i) set(objects[i], worlds[i]);
+}
+
+bool ObjectBuffer::ready() const {
+    return vk_->uploads->isSubmitted(readyTicket_);
+}
+
+void ObjectBuffer::flush() {
+    AURORA_PROFILE_ZONE("ObjectBuffer::flush");
+    // Same rule as retired swapchains: maxFramesInFlight newer frames have waited their fences
+    for (size_t i = 0; i < retired_.size();) {
+        if (vk_->frameNumber >= retired_[i].retiredAtFrame + vk_->maxFramesInFlight) {
+            destroyStorage(retired_[i]);
+            retired_.erase(retired_.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            ++i;
+        }
+    }
+    stats_.uploadedObjects = 0;
+    stats_.copyRegions = 0;
+    stats_.deferredObjects = 0;
+
+    const uint32_t count = static_cast<uint32_t>(shadow_.size());
+    if (count > current_.capacity) {
+        current_.retiredAtFrame = vk_->frameNumber;
+        retired_.push_back(current_);
+        current_ = createStorage(std::max(count, current_.capacity * 2));
+        uploadAll_ = true;
+        readyTicket_ = UINT64_MAX; // not drawable until the full upload below is recorded
+    }
+    stats_.capacity = current_.capacity;
+
+    frameSet_ = vk_->descriptors->allocate(setLayout_);
+    VkDescriptorBufferInfo info{current_.buffer, 0, VK_WHOLE_SIZE};
+    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = frameSet_;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &info;
+    vkUpdateDescriptorSets(vk_->device, 1, &write, 0, nullptr);
+
+    if (dirty_.empty() && !uploadAll_) return;
+
+    // Regions of one vkCmdCopyBuffer must not overlap: while an earlier flush's copies still
+    // wait for staging budget, keep collecting instead of queueing a second copy of an id
+    if (!vk_->uploads->isSubmitted(lastTicket_)) {
+        stats_.deferredObjects = static_cast<uint32_t>(uploadAll_ ? count : dirty_.size());
+        return;
+    }
+
+    if (uploadAll_) {
+        lastTicket_ = readyTicket_ = vk_->uploads->enqueue(current_.buffer, 0, shadow_.data(), count * kObjectBytes);
+        stats_.uploadedObjects = count;
+        stats_.copyRegions = 1;
+        uploadAll_ = false;
+    } else {
+        std::sort(dirty_.begin(), dirty_.end());
+        for (size_t i = 0; i < dirty_.size();) {
+            const uint32_t first = dirty_[i];
+            uint32_t last = first;
+            for (++i; i < dirty_.size() && dirty_[i] - last <= kMaxGapObjects + 1; ++i) last = dirty_[i];
+            const uint32_t n = last - first + 1;
+            lastTicket_ = vk_->uploads->enqueue(current_.buffer, first * kObjectBytes, &shadow_[first], n * kObjectBytes);
+            stats_.uploadedObjects += n;
+            ++stats_.copyRegions;
+        }
+    }
+    for (uint32_t object : dirty_) dirtyFlag_[object] = 0;
+    dirty_.clear();
+}
+
+}
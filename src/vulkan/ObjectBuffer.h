@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "vulkan/MemoryAllocator.h"
+#include "vulkan/UploadManager.h"
+#include <aurora/math/Math.h>
+
+struct VkObjects;
+
+namespace vulkan {
+// Per-object data for the vertex shader: one world matrix per object id in a DEVICE_LOCAL
+// storage buffer (set 0, binding 0), indexed by DrawCommand::object. A CPU shadow holds the
+// latest matrices; set() only records which ids changed, and flush() uploads the changed ids
+// once per frame through the UploadManager, with neighbouring ids merged into one copy region.
+// So a frame in which few objects moved copies only those. Growing the buffer uploads the
+// whole shadow into a new buffer; the old one is destroyed once no frame in flight can
+// reference it. The descriptor set is allocated each frame from vk->descriptors, so it always
+// points at the current buffer.
+//
+// Used from the thread that renders (set, flush and recording are not thread-safe against
+// each other).
+class ObjectBuffer {
+public:
+    static constexpr uint32_t kDefaultCapacity = 1024;
+
+    struct Stats {
+        uint32_t capacity = 0;
+        uint32_t uploadedObjects = 0; // by the last flush, gap fill included
+        uint32_t copyRegions = 0;     // by the last flush
+        uint32_t deferredObjects = 0; // changed but held back behind an unsubmitted upload
+    };
+
+    ObjectBuffer(VkObjects* vk, uint32_t initialCapacity = kDefaultCapacity);
+    ~ObjectBuffer();
+
+    ObjectBuffer(const ObjectBuffer&) = delete;
+    ObjectBuffer& operator=(const ObjectBuffer&) = delete;
+
+    void set(uint32_t object, const aurora::math::Mat4& world);
+    void set(const uint32_t* objects, const aurora::math::Mat4* worlds, size_t count);
+
+    // After the frame's fence wait and vk->descriptors->beginFrame, before recording: queue
+    // this frame's copies, write this frame's set and destroy buffers no frame in flight uses
+    void flush();
+
+    VkDescriptorSetLayout setLayout() const { return setLayout_; }
+    VkDescriptorSet descriptorSet() const { return frameSet_; }
+    // False until the contents of a freshly grown buffer are in a recorded upload batch;
+    // draws that read it are skipped meanwhile
+    bool ready() const;
+    const Stats& stats() const { return stats_; }
+    // Latest matrices set, indexed by object (CPU copy; what the GPU sees after flush)
+    const std::vector<aurora::math::Mat4>& worlds() const { return shadow_; }
+
+private:
+    struct Storage {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        Allocation alloc;
+        uint32_t capacity = 0;
+        uint64_t retiredAtFrame = 0;
+    };
+
+    Storage createStorage(uint32_t capacity);
+    void destroyStorage(Storage& s);
+
+    VkObjects* vk_ = nullptr;
+    VkDescriptorSetLayout setLayout_ = VK_NULL_HANDLE; // owned by vk->descriptorLayouts
+    VkDescriptorSet frameSet_ = VK_NULL_HANDLE;        // of the frame being recorded
+    Storage current_;
+    std::vector<Storage> retired_;
+
+    std::vector<aurora::math::Mat4> shadow_;
+    std::vector<uint8_t> dirtyFlag_;
+    std::vector<uint32_t> dirty_;
+    bool uploadAll_ = false;
+    UploadManager::Ticket lastTicket_ = 0;  // last copy queued by flush()
+    UploadManager::Ticket readyTicket_ = 0; // full upload into current_
+    Stats stats_;
+};
+}
@@ -0,0 +1,57 @@
+#include "Offscreen.h"
+
+#include <stdexcept>
+#include <iostream>
+
+
+namespace vulkan {
+
+void OffscreenTargets::createTargets(VkObjects* vk, uint32_t width, uint32_t height) {
+    vk->swapchainImageFormat = kColorFormat;
+    vk->swapchainExtent = { width == 0 ? 1u : width, height == 0 ? 1u : height };
+    vk->swapchainImages.resize(kImageCount);
+    vk->swapchainImageViews.resize(kImageCount);
+    vk->offscreenImageAllocs.resize(kImageCount);
+
+    for (uint32_t i = 0; i < kImageCount; ++i) {
+        VkImageCreateInfo ici{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        ici.imageType = VK_IMAGE_TYPE_2D;
+        ici.format = kColorFormat;
+        ici.extent = { vk->swapchainExtent.width, vk->swapchainExtent.height, 1 };
+        ici.mipLevels = 1;
+        ici.arrayLayers = 1;
+        ici.samples = VK_SAMPLE_COUNT_1_BIT;
+        ici.tiling = VK_IMAGE_TILING_OPTIMAL;
+        // TRANSFER_SRC so tests / tools can read frames back
+        ici.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        vk->swapchainImages[i] = vk->allocator->createImage(ici, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, vk->offscreenImageAllocs[i]);
+
+        VkImageViewCreateInfo iv{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+        iv.image = vk->swapchainImages[i];
+        iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        iv.format = kColorFormat;
+        iv.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        iv.subresourceRange.baseMipLevel = 0;
+        iv.subresourceRange.levelCount = 1;
+        iv.subresourceRange.baseArrayLayer = 0;
+        iv.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(vk->device, &iv, nullptr, &vk->swapchainImageViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create offscreen image view");
+        }
+    }
+    std::cout << "Offscreen: created " << kImageCount << " targets "
+              << vk->swapchainExtent.width << "x" << vk->swapchainExtent.height << std::endl;
+}
+
+void OffscreenTargets::destroyImages(VkObjects* vk) {
+    if (!vk || !vk->device) return;
+    for (size_t i = 0; i < vk->swapchainImages.size(); ++i) {
+        vk->allocator->destroyImage(vk->swapchainImages[i], vk->offscreenImageAllocs[i]);
+    }
+    vk->swapchainImages.clear();
+    vk->offscreenImageAllocs.clear();
+}
+
+} // namespace vulkan
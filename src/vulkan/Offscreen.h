@@ -0,0 +1,17 @@
+#pragma once
+
+#include "vulkan/VkObjects.h"
+
+namespace vulkan {
+// Engine-owned color targets used in place of a swapchain when running headless.
+// Images/views are stored in vk->swapchainImages / vk->swapchainImageViews so the
+// render pass, framebuffer and command buffer code paths stay identical.
+struct OffscreenTargets {
+    static constexpr uint32_t kImageCount = 3;
+    static constexpr VkFormat kColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+    static void createTargets(VkObjects* vk, uint32_t width, uint32_t height);
+    // Destroys images + memory only; views go through SwapchainManager::cleanupSwapchain
+    static void destroyImages(VkObjects* vk);
+};
+}
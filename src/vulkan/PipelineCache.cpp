@@ -0,0 +1,184 @@
+#include "PipelineCache.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <cstring>
+#include <chrono>
+#include <mutex>
+
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+namespace {
+// VkPipelineCacheHeaderVersionOne as laid out in the blob (tightly packed, 32 bytes)
+constexpr size_t kHeaderSize = 16 + VK_UUID_SIZE;
+
+bool headerMatches(const std::vector<char>& blob, const VkPhysicalDeviceProperties& props) {
+    if (blob.size() < kHeaderSize) return false;
+    uint32_t headerSize = 0, headerVersion = 0, vendorID = 0, deviceID = 0;
+    std::memcpy(&headerSize, blob.data() + 0, 4);
+    std::memcpy(&headerVersion, blob.data() + 4, 4);
+    std::memcpy(&vendorID, blob.data() + 8, 4);
+    std::memcpy(&deviceID, blob.data() + 12, 4);
+    return headerSize >= kHeaderSize && headerSize <= blob.size() &&
+           headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vendorID == props.vendorID && deviceID == props.deviceID &&
+           std::memcmp(blob.data() + 16, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<char> readBlob(const std::string& path) {
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) return {};
+    std::streamsize size = f.tellg();
+    if (size <= 0) return {};
+    std::vector<char> blob(static_cast<size_t>(size));
+    f.seekg(0);
+    if (!f.read(blob.data(), size)) return {};
+    return blob;
+}
+}
+
+void PipelineCache::create(VkObjects* vk) {
+    AURORA_PROFILE_ZONE("PipelineCache::create");
+    vk->pipelineCacheStats = {};
+    std::vector<char> blob;
+    if (!vk->pipelineCachePath.empty()) {
+        blob = readBlob(vk->pipelineCachePath);
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(vk->physicalDevice, &props);
+        if (!blob.empty() && !headerMatches(blob, props)) {
+            std::cout << "PipelineCache: " << vk->pipelineCachePath
+                      << " was written by another device/driver, starting empty" << std::endl;
+            blob.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo ci{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    ci.initialDataSize = blob.size();
+    ci.pInitialData = blob.empty() ? nullptr : blob.data();
+    VkResult res = vkCreatePipelineCache(vk->device, &ci, nullptr, &vk->pipelineCache);
+    if (res != VK_SUCCESS && !blob.empty()) {
+        // The header matched but the driver still rejected the payload (e.g. truncated file)
+        std::cout << "PipelineCache: driver rejected " << vk->pipelineCachePath << ", starting empty" << std::endl;
+        blob.clear();
+        ci.initialDataSize = 0;
+        ci.pInitialData = nullptr;
+        res = vkCreatePipelineCache(vk->device, &ci, nullptr, &vk->pipelineCache);
+    }
+    if (res != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache");
+    }
+    vk->pipelineCacheStats.loadedFromDisk = !blob.empty();
+    vk->pipelineCacheStats.loadedBytes = blob.size();
+    if (!blob.empty()) {
+        std::cout << "PipelineCache: loaded " << blob.size() << " bytes from " << vk->pipelineCachePath << std::endl;
+    }
+}
+
+bool PipelineCache::save(VkObjects* vk) {
+    if (!vk->pipelineCache || vk->pipelineCachePath.empty()) return false;
+    size_t size = 0;
+    if (vkGetPipelineCacheData(vk->device, vk->pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0) return false;
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(vk->device, vk->pipelineCache, &size, data.data()) != VK_SUCCESS) return false;
+    data.resize(size);
+
+    namespace fs = std::filesystem;
+    const std::string tmpPath = vk->pipelineCachePath + ".tmp";
+    {
+        std::ofstream f(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!f || !f.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+            std::cerr << "PipelineCache: cannot write " << tmpPath << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmpPath, vk->pipelineCachePath, ec); // atomic replace on the same filesystem
+    if (ec) {
+        std::cerr << "PipelineCache: cannot replace " << vk->pipelineCachePath << ": " << ec.message() << std::endl;
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    vk->pipelineCacheStats.savedBytes = data.size();
+    std::cout << "PipelineCache: saved " << data.size() << " bytes to " << vk->pipelineCachePath << std::endl;
+    return true;
+}
+
+void PipelineCache::destroy(VkObjects* vk) {
+    if (!vk || !vk->pipelineCache) return;
+    save(vk);
+    const PipelineCacheStats& s = vk->pipelineCacheStats;
+    std::cout << "PipelineCache: " << s.pipelinesCreated << " pipelines in " << s.totalMs << " ms";
+    if (vk->pipelineCreationFeedback) {
+        std::cout << " (" << s.cacheHits << " hits " << s.hitMs << " ms, "
+                  << s.cacheMisses << " misses " << s.missMs << " ms)";
+    }
+    std::cout << std::endl;
+    vkDestroyPipelineCache(vk->device, vk->pipelineCache, nullptr);
+    vk->pipelineCache = VK_NULL_HANDLE;
+}
+
+namespace {
+// vk->pipelineCacheStats while pipelines are created on several threads (the VkPipelineCache
+// itself is internally synchronized)
+std::mutex statsMutex;
+
+// Creates one pipeline through vk->pipelineCache with creation feedback chained in when
+// available, and adds its time to the hit/miss statistics
+template<typename CreateInfo, typename CreateFn>
+VkResult createTracked(VkObjects* vk, const CreateInfo& ci, VkPipeline* pipeline, const char* kind, CreateFn create) {
+    CreateInfo info = ci;
+    VkPipelineCreationFeedbackEXT feedback{};
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT};
+    if (vk->pipelineCreationFeedback) {
+        feedbackInfo.pNext = info.pNext;
+        feedbackInfo.pPipelineCreationFeedback = &feedback;
+        info.pNext = &feedbackInfo;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    VkResult res = create(vk->device, vk->pipelineCache, 1, &info, nullptr, pipeline);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (res != VK_SUCCESS) return res;
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    PipelineCacheStats& s = vk->pipelineCacheStats;
+    ++s.pipelinesCreated;
+    s.totalMs += ms;
+    s.maxMs = std::max(s.maxMs, ms);
+    const char* outcome = "unknown";
+    if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) {
+        if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) {
+            ++s.cacheHits;
+            s.hitMs += ms;
+            outcome = "hit";
+        } else {
+            ++s.cacheMisses;
+            s.missMs += ms;
+            outcome = "miss";
+        }
+    }
+    std::cout << "PipelineCache: " << kind << " pipeline in " << ms << " ms (cache " << outcome << ")" << std::endl;
+    return res;
+}
+} // namespace
+
+VkResult PipelineCache::createGraphicsPipeline(VkObjects* vk, const VkGraphicsPipelineCreateInfo& ci, VkPipeline* pipeline) {
+    return createTracked(vk, ci, pipeline, "graphics", vkCreateGraphicsPipelines);
+}
+
+VkResult PipelineCache::createComputePipeline(VkObjects* vk, const VkComputePipelineCreateInfo& ci, VkPipeline* pipeline) {
+    return createTracked(vk, ci, pipeline, "compute", vkCreateComputePipelines);
+}
+
+PipelineCacheStats PipelineCache::stats(VkObjects* vk) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return vk->pipelineCacheStats;
+}
+
+} // namespace vulkan
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "vulkan/VkObjects.h"
+
+namespace vulkan {
+// Process-wide VkPipelineCache persisted between runs. The blob on disk is only used when
+// its header (vendor ID, device ID, pipelineCacheUUID) matches the current device, since
+// the UUID changes with the driver build; anything else starts from an empty cache.
+struct PipelineCache {
+    // Create vk->pipelineCache, seeded from vk->pipelineCachePath when valid
+    static void create(VkObjects* vk);
+    // Write the cache back (temp file + rename so a crash never leaves a torn blob)
+    static bool save(VkObjects* vk);
+    // Save, then destroy the cache
+    static void destroy(VkObjects* vk);
+
+    // vkCreateGraphicsPipelines through the shared cache, recording hit/miss timing
+    static VkResult createGraphicsPipeline(VkObjects* vk, const VkGraphicsPipelineCreateInfo& ci, VkPipeline* pipeline);
+    // Same for vkCreateComputePipelines
+    static VkResult createComputePipeline(VkObjects* vk, const VkComputePipelineCreateInfo& ci, VkPipeline* pipeline);
+    // Both may run on job threads (vulkan::PipelineStateCache): read the statistics through this
+    static PipelineCacheStats stats(VkObjects* vk);
+};
+}
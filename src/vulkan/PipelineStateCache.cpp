@@ -0,0 +1,200 @@
+#include "vulkan/PipelineStateCache.h"
+
+#include <bit>
+#include <exception>
+#include <functional>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "vulkan/Renderer.h"
+#include "vulkan/Utils.h"
+#include "vulkan/VkObjects.h"
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+uint64_t GraphicsPipelineDesc::hash() const {
+    using vkutils::hashMix;
+    uint64_t h = vkutils::kHashSeed;
+    h = hashMix(h, std::hash<std::string>{}(vertexShader));
+    h = hashMix(h, std::hash<std::string>{}(fragmentShader));
+    h = hashMix(h, constants.octahedralNormal | (constants.vertexColor << 1) | (constants.lit << 2) | (constants.alphaTest << 3));
+    h = hashMix(h, std::bit_cast<uint32_t>(constants.alphaCutoff));
+    h = hashMix(h, constants.materialBuffer);
+    h = hashMix(h, static_cast<uint64_t>(vertexFormat));
+    h = hashMix(h, reinterpret_cast<uint64_t>(layout));
+    h = hashMix(h, reinterpret_cast<uint64_t>(renderPass));
+    h = hashMix(h, static_cast<uint64_t>(topology));
+    h = hashMix(h, static_cast<uint64_t>(polygonMode));
+    h = hashMix(h, cullMode);
+    h = hashMix(h, static_cast<uint64_t>(frontFace));
+    h = hashMix(h, (depthTest ? 1u : 0u) | (depthWrite ? 2u : 0u) | (alphaBlend ? 4u : 0u));
+    h = hashMix(h, static_cast<uint64_t>(depthCompare));
+    return h;
+}
+
+PipelineStateCache::PipelineStateCache(VkObjects* vk) : vk_(vk), thread_([this] { compileMain(); }) {}
+
+PipelineStateCache::~PipelineStateCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+    thread_.join();
+    for (Entry& e : entries_) {
+        if (e.pipeline) vkDestroyPipeline(vk_->device, e.pipeline, nullptr);
+    }
+}
+
+uint32_t PipelineStateCache::request(const GraphicsPipelineDesc& desc, uint32_t fallback) {
+    const uint64_t hash = desc.hash();
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++requests_;
+    if (auto it = byHash_.find(hash); it != byHash_.end()) {
+        for (uint32_t id : it->second) {
+            Entry& e = entries_[id];
+            if (!(e.desc == desc)) continue;
+            ++deduplicated_;
+            if (e.state.load(std::memory_order_acquire) == State::Released) {
+                std::erase(released_, id);
+                schedule(id);
+            }
+            return id;
+        }
+    }
+    uint32_t id = takeReleased(desc);
+    if (id != kNone) {
+        // Re-key in place: the id leaves its old description's bucket
+        std::vector<uint32_t>& old = byHash_[entries_[id].hash];
+        std::erase(old, id);
+        if (old.empty()) byHash_.erase(entries_[id].hash);
+    } else {
+        id = static_cast<uint32_t>(entries_.size());
+        if (id == kMaxPipelines) throw std::runtime_error("PipelineStateCache: pipeline ids exhausted (sort key field)");
+        entries_.emplace_back();
+    }
+    Entry& e = entries_[id];
+    e.desc = desc;
+    e.hash = hash;
+    e.fallback = fallback;
+    byHash_[hash].push_back(id);
+    schedule(id);
+    return id;
+}
+
+uint32_t PipelineStateCache::takeReleased(const GraphicsPipelineDesc& desc) {
+    if (released_.empty()) return kNone;
+    size_t pick = released_.size() - 1;
+    for (size_t i = 0; i < released_.size(); ++i) {
+        GraphicsPipelineDesc other = entries_[released_[i]].desc;
+        other.renderPass = desc.renderPass;
+        if (other == desc) {
+            pick = i;
+            break;
+        }
+    }
+    const uint32_t id = released_[pick];
+    released_[pick] = released_.back();
+    released_.pop_back();
+    return id;
+}
+
+void PipelineStateCache::schedule(uint32_t id) {
+    entries_[id].state.store(State::Compiling, std::memory_order_release);
+    queue_.push_back(id);
+    ++compiling_;
+    workCv_.notify_one();
+}
+
+void PipelineStateCache::compileMain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        workCv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) return;
+        const uint32_t id = queue_.front();
+        queue_.pop_front();
+        // The entry's description stays put while it is Compiling; its address is stable
+        Entry* e = &entries_[id];
+        lock.unlock();
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        bool ok = true;
+        {
+            AURORA_PROFILE_ZONE("PipelineStateCache::compile");
+            try {
+                pipeline = Renderer::createMeshPipeline(vk_, e->desc);
+            } catch (const std::exception& ex) {
+                // The draws keep using the fallback
+                std::cerr << "PipelineStateCache: pipeline " << id << " failed: " << ex.what() << std::endl;
+                ok = false;
+            }
+        }
+        lock.lock();
+        e->pipeline = pipeline;
+        (ok ? compiled_ : failed_).fetch_add(1, std::memory_order_relaxed);
+        e->state.store(ok ? State::Ready : State::Failed, std::memory_order_release);
+        --compiling_;
+        idleCv_.notify_all();
+    }
+}
+
+VkPipeline PipelineStateCache::get(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // One fallback step: a fallback is expected to be compiled up front (see wait)
+    for (uint32_t i = id, step = 0; i < entries_.size() && step < 2; i = entries_[i].fallback, ++step) {
+        const Entry& e = entries_[i];
+        if (e.state.load(std::memory_order_acquire) == State::Ready) {
+            if (step) fallbacks_.fetch_add(1, std::memory_order_relaxed);
+            return e.pipeline;
+        }
+    }
+    fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return VK_NULL_HANDLE;
+}
+
+bool PipelineStateCache::ready(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return id < entries_.size() && entries_[id].state.load(std::memory_order_acquire) == State::Ready;
+}
+
+VkPipeline PipelineStateCache::wait(uint32_t id) {
+    AURORA_PROFILE_ZONE("PipelineStateCache::wait");
+    std::unique_lock<std::mutex> lock(mutex_);
+    const Entry& e = entries_.at(id);
+    idleCv_.wait(lock, [&e] { return e.state.load(std::memory_order_acquire) != State::Compiling; });
+    return e.state.load(std::memory_order_acquire) == State::Ready ? e.pipeline : VK_NULL_HANDLE;
+}
+
+void PipelineStateCache::releaseRenderPass(VkRenderPass renderPass) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this] { return compiling_ == 0; });
+    for (uint32_t id = 0; id < entries_.size(); ++id) {
+        Entry& e = entries_[id];
+        if (e.desc.renderPass != renderPass || e.state.load(std::memory_order_acquire) == State::Released) continue;
+        if (e.pipeline) vkDestroyPipeline(vk_->device, e.pipeline, nullptr);
+        e.pipeline = VK_NULL_HANDLE;
+        e.state.store(State::Released, std::memory_order_release);
+        released_.push_back(id);
+    }
+}
+
+void PipelineStateCache::beginFrame() {
+    fallbacks_.store(0, std::memory_order_relaxed);
+}
+
+PipelineStateCache::Stats PipelineStateCache::stats() const {
+    Stats s;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        s.requests = requests_;
+        s.deduplicated = deduplicated_;
+        s.compiling = compiling_;
+    }
+    s.compiled = compiled_.load(std::memory_order_relaxed);
+    s.failed = failed_.load(std::memory_order_relaxed);
+    s.fallbacks = fallbacks_.load(std::memory_order_relaxed);
+    return s;
+}
+
+}
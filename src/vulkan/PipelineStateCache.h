@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "render/RenderQueue.h"
+#include "render/ShaderVariant.h"
+#include "render/VertexFormat.h"
+
+struct VkObjects;
+
+namespace vulkan {
+// Everything that distinguishes one mesh graphics pipeline from another. Viewport and scissor
+// are dynamic and not part of it. Shaders are file system paths (render::shaderPath picks a
+// #define permutation); constants specializes them.
+struct GraphicsPipelineDesc {
+    std::string vertexShader = "shaders/triangle.vert.spv";
+    std::string fragmentShader = "shaders/triangle.frag.spv";
+    render::SpecConstants constants;
+    render::VertexFormat vertexFormat = render::VertexFormat::Quantized;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE; // or a compatible one
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+    bool depthTest = true;
+    bool depthWrite = true;
+    VkCompareOp depthCompare = VK_COMPARE_OP_LESS_OR_EQUAL;
+    bool alphaBlend = false; // src alpha / one minus src alpha
+
+    uint64_t hash() const;
+    bool operator==(const GraphicsPipelineDesc&) const = default;
+};
+
+// Pipeline state objects by description. request() returns a small stable id (it fits the
+// pipeline field of render::sortkey) for a description, the same id for an identical one; a
+// new description is compiled (Renderer::createMeshPipeline) on the cache's own compile thread
+// through the shared VkPipelineCache, so a material streaming in never stalls the frame that
+// first draws it, and a long compile never holds up gameplay jobs on the aurora::JobSystem.
+// Until the pipeline is ready get() returns the request's fallback (e.g. the default
+// material's pipeline) or VK_NULL_HANDLE, and the draws using it are skipped.
+//
+// request/get/stats are thread-safe (secondary command buffers resolve pipelines in parallel).
+class PipelineStateCache {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint32_t kMaxPipelines = 1u << render::sortkey::kPipelineBits;
+
+    struct Stats {
+        uint64_t requests = 0;          // request() calls
+        uint64_t deduplicated = 0;      // served an existing id
+        uint32_t compiled = 0;          // pipelines built (on the compile thread)
+        uint32_t failed = 0;
+        uint32_t compiling = 0;         // queued or in progress right now
+        uint32_t fallbacks = 0;         // get() calls since beginFrame that had no ready pipeline
+    };
+
+    explicit PipelineStateCache(VkObjects* vk);
+    // Finishes the compile in progress, drops queued ones, then destroys every pipeline
+    // (device idle)
+    ~PipelineStateCache();
+
+    PipelineStateCache(const PipelineStateCache&) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+    // fallback: id used by get() until this one is ready (kNone = skip the draws)
+    uint32_t request(const GraphicsPipelineDesc& desc, uint32_t fallback = kNone);
+    // The pipeline of id, else its fallback's when that one is ready, else VK_NULL_HANDLE
+    VkPipeline get(uint32_t id);
+    bool ready(uint32_t id) const;
+    // Blocks until id is compiled (or failed); for startup only
+    VkPipeline wait(uint32_t id);
+
+    // Before destroying renderPass (device idle): waits for compiles, destroys the pipelines
+    // built against it. Their ids recompile on the next request of the same description, or
+    // are reused by new descriptions (first one that differs only in the render pass), so
+    // rebuilding the render pass does not use up the id space.
+    void releaseRenderPass(VkRenderPass renderPass);
+
+    // Resets the per-frame fallback count
+    void beginFrame();
+    Stats stats() const;
+
+private:
+    enum class State : uint8_t { Compiling, Ready, Failed, Released };
+    struct Entry {
+        GraphicsPipelineDesc desc;
+        uint64_t hash = 0;
+        uint32_t fallback = kNone;
+        VkPipeline pipeline = VK_NULL_HANDLE; // written by the compile thread before state Ready
+        std::atomic<State> state{State::Compiling};
+    };
+
+    // A Released id for desc, preferring one whose description differs only in the render
+    // pass; kNone when there is none. Caller holds mutex_
+    uint32_t takeReleased(const GraphicsPipelineDesc& desc);
+    // Sets entry id to Compiling and queues it on the compile thread; caller holds mutex_
+    void schedule(uint32_t id);
+    void compileMain();
+
+    VkObjects* vk_ = nullptr;
+    mutable std::mutex mutex_;            // everything below except the atomics
+    std::condition_variable workCv_;      // queue_ or stopping_ changed
+    std::condition_variable idleCv_;      // a compile finished
+    std::deque<Entry> entries_;           // by id; addresses stay stable as it grows
+    std::unordered_map<uint64_t, std::vector<uint32_t>> byHash_;
+    std::vector<uint32_t> released_;      // ids in state Released, free for reuse
+    std::deque<uint32_t> queue_;          // ids waiting for the compile thread
+    uint32_t compiling_ = 0;              // queued plus in progress
+    bool stopping_ = false;
+    uint64_t requests_ = 0, deduplicated_ = 0;
+    std::atomic<uint32_t> compiled_{0}, failed_{0}, fallbacks_{0};
+    std::thread thread_;                  // last: starts once the members above exist
+};
+}
@@ -0,0 +1,516 @@
+#include "vulkan/RenderGraph.h"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "vulkan/VkObjects.h"
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+namespace {
+bool isDepthFormat(VkFormat f) {
+    return f == VK_FORMAT_D16_UNORM || f == VK_FORMAT_D32_SFLOAT || f == VK_FORMAT_X8_D24_UNORM_PACK32 ||
+           f == VK_FORMAT_D16_UNORM_S8_UINT || f == VK_FORMAT_D24_UNORM_S8_UINT || f == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+VkImageAspectFlags aspectOf(VkFormat f) {
+    if (!isDepthFormat(f)) return VK_IMAGE_ASPECT_COLOR_BIT;
+    const bool stencil = f == VK_FORMAT_D16_UNORM_S8_UINT || f == VK_FORMAT_D24_UNORM_S8_UINT || f == VK_FORMAT_D32_SFLOAT_S8_UINT;
+    return VK_IMAGE_ASPECT_DEPTH_BIT | (stencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+}
+
+bool sameAttachment(const VkAttachmentDescription& a, const VkAttachmentDescription& b) {
+    return a.format == b.format && a.samples == b.samples && a.loadOp == b.loadOp && a.storeOp == b.storeOp &&
+           a.initialLayout == b.initialLayout && a.finalLayout == b.finalLayout;
+}
+}
+
+// --- PassBuilder
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(Resource r, Usage usage) {
+    RenderGraphPlan::Access a;
+    a.resource = r;
+    a.usage = usage;
+    graph_.plan_.pass(pass_).accesses.push_back(a);
+    graph_.passes_[pass_].accessClears.push_back({});
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(Resource r, Usage usage) {
+    RenderGraphPlan::Access a;
+    a.resource = r;
+    a.usage = usage;
+    a.write = true;
+    graph_.plan_.pass(pass_).accesses.push_back(a);
+    graph_.passes_[pass_].accessClears.push_back({});
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::clearColor(Resource r, const VkClearColorValue& value) {
+    write(r, Usage::ColorAttachment);
+    graph_.plan_.pass(pass_).accesses.back().clear = true;
+    graph_.passes_[pass_].accessClears.back().color = value;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::clearDepth(Resource r, float depth) {
+    write(r, Usage::DepthAttachment);
+    graph_.plan_.pass(pass_).accesses.back().clear = true;
+    graph_.passes_[pass_].accessClears.back().depthStencil = {depth, 0};
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::sideEffect() {
+    graph_.plan_.pass(pass_).sideEffect = true;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::secondaryCommandBuffers(bool enabled) {
+    graph_.passes_[pass_].secondaries = enabled;
+    return *this;
+}
+
+// --- RenderGraph
+
+RenderGraph::RenderGraph(VkObjects* vk, uint32_t frameCount) : vk_(vk) {
+    timestampSlots_.resize(frameCount);
+    // Timestamps are available when GpuProfiler found them usable on the graphics queue
+    if (vk->timestampQueryPool && vk->timestampPeriodNs > 0.0) {
+        VkQueryPoolCreateInfo qci{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+        qci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        qci.queryCount = frameCount * kMaxPasses * 2;
+        if (vkCreateQueryPool(vk->device, &qci, nullptr, &queryPool_) != VK_SUCCESS) {
+            throw std::runtime_error("RenderGraph: failed to create timestamp query pool");
+        }
+    }
+}
+
+RenderGraph::~RenderGraph() {
+    // Caller guarantees the device is idle
+    retireTransients();
+    destroyRetired(true);
+    for (auto& rp : renderPasses_) vkDestroyRenderPass(vk_->device, rp.renderPass, nullptr);
+    if (queryPool_) vkDestroyQueryPool(vk_->device, queryPool_, nullptr);
+}
+
+RenderGraph::Resource RenderGraph::importImage(const char* name, VkImage image, VkImageView view, VkFormat format,
+                                               VkExtent2D extent, VkImageLayout initialLayout, VkImageLayout finalLayout,
+                                               VkPipelineStageFlags initialStages) {
+    RenderGraphPlan::ResourceDecl d;
+    d.name = name;
+    d.isImage = true;
+    d.initialLayout = initialLayout;
+    d.initialStages = initialStages;
+    d.finalLayout = finalLayout;
+    ResourceInfo r;
+    r.image = image;
+    r.view = view;
+    r.format = format;
+    r.extent = extent;
+    resources_.push_back(r);
+    return plan_.addResource(d);
+}
+
+RenderGraph::Resource RenderGraph::importBuffer(const char* name, VkBuffer buffer, VkPipelineStageFlags finalStages,
+                                                VkAccessFlags finalAccess) {
+    RenderGraphPlan::ResourceDecl d;
+    d.name = name;
+    d.finalStages = finalStages;
+    d.finalAccess = finalAccess;
+    ResourceInfo r;
+    r.buffer = buffer;
+    resources_.push_back(r);
+    return plan_.addResource(d);
+}
+
+RenderGraph::Resource RenderGraph::createImage(const char* name, const ImageDesc& desc) {
+    RenderGraphPlan::ResourceDecl d;
+    d.name = name;
+    d.isImage = true;
+    d.transient = true;
+    d.extraUsage = desc.extraUsage;
+    ResourceInfo r;
+    r.format = desc.format;
+    r.extent = desc.extent;
+    resources_.push_back(r);
+    return plan_.addResource(d);
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const char* name, PassType type, ExecuteFn execute) {
+    Pass p;
+    p.execute = std::move(execute);
+    passes_.push_back(std::move(p));
+    return PassBuilder(*this, plan_.addPass(name, type));
+}
+
+// Plans the frame, then creates what the plan calls for and turns its barriers into Vulkan ones
+void RenderGraph::compile() {
+    AURORA_PROFILE_ZONE("RenderGraph::compile");
+    plan_.cull();
+    if (plan_.executedPasses() > kMaxPasses) throw std::runtime_error("RenderGraph: more than kMaxPasses passes to execute");
+    stats_.culledPasses = plan_.culledPasses();
+    allocateTransients();
+
+    std::vector<uint32_t> slotOf(transients_.size());
+    for (size_t i = 0; i < transients_.size(); ++i) slotOf[i] = transients_[i].slot;
+    plan_.buildBarriers(slotOf, slotUse_);
+
+    stats_.barrierBatches = stats_.imageBarriers = stats_.bufferBarriers = 0;
+    for (uint32_t i = 0; i < passes_.size(); ++i) {
+        const RenderGraphPlan::PassPlan& p = plan_.passes()[i];
+        if (p.culled) continue;
+        translateBarriers(p, passes_[i]);
+        if (plan_.declaredPasses()[i].type == PassType::Graphics) buildRenderPass(i);
+    }
+    translateBarriers(plan_.finalTransitions(), final_);
+    compiled_ = true;
+}
+
+// Transients are reused while their descriptions and lifetimes match the previous frame's.
+// Otherwise every transient is recreated and the plan packs them into memory slots, each slot
+// one allocation.
+void RenderGraph::allocateTransients() {
+    const std::vector<RenderGraphPlan::Lifetime>& lifetimes = plan_.transients();
+    std::vector<Transient> wanted;
+    for (const RenderGraphPlan::Lifetime& l : lifetimes) {
+        const ResourceInfo& r = resources_[l.resource];
+        Transient t;
+        t.format = r.format;
+        t.extent = r.extent;
+        t.usage = plan_.resources()[l.resource].usage;
+        t.firstPass = l.firstPass;
+        t.lastPass = l.lastPass;
+        wanted.push_back(t);
+    }
+    bool same = wanted.size() == transients_.size();
+    for (size_t i = 0; same && i < wanted.size(); ++i) {
+        const Transient& a = wanted[i];
+        const Transient& b = transients_[i];
+        same = a.format == b.format && a.extent.width == b.extent.width && a.extent.height == b.extent.height &&
+               a.usage == b.usage && a.firstPass == b.firstPass && a.lastPass == b.lastPass;
+    }
+    if (!same) {
+        AURORA_PROFILE_ZONE("RenderGraph::allocateTransients");
+        retireTransients();
+        transients_ = std::move(wanted);
+        std::vector<VkMemoryRequirements> requirements;
+        for (Transient& t : transients_) {
+            VkImageCreateInfo ici{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+            ici.imageType = VK_IMAGE_TYPE_2D;
+            ici.format = t.format;
+            ici.extent = {t.extent.width, t.extent.height, 1};
+            ici.mipLevels = 1;
+            ici.arrayLayers = 1;
+            ici.samples = VK_SAMPLE_COUNT_1_BIT;
+            ici.tiling = VK_IMAGE_TILING_OPTIMAL;
+            ici.usage = t.usage;
+            ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            if (vkCreateImage(vk_->device, &ici, nullptr, &t.image) != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to create transient image");
+            }
+            vkGetImageMemoryRequirements(vk_->device, t.image, &t.requirements);
+            requirements.push_back(t.requirements);
+        }
+
+        std::vector<VkMemoryRequirements> slotReq;
+        const std::vector<uint32_t> slotOf = RenderGraphPlan::assignSlots(lifetimes, requirements, slotReq);
+        for (size_t i = 0; i < transients_.size(); ++i) transients_[i].slot = slotOf[i];
+        slots_.resize(slotReq.size());
+        slotUse_.assign(slotReq.size(), {});
+        for (size_t s = 0; s < slotReq.size(); ++s) {
+            slots_[s] = {};
+            slots_[s].size = slotReq[s].size;
+            slots_[s].alloc = vk_->allocator->allocate(slotReq[s], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, ResourceKind::Optimal);
+        }
+        for (Transient& t : transients_) {
+            const Allocation& a = slots_[t.slot].alloc;
+            if (vkBindImageMemory(vk_->device, t.image, a.memory, a.offset) != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to bind transient image memory");
+            }
+            VkImageViewCreateInfo iv{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+            iv.image = t.image;
+            iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            iv.format = t.format;
+            iv.subresourceRange = {aspectOf(t.format), 0, 1, 0, 1};
+            if (vkCreateImageView(vk_->device, &iv, nullptr, &t.view) != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to create transient image view");
+            }
+        }
+    }
+
+    VkDeviceSize individual = 0;
+    stats_.transientBytes = 0;
+    for (const Transient& t : transients_) individual += t.requirements.size;
+    for (const MemorySlot& s : slots_) stats_.transientBytes += s.size;
+    stats_.transientBytesSaved = individual - stats_.transientBytes;
+    for (size_t i = 0; i < lifetimes.size(); ++i) {
+        ResourceInfo& r = resources_[lifetimes[i].resource];
+        r.image = transients_[i].image;
+        r.view = transients_[i].view;
+    }
+}
+
+void RenderGraph::translateBarriers(const RenderGraphPlan::PassPlan& plan, Pass& pass) {
+    pass.srcStages = plan.srcStages;
+    pass.dstStages = plan.dstStages;
+    pass.imageBarriers.clear();
+    pass.bufferBarriers.clear();
+    for (const RenderGraphPlan::Barrier& pb : plan.barriers) {
+        const ResourceInfo& r = resources_[pb.resource];
+        if (plan_.declaredResources()[pb.resource].isImage) {
+            VkImageMemoryBarrier b{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+            b.srcAccessMask = pb.srcAccess;
+            b.dstAccessMask = pb.dstAccess;
+            b.oldLayout = pb.oldLayout;
+            b.newLayout = pb.newLayout;
+            b.srcQueueFamilyIndex = b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            b.image = r.image;
+            b.subresourceRange = {aspectOf(r.format), 0, 1, 0, 1};
+            pass.imageBarriers.push_back(b);
+        } else {
+            VkBufferMemoryBarrier b{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            b.srcAccessMask = pb.srcAccess;
+            b.dstAccessMask = pb.dstAccess;
+            b.srcQueueFamilyIndex = b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            b.buffer = r.buffer;
+            b.size = VK_WHOLE_SIZE;
+            pass.bufferBarriers.push_back(b);
+        }
+    }
+    if (pass.srcStages) {
+        ++stats_.barrierBatches;
+        stats_.imageBarriers += static_cast<uint32_t>(pass.imageBarriers.size());
+        stats_.bufferBarriers += static_cast<uint32_t>(pass.bufferBarriers.size());
+    }
+}
+
+// Render pass and framebuffer over the attachments the plan listed; the render pass keeps the
+// layouts, the graph's barriers do the transitions
+void RenderGraph::buildRenderPass(uint32_t index) {
+    Pass& pass = passes_[index];
+    const RenderGraphPlan::PassDecl& decl = plan_.declaredPasses()[index];
+    RenderPassEntry key;
+    std::vector<VkImageView> views;
+    for (const RenderGraphPlan::Attachment& a : plan_.passes()[index].attachments) {
+        const ResourceInfo& r = resources_[a.resource];
+        VkAttachmentDescription d{};
+        d.format = r.format;
+        d.samples = VK_SAMPLE_COUNT_1_BIT;
+        d.loadOp = decl.accesses[a.access].clear ? VK_ATTACHMENT_LOAD_OP_CLEAR
+                   : a.load                      ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                                 : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        d.storeOp = a.store ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        d.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        d.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        d.initialLayout = d.finalLayout = RenderGraphPlan::usageInfo(a.usage).layout;
+        key.attachments.push_back(d);
+        views.push_back(r.view);
+        pass.clearValues.push_back(pass.accessClears[a.access]);
+        pass.extent = r.extent;
+        if (a.usage == Usage::ColorAttachment) ++key.colorCount;
+        else key.depth = true;
+    }
+    pass.renderPass = getRenderPass(key);
+    pass.framebuffer = getFramebuffer(pass.renderPass, views, pass.extent);
+}
+
+VkRenderPass RenderGraph::getRenderPass(const RenderPassEntry& key) {
+    for (const RenderPassEntry& e : renderPasses_) {
+        if (e.colorCount != key.colorCount || e.depth != key.depth || e.attachments.size() != key.attachments.size()) continue;
+        bool same = true;
+        for (size_t i = 0; same && i < e.attachments.size(); ++i) same = sameAttachment(e.attachments[i], key.attachments[i]);
+        if (same) return e.renderPass;
+    }
+    std::vector<VkAttachmentReference> colorRefs(key.colorCount);
+    for (uint32_t i = 0; i < key.colorCount; ++i) colorRefs[i] = {i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference depthRef{key.colorCount, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = key.colorCount;
+    subpass.pColorAttachments = colorRefs.data();
+    subpass.pDepthStencilAttachment = key.depth ? &depthRef : nullptr;
+    VkRenderPassCreateInfo rpci{VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+    rpci.attachmentCount = static_cast<uint32_t>(key.attachments.size());
+    rpci.pAttachments = key.attachments.data();
+    rpci.subpassCount = 1;
+    rpci.pSubpasses = &subpass;
+    RenderPassEntry entry = key;
+    if (vkCreateRenderPass(vk_->device, &rpci, nullptr, &entry.renderPass) != VK_SUCCESS) {
+        throw std::runtime_error("RenderGraph: failed to create render pass");
+    }
+    renderPasses_.push_back(std::move(entry));
+    return renderPasses_.back().renderPass;
+}
+
+VkFramebuffer RenderGraph::getFramebuffer(VkRenderPass renderPass, const std::vector<VkImageView>& views, VkExtent2D extent) {
+    for (const FramebufferEntry& e : framebuffers_) {
+        if (e.renderPass == renderPass && e.views == views && e.extent.width == extent.width && e.extent.height == extent.height) {
+            return e.framebuffer;
+        }
+    }
+    FramebufferEntry entry;
+    entry.renderPass = renderPass;
+    entry.views = views;
+    entry.extent = extent;
+    VkFramebufferCreateInfo fci{VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+    fci.renderPass = renderPass;
+    fci.attachmentCount = static_cast<uint32_t>(views.size());
+    fci.pAttachments = views.data();
+    fci.width = extent.width;
+    fci.height = extent.height;
+    fci.layers = 1;
+    if (vkCreateFramebuffer(vk_->device, &fci, nullptr, &entry.framebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("RenderGraph: failed to create framebuffer");
+    }
+    framebuffers_.push_back(std::move(entry));
+    return framebuffers_.back().framebuffer;
+}
+
+void RenderGraph::execute(VkCommandBuffer cmd, uint32_t frameIndex) {
+    AURORA_PROFILE_ZONE("RenderGraph::execute");
+    if (!compiled_) compile();
+    TimestampSlot& ts = timestampSlots_[frameIndex];
+    ts.names.clear();
+    ts.cpuMs.clear();
+    if (queryPool_) vkCmdResetQueryPool(cmd, queryPool_, frameIndex * kMaxPasses * 2, kMaxPasses * 2);
+
+    stats_.passes.clear();
+    for (uint32_t i = 0; i < passes_.size(); ++i) {
+        if (plan_.passes()[i].culled) continue;
+        const Pass& p = passes_[i];
+        const char* name = plan_.declaredPasses()[i].name;
+        PassContext ctx;
+        ctx.cmd = cmd;
+        ctx.frameIndex = frameIndex;
+        ctx.renderPass = p.renderPass;
+        ctx.framebuffer = p.framebuffer;
+        ctx.extent = p.extent;
+        const auto t0 = std::chrono::steady_clock::now();
+        recordPass(p, name, ctx, static_cast<uint32_t>(ts.names.size()));
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        ts.names.push_back(name);
+        ts.cpuMs.push_back(ms);
+        PassStats s;
+        s.name = name;
+        s.cpuMs = ms;
+        for (const PassStats& g : gpuTimes_) {
+            if (g.name == name) s.gpuMs = g.gpuMs;
+        }
+        stats_.passes.push_back(s);
+    }
+    if (final_.srcStages) {
+        vkCmdPipelineBarrier(cmd, final_.srcStages, final_.dstStages, 0, 0, nullptr,
+                             static_cast<uint32_t>(final_.bufferBarriers.size()), final_.bufferBarriers.data(),
+                             static_cast<uint32_t>(final_.imageBarriers.size()), final_.imageBarriers.data());
+    }
+    auto& profiler = aurora::Profiler::get();
+    ts.pending = queryPool_ != VK_NULL_HANDLE;
+    ts.submitUs = profiler.isEnabled() ? profiler.nowUs() : 0;
+
+    passes_.clear();
+    resources_.clear();
+    final_ = {};
+    plan_.reset();
+    compiled_ = false;
+}
+
+void RenderGraph::recordPass(const Pass& p, const char* name, const PassContext& ctx, uint32_t executedIndex) {
+    AURORA_PROFILE_ZONE(name);
+    const uint32_t query = ctx.frameIndex * kMaxPasses * 2 + executedIndex * 2;
+    if (queryPool_) vkCmdWriteTimestamp(ctx.cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, query);
+    if (p.srcStages) {
+        vkCmdPipelineBarrier(ctx.cmd, p.srcStages, p.dstStages, 0, 0, nullptr,
+                             static_cast<uint32_t>(p.bufferBarriers.size()), p.bufferBarriers.data(),
+                             static_cast<uint32_t>(p.imageBarriers.size()), p.imageBarriers.data());
+    }
+    if (p.renderPass) {
+        VkRenderPassBeginInfo rpbi{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+        rpbi.renderPass = p.renderPass;
+        rpbi.framebuffer = p.framebuffer;
+        rpbi.renderArea.extent = p.extent;
+        rpbi.clearValueCount = static_cast<uint32_t>(p.clearValues.size());
+        rpbi.pClearValues = p.clearValues.data();
+        vkCmdBeginRenderPass(ctx.cmd, &rpbi, p.secondaries ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+    }
+    if (p.execute) p.execute(ctx);
+    if (p.renderPass) vkCmdEndRenderPass(ctx.cmd);
+    if (queryPool_) vkCmdWriteTimestamp(ctx.cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_, query + 1);
+}
+
+void RenderGraph::beginFrame(uint32_t frameIndex) {
+    destroyRetired(false);
+    TimestampSlot& ts = timestampSlots_[frameIndex];
+    if (!ts.pending) return;
+    ts.pending = false;
+    const uint32_t count = static_cast<uint32_t>(ts.names.size());
+    if (count == 0) return;
+    uint64_t ticks[kMaxPasses * 2] = {};
+    // No WAIT bit: a sample that is not ready is dropped rather than stalling the frame
+    if (vkGetQueryPoolResults(vk_->device, queryPool_, frameIndex * kMaxPasses * 2, count * 2, sizeof(ticks), ticks,
+                              sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return;
+    }
+    gpuTimes_.clear();
+    auto& profiler = aurora::Profiler::get();
+    const uint64_t frameBegin = ticks[0] & vk_->timestampMask;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint64_t begin = ticks[i * 2] & vk_->timestampMask;
+        const uint64_t end = ticks[i * 2 + 1] & vk_->timestampMask;
+        if (end < begin || begin < frameBegin) continue;
+        PassStats g;
+        g.name = ts.names[i];
+        g.gpuMs = static_cast<double>(end - begin) * vk_->timestampPeriodNs / 1e6;
+        gpuTimes_.push_back(g);
+        // Same anchoring as GpuProfiler: CPU recording time, exact durations
+        if (ts.submitUs) {
+            const double offsetUs = static_cast<double>(begin - frameBegin) * vk_->timestampPeriodNs / 1000.0;
+            profiler.recordGpu(ts.names[i], ts.submitUs + static_cast<uint64_t>(offsetUs),
+                               static_cast<uint64_t>(g.gpuMs * 1000.0));
+        }
+    }
+}
+
+void RenderGraph::releaseFramebuffers() {
+    if (framebuffers_.empty()) return;
+    Retired r;
+    r.retiredAtFrame = vk_->frameNumber;
+    for (const FramebufferEntry& e : framebuffers_) r.framebuffers.push_back(e.framebuffer);
+    framebuffers_.clear();
+    retired_.push_back(std::move(r));
+}
+
+void RenderGraph::retireTransients() {
+    // Framebuffers may reference the transient views
+    releaseFramebuffers();
+    if (transients_.empty() && slots_.empty()) return;
+    Retired r;
+    r.retiredAtFrame = vk_->frameNumber;
+    r.transients = std::move(transients_);
+    for (MemorySlot& s : slots_) r.memory.push_back(s.alloc);
+    transients_.clear();
+    slots_.clear();
+    slotUse_.clear();
+    retired_.push_back(std::move(r));
+}
+
+void RenderGraph::destroyRetired(bool force) {
+    // Same rule as retired swapchains: maxFramesInFlight newer frames have waited their fences
+    for (size_t i = 0; i < retired_.size();) {
+        Retired& r = retired_[i];
+        if (!force && vk_->frameNumber < r.retiredAtFrame + vk_->maxFramesInFlight) {
+            ++i;
+            continue;
+        }
+        for (VkFramebuffer fb : r.framebuffers) vkDestroyFramebuffer(vk_->device, fb, nullptr);
+        for (Transient& t : r.transients) {
+            if (t.view) vkDestroyImageView(vk_->device, t.view, nullptr);
+            if (t.image) vkDestroyImage(vk_->device, t.image, nullptr);
+        }
+        for (Allocation& a : r.memory) vk_->allocator->free(a);
+        retired_.erase(retired_.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "vulkan/MemoryAllocator.h"
+#include "vulkan/RenderGraphPlan.h"
+
+struct VkObjects;
+
+namespace vulkan {
+// Frame graph. Every frame the renderer declares its passes in execution order, each with
+// the resources it reads and writes, then compile() and execute():
+//  - passes that contribute nothing to an output (an imported resource with a final state)
+//    and have no side effects are culled;
+//  - pipeline barriers and image layout transitions are derived from the declared usages
+//    (read-after-read needs none) and batched into one vkCmdPipelineBarrier per pass;
+//  - graphics passes get a VkRenderPass and VkFramebuffer over their attachments (both
+//    cached); attachments not needed afterwards are not stored;
+//  - transient images (createImage) live from their first to their last pass. Images whose
+//    lifetimes do not overlap share one memory range (aliasing). Allocations are kept while
+//    the set of transients stays the same.
+// The decisions above are made by RenderGraphPlan, which needs no device; this class creates
+// the images, memory, render passes and framebuffers they call for and records the commands.
+// Per-pass CPU recording time and GPU time (timestamps, read back after the frame slot's
+// fence) are reported in stats(). Passes may still record their own barriers for resources
+// they do not declare (e.g. the upload batch). Used from the thread that renders.
+class RenderGraph {
+public:
+    using Resource = RenderGraphPlan::Resource;
+    using PassType = RenderGraphPlan::PassType;
+    using Usage = RenderGraphPlan::Usage;
+    static constexpr uint32_t kMaxPasses = 16;
+
+    struct ImageDesc {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent{};
+        VkImageUsageFlags extraUsage = 0; // beyond what the declared usages imply
+    };
+
+    struct PassContext {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        uint32_t frameIndex = 0;
+        // Graphics passes: the render pass begun for this pass, and its framebuffer
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkExtent2D extent{};
+    };
+    using ExecuteFn = std::function<void(const PassContext&)>;
+
+    class PassBuilder {
+    public:
+        PassBuilder& read(Resource r, Usage usage);
+        PassBuilder& write(Resource r, Usage usage);
+        // Color / depth attachment cleared at the start of the render pass
+        PassBuilder& clearColor(Resource r, const VkClearColorValue& value);
+        PassBuilder& clearDepth(Resource r, float depth);
+        // Never culled (e.g. uploads whose consumers are not declared)
+        PassBuilder& sideEffect();
+        // Graphics: the pass body only executes secondary command buffers
+        PassBuilder& secondaryCommandBuffers(bool enabled = true);
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, uint32_t pass) : graph_(graph), pass_(pass) {}
+        RenderGraph& graph_;
+        uint32_t pass_;
+    };
+
+    struct PassStats {
+        const char* name = "";
+        double cpuMs = 0.0; // recording, barriers included
+        double gpuMs = 0.0; // of the last completed execution of this pass (lags the frame)
+    };
+    struct Stats {
+        std::vector<PassStats> passes; // executed passes of the last frame, in order
+        uint32_t culledPasses = 0;
+        uint32_t barrierBatches = 0;   // vkCmdPipelineBarrier calls
+        uint32_t imageBarriers = 0;
+        uint32_t bufferBarriers = 0;
+        VkDeviceSize transientBytes = 0;      // memory bound for transient images
+        VkDeviceSize transientBytesSaved = 0; // versus one allocation per transient image
+    };
+
+    RenderGraph(VkObjects* vk, uint32_t frameCount);
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // After the frame's fence wait: GPU times of that slot's previous frame, retired objects
+    void beginFrame(uint32_t frameIndex);
+
+    // --- Declaration (each frame, in execution order). Names must outlive the graph.
+    // Contents before the graph are assumed synchronized up to initialStages (e.g. the
+    // acquire semaphore's wait stage). finalLayout != UNDEFINED makes the image an output
+    // and transitions it there at the end.
+    Resource importImage(const char* name, VkImage image, VkImageView view, VkFormat format, VkExtent2D extent,
+                         VkImageLayout initialLayout, VkImageLayout finalLayout,
+                         VkPipelineStageFlags initialStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    // finalStages/finalAccess != 0 make the buffer an output, made available to them at the end
+    // (e.g. HOST / HOST_READ for a readback)
+    Resource importBuffer(const char* name, VkBuffer buffer, VkPipelineStageFlags finalStages = 0,
+                          VkAccessFlags finalAccess = 0);
+    Resource createImage(const char* name, const ImageDesc& desc);
+    PassBuilder addPass(const char* name, PassType type, ExecuteFn execute);
+
+    // Culling, barriers, render passes, transient allocation
+    void compile();
+    // Records the compiled frame into cmd (outside any render pass) and resets the declaration
+    void execute(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    // Swapchain image views changed: drop cached framebuffers once no frame uses them
+    void releaseFramebuffers();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    // Vulkan side of a declared pass; the declaration itself lives in plan_
+    struct Pass {
+        ExecuteFn execute;
+        bool secondaries = false;
+        std::vector<VkClearValue> accessClears; // per declared access
+        // compile()
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        VkPipelineStageFlags srcStages = 0, dstStages = 0;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkExtent2D extent{};
+        std::vector<VkClearValue> clearValues;
+    };
+    // Vulkan side of a declared resource (transients get their image in compile())
+    struct ResourceInfo {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent{};
+    };
+    // Transient image kept across frames; slot = shared memory range
+    struct Transient {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent{};
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = 0, lastPass = 0;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkMemoryRequirements requirements{};
+        uint32_t slot = 0;
+    };
+    struct MemorySlot {
+        Allocation alloc;
+        VkDeviceSize size = 0;
+    };
+    struct RenderPassEntry {
+        std::vector<VkAttachmentDescription> attachments;
+        uint32_t colorCount = 0;
+        bool depth = false;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+    };
+    struct FramebufferEntry {
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        std::vector<VkImageView> views;
+        VkExtent2D extent{};
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    };
+    struct Retired {
+        std::vector<VkFramebuffer> framebuffers;
+        std::vector<Transient> transients;
+        std::vector<Allocation> memory;
+        uint64_t retiredAtFrame = 0;
+    };
+    struct TimestampSlot {
+        std::vector<const char*> names; // executed passes, query pair i
+        std::vector<double> cpuMs;
+        bool pending = false;
+        uint64_t submitUs = 0; // profiler time at recording, anchors the GPU zones
+    };
+
+    void allocateTransients();
+    void translateBarriers(const RenderGraphPlan::PassPlan& plan, Pass& pass);
+    void buildRenderPass(uint32_t index);
+    VkRenderPass getRenderPass(const RenderPassEntry& key);
+    VkFramebuffer getFramebuffer(VkRenderPass renderPass, const std::vector<VkImageView>& views, VkExtent2D extent);
+    void retireTransients();
+    void destroyRetired(bool force);
+    void recordPass(const Pass& pass, const char* name, const PassContext& ctx, uint32_t executedIndex);
+
+    VkObjects* vk_ = nullptr;
+    RenderGraphPlan plan_;
+    std::vector<Pass> passes_;            // parallel to plan_'s passes
+    std::vector<ResourceInfo> resources_; // parallel to plan_'s resources
+    Pass final_;                          // outputs' final transitions, after the last pass
+    std::vector<Transient> transients_;
+    std::vector<MemorySlot> slots_;
+    std::vector<RenderGraphPlan::SlotUse> slotUse_; // parallel to slots_
+    std::vector<RenderPassEntry> renderPasses_;
+    std::vector<FramebufferEntry> framebuffers_;
+    std::vector<Retired> retired_;
+    VkQueryPool queryPool_ = VK_NULL_HANDLE;
+    std::vector<TimestampSlot> timestampSlots_;
+    std::vector<PassStats> gpuTimes_; // last collected, matched to passes by name
+    bool compiled_ = false;
+    Stats stats_;
+};
+}
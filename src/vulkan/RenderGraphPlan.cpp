@@ -0,0 +1,282 @@
+#include "vulkan/RenderGraphPlan.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace vulkan {
+
+namespace {
+bool overlaps(uint32_t aFirst, uint32_t aLast, uint32_t bFirst, uint32_t bLast) {
+    return aFirst <= bLast && bFirst <= aLast;
+}
+}
+
+RenderGraphPlan::UsageInfo RenderGraphPlan::usageInfo(Usage usage) {
+    using U = Usage;
+    switch (usage) {
+    case U::ColorAttachment:
+        return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+    case U::DepthAttachment:
+        return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+    case U::SampledFragment:
+        return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+    case U::StorageReadCompute:
+        return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+    case U::StorageWriteCompute:
+        return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+    case U::StorageReadVertex:
+        return {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+    case U::VertexInput:
+        return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0};
+    case U::IndirectRead:
+        return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0};
+    case U::TransferRead:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+    case U::TransferWrite:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+    }
+    return {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT, VK_ACCESS_MEMORY_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, 0};
+}
+
+RenderGraphPlan::Resource RenderGraphPlan::addResource(const ResourceDecl& resource) {
+    resources_.push_back(resource);
+    return static_cast<Resource>(resources_.size() - 1);
+}
+
+uint32_t RenderGraphPlan::addPass(const char* name, PassType type) {
+    PassDecl p;
+    p.name = name;
+    p.type = type;
+    passes_.push_back(std::move(p));
+    return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+void RenderGraphPlan::reset() {
+    passes_.clear();
+    resources_.clear();
+    passPlans_.clear();
+    resourcePlans_.clear();
+    transients_.clear();
+    final_ = {};
+    culledPasses_ = 0;
+}
+
+// A pass runs if it has side effects or writes something a later running pass (or the
+// frame's output) needs. A clear discards earlier contents, so it ends the need for earlier
+// writers; any other write keeps them (loads, atomics, partial writes).
+void RenderGraphPlan::cull() {
+    for (const PassDecl& p : passes_) {
+        for (const Access& a : p.accesses) {
+            if (a.resource >= resources_.size()) throw std::runtime_error(std::string("RenderGraph: pass ") + p.name + " uses an undeclared resource");
+        }
+    }
+    passPlans_.assign(passes_.size(), {});
+    resourcePlans_.assign(resources_.size(), {});
+    std::vector<uint8_t> needed(resources_.size(), 0);
+    for (size_t i = 0; i < resources_.size(); ++i) {
+        const ResourceDecl& r = resources_[i];
+        ResourcePlan& rp = resourcePlans_[i];
+        rp.output = (r.isImage && !r.transient && r.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED) || r.finalStages != 0;
+        rp.usage = r.extraUsage;
+        needed[i] = rp.output;
+    }
+    culledPasses_ = 0;
+    for (size_t i = passes_.size(); i-- > 0;) {
+        const PassDecl& p = passes_[i];
+        bool need = p.sideEffect;
+        for (const Access& a : p.accesses) need = need || (a.write && needed[a.resource]);
+        passPlans_[i].culled = !need;
+        if (!need) {
+            ++culledPasses_;
+            continue;
+        }
+        for (const Access& a : p.accesses) {
+            if (a.write && a.clear) needed[a.resource] = 0;
+        }
+        for (const Access& a : p.accesses) {
+            if (!a.write || !a.clear) needed[a.resource] = 1;
+        }
+    }
+    for (uint32_t i = 0; i < passes_.size(); ++i) {
+        if (passPlans_[i].culled) continue;
+        for (const Access& a : passes_[i].accesses) {
+            ResourcePlan& r = resourcePlans_[a.resource];
+            r.firstPass = std::min(r.firstPass, i);
+            r.lastPass = std::max(r.lastPass, i);
+            r.usage |= usageInfo(a.usage).imageUsage;
+        }
+    }
+    transients_.clear();
+    for (uint32_t i = 0; i < resources_.size(); ++i) {
+        ResourcePlan& r = resourcePlans_[i];
+        if (!resources_[i].transient || r.firstPass == UINT32_MAX) continue;
+        r.transient = static_cast<uint32_t>(transients_.size());
+        transients_.push_back({i, r.firstPass, r.lastPass});
+    }
+}
+
+std::vector<uint32_t> RenderGraphPlan::assignSlots(const std::vector<Lifetime>& lifetimes,
+                                                   const std::vector<VkMemoryRequirements>& requirements,
+                                                   std::vector<VkMemoryRequirements>& slotRequirements) {
+    std::vector<uint32_t> order(lifetimes.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return requirements[a].size > requirements[b].size;
+    });
+    std::vector<uint32_t> slotOf(lifetimes.size(), 0);
+    std::vector<std::vector<uint32_t>> occupants;
+    slotRequirements.clear();
+    for (uint32_t i : order) {
+        const Lifetime& t = lifetimes[i];
+        const VkMemoryRequirements& req = requirements[i];
+        uint32_t slot = 0;
+        for (; slot < slotRequirements.size(); ++slot) {
+            if (!(slotRequirements[slot].memoryTypeBits & req.memoryTypeBits)) continue;
+            bool free = true;
+            for (uint32_t o : occupants[slot]) {
+                free = free && !overlaps(t.firstPass, t.lastPass, lifetimes[o].firstPass, lifetimes[o].lastPass);
+            }
+            if (free) break;
+        }
+        if (slot == slotRequirements.size()) {
+            slotRequirements.push_back(req);
+            occupants.emplace_back();
+        }
+        VkMemoryRequirements& s = slotRequirements[slot];
+        s.size = std::max(s.size, req.size);
+        s.alignment = std::max(s.alignment, req.alignment);
+        s.memoryTypeBits &= req.memoryTypeBits;
+        occupants[slot].push_back(i);
+        slotOf[i] = slot;
+    }
+    return slotOf;
+}
+
+// Walks the running passes in order, tracking each resource's last write and the reads that
+// already waited for it. A barrier is added only for a layout change, a write after any
+// access, or a read in stages/access types not yet synchronized with the last write; a
+// resource gets at most one per pass.
+void RenderGraphPlan::buildBarriers(const std::vector<uint32_t>& slotOf, std::vector<SlotUse>& slotUse) {
+    auto addBarrier = [&](PassPlan& p, Resource resource, VkPipelineStageFlags srcStages, VkAccessFlags srcAccess,
+                          VkPipelineStageFlags dstStages, VkAccessFlags dstAccess, VkImageLayout oldLayout,
+                          VkImageLayout newLayout) {
+        p.srcStages |= srcStages ? srcStages : VkPipelineStageFlags(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        p.dstStages |= dstStages;
+        const bool isImage = resources_[resource].isImage;
+        if ((isImage && (oldLayout != newLayout || srcAccess)) || (!isImage && srcAccess)) {
+            // A second access to the resource in the same pass widens its barrier
+            for (Barrier& b : p.barriers) {
+                if (b.resource == resource && b.oldLayout == oldLayout && b.newLayout == newLayout) {
+                    b.srcAccess |= srcAccess;
+                    b.dstAccess |= dstAccess;
+                    return;
+                }
+            }
+            p.barriers.push_back({resource, srcAccess, dstAccess, oldLayout, newLayout});
+        }
+        // else: execution dependency only, carried by the stage masks
+    };
+
+    std::vector<State> states(resources_.size());
+    for (size_t i = 0; i < resources_.size(); ++i) {
+        states[i].layout = resources_[i].initialLayout;
+        states[i].writeStages = resources_[i].initialStages;
+    }
+    for (uint32_t i = 0; i < passes_.size(); ++i) {
+        PassPlan& p = passPlans_[i];
+        if (p.culled) continue;
+        // Transients start undefined, after the last use of their memory (previous frame or
+        // the image aliased before them)
+        for (const Access& a : passes_[i].accesses) {
+            const ResourcePlan& r = resourcePlans_[a.resource];
+            if (r.transient == UINT32_MAX || r.firstPass != i) continue;
+            const SlotUse& slot = slotUse[slotOf[r.transient]];
+            states[a.resource] = {};
+            states[a.resource].writeStages = slot.lastStages;
+            states[a.resource].writeAccess = slot.lastWriteAccess;
+        }
+        if (passes_[i].type == PassType::Graphics) planAttachments(i, states);
+
+        for (const Access& a : passes_[i].accesses) {
+            const bool isImage = resources_[a.resource].isImage;
+            State& s = states[a.resource];
+            const UsageInfo u = usageInfo(a.usage);
+            const VkAccessFlags dstAccess = u.read | (a.write ? u.write : 0);
+            const bool layoutChange = isImage && s.layout != u.layout;
+            if (layoutChange || a.write) {
+                const VkPipelineStageFlags src = s.writeStages | s.readStages;
+                if (layoutChange || src) {
+                    const VkImageLayout oldLayout = a.clear ? VK_IMAGE_LAYOUT_UNDEFINED : s.layout;
+                    addBarrier(p, a.resource, src, s.writeAccess, u.stages, dstAccess, oldLayout, isImage ? u.layout : oldLayout);
+                }
+                if (isImage) s.layout = u.layout;
+                s.writeStages = u.stages;
+                s.writeAccess = a.write ? u.write : 0;
+                s.readStages = a.write ? 0 : u.stages;
+                s.readAccess = a.write ? 0 : u.read;
+            } else {
+                if (s.writeStages && ((s.readStages & u.stages) != u.stages || (s.readAccess & u.read) != u.read)) {
+                    addBarrier(p, a.resource, s.writeStages, s.writeAccess, u.stages, u.read, s.layout, s.layout);
+                }
+                s.readStages |= u.stages;
+                s.readAccess |= u.read;
+            }
+            const uint32_t t = resourcePlans_[a.resource].transient;
+            if (t != UINT32_MAX) {
+                SlotUse& slot = slotUse[slotOf[t]];
+                slot.lastStages = s.writeStages | s.readStages;
+                slot.lastWriteAccess = s.writeAccess;
+            }
+        }
+    }
+
+    // Outputs end in their final state
+    final_ = {};
+    for (uint32_t i = 0; i < resources_.size(); ++i) {
+        const ResourceDecl& r = resources_[i];
+        if (!resourcePlans_[i].output || resourcePlans_[i].firstPass == UINT32_MAX) continue;
+        const State& s = states[i];
+        if (r.isImage && s.layout != r.finalLayout) {
+            addBarrier(final_, i, s.writeStages | s.readStages, s.writeAccess, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                       s.layout, r.finalLayout);
+        } else if (!r.isImage && s.writeAccess) {
+            addBarrier(final_, i, s.writeStages, s.writeAccess, r.finalStages, r.finalAccess, s.layout, s.layout);
+        }
+    }
+}
+
+// Called before the pass's accesses update the states: an attachment is loaded only if it has
+// contents and is not cleared, and stored only if someone uses it afterwards
+void RenderGraphPlan::planAttachments(uint32_t passIndex, const std::vector<State>& states) {
+    const PassDecl& pass = passes_[passIndex];
+    PassPlan& plan = passPlans_[passIndex];
+    uint32_t depthCount = 0;
+    for (int depthPass = 0; depthPass < 2; ++depthPass) {
+        for (uint32_t i = 0; i < pass.accesses.size(); ++i) {
+            const Access& a = pass.accesses[i];
+            const bool isColor = a.usage == Usage::ColorAttachment;
+            const bool isDepth = a.usage == Usage::DepthAttachment;
+            if ((depthPass == 0 && !isColor) || (depthPass == 1 && !isDepth)) continue;
+            const ResourcePlan& r = resourcePlans_[a.resource];
+            Attachment att;
+            att.resource = a.resource;
+            att.usage = a.usage;
+            att.access = i;
+            att.load = !a.clear && states[a.resource].layout != VK_IMAGE_LAYOUT_UNDEFINED;
+            att.store = r.output || r.lastPass > passIndex;
+            plan.attachments.push_back(att);
+            depthCount += isDepth ? 1 : 0;
+        }
+    }
+    if (depthCount > 1) throw std::runtime_error(std::string("RenderGraph: pass ") + pass.name + " has more than one depth attachment");
+}
+
+}
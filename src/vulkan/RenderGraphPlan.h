@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace vulkan {
+// The device-independent half of RenderGraph::compile(). From the declared passes and
+// resources it works out which passes run, each resource's lifetime, which transient images
+// can share memory, the barriers and layout transitions before each pass, and whether
+// attachments are loaded and stored. It uses Vulkan's flag and layout types but creates no
+// objects and records no commands, so it runs without a device; RenderGraph turns the result
+// into images, render passes and vkCmd* calls.
+//
+// Per frame: declare with addResource/addPass, then cull(), assignSlots() for the transients,
+// buildBarriers(); reset() before the next frame's declarations.
+class RenderGraphPlan {
+public:
+    using Resource = uint32_t;
+
+    enum class PassType : uint8_t { Graphics, Compute, Transfer };
+
+    // How a pass touches a resource: selects stages, access mask and image layout
+    enum class Usage : uint8_t {
+        ColorAttachment,    // write
+        DepthAttachment,    // write (depth test reads too)
+        SampledFragment,    // read: sampled image in the fragment shader
+        StorageReadCompute,
+        StorageWriteCompute, // includes atomics (read-modify-write)
+        StorageReadVertex,
+        VertexInput,        // read: vertex or instance buffer
+        IndirectRead,       // read: indirect draw arguments / count
+        TransferRead,
+        TransferWrite,
+    };
+
+    struct UsageInfo {
+        VkPipelineStageFlags stages;
+        VkAccessFlags read;
+        VkAccessFlags write;
+        VkImageLayout layout;
+        VkImageUsageFlags imageUsage;
+    };
+    static UsageInfo usageInfo(Usage usage);
+
+    struct Access {
+        Resource resource = 0;
+        Usage usage = Usage::TransferRead;
+        bool write = false;
+        bool clear = false; // write that discards the previous contents
+    };
+    struct PassDecl {
+        const char* name = "";
+        PassType type = PassType::Compute;
+        std::vector<Access> accesses;
+        bool sideEffect = false; // never culled
+    };
+    // Contents before the graph are synchronized up to initialStages. An image with a
+    // finalLayout, or a buffer with finalStages, is an output: it keeps its writers alive and
+    // ends the frame in that state.
+    struct ResourceDecl {
+        const char* name = "";
+        bool isImage = false;
+        bool transient = false; // image created by the graph, contents undefined at first use
+        VkImageUsageFlags extraUsage = 0;
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags initialStages = 0;
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags finalStages = 0;
+        VkAccessFlags finalAccess = 0;
+    };
+
+    // A memory dependency or layout transition on one resource. Dependencies that only order
+    // execution have no entry; the pass's stage masks carry them.
+    struct Barrier {
+        Resource resource = 0;
+        VkAccessFlags srcAccess = 0;
+        VkAccessFlags dstAccess = 0;
+        VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+    // Graphics pass attachment: colour attachments in declaration order, then the depth one
+    struct Attachment {
+        Resource resource = 0;
+        Usage usage = Usage::ColorAttachment;
+        uint32_t access = 0; // index into the pass's accesses
+        bool load = false;   // has contents and is not cleared
+        bool store = false;  // used by a later pass or an output
+    };
+    struct PassPlan {
+        bool culled = false;
+        // One vkCmdPipelineBarrier before the pass when srcStages != 0
+        VkPipelineStageFlags srcStages = 0, dstStages = 0;
+        std::vector<Barrier> barriers;
+        std::vector<Attachment> attachments;
+    };
+    struct ResourcePlan {
+        bool output = false;
+        uint32_t firstPass = UINT32_MAX, lastPass = 0; // running passes using it; UINT32_MAX: none
+        VkImageUsageFlags usage = 0;                    // extraUsage plus what the usages imply
+        uint32_t transient = UINT32_MAX;                // index into transients()
+    };
+    // A transient image used by a running pass, in declaration order
+    struct Lifetime {
+        Resource resource = 0;
+        uint32_t firstPass = 0, lastPass = 0;
+    };
+    // Last use of a memory slot, carried to its next occupant (an aliased image later in the
+    // frame, or the next frame's)
+    struct SlotUse {
+        VkPipelineStageFlags lastStages = 0;
+        VkAccessFlags lastWriteAccess = 0;
+    };
+
+    // --- Declaration
+    Resource addResource(const ResourceDecl& resource);
+    uint32_t addPass(const char* name, PassType type);
+    PassDecl& pass(uint32_t index) { return passes_[index]; }
+    const std::vector<PassDecl>& declaredPasses() const { return passes_; }
+    const std::vector<ResourceDecl>& declaredResources() const { return resources_; }
+    void reset();
+
+    // --- Planning
+    // Backwards from the outputs: marks the passes that contribute nothing as culled and
+    // computes each resource's lifetime over the running passes. Throws when a pass uses an
+    // undeclared resource.
+    void cull();
+    // Images sorted by size (largest first) go into the first slot whose memory types fit and
+    // whose occupants' lifetimes do not overlap theirs. requirements[i] belongs to
+    // lifetimes[i]; returns each image's slot and sets each slot's combined requirements.
+    static std::vector<uint32_t> assignSlots(const std::vector<Lifetime>& lifetimes,
+                                             const std::vector<VkMemoryRequirements>& requirements,
+                                             std::vector<VkMemoryRequirements>& slotRequirements);
+    // After cull(): barriers and attachment load/store for every running pass, then the final
+    // transitions of the outputs. slotOf[t] is the memory slot of transients()[t]; slotUse is
+    // read for each transient's first use and updated with its last.
+    void buildBarriers(const std::vector<uint32_t>& slotOf, std::vector<SlotUse>& slotUse);
+
+    const std::vector<PassPlan>& passes() const { return passPlans_; }
+    const std::vector<ResourcePlan>& resources() const { return resourcePlans_; }
+    const std::vector<Lifetime>& transients() const { return transients_; }
+    // Barriers recorded after the last pass (outputs to their final state)
+    const PassPlan& finalTransitions() const { return final_; }
+    uint32_t culledPasses() const { return culledPasses_; }
+    uint32_t executedPasses() const { return static_cast<uint32_t>(passes_.size()) - culledPasses_; }
+
+private:
+    // Synchronization state of a resource while building barriers
+    struct State {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0; // last write (or layout transition)
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;  // reads since then that already waited for it
+        VkAccessFlags readAccess = 0;
+    };
+
+    void planAttachments(uint32_t passIndex, const std::vector<State>& states);
+
+    std::vector<PassDecl> passes_;
+    std::vector<ResourceDecl> resources_;
+    std::vector<PassPlan> passPlans_;
+    std::vector<ResourcePlan> resourcePlans_;
+    std::vector<Lifetime> transients_;
+    PassPlan final_;
+    uint32_t culledPasses_ = 0;
+};
+}
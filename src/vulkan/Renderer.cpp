@@ -7,14 +7,62 @@
 #include <vector>
 #include <string>
 #include <iostream>
-#include <filesystem>
+#include <chrono>
+#include <cstring>
 
 #include "vulkan/Utils.h"
 #include "vulkan/Swapchain.h"
+#include "vulkan/GpuProfiler.h"
+#include "vulkan/PipelineCache.h"
+#include "vulkan/UploadManager.h"
+#include "vulkan/FrameAllocator.h"
+#include "vulkan/CommandRecorder.h"
+#include "vulkan/ObjectBuffer.h"
+#include "vulkan/GpuDrivenPass.h"
+#include "vulkan/RenderGraph.h"
+#include "vulkan/DescriptorAllocator.h"
+#include "vulkan/BindlessTable.h"
+#include "vulkan/PipelineStateCache.h"
+#include "vulkan/MaterialTable.h"
+#include "render/ShaderVariant.h"
+#include "io/FileSystem.h"
+#include <aurora/Profiler.h>
+
+namespace {
+using FrameClock = std::chrono::steady_clock;
+double msSince(FrameClock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(FrameClock::now() - t0).count();
+}
+
+// Times one drawFrame stage into RenderTimings and a profiler zone
+class StageTimer {
+public:
+    StageTimer(const char* name, double& outMs) : zone_(name), outMs_(outMs), t0_(FrameClock::now()) {}
+    ~StageTimer() { outMs_ = msSince(t0_); }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+private:
+    aurora::ScopedZone zone_;
+    double& outMs_;
+    FrameClock::time_point t0_;
+};
+
+VkFormat pickDepthFormat(VkPhysicalDevice physicalDevice) {
+    for (VkFormat f : {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT}) {
+        VkFormatProperties props{};
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, f, &props);
+        if (props.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) return f;
+    }
+    throw std::runtime_error("No supported depth attachment format");
+}
+}
 
 namespace vulkan {
 
+// Pipelines and secondary command buffers are built against this render pass; the render
+// graph begins its own, compatible one (same attachment formats) for the main pass
 void Renderer::createRenderPass(VkObjects* vk) {
+    if (vk->depthFormat == VK_FORMAT_UNDEFINED) vk->depthFormat = pickDepthFormat(vk->physicalDevice);
     VkAttachmentDescription colorAttachment{};
     colorAttachment.format = vk->swapchainImageFormat;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -23,126 +71,157 @@ void Renderer::createRenderPass(VkObjects* vk) {
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Headless targets are never presented; leave them ready for readback instead
+    colorAttachment.finalLayout = vk->headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = vk->depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
 
+    VkAttachmentDescription attachments[] = {colorAttachment, depthAttachment};
     VkRenderPassCreateInfo rpci{VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
-    rpci.attachmentCount = 1;
-    rpci.pAttachments = &colorAttachment;
+    rpci.attachmentCount = 2;
+    rpci.pAttachments = attachments;
     rpci.subpassCount = 1;
     rpci.pSubpasses = &subpass;
 
     if (vkCreateRenderPass(vk->device, &rpci, nullptr, &vk->renderPass) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create render pass");
     }
+    vk->renderPassFormat = colorAttachment.format;
 }
 
 void Renderer::createGraphicsPipeline(VkObjects* vk) {
-    auto findShader = [](const std::string& name) {
-        std::vector<std::string> candidates = {
-            std::string("build/shaders/") + name,
-            std::string("shaders/") + name,
-            std::string("../build/shaders/") + name,
-            std::string("../shaders/") + name
-        };
-        for (const auto &c : candidates) {
-            if (std::filesystem::exists(c)) return c;
-        }
-        return std::string();
-    };
+    AURORA_PROFILE_ZONE("Renderer::createGraphicsPipeline");
+    VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = render::kMeshPushStages;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(render::MeshPushConstants);
+    // Set 0: object matrices; set 1: the bindless table when enabled
+    VkDescriptorSetLayout setLayouts[2] = {vk->objects->setLayout(), VK_NULL_HANDLE};
+    plci.setLayoutCount = 1;
+    if (vk->bindlessTable) {
+        setLayouts[1] = vk->bindlessTable->setLayout();
+        plci.setLayoutCount = 2;
+    }
+    plci.pSetLayouts = setLayouts;
+    plci.pushConstantRangeCount = 1;
+    plci.pPushConstantRanges = &pushRange;
+    if (vkCreatePipelineLayout(vk->device, &plci, nullptr, &vk->pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout");
+    }
+    vk->materials->requestPipelines();
+}
 
-    std::string vertPath = findShader("triangle.vert.spv");
-    std::string fragPath = findShader("triangle.frag.spv");
-    if (vertPath.empty() || fragPath.empty()) {
-        throw std::runtime_error("Failed to find triangle shader SPIR-V files in expected locations");
+VkPipeline Renderer::createMeshPipeline(VkObjects* vk, const GraphicsPipelineDesc& desc) {
+    // Served from the mounted pack, or loose build/shaders during development
+    io::FileData vertCode = vk->files->read(desc.vertexShader);
+    io::FileData fragCode = vk->files->read(desc.fragmentShader);
+
+    VkShaderModule vertModule = vkutils::createShaderModule(vk->device, vertCode.data(), vertCode.size());
+    VkShaderModule fragModule = VK_NULL_HANDLE;
+    try {
+        fragModule = vkutils::createShaderModule(vk->device, fragCode.data(), fragCode.size());
+    } catch (...) {
+        vkDestroyShaderModule(vk->device, vertModule, nullptr);
+        throw;
     }
-    auto vertCode = vkutils::readFile(vertPath);
-    auto fragCode = vkutils::readFile(fragPath);
 
-    VkShaderModule vertModule = vkutils::createShaderModule(vk->device, vertCode);
-    VkShaderModule fragModule = vkutils::createShaderModule(vk->device, fragCode);
+    // Material features and vertex encoding: code depending on them is folded at creation
+    const VkSpecializationInfo specialization = render::specializationInfo(desc.constants);
 
     VkPipelineShaderStageCreateInfo vertStage{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
     vertStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
     vertStage.module = vertModule;
     vertStage.pName = "main";
+    vertStage.pSpecializationInfo = &specialization;
 
     VkPipelineShaderStageCreateInfo fragStage{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
     fragStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     fragStage.module = fragModule;
     fragStage.pName = "main";
+    fragStage.pSpecializationInfo = &specialization;
 
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertStage, fragStage };
 
-    // Vertex input (position + color)
-    VkVertexInputBindingDescription binding{}; binding.binding = 0; binding.stride = sizeof(float)*5; binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-    VkVertexInputAttributeDescription attrs[2]{};
-    attrs[0].binding = 0; attrs[0].location = 0; attrs[0].format = VK_FORMAT_R32G32_SFLOAT; attrs[0].offset = 0; // pos
-    attrs[1].binding = 0; attrs[1].location = 1; attrs[1].format = VK_FORMAT_R32G32B32_SFLOAT; attrs[1].offset = sizeof(float)*2; // color
+    // Vertex input (position + normal + color) in the configured encoding; meshes must be
+    // uploaded with the same render::VertexFormat. Placement comes per instance.
+    render::VertexInputLayout inputLayout = render::vertexInputLayout(desc.vertexFormat);
     VkPipelineVertexInputStateCreateInfo vertexInput{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-    vertexInput.vertexBindingDescriptionCount = 1;
-    vertexInput.pVertexBindingDescriptions = &binding;
-    vertexInput.vertexAttributeDescriptionCount = 2;
-    vertexInput.pVertexAttributeDescriptions = attrs;
+    vertexInput.vertexBindingDescriptionCount = inputLayout.bindingCount;
+    vertexInput.pVertexBindingDescriptions = inputLayout.bindings.data();
+    vertexInput.vertexAttributeDescriptionCount = inputLayout.attributeCount;
+    vertexInput.pVertexAttributeDescriptions = inputLayout.attributes.data();
 
     VkPipelineInputAssemblyStateCreateInfo inputAsm{VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
-    inputAsm.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAsm.topology = desc.topology;
     inputAsm.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)vk->swapchainExtent.width;
-    viewport.height = (float)vk->swapchainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = {0,0};
-    scissor.extent = vk->swapchainExtent;
-
+    // Viewport and scissor are dynamic so a resize does not invalidate the pipeline;
+    // recordCommandBuffer sets them from the current swapchain extent
     VkPipelineViewportStateCreateInfo viewportState{VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState{VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
 
     VkPipelineRasterizationStateCreateInfo raster{VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
     raster.depthClampEnable = VK_FALSE;
     raster.rasterizerDiscardEnable = VK_FALSE;
-    raster.polygonMode = VK_POLYGON_MODE_FILL;
+    raster.polygonMode = desc.polygonMode;
     raster.lineWidth = 1.0f;
-    raster.cullMode = VK_CULL_MODE_BACK_BIT;
-    raster.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    raster.cullMode = desc.cullMode;
+    raster.frontFace = desc.frontFace;
     raster.depthBiasEnable = VK_FALSE;
 
     VkPipelineMultisampleStateCreateInfo multisample{VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
     multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+    // Draws are sorted front to back, so the depth test rejects most hidden fragments early
+    VkPipelineDepthStencilStateCreateInfo depthStencil{VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO};
+    depthStencil.depthTestEnable = desc.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = desc.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = desc.depthCompare;
+
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
+    colorBlendAttachment.blendEnable = desc.alphaBlend ? VK_TRUE : VK_FALSE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
 
     VkPipelineColorBlendStateCreateInfo colorBlend{VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
     colorBlend.logicOpEnable = VK_FALSE;
     colorBlend.attachmentCount = 1;
     colorBlend.pAttachments = &colorBlendAttachment;
 
-    VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    plci.setLayoutCount = 0;
-    plci.pushConstantRangeCount = 0;
-    if (vkCreatePipelineLayout(vk->device, &plci, nullptr, &vk->pipelineLayout) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create pipeline layout");
-    }
-
     VkGraphicsPipelineCreateInfo pci{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
     pci.stageCount = 2;
     pci.pStages = shaderStages;
@@ -151,17 +230,19 @@ void Renderer::createGraphicsPipeline(VkObjects* vk) {
     pci.pViewportState = &viewportState;
     pci.pRasterizationState = &raster;
     pci.pMultisampleState = &multisample;
+    pci.pDepthStencilState = &depthStencil;
     pci.pColorBlendState = &colorBlend;
-    pci.layout = vk->pipelineLayout;
-    pci.renderPass = vk->renderPass;
+    pci.pDynamicState = &dynamicState;
+    pci.layout = desc.layout;
+    pci.renderPass = desc.renderPass;
     pci.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(vk->device, VK_NULL_HANDLE, 1, &pci, nullptr, &vk->graphicsPipeline) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create graphics pipeline");
-    }
-
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult res = PipelineCache::createGraphicsPipeline(vk, pci, &pipeline);
     vkDestroyShaderModule(vk->device, fragModule, nullptr);
     vkDestroyShaderModule(vk->device, vertModule, nullptr);
+    if (res != VK_SUCCESS) throw std::runtime_error("Failed to create graphics pipeline for " + desc.vertexShader);
+    return pipeline;
 }
 
 void Renderer::createCommandPool(VkObjects* vk) {
@@ -174,96 +255,393 @@ void Renderer::createCommandPool(VkObjects* vk) {
 }
 
 void Renderer::createCommandBuffers(VkObjects* vk) {
-    vk->commandBuffers.resize(vk->swapchainFramebuffers.size());
+    // One primary buffer per frame in flight, re-recorded each frame in drawFrame
+    std::vector<VkCommandBuffer> buffers(vk->maxFramesInFlight);
     VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
     ai.commandPool = vk->commandPool;
     ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    ai.commandBufferCount = static_cast<uint32_t>(vk->commandBuffers.size());
-    if (vkAllocateCommandBuffers(vk->device, &ai, vk->commandBuffers.data()) != VK_SUCCESS) {
+    ai.commandBufferCount = static_cast<uint32_t>(buffers.size());
+    if (vkAllocateCommandBuffers(vk->device, &ai, buffers.data()) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate command buffers");
     }
+    vk->frames.resize(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) vk->frames[i].commandBuffer = buffers[i];
+    GpuProfiler::createQueryPool(vk, vk->maxFramesInFlight);
+}
 
-    for (size_t i = 0; i < vk->commandBuffers.size(); ++i) {
-        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        if (vkBeginCommandBuffer(vk->commandBuffers[i], &bi) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to begin recording command buffer");
-        }
+void Renderer::setMainPassViewport(VkObjects* vk, VkCommandBuffer cmd) {
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)vk->swapchainExtent.width;
+    viewport.height = (float)vk->swapchainExtent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    VkRect2D scissor{};
+    scissor.offset = {0,0};
+    scissor.extent = vk->swapchainExtent;
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
 
-        VkRenderPassBeginInfo rpbi{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
-        rpbi.renderPass = vk->renderPass;
-        rpbi.framebuffer = vk->swapchainFramebuffers[i];
-        rpbi.renderArea.offset = {0,0};
-        rpbi.renderArea.extent = vk->swapchainExtent;
-        VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
-        rpbi.clearValueCount = 1;
-        rpbi.pClearValues = &clearColor;
-
-        vkCmdBeginRenderPass(vk->commandBuffers[i], &rpbi, VK_SUBPASS_CONTENTS_INLINE);
-        vkCmdBindPipeline(vk->commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, vk->graphicsPipeline);
-        if (vk->vertexBuffer) {
-            VkBuffer buffers[] = { vk->vertexBuffer };
-            VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(vk->commandBuffers[i], 0, 1, buffers, offsets);
-            vkCmdDraw(vk->commandBuffers[i], vk->vertexCount, 1, 0, 0);
-        } else {
-            vkCmdDraw(vk->commandBuffers[i], 3, 1, 0, 0);
+FrameAllocator::Slice Renderer::buildRenderQueue(VkObjects* vk, const aurora::DrawCommand* draws, uint32_t count) {
+    AURORA_PROFILE_ZONE("Renderer::buildRenderQueue");
+    render::RenderQueue& queue = vk->renderQueue;
+    queue.clear();
+    const render::GpuMesh& mesh = vk->mesh;
+    if (!mesh.vertexBuffer || !vk->uploads->isSubmitted(mesh.uploadTicket)) return {};
+    queue.reserve(count);
+    // Only the main pass exists so far. Each material has its pipeline (shader variant); ids
+    // the table does not know draw with the default material.
+    constexpr uint32_t kMainPass = 0;
+    const MaterialTable& materials = *vk->materials;
+    const uint32_t materialCount = materials.count();
+    const bool objectsReady = vk->objects->ready();
+    const std::vector<aurora::math::Mat4>& worlds = vk->objects->worlds();
+    for (uint32_t i = 0; i < count; ++i) {
+        const aurora::DrawCommand& d = draws[i];
+        float depth = d.position[2];
+        if (d.object != aurora::DrawCommand::kNoObject) {
+            // A grown object buffer is still being filled
+            if (!objectsReady || d.object >= worlds.size()) continue;
+            depth = worlds[d.object].cols[3].z;
         }
-        vkCmdEndRenderPass(vk->commandBuffers[i]);
+        const uint32_t material = d.material < materialCount ? d.material : aurora::kDefaultMaterial;
+        queue.add(render::sortkey::make(kMainPass, materials.pipeline(material), material, d.mesh, depth), i);
+    }
+    queue.sort();
+    if (queue.empty()) return {};
+    FrameAllocator::Slice instances = vk->frameAllocator->allocate(queue.size() * sizeof(aurora::DrawCommand), 16);
+    queue.writeInstances(draws, static_cast<aurora::DrawCommand*>(instances.data));
+    return instances;
+}
+
+void Renderer::bindMainPassSets(VkObjects* vk, VkCommandBuffer cmd) {
+    VkDescriptorSet sets[2] = {vk->objects->descriptorSet(), VK_NULL_HANDLE};
+    uint32_t count = 1;
+    if (vk->bindlessTable) sets[count++] = vk->bindlessTable->set();
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, vk->pipelineLayout, 0, count, sets, 0, nullptr);
+}
 
-        if (vkEndCommandBuffer(vk->commandBuffers[i]) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to record command buffer");
+void Renderer::recordMainPassBatches(VkObjects* vk, VkCommandBuffer cmd, const render::DrawBatch* batches, uint32_t count,
+                                     const FrameAllocator::Slice& instances) {
+    setMainPassViewport(vk, cmd);
+    if (count == 0) return;
+    VkDeviceSize instanceOffset = instances.offset;
+    vkCmdBindVertexBuffers(cmd, render::kInstanceBinding, 1, &instances.buffer, &instanceOffset);
+    // State is bound only where it differs from the previous batch; batches arrive in key
+    // order, so each pipeline, material and mesh is bound once per run. Pipeline ids resolve
+    // through vk->pipelines; batches whose pipeline is still compiling (without a ready
+    // fallback) are skipped this frame. A material change pushes the material's parameters
+    // (with bindless only its id) and rebinds the object set, which stands in for a
+    // per-material set without bindless. Mesh ids resolve to the built-in mesh for now.
+    uint32_t pipeline = UINT32_MAX, material = UINT32_MAX, meshId = UINT32_MAX;
+    VkPipeline pipelineHandle = VK_NULL_HANDLE;
+    const render::GpuMesh& mesh = vk->mesh;
+    for (uint32_t i = 0; i < count; ++i) {
+        const render::DrawBatch& b = batches[i];
+        if (render::sortkey::pipeline(b.key) != pipeline) {
+            pipeline = render::sortkey::pipeline(b.key);
+            pipelineHandle = vk->pipelines->get(pipeline);
+            if (pipelineHandle) vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineHandle);
         }
+        if (!pipelineHandle) continue;
+        if (render::sortkey::material(b.key) != material) {
+            if (material == UINT32_MAX || !vk->bindlessTable) bindMainPassSets(vk, cmd);
+            material = render::sortkey::material(b.key);
+            render::MeshPushConstants pc;
+            pc.material = material;
+            uint32_t bytes = sizeof(uint32_t);
+            if (!vk->bindlessTable) {
+                const aurora::MaterialDesc& desc = vk->materials->desc(material);
+                std::memcpy(pc.baseColor, desc.baseColor, sizeof(pc.baseColor));
+                bytes = render::MeshPushConstants::kMaterialBytes;
+            }
+            vkCmdPushConstants(cmd, vk->pipelineLayout, render::kMeshPushStages, render::MeshPushConstants::kMaterialOffset,
+                               bytes, &pc.material);
+        }
+        if (render::sortkey::mesh(b.key) != meshId) {
+            meshId = render::sortkey::mesh(b.key);
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.vertexBuffer, &offset);
+            if (mesh.indexBuffer) vkCmdBindIndexBuffer(cmd, mesh.indexBuffer, 0, mesh.indexType);
+            vkCmdPushConstants(cmd, vk->pipelineLayout, render::kMeshPushStages, 0, render::MeshPushConstants::kMeshBytes,
+                               &mesh.pushConstants);
+        }
+        if (mesh.indexBuffer) vkCmdDrawIndexed(cmd, mesh.indexCount, b.instanceCount, 0, 0, b.firstInstance);
+        else vkCmdDraw(cmd, mesh.vertexCount, b.instanceCount, 0, b.firstInstance);
     }
 }
 
-void Renderer::createSyncObjects(VkObjects* vk) {
-    size_t maxFrames = vk->swapchainFramebuffers.size();
-    vk->imageAvailableSemaphores.resize(maxFrames);
-    vk->renderFinishedSemaphores.resize(maxFrames);
-    vk->inFlightFences.resize(maxFrames);
+void Renderer::recordCommandBuffer(VkObjects* vk, uint32_t frameIndex, uint32_t imageIndex) {
+    AURORA_PROFILE_ZONE("Renderer::recordCommandBuffer");
+    VkCommandBuffer cmd = vk->frames[frameIndex].commandBuffer;
+    vkResetCommandBuffer(cmd, 0);
+    VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(cmd, &bi) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording command buffer");
+    }
+    GpuProfiler::cmdResetSlot(vk, cmd, frameIndex);
+    GpuProfiler::cmdBeginZone(vk, cmd, frameIndex, GpuProfiler::ZoneFrame);
+
+    // Game draws for this frame (possibly none, e.g. all culled); without a list, the
+    // built-in triangle once
+    static const aurora::DrawCommand kDefaultDraw{};
+    const aurora::DrawCommand* draws = &kDefaultDraw;
+    uint32_t drawCount = 1;
+    if (vk->drawList) {
+        draws = vk->drawList->commands().data();
+        drawCount = static_cast<uint32_t>(vk->drawList->size());
+    }
+    // GPU-driven: the draw list is culled by a compute dispatch and drawn indirectly.
+    // Otherwise the draws are sorted by state and merged into instanced batches.
+    const bool gpuDriven = vk->gpuPass && vk->drawList && vk->gpuPass->prepare(frameIndex, draws, drawCount);
+    FrameAllocator::Slice instances;
+    if (!gpuDriven) {
+        StageTimer st("sort draws", vk->lastFrameTimings.sortMs);
+        instances = buildRenderQueue(vk, draws, drawCount);
+    }
+    const std::vector<render::DrawBatch>& batches = vk->renderQueue.batches();
+    const uint32_t batchCount = gpuDriven ? 0u : static_cast<uint32_t>(batches.size());
+    vk->lastFrameTimings.drawCalls = gpuDriven ? (drawCount ? 1u : 0u) : batchCount;
+    const bool parallel = !gpuDriven && vk->recorder && vk->recorder->partitionCount(batchCount) > 1;
+
+    // The frame as a render graph; barriers, layout transitions and the main pass's render
+    // pass and framebuffer follow from the declared usages
+    RenderGraph& graph = *vk->graph;
+    using Usage = RenderGraph::Usage;
+    // Acquire waits on COLOR_ATTACHMENT_OUTPUT, so the first transition must not start earlier
+    const RenderGraph::Resource backbuffer = graph.importImage(
+        "backbuffer", vk->swapchainImages[imageIndex], vk->swapchainImageViews[imageIndex], vk->swapchainImageFormat,
+        vk->swapchainExtent, VK_IMAGE_LAYOUT_UNDEFINED,
+        vk->headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    RenderGraph::ImageDesc depthDesc;
+    depthDesc.format = vk->depthFormat;
+    depthDesc.extent = vk->swapchainExtent;
+    const RenderGraph::Resource depth = graph.createImage("depth", depthDesc);
+
+    // Staging copies; their own barrier makes the data visible to every later stage
+    graph.addPass("upload", RenderGraph::PassType::Transfer, [vk](const RenderGraph::PassContext& ctx) {
+        if (vk->uploads) vk->uploads->record(ctx.cmd, ctx.frameIndex);
+    }).sideEffect();
+
+    RenderGraph::Resource commands = 0, count = 0;
+    if (gpuDriven) {
+        GpuDrivenPass* gpuPass = vk->gpuPass;
+        const GpuDrivenPass::Buffers buffers = gpuPass->buffers(frameIndex);
+        commands = graph.importBuffer("indirect commands", buffers.commands);
+        count = graph.importBuffer("draw count", buffers.count);
+        const RenderGraph::Resource readback =
+            graph.importBuffer("draw count readback", buffers.readback, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+        graph.addPass("cull reset", RenderGraph::PassType::Transfer, [gpuPass](const RenderGraph::PassContext& ctx) {
+            gpuPass->recordReset(ctx.cmd, ctx.frameIndex);
+        }).write(count, Usage::TransferWrite);
+        graph.addPass("gpu cull", RenderGraph::PassType::Compute, [gpuPass](const RenderGraph::PassContext& ctx) {
+            gpuPass->recordCull(ctx.cmd, ctx.frameIndex);
+        }).write(count, Usage::StorageWriteCompute).write(commands, Usage::StorageWriteCompute);
+        graph.addPass("cull readback", RenderGraph::PassType::Transfer, [gpuPass](const RenderGraph::PassContext& ctx) {
+            gpuPass->recordReadback(ctx.cmd, ctx.frameIndex);
+        }).read(count, Usage::TransferRead).write(readback, Usage::TransferWrite);
+    }
+
+    RenderGraph::PassBuilder mainPass = graph.addPass(
+        "main pass", RenderGraph::PassType::Graphics,
+        [vk, gpuDriven, parallel, batchCount, &batches, &instances](const RenderGraph::PassContext& ctx) {
+            StageTimer st("record draws", vk->lastFrameTimings.recordMs);
+            auto recordDraws = [vk, &batches, &instances](VkCommandBuffer c, uint32_t first, uint32_t n) {
+                recordMainPassBatches(vk, c, batches.data() + first, n, instances);
+            };
+            if (gpuDriven) {
+                setMainPassViewport(vk, ctx.cmd);
+                vk->gpuPass->recordDraws(ctx.cmd, ctx.frameIndex);
+            } else if (parallel) {
+                // Secondaries inherit the graph's framebuffer; replayed in batch order
+                const auto& secondaries = vk->recorder->record(ctx.frameIndex, ctx.framebuffer, batchCount, recordDraws);
+                vkCmdExecuteCommands(ctx.cmd, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+            } else {
+                recordDraws(ctx.cmd, 0, batchCount);
+            }
+        });
+    mainPass.clearColor(backbuffer, {{0.0f, 0.0f, 0.0f, 1.0f}}).clearDepth(depth, 1.0f).secondaryCommandBuffers(parallel);
+    if (gpuDriven) mainPass.read(commands, Usage::IndirectRead).read(count, Usage::IndirectRead);
+
+    graph.compile();
+    graph.execute(cmd, frameIndex);
+
+    const RenderGraph::Stats& stats = graph.stats();
+    RenderTimings& timings = vk->lastFrameTimings;
+    timings.graphPassCount = 0;
+    for (const RenderGraph::PassStats& p : stats.passes) {
+        if (timings.graphPassCount == RenderTimings::kMaxGraphPasses) break;
+        timings.graphPasses[timings.graphPassCount++] = {p.name, p.cpuMs, p.gpuMs};
+    }
+    timings.graphPassesCulled = stats.culledPasses;
+    timings.graphBarriers = stats.imageBarriers + stats.bufferBarriers;
+    timings.graphBarrierBatches = stats.barrierBatches;
+    timings.transientBytes = stats.transientBytes;
+    timings.transientBytesSaved = stats.transientBytesSaved;
+    const DescriptorAllocator::Stats& descriptors = vk->descriptors->stats();
+    const DescriptorLayoutCache::Stats layouts = vk->descriptorLayouts->stats();
+    timings.descriptorSets = descriptors.setsAllocated;
+    timings.descriptorPools = descriptors.pools;
+    timings.descriptorPoolGrowths = descriptors.poolGrowths;
+    timings.descriptorLayouts = layouts.layouts;
+    timings.descriptorLayoutHits = layouts.hits;
+    if (vk->bindlessTable) {
+        timings.bindlessTextures = vk->bindlessTable->stats().textures;
+        timings.bindlessBuffers = vk->bindlessTable->stats().buffers;
+    }
+    const PipelineStateCache::Stats pipelines = vk->pipelines->stats();
+    timings.pipelinesCompiling = pipelines.compiling;
+    timings.pipelineFallbacks = pipelines.fallbacks;
 
+    GpuProfiler::cmdEndZone(vk, cmd, frameIndex, GpuProfiler::ZoneFrame);
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record command buffer");
+    }
+}
+
+void Renderer::createSyncObjects(VkObjects* vk) {
     VkSemaphoreCreateInfo sci{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
     VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
     fci.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    for (size_t i = 0; i < maxFrames; ++i) {
-        if (vkCreateSemaphore(vk->device, &sci, nullptr, &vk->imageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateSemaphore(vk->device, &sci, nullptr, &vk->renderFinishedSemaphores[i]) != VK_SUCCESS ||
-            vkCreateFence(vk->device, &fci, nullptr, &vk->inFlightFences[i]) != VK_SUCCESS) {
+    vk->frames.resize(vk->maxFramesInFlight);
+    for (auto& frame : vk->frames) {
+        if (vkCreateSemaphore(vk->device, &sci, nullptr, &frame.imageAvailable) != VK_SUCCESS ||
+            vkCreateFence(vk->device, &fci, nullptr, &frame.inFlight) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create synchronization objects for a frame");
         }
     }
+    createImageSyncObjects(vk);
+    vk->currentFrame = 0;
+}
+
+void Renderer::createImageSyncObjects(VkObjects* vk) {
+    destroyImageSyncObjects(vk);
+    size_t imageCount = vk->swapchainImages.size();
+    vk->imagesInFlight.assign(imageCount, VK_NULL_HANDLE);
+    vk->nextOffscreenImage = 0;
+    if (vk->headless) return; // nothing is presented, no present semaphores needed
+    // Present waits on these, so they must be per image: a per-frame semaphore could be
+    // re-signaled while the presentation engine still holds it.
+    VkSemaphoreCreateInfo sci{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    vk->renderFinishedSemaphores.resize(imageCount);
+    for (auto& s : vk->renderFinishedSemaphores) {
+        if (vkCreateSemaphore(vk->device, &sci, nullptr, &s) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create present semaphore");
+        }
+    }
+}
+
+void Renderer::destroyImageSyncObjects(VkObjects* vk) {
+    for (auto s : vk->renderFinishedSemaphores) if (s) vkDestroySemaphore(vk->device, s, nullptr);
+    vk->renderFinishedSemaphores.clear();
+    vk->imagesInFlight.clear();
+}
+
+void Renderer::destroySyncObjects(VkObjects* vk) {
+    for (auto& frame : vk->frames) {
+        if (frame.imageAvailable) vkDestroySemaphore(vk->device, frame.imageAvailable, nullptr);
+        if (frame.inFlight) vkDestroyFence(vk->device, frame.inFlight, nullptr);
+        frame.imageAvailable = VK_NULL_HANDLE;
+        frame.inFlight = VK_NULL_HANDLE;
+    }
+    destroyImageSyncObjects(vk);
 }
 
 void Renderer::drawFrame(VkObjects* vk, GLFWwindow* window) {
-    vkWaitForFences(vk->device, 1, &vk->inFlightFences[vk->currentFrame], VK_TRUE, UINT64_MAX);
+    AURORA_PROFILE_ZONE("Renderer::drawFrame");
+    RenderTimings& timings = vk->lastFrameTimings;
+    timings = {};
+    const uint32_t frameIndex = static_cast<uint32_t>(vk->currentFrame);
+    FrameData& frame = vk->frames[frameIndex];
+    {
+        StageTimer st("vkWaitForFences", timings.fenceWaitMs);
+        vkWaitForFences(vk->device, 1, &frame.inFlight, VK_TRUE, UINT64_MAX);
+    }
+    // This frame's previous submission is complete: its queries are ready, and swapchains
+    // retired maxFramesInFlight frames ago are no longer referenced
+    GpuProfiler::collect(vk, frameIndex);
+    if (vk->uploads) vk->uploads->beginFrame(frameIndex);
+    // Before anything allocates this frame's descriptor sets (object set, cull set)
+    if (vk->descriptors) vk->descriptors->beginFrame(frameIndex);
+    if (vk->bindlessTable) vk->bindlessTable->beginFrame();
+    if (vk->pipelines) vk->pipelines->beginFrame();
+    // Pipelines of materials created since the last frame
+    if (vk->materials) vk->materials->beginFrame();
+    if (vk->gpuPass) {
+        vk->gpuPass->beginFrame(frameIndex);
+        timings.gpuDrawsTested = vk->gpuPass->stats().tested;
+        timings.gpuDrawsVisible = vk->gpuPass->stats().visible;
+    }
+    // Changed object matrices join this frame's upload batch
+    if (vk->objects) vk->objects->flush();
+    if (vk->frameAllocator) vk->frameAllocator->beginFrame(frameIndex);
+    if (vk->recorder) vk->recorder->beginFrame(frameIndex);
+    if (vk->graph) vk->graph->beginFrame(frameIndex);
+    if (!vk->retiredSwapchains.empty()) SwapchainManager::destroyRetired(vk, false);
+
     uint32_t imageIndex;
-    VkResult res = vkAcquireNextImageKHR(vk->device, vk->swapchain, UINT64_MAX, vk->imageAvailableSemaphores[vk->currentFrame], VK_NULL_HANDLE, &imageIndex);
-    if (res == VK_ERROR_OUT_OF_DATE_KHR) {
-        std::cout << "Renderer::drawFrame - acquire returned OUT_OF_DATE, recreating..." << std::endl;
-        // Recreate swapchain and renderer resources
-        vulkan::SwapchainManager::recreateSwapchain(vk, window);
-        vulkan::Renderer::recreate(vk, window);
-        return;
-    } else if (res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR) {
-        throw std::runtime_error("Failed to acquire swapchain image");
+    if (vk->headless) {
+        // No acquire: offscreen targets are handed out round-robin
+        imageIndex = vk->nextOffscreenImage;
+        vk->nextOffscreenImage = (imageIndex + 1) % static_cast<uint32_t>(vk->swapchainImages.size());
+    } else {
+        VkResult res;
+        {
+            StageTimer st("vkAcquireNextImageKHR", timings.acquireMs);
+            res = vkAcquireNextImageKHR(vk->device, vk->swapchain, UINT64_MAX, frame.imageAvailable, VK_NULL_HANDLE, &imageIndex);
+        }
+        if (res == VK_ERROR_OUT_OF_DATE_KHR) {
+            std::cout << "Renderer::drawFrame - acquire returned OUT_OF_DATE, recreating..." << std::endl;
+            // Recreate swapchain and renderer resources; skip the frame while minimized
+            if (vulkan::SwapchainManager::recreateSwapchain(vk, window)) {
+                vulkan::Renderer::recreate(vk, window);
+            }
+            return;
+        } else if (res != VK_SUCCESS && res != VK_SUBOPTIMAL_KHR) {
+            throw std::runtime_error("Failed to acquire swapchain image");
+        }
+    }
+
+    // The image may still be in use by an older frame (image count != frames in flight)
+    if (vk->imagesInFlight[imageIndex] != VK_NULL_HANDLE && vk->imagesInFlight[imageIndex] != frame.inFlight) {
+        StageTimer st("wait image fence", timings.fenceWaitMs);
+        vkWaitForFences(vk->device, 1, &vk->imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
     }
+    vk->imagesInFlight[imageIndex] = frame.inFlight;
+
+    recordCommandBuffer(vk, frameIndex, imageIndex);
 
     VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    VkSemaphore waitSemaphores[] = { vk->imageAvailableSemaphores[vk->currentFrame] };
+    VkSemaphore waitSemaphores[] = { frame.imageAvailable };
     VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    VkSemaphore signalSemaphores[] = { VK_NULL_HANDLE };
+    if (!vk->headless) {
+        signalSemaphores[0] = vk->renderFinishedSemaphores[imageIndex];
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = waitSemaphores;
+        submitInfo.pWaitDstStageMask = waitStages;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = signalSemaphores;
+    }
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &vk->commandBuffers[imageIndex];
-    VkSemaphore signalSemaphores[] = { vk->renderFinishedSemaphores[vk->currentFrame] };
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-
-    vkResetFences(vk->device, 1, &vk->inFlightFences[vk->currentFrame]);
-    if (vkQueueSubmit(vk->graphicsQueue, 1, &submitInfo, vk->inFlightFences[vk->currentFrame]) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to submit draw command buffer");
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
+
+    if (vk->frameAllocator) vk->frameAllocator->flush();
+    vkResetFences(vk->device, 1, &frame.inFlight);
+    GpuProfiler::onSubmit(vk, frameIndex);
+    {
+        StageTimer st("vkQueueSubmit", timings.submitMs);
+        if (vkQueueSubmit(vk->graphicsQueue, 1, &submitInfo, frame.inFlight) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit draw command buffer");
+        }
     }
+    vk->currentFrame = (vk->currentFrame + 1) % vk->frames.size();
+    ++vk->frameNumber;
+    if (vk->headless) return;
 
     VkPresentInfoKHR presentInfo{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
     presentInfo.waitSemaphoreCount = 1;
@@ -272,65 +650,62 @@ void Renderer::drawFrame(VkObjects* vk, GLFWwindow* window) {
     presentInfo.pSwapchains = &vk->swapchain;
     presentInfo.pImageIndices = &imageIndex;
 
-    res = vkQueuePresentKHR(vk->graphicsQueue, &presentInfo);
+    VkResult res;
+    {
+        StageTimer st("vkQueuePresentKHR", timings.presentMs);
+        res = vkQueuePresentKHR(vk->graphicsQueue, &presentInfo);
+    }
     if (res == VK_ERROR_OUT_OF_DATE_KHR || res == VK_SUBOPTIMAL_KHR) {
         std::cout << "Renderer::drawFrame - present returned OUT_OF_DATE/SUBOPTIMAL, recreating..." << std::endl;
-        vulkan::SwapchainManager::recreateSwapchain(vk, window);
-        vulkan::Renderer::recreate(vk, window);
+        if (vulkan::SwapchainManager::recreateSwapchain(vk, window)) {
+            vulkan::Renderer::recreate(vk, window);
+        }
     } else if (res != VK_SUCCESS) {
         throw std::runtime_error("Failed to present swapchain image");
     }
-
-    vk->currentFrame = (vk->currentFrame + 1) % vk->inFlightFences.size();
 }
 
 void Renderer::cleanupRenderer(VkObjects* vk) {
     if (!vk) return;
-    for (auto s : vk->renderFinishedSemaphores) if (s) vkDestroySemaphore(vk->device, s, nullptr);
-    for (auto s : vk->imageAvailableSemaphores) if (s) vkDestroySemaphore(vk->device, s, nullptr);
-    for (auto f : vk->inFlightFences) if (f) vkDestroyFence(vk->device, f, nullptr);
+    destroySyncObjects(vk);
 
-    if (vk->commandPool) vkDestroyCommandPool(vk->device, vk->commandPool, nullptr);
+    // frees the per-frame command buffers too
+    if (vk->commandPool) { vkDestroyCommandPool(vk->device, vk->commandPool, nullptr); vk->commandPool = VK_NULL_HANDLE; }
+    vk->frames.clear();
+    GpuProfiler::destroyQueryPool(vk);
 
-    // Note: framebuffers, image views, swapchain destroyed by SwapchainManager
+    // Note: image views, swapchain destroyed by SwapchainManager; framebuffers by the render
+    // graph; pipelines by the PipelineStateCache (deleted before this)
 
-    if (vk->graphicsPipeline) { vkDestroyPipeline(vk->device, vk->graphicsPipeline, nullptr); vk->graphicsPipeline = VK_NULL_HANDLE; }
     if (vk->pipelineLayout) { vkDestroyPipelineLayout(vk->device, vk->pipelineLayout, nullptr); vk->pipelineLayout = VK_NULL_HANDLE; }
     if (vk->renderPass) { vkDestroyRenderPass(vk->device, vk->renderPass, nullptr); vk->renderPass = VK_NULL_HANDLE; }
 }
 
 void Renderer::recreate(VkObjects* vk, GLFWwindow* window) {
-    // wait idle
-    if (vk->device) vkDeviceWaitIdle(vk->device);
+    AURORA_PROFILE_ZONE("Renderer::recreate");
+    (void)window;
     std::cout << "Renderer: recreate() start" << std::endl;
 
-    // cleanup renderer specific resources
-    std::cout << "Renderer: cleaning up renderer resources" << std::endl;
-    cleanupRenderer(vk);
-
-    // swapchain/framebuffers handled by SwapchainManager; ensure they are valid
-    // recreate renderpass/pipeline
-    std::cout << "Renderer: creating render pass" << std::endl;
-    createRenderPass(vk);
-    std::cout << "Renderer: creating graphics pipeline" << std::endl;
-    createGraphicsPipeline(vk);
-    // now that new render pass/pipeline exist, rebuild swapchain framebuffers
-    std::cout << "Renderer: creating framebuffers" << std::endl;
-    vulkan::SwapchainManager::createFramebuffers(vk);
-
-    // recreate framebuffers for new swapchain extent
-    // command buffers and sync objects need to be recreated
-    // command pool recreated
-    if (vk->commandPool) {
-        std::cout << "Renderer: destroying old command pool" << std::endl;
-        vkDestroyCommandPool(vk->device, vk->commandPool, nullptr);
+    // The pipeline uses dynamic viewport/scissor, so only a surface format change makes the
+    // render pass (and with it the pipelines) incompatible. That is rare enough to afford a
+    // full wait; the common resize path never stalls the GPU or touches a pipeline.
+    if (vk->swapchainImageFormat != vk->renderPassFormat) {
+        std::cout << "Renderer: surface format changed, rebuilding render pass and pipeline" << std::endl;
+        if (vk->device) vkDeviceWaitIdle(vk->device);
+        vk->pipelines->releaseRenderPass(vk->renderPass);
+        if (vk->pipelineLayout) { vkDestroyPipelineLayout(vk->device, vk->pipelineLayout, nullptr); vk->pipelineLayout = VK_NULL_HANDLE; }
+        if (vk->renderPass) { vkDestroyRenderPass(vk->device, vk->renderPass, nullptr); vk->renderPass = VK_NULL_HANDLE; }
+        createRenderPass(vk);
+        createGraphicsPipeline(vk);
+        vk->pipelines->wait(vk->materials->pipeline(aurora::kDefaultMaterial)); // already stalled; draw the next frame
     }
-    std::cout << "Renderer: creating command pool" << std::endl;
-    createCommandPool(vk);
-    std::cout << "Renderer: creating command buffers" << std::endl;
-    createCommandBuffers(vk);
-    std::cout << "Renderer: creating sync objects" << std::endl;
-    createSyncObjects(vk);
+
+    // Present semaphores are per swapchain image; the old ones were retired with the old
+    // swapchain. The graph's framebuffers reference the old views: drop them once unused, new
+    // ones (and a depth buffer of the new size) are created by the next frame's graph.
+    // Command buffers and per-frame sync objects are kept.
+    if (vk->graph) vk->graph->releaseFramebuffers();
+    createImageSyncObjects(vk);
     std::cout << "Renderer: recreate() complete" << std::endl;
 }
 
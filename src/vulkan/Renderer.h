@@ -1,18 +1,44 @@
 #pragma once
 
 #include "vulkan/VkObjects.h"
+#include "vulkan/FrameAllocator.h"
 
 // Forward declare GLFW types to avoid including GLFW headers in this header
 struct GLFWwindow;
 
 namespace vulkan {
+struct GraphicsPipelineDesc;
+
 struct Renderer {
     static void createRenderPass(VkObjects* vk);
+    // Pipeline layout, and requests for every material's pipeline (vk->materials); they
+    // compile in the background
     static void createGraphicsPipeline(VkObjects* vk);
+    // Mesh pipeline (vertex input, raster, depth and blend state) as described. Thread-safe;
+    // called by vulkan::PipelineStateCache on job threads. Throws on failure.
+    static VkPipeline createMeshPipeline(VkObjects* vk, const GraphicsPipelineDesc& desc);
     static void createCommandPool(VkObjects* vk);
+    // Allocates one primary command buffer per frame in flight (recorded per frame)
     static void createCommandBuffers(VkObjects* vk);
+    static void recordCommandBuffer(VkObjects* vk, uint32_t frameIndex, uint32_t imageIndex);
+    // Dynamic viewport/scissor covering the swapchain extent
+    static void setMainPassViewport(VkObjects* vk, VkCommandBuffer cmd);
+    // Sets of the main pipeline layout: object matrices, plus the bindless table when enabled
+    static void bindMainPassSets(VkObjects* vk, VkCommandBuffer cmd);
+    // Sort keys for the frame's draws into vk->renderQueue, radix sort, and write the draws in
+    // key order into the frame allocator as the instance buffer (empty while the mesh uploads)
+    static FrameAllocator::Slice buildRenderQueue(VkObjects* vk, const aurora::DrawCommand* draws, uint32_t count);
+    // Main pass state + instanced draws of vk->renderQueue batches; used inline and by the
+    // parallel secondary recorders
+    static void recordMainPassBatches(VkObjects* vk, VkCommandBuffer cmd, const render::DrawBatch* batches, uint32_t count,
+                                      const FrameAllocator::Slice& instances);
+    // Per-frame semaphore/fence plus per-image present semaphores and images-in-flight table
     static void createSyncObjects(VkObjects* vk);
+    static void createImageSyncObjects(VkObjects* vk);
+    static void destroyImageSyncObjects(VkObjects* vk);
+    static void destroySyncObjects(VkObjects* vk);
     static void cleanupRenderer(VkObjects* vk);
+    // Headless: no acquire/present, offscreen images used round-robin
     static void drawFrame(VkObjects* vk, GLFWwindow* window);
     static void recreate(VkObjects* vk, GLFWwindow* window);
 };
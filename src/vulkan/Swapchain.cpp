@@ -8,6 +8,9 @@
 #include <vector>
 #include <algorithm>
 
+#include <aurora/Profiler.h>
+#include "window/Window.h"
+
 namespace {
 struct SwapchainSupportDetails {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -54,9 +57,9 @@ static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR
 static VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& caps, GLFWwindow* window) {
     if (caps.currentExtent.width != UINT32_MAX) return caps.currentExtent;
     int width = 0, height = 0;
-    // If window is minimized, glfwGetFramebufferSize may return 0. Do not block here
+    // If window is minimized, the framebuffer size may be 0. Do not block here
     // to avoid hanging the app; use a minimal non-zero extent as a safe fallback.
-    glfwGetFramebufferSize(window, &width, &height);
+    Window::framebufferSize(window, width, height);
     if (width == 0) width = 1;
     if (height == 0) height = 1;
     VkExtent2D actual{static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
@@ -98,11 +101,15 @@ void SwapchainManager::createSwapchain(VkObjects* vk, GLFWwindow* window) {
     ci.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     ci.presentMode = presentMode;
     ci.clipped = VK_TRUE;
-    ci.oldSwapchain = VK_NULL_HANDLE;
+    // Hand over the previous swapchain (if any) so the driver can reuse its resources and
+    // keep already-queued presents valid while we switch
+    ci.oldSwapchain = vk->swapchain;
 
-    if (vkCreateSwapchainKHR(vk->device, &ci, nullptr, &vk->swapchain) != VK_SUCCESS) {
+    VkSwapchainKHR newSwapchain = VK_NULL_HANDLE;
+    if (vkCreateSwapchainKHR(vk->device, &ci, nullptr, &newSwapchain) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create swapchain");
     }
+    vk->swapchain = newSwapchain;
     // record chosen format and extent
     vk->swapchainImageFormat = surfaceFormat.format;
     vk->swapchainExtent = extent;
@@ -139,27 +146,9 @@ void SwapchainManager::createImageViews(VkObjects* vk) {
     }
 }
 
-void SwapchainManager::createFramebuffers(VkObjects* vk) {
-    vk->swapchainFramebuffers.resize(vk->swapchainImageViews.size());
-    for (size_t i = 0; i < vk->swapchainImageViews.size(); ++i) {
-        VkImageView attachments[] = { vk->swapchainImageViews[i] };
-        VkFramebufferCreateInfo fci{VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
-        fci.renderPass = vk->renderPass;
-        fci.attachmentCount = 1;
-        fci.pAttachments = attachments;
-        fci.width = vk->swapchainExtent.width;
-        fci.height = vk->swapchainExtent.height;
-        fci.layers = 1;
-        if (vkCreateFramebuffer(vk->device, &fci, nullptr, &vk->swapchainFramebuffers[i]) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create framebuffer");
-        }
-    }
-}
-
 void SwapchainManager::cleanupSwapchain(VkObjects* vk) {
     if (!vk) return;
-    for (auto fb : vk->swapchainFramebuffers) if (fb) vkDestroyFramebuffer(vk->device, fb, nullptr);
-    vk->swapchainFramebuffers.clear();
+    destroyRetired(vk, true);
     for (auto iv : vk->swapchainImageViews) if (iv) vkDestroyImageView(vk->device, iv, nullptr);
     vk->swapchainImageViews.clear();
     if (vk->swapchain) {
@@ -168,17 +157,53 @@ void SwapchainManager::cleanupSwapchain(VkObjects* vk) {
     }
 }
 
-void SwapchainManager::recreateSwapchain(VkObjects* vk, GLFWwindow* window) {
-    // wait for device idle before tearing down
-    if (vk->device) vkDeviceWaitIdle(vk->device);
+bool SwapchainManager::recreateSwapchain(VkObjects* vk, GLFWwindow* window) {
+    AURORA_PROFILE_ZONE("SwapchainManager::recreateSwapchain");
+    VkSurfaceCapabilitiesKHR caps{};
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(vk->physicalDevice, vk->surface, &caps);
+    int fbWidth = 0, fbHeight = 0;
+    Window::framebufferSize(window, fbWidth, fbHeight);
+    if (caps.currentExtent.width == 0 || caps.currentExtent.height == 0 || fbWidth == 0 || fbHeight == 0) {
+        return false; // minimized: a zero-sized swapchain is invalid, retry once restored
+    }
+
     std::cout << "Swapchain: recreating swapchain..." << std::endl;
-    cleanupSwapchain(vk);
-    std::cout << "Swapchain: cleaned up old swapchain" << std::endl;
+    // No vkDeviceWaitIdle: frames in flight keep using the old objects until they retire
+    RetiredSwapchain retired;
+    retired.swapchain = vk->swapchain;
+    retired.imageViews = std::move(vk->swapchainImageViews);
+    retired.presentSemaphores = std::move(vk->renderFinishedSemaphores);
+    retired.retiredAtFrame = vk->frameNumber;
+    vk->swapchainImageViews.clear();
+    vk->renderFinishedSemaphores.clear();
+    vk->retiredSwapchains.push_back(std::move(retired));
+
+    // oldSwapchain is retired by this call even if creation fails
     createSwapchain(vk, window);
     std::cout << "Swapchain: created new swapchain" << std::endl;
     createImageViews(vk);
     std::cout << "Swapchain: image views created" << std::endl;
-    // framebuffers created after new render pass/pipeline (in renderer recreate)
+    // Framebuffers over the new views are created by the render graph on first use
+    return true;
+}
+
+void SwapchainManager::destroyRetired(VkObjects* vk, bool force) {
+    auto& retired = vk->retiredSwapchains;
+    // Frame k waits on the fence of frame k - maxFramesInFlight, so everything submitted
+    // before the retirement is complete once maxFramesInFlight further frames have begun
+    auto done = [&](const RetiredSwapchain& r) {
+        return force || vk->frameNumber >= r.retiredAtFrame + vk->maxFramesInFlight;
+    };
+    for (auto& r : retired) {
+        if (!done(r)) continue;
+        for (auto iv : r.imageViews) if (iv) vkDestroyImageView(vk->device, iv, nullptr);
+        for (auto sem : r.presentSemaphores) if (sem) vkDestroySemaphore(vk->device, sem, nullptr);
+        if (r.swapchain) vkDestroySwapchainKHR(vk->device, r.swapchain, nullptr);
+        r.swapchain = VK_NULL_HANDLE;
+    }
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [](const RetiredSwapchain& r) { return r.swapchain == VK_NULL_HANDLE; }),
+                  retired.end());
 }
 
 } // namespace vulkan
@@ -7,8 +7,12 @@ namespace vulkan {
 struct SwapchainManager {
     static void createSwapchain(VkObjects* vk, GLFWwindow* window);
     static void createImageViews(VkObjects* vk);
-    static void createFramebuffers(VkObjects* vk);
     static void cleanupSwapchain(VkObjects* vk);
-    static void recreateSwapchain(VkObjects* vk, GLFWwindow* window);
+    // Builds a new swapchain from the old one without waiting for the device; the old
+    // swapchain, views and present semaphores are retired (framebuffers belong to the render
+    // graph). Returns false (and changes nothing) while the surface has a zero extent.
+    static bool recreateSwapchain(VkObjects* vk, GLFWwindow* window);
+    // Destroy retired resources no frame in flight can still use (all of them if force)
+    static void destroyRetired(VkObjects* vk, bool force);
 };
 }
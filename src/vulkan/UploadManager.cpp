@@ -0,0 +1,181 @@
+#include "UploadManager.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include "vulkan/VkObjects.h"
+#include <aurora/Profiler.h>
+
+namespace vulkan {
+
+namespace {
+constexpr VkDeviceSize kStagingAlign = 16;
+// Below this much room before the ring end we wrap instead of splitting into a tiny chunk
+constexpr VkDeviceSize kMinChunk = 64ull << 10;
+
+VkDeviceSize alignUp(VkDeviceSize v, VkDeviceSize a) { return (v + a - 1) / a * a; }
+}
+
+UploadManager::UploadManager(VkObjects* vk, uint32_t frameCount, VkDeviceSize ringSize, VkDeviceSize frameBudget)
+    : vk_(vk), ringSize_(ringSize), frameBudget_(frameBudget), slots_(frameCount) {
+    VkBufferCreateInfo bci{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bci.size = ringSize;
+    bci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    staging_ = vk->allocator->createBuffer(bci, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingAlloc_);
+    if (!stagingAlloc_.mapped) {
+        vk->allocator->destroyBuffer(staging_, stagingAlloc_);
+        throw std::runtime_error("Failed to map staging ring");
+    }
+}
+
+UploadManager::~UploadManager() {
+    // Caller guarantees the device is idle
+    vk_->allocator->destroyBuffer(staging_, stagingAlloc_);
+}
+
+VkDeviceSize UploadManager::reserve(VkDeviceSize want, VkDeviceSize& ringOffset) {
+    uint64_t pos = alignUp(head_, kStagingAlign);
+    VkDeviceSize off = pos % ringSize_;
+    VkDeviceSize contiguous = ringSize_ - off;
+    if (contiguous < want && contiguous < std::min(want, kMinChunk)) {
+        pos += contiguous; // skip the tail end, continue at the ring start
+        off = 0;
+        contiguous = ringSize_;
+    }
+    if (pos - tail_ >= ringSize_) return 0;
+    VkDeviceSize granted = std::min({want, contiguous, ringSize_ - (pos - tail_)});
+    if (!granted) return 0;
+    head_ = pos + granted;
+    ringOffset = off;
+    return granted;
+}
+
+void UploadManager::stage(VkBuffer dst, VkDeviceSize dstOffset, const uint8_t* data, VkDeviceSize size, VkDeviceSize ringOffset) {
+    std::memcpy(static_cast<uint8_t*>(stagingAlloc_.mapped) + ringOffset, data, size);
+    vk_->allocator->flush(stagingAlloc_, ringOffset, size);
+    Copy c;
+    c.dst = dst;
+    c.region.srcOffset = ringOffset;
+    c.region.dstOffset = dstOffset;
+    c.region.size = size;
+    batch_.push_back(c);
+    budgetUsed_ += size;
+}
+
+UploadManager::Ticket UploadManager::enqueue(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Ticket t = nextTicket_++;
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    VkDeviceSize done = 0;
+    // Fast path: straight into the ring. Only when nothing is queued, to keep tickets in order.
+    if (pending_.empty()) {
+        while (done < size && budgetUsed_ < frameBudget_) {
+            VkDeviceSize off = 0;
+            VkDeviceSize got = reserve(std::min(size - done, frameBudget_ - budgetUsed_), off);
+            if (!got) break;
+            stage(dst, dstOffset + done, src + done, got, off);
+            done += got;
+        }
+        if (done == size) {
+            stagedTicket_ = t;
+            return t;
+        }
+    }
+    Pending p;
+    p.ticket = t;
+    p.dst = dst;
+    p.dstOffset = dstOffset + done;
+    p.data.assign(src + done, src + size);
+    pending_.push_back(std::move(p));
+    return t;
+}
+
+void UploadManager::setFrameBudget(VkDeviceSize bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frameBudget_ = std::max<VkDeviceSize>(bytes, 1);
+}
+
+void UploadManager::beginFrame(uint32_t frameIndex) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FrameSlot& slot = slots_[frameIndex];
+    if (!slot.inFlight) return;
+    tail_ = std::max(tail_, slot.ringEnd);
+    completedTicket_ = std::max(completedTicket_, slot.lastTicket);
+    slot.inFlight = false;
+}
+
+void UploadManager::record(VkCommandBuffer cmd, uint32_t frameIndex) {
+    AURORA_PROFILE_ZONE("UploadManager::record");
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Top up the batch from the backlog, oldest first, within the frame budget
+    while (!pending_.empty()) {
+        Pending& p = pending_.front();
+        VkDeviceSize remaining = p.data.size() - p.done;
+        if (remaining) {
+            if (budgetUsed_ >= frameBudget_) break;
+            VkDeviceSize off = 0;
+            VkDeviceSize got = reserve(std::min(remaining, frameBudget_ - budgetUsed_), off);
+            if (!got) break;
+            stage(p.dst, p.dstOffset + p.done, p.data.data() + p.done, got, off);
+            p.done += got;
+            if (p.done < p.data.size()) continue;
+        }
+        stagedTicket_ = p.ticket;
+        pending_.pop_front();
+    }
+
+    if (!batch_.empty()) {
+        // Some copies overwrite data earlier frames may still be reading (ObjectBuffer updates
+        // matrices in place): an execution dependency orders them after those reads
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+        // One vkCmdCopyBuffer per run of copies into the same buffer
+        std::vector<VkBufferCopy> regions;
+        for (size_t i = 0; i < batch_.size();) {
+            VkBuffer dst = batch_[i].dst;
+            regions.clear();
+            for (; i < batch_.size() && batch_[i].dst == dst; ++i) regions.push_back(batch_[i].region);
+            vkCmdCopyBuffer(cmd, staging_, dst, static_cast<uint32_t>(regions.size()), regions.data());
+        }
+        // Queue-order barrier: covers every later command on the queue, not just this buffer
+        VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    FrameSlot& slot = slots_[frameIndex];
+    slot.ringEnd = head_;
+    slot.lastTicket = stagedTicket_;
+    slot.inFlight = true;
+    submittedTicket_ = stagedTicket_;
+    batch_.clear();
+    budgetUsed_ = 0;
+}
+
+bool UploadManager::isSubmitted(Ticket t) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return t <= submittedTicket_;
+}
+
+bool UploadManager::isComplete(Ticket t) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return t <= completedTicket_;
+}
+
+VkDeviceSize UploadManager::pendingBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    VkDeviceSize bytes = budgetUsed_;
+    for (const auto& p : pending_) bytes += p.data.size() - p.done;
+    return bytes;
+}
+
+} // namespace vulkan
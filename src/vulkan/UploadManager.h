@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "vulkan/MemoryAllocator.h"
+
+struct VkObjects;
+
+namespace vulkan {
+// Streams CPU data into DEVICE_LOCAL buffers through a persistently mapped staging ring.
+// Copies queued between two frames are recorded as one batch at the start of the next
+// frame's command buffer between two barriers (earlier reads -> copies -> later reads), so
+// copies may also overwrite data in use by frames in flight. They are fenced by that frame's
+// fence; the ring space is recycled when the fence is waited on again. At most
+// frameBudget bytes are staged per frame - larger requests are split and trickle in over
+// several frames instead of stalling one.
+class UploadManager {
+public:
+    using Ticket = uint64_t; // monotonically increasing per enqueue; 0 = nothing
+
+    static constexpr VkDeviceSize kDefaultRingSize = 32ull << 20;
+    static constexpr VkDeviceSize kDefaultFrameBudget = 8ull << 20;
+
+    UploadManager(VkObjects* vk, uint32_t frameCount,
+                  VkDeviceSize ringSize = kDefaultRingSize, VkDeviceSize frameBudget = kDefaultFrameBudget);
+    ~UploadManager();
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+    // Copy size bytes to dst at dstOffset. data is consumed before returning. Thread-safe.
+    Ticket enqueue(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+    void setFrameBudget(VkDeviceSize bytes);
+
+    // After the frame's fence wait: that frame's previous batch is done, reclaim its staging
+    void beginFrame(uint32_t frameIndex);
+    // Record this frame's batch (copies + barrier) into cmd; call outside a render pass
+    void record(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    // Submitted: every byte is in a recorded batch, so commands recorded after it in queue
+    // order (e.g. this frame's draws) see the data. Complete: the GPU has finished the copy.
+    bool isSubmitted(Ticket t) const;
+    bool isComplete(Ticket t) const;
+    VkDeviceSize pendingBytes() const;
+
+private:
+    struct Copy {
+        VkBuffer dst = VK_NULL_HANDLE;
+        VkBufferCopy region{};
+    };
+    // Data that did not fit the ring or budget yet; staged by later record() calls
+    struct Pending {
+        Ticket ticket = 0;
+        VkBuffer dst = VK_NULL_HANDLE;
+        VkDeviceSize dstOffset = 0;
+        std::vector<uint8_t> data;
+        VkDeviceSize done = 0;
+    };
+    struct FrameSlot {
+        uint64_t ringEnd = 0;   // ring head when the batch was recorded
+        Ticket lastTicket = 0;  // highest ticket fully contained in this or earlier batches
+        bool inFlight = false;
+    };
+
+    // Reserve up to want bytes of contiguous ring space; returns the granted size (0 = full)
+    VkDeviceSize reserve(VkDeviceSize want, VkDeviceSize& ringOffset);
+    void stage(VkBuffer dst, VkDeviceSize dstOffset, const uint8_t* data, VkDeviceSize size, VkDeviceSize ringOffset);
+
+    VkObjects* vk_ = nullptr;
+    VkBuffer staging_ = VK_NULL_HANDLE;
+    Allocation stagingAlloc_;
+    VkDeviceSize ringSize_ = 0;
+    VkDeviceSize frameBudget_ = kDefaultFrameBudget;
+
+    mutable std::mutex mutex_;
+    uint64_t head_ = 0, tail_ = 0; // monotonically increasing ring positions
+    VkDeviceSize budgetUsed_ = 0;  // bytes staged for the batch being built
+    std::vector<Copy> batch_;
+    std::deque<Pending> pending_;
+    std::vector<FrameSlot> slots_;
+    Ticket nextTicket_ = 1;
+    Ticket stagedTicket_ = 0;      // all tickets <= this are fully in batch_ or earlier
+    Ticket submittedTicket_ = 0;
+    Ticket completedTicket_ = 0;
+};
+}
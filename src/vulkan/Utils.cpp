@@ -16,9 +16,13 @@ std::vector<char> readFile(const std::string& path) {
 }
 
 VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& code) {
+    return createShaderModule(device, code.data(), code.size());
+}
+
+VkShaderModule createShaderModule(VkDevice device, const void* code, size_t size) {
     VkShaderModuleCreateInfo ci{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-    ci.codeSize = code.size();
-    ci.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    ci.codeSize = size;
+    ci.pCode = static_cast<const uint32_t*>(code);
     VkShaderModule module;
     if (vkCreateShaderModule(device, &ci, nullptr, &module) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create shader module");
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -7,4 +8,10 @@
 namespace vkutils {
     std::vector<char> readFile(const std::string& path);
     VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& code);
+    // code must be 4-byte aligned SPIR-V (pack entries and mapped files are)
+    VkShaderModule createShaderModule(VkDevice device, const void* code, size_t size);
+
+    // FNV-1a over 64-bit words; keys the descriptor layout and pipeline caches
+    constexpr uint64_t kHashSeed = 14695981039346656037ull;
+    inline uint64_t hashMix(uint64_t h, uint64_t v) { return (h ^ v) * 1099511628211ull; }
 }
@@ -2,14 +2,125 @@
 
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <string>
+
+#include "vulkan/MemoryAllocator.h"
+#include "render/Mesh.h"
+#include "render/RenderQueue.h"
+#include <aurora/DrawList.h>
+
+namespace vulkan { class UploadManager; class FrameAllocator; class CommandRecorder; class ObjectBuffer; class GpuDrivenPass; class RenderGraph;
+                   class DescriptorLayoutCache; class DescriptorAllocator; class BindlessTable;
+                   class PipelineStateCache; class MaterialTable; }
+namespace io { class FileSystem; }
+
+// CPU-side timings of the last Renderer::drawFrame (milliseconds)
+struct RenderTimings {
+    double fenceWaitMs = 0.0;
+    double acquireMs = 0.0;
+    double submitMs = 0.0;
+    double presentMs = 0.0;
+    double recordMs = 0.0; // main pass draw recording, including parallel secondaries
+    double sortMs = 0.0;   // sort keys, radix sort and instance data of the render queue
+    uint32_t drawCalls = 0; // instanced draw calls of the main pass (1 indirect call GPU-driven)
+    // GPU-driven path: draws tested and left visible by the compute cull of the frame that
+    // last used this frame slot (maxFramesInFlight frames ago); 0 when drawing from the CPU
+    uint32_t gpuDrawsTested = 0;
+    uint32_t gpuDrawsVisible = 0;
+    // Render graph of the frame: executed passes in order (GPU time lags by the frames in
+    // flight) and what compile() derived
+    static constexpr uint32_t kMaxGraphPasses = 16;
+    struct GraphPass {
+        const char* name = "";
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+    };
+    GraphPass graphPasses[kMaxGraphPasses];
+    uint32_t graphPassCount = 0;
+    uint32_t graphPassesCulled = 0;
+    uint32_t graphBarriers = 0; // image + buffer barriers, in graphBarrierBatches calls
+    uint32_t graphBarrierBatches = 0;
+    uint64_t transientBytes = 0;      // memory bound for transient attachments
+    uint64_t transientBytesSaved = 0; // by aliasing transients with disjoint lifetimes
+    // Descriptors: sets allocated this frame from the per-frame pools, pools created so far
+    // and growth events (a frame outgrew its pools), layouts created / served from the cache
+    uint32_t descriptorSets = 0;
+    uint32_t descriptorPools = 0;
+    uint32_t descriptorPoolGrowths = 0;
+    uint32_t descriptorLayouts = 0;
+    uint64_t descriptorLayoutHits = 0;
+    // Bindless table entries (0 when bindless is off)
+    uint32_t bindlessTextures = 0;
+    uint32_t bindlessBuffers = 0;
+    // Pipelines: compiling in the background right now, and pipeline lookups of this frame
+    // that found theirs still compiling (drawn with the fallback pipeline or skipped)
+    uint32_t pipelinesCompiling = 0;
+    uint32_t pipelineFallbacks = 0;
+};
+
+// Pipeline cache load/creation statistics (vulkan::PipelineCache)
+struct PipelineCacheStats {
+    bool loadedFromDisk = false;  // a blob matching this device/driver was used to seed the cache
+    size_t loadedBytes = 0;
+    size_t savedBytes = 0;
+    uint32_t pipelinesCreated = 0;
+    // Hit/miss split needs VK_EXT_pipeline_creation_feedback; without it both stay 0
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+    double hitMs = 0.0;      // total creation time of pipelines served from the cache
+    double missMs = 0.0;     // total creation time of pipelines compiled from scratch
+    double totalMs = 0.0;    // total vkCreate*Pipelines time, with or without feedback
+    double maxMs = 0.0;      // slowest single creation: the hitch it would cost a frame
+    // vulkan::PipelineStateCache requests, and those served by an existing pipeline state
+    uint64_t stateRequests = 0;
+    uint64_t stateDeduplicated = 0;
+};
+
+// Resources owned by one frame in flight; reused once its fence has signaled
+struct FrameData {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkSemaphore imageAvailable = VK_NULL_HANDLE;
+    VkFence inFlight = VK_NULL_HANDLE;
+};
+
+// Swapchain resources replaced by a resize; destroyed once no frame in flight can reference them
+struct RetiredSwapchain {
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    std::vector<VkImageView> imageViews;
+    std::vector<VkSemaphore> presentSemaphores;
+    uint64_t retiredAtFrame = 0;
+};
 
 struct VkObjects {
+    // Headless: no window/surface/swapchain; frames go to engine-owned offscreen images
+    bool headless = false;
     VkInstance instance = VK_NULL_HANDLE;
     VkSurfaceKHR surface = VK_NULL_HANDLE;
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
     VkDevice device = VK_NULL_HANDLE;
     uint32_t graphicsQueueFamily = 0;
     VkQueue graphicsQueue = VK_NULL_HANDLE;
+    // All buffer/image memory comes from here (created with the device, destroyed before it)
+    vulkan::MemoryAllocator* allocator = nullptr;
+    // Staging ring feeding DEVICE_LOCAL buffers; batches are recorded into the frame command buffer
+    vulkan::UploadManager* uploads = nullptr;
+    // Transient per-frame data (uniforms, instances); region recycled after the frame fence
+    vulkan::FrameAllocator* frameAllocator = nullptr;
+    // Every descriptor set layout (cached by bindings), and the per-frame descriptor pools
+    vulkan::DescriptorLayoutCache* descriptorLayouts = nullptr;
+    vulkan::DescriptorAllocator* descriptors = nullptr;
+    // Set before device creation to request bindless descriptors; cleared if the device lacks
+    // descriptor indexing. When set after init, bindlessTable is set 1 of the pipeline layout.
+    bool bindless = false;
+    vulkan::BindlessTable* bindlessTable = nullptr;
+    // World matrices of scene objects (set 0 of the pipeline layout), updated incrementally
+    vulkan::ObjectBuffer* objects = nullptr;
+    // Set before device creation to request GPU-driven rendering; cleared if the device lacks
+    // the features. When set after init, gpuPass culls and draws the draw list.
+    bool gpuDriven = false;
+    vulkan::GpuDrivenPass* gpuPass = nullptr;
+    // Asset files (owned by App): mounted pack with loose-file fallback
+    io::FileSystem* files = nullptr;
     // Debug messenger (optional)
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
     // Swapchain objects
@@ -18,24 +129,55 @@ struct VkObjects {
     std::vector<VkImageView> swapchainImageViews;
     VkFormat swapchainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
     VkExtent2D swapchainExtent{};
+    // Backing memory for offscreen images (headless only; swapchain images are owned by the WSI)
+    std::vector<vulkan::Allocation> offscreenImageAllocs;
+
+    std::vector<RetiredSwapchain> retiredSwapchains;
 
     // Render objects
     VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFormat renderPassFormat = VK_FORMAT_UNDEFINED; // color format the render pass/pipeline were built for
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;      // main pass depth buffer (a render graph transient)
     VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-    VkPipeline graphicsPipeline = VK_NULL_HANDLE;
-    std::vector<VkFramebuffer> swapchainFramebuffers;
+    // Graphics pipelines by description, compiled on job threads; the materials' pipeline
+    // ids are the pipeline field of the main pass sort keys
+    vulkan::PipelineStateCache* pipelines = nullptr;
+    vulkan::MaterialTable* materials = nullptr;
+    // Shared by every pipeline creation; persisted to pipelineCachePath (empty = memory only)
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    std::string pipelineCachePath;
+    bool pipelineCreationFeedback = false; // VK_EXT_pipeline_creation_feedback enabled
+    PipelineCacheStats pipelineCacheStats;
+    // Declares and records each frame's passes; owns the framebuffers and transient images
+    vulkan::RenderGraph* graph = nullptr;
 
     VkCommandPool commandPool = VK_NULL_HANDLE;
-    std::vector<VkCommandBuffer> commandBuffers;
+
+    // Parallel main-pass recording (secondary command buffers); null records inline
+    vulkan::CommandRecorder* recorder = nullptr;
+    // Draws for the frame being recorded (owned by the engine; null = built-in triangle)
+    const aurora::DrawList* drawList = nullptr;
+    // Main pass draws of the frame being recorded, sorted and batched (rebuilt every frame)
+    render::RenderQueue renderQueue;
 
     // Geometry (temporary single mesh)
-    VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
-    uint32_t vertexCount = 0;
+    render::VertexFormat vertexFormat = render::VertexFormat::Quantized; // pipeline vertex input
+    render::GpuMesh mesh;
 
-    // Sync
-    std::vector<VkSemaphore> imageAvailableSemaphores;
-    std::vector<VkSemaphore> renderFinishedSemaphores;
-    std::vector<VkFence> inFlightFences;
+    // GPU timestamps (vulkan::GpuProfiler); one query block per frame in flight
+    VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
+    double timestampPeriodNs = 0.0;
+    uint64_t timestampMask = ~0ull;
+    std::vector<uint64_t> timestampSubmitUs; // profiler time of last submit per slot (0 = nothing pending)
+
+    // Frames in flight (CPU may run this many frames ahead of the GPU); independent of image count
+    uint32_t maxFramesInFlight = 2;
+    std::vector<FrameData> frames;
     size_t currentFrame = 0;
+    uint64_t frameNumber = 0; // frames submitted so far
+    // Per swapchain/offscreen image: present wait semaphore and the fence of the frame last rendering to it
+    std::vector<VkSemaphore> renderFinishedSemaphores;
+    std::vector<VkFence> imagesInFlight;
+    uint32_t nextOffscreenImage = 0; // headless round-robin cursor
+    RenderTimings lastFrameTimings;
 };
@@ -12,9 +12,17 @@ Window::Window(int width, int height, const char* title) {
 
     // install framebuffer resize callback to mark window as resized
     glfwSetWindowUserPointer(window_, this);
+    int fbWidth = 0, fbHeight = 0;
+    glfwGetFramebufferSize(window_, &fbWidth, &fbHeight);
+    fbWidth_ = fbWidth;
+    fbHeight_ = fbHeight;
     glfwSetFramebufferSizeCallback(window_, [](GLFWwindow* win, int w, int h){
         auto self = reinterpret_cast<Window*>(glfwGetWindowUserPointer(win));
-        if (self) self->resized_ = true;
+        if (self) {
+            self->fbWidth_ = w;
+            self->fbHeight_ = h;
+            self->resized_ = true;
+        }
     });
 }
 
@@ -39,3 +47,10 @@ double Window::getTime() const { return glfwGetTime(); }
 bool Window::wasResized() const { return resized_; }
 
 void Window::clearResizedFlag() { resized_ = false; }
+
+void Window::framebufferSize(GLFWwindow* window, int& width, int& height) {
+    // glfwGetWindowUserPointer is thread-safe
+    auto self = reinterpret_cast<Window*>(glfwGetWindowUserPointer(window));
+    width = self ? self->fbWidth_.load() : 0;
+    height = self ? self->fbHeight_.load() : 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 
 struct GLFWwindow;
@@ -16,8 +17,14 @@ public:
     double getTime() const;
     bool wasResized() const;
     void clearResizedFlag();
+    // Framebuffer size as of the last pollEvents. Unlike glfwGetFramebufferSize this may be
+    // called from any thread (the render thread recreates the swapchain).
+    static void framebufferSize(GLFWwindow* window, int& width, int& height);
 
 private:
     GLFWwindow* window_ = nullptr;
-    bool resized_ = false;
+    // Written by GLFW callbacks on the main thread, read by the render thread
+    std::atomic<bool> resized_{false};
+    std::atomic<int> fbWidth_{0};
+    std::atomic<int> fbHeight_{0};
 };
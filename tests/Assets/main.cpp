@@ -0,0 +1,246 @@
+// assets_test: drives an AssetStreamer over a FileSystem whose only mount is a pack built in
+// memory with io::PackWriter. Checks that released assets are unloaded and their path entries
+// pruned, that a path reloads after release, that a throwing decoder or missing file leaves
+// the asset Failed (and cached as such while a handle lives), and that decodes run in
+// priority order. Host-only (no window or GPU); registered with CTest.
+#include <aurora/Assets.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "io/FileSystem.h"
+#include "io/PackWriter.h"
+
+using namespace aurora;
+
+namespace {
+
+constexpr uint32_t kManyPaths = 1000;
+constexpr uint32_t kQueuedPaths = 5;
+
+int failures = 0;
+
+void fail(const std::string& what) {
+    std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+std::vector<uint8_t> bytesOf(const std::string& s) {
+    return {s.begin(), s.end()};
+}
+
+std::string textOf(const uint8_t* data, size_t size) {
+    return {reinterpret_cast<const char*>(data), size};
+}
+
+// Decoded form of the test's text files
+struct Text {
+    std::string value;
+};
+
+// Counts decoder runs; "throw" makes the decoder throw. "gate" blocks the single decode thread
+// until open() so the files loaded meanwhile pile up in the decode queue, and the order they
+// are decoded in afterwards is recorded.
+struct Decoders {
+    std::atomic<uint32_t> runs{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool gateEntered = false;
+    bool gateOpen = false;
+    std::vector<std::string> order;
+
+    std::shared_ptr<Text> decode(const uint8_t* data, size_t size) {
+        runs.fetch_add(1);
+        auto text = std::make_shared<Text>(Text{textOf(data, size)});
+        if (text->value == "throw") throw std::runtime_error("test decoder rejects this file");
+        std::unique_lock<std::mutex> lock(mutex);
+        if (text->value == "gate") {
+            gateEntered = true;
+            cv.notify_all();
+            cv.wait(lock, [this] { return gateOpen; });
+        } else {
+            order.push_back(text->value);
+        }
+        return text;
+    }
+
+    void waitForGate() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return gateEntered; });
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(mutex);
+        gateOpen = true;
+        cv.notify_all();
+    }
+};
+
+// Polls until pred() holds; false after a few seconds
+template<typename Pred>
+bool waitFor(Pred pred) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+std::string writePack() {
+    io::PackWriter pack;
+    pack.add("a.txt", bytesOf("alpha"));
+    pack.add("bad.txt", bytesOf("throw"));
+    pack.add("gate.txt", bytesOf("gate"));
+    for (uint32_t i = 0; i < kQueuedPaths; ++i) pack.add("queued/" + std::to_string(i) + ".txt", bytesOf("q" + std::to_string(i)));
+    for (uint32_t i = 0; i < kManyPaths; ++i) pack.add("many/" + std::to_string(i) + ".bin", bytesOf(std::to_string(i)));
+    const std::string path = (std::filesystem::temp_directory_path() / "aurora_assets_test.pak").string();
+    pack.write(path, {});
+    return path;
+}
+
+// Load, reuse while alive, release (unloaded and pruned), reload
+void checkLifetime(AssetStreamer& assets) {
+    uint32_t callbacks = 0;
+    {
+        AssetHandle<Text> a = assets.load<Text>("a.txt", 0.0f, [&](const AssetHandle<Text>& h) {
+            ++callbacks;
+            if (h.state() != AssetState::Resident) fail("lifetime: callback before the asset was resident");
+        });
+        assets.waitIdle();
+        if (!a.isResident() || !a.get() || a->value != "alpha") fail("lifetime: a.txt not resident with its contents");
+        const uint64_t bytes = assets.stats().bytesRead;
+        AssetHandle<Text> again = assets.load<Text>("a.txt", 0.0f, [&](const AssetHandle<Text>&) { ++callbacks; });
+        assets.waitIdle();
+        if (again.get() != a.get()) fail("lifetime: loading a live path created a second asset");
+        if (assets.stats().bytesRead != bytes) fail("lifetime: loading a live path read it again");
+        if (callbacks != 2) fail("lifetime: " + std::to_string(callbacks) + " callbacks for two loads");
+        bool threw = false;
+        try {
+            assets.load<AssetBlob>("a.txt");
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) fail("lifetime: loading a live path as another type did not throw");
+    }
+    AssetStreamer::Stats s = assets.stats();
+    if (s.resident != 0) fail("lifetime: " + std::to_string(s.resident) + " resident after the last handle went");
+
+    const uint64_t bytes = s.bytesRead;
+    AssetHandle<Text> reloaded = assets.load<Text>("a.txt");
+    assets.waitIdle();
+    if (!reloaded.isResident() || reloaded->value != "alpha") fail("lifetime: reload after release did not become resident");
+    if (assets.stats().bytesRead != bytes + 5) fail("lifetime: reload after release did not read the file again");
+
+    // Load and drop many paths; the path map must be swept as it goes rather than keep them all
+    for (uint32_t i = 0; i < kManyPaths; ++i) {
+        AssetHandle<AssetBlob> blob = assets.load<AssetBlob>("many/" + std::to_string(i) + ".bin");
+        if (i % 100 == 0) assets.waitIdle();
+    }
+    assets.waitIdle();
+    s = assets.stats();
+    if (s.trackedPaths > 256) fail("lifetime: " + std::to_string(s.trackedPaths) + " path entries kept for released assets");
+    if (s.resident != 1) fail("lifetime: " + std::to_string(s.resident) + " resident, expected only the reloaded a.txt");
+}
+
+// A throwing decoder and a missing file both fail; the failure is cached while a handle lives
+void checkFailures(AssetStreamer& assets, Decoders& decoders) {
+    const uint32_t runs = decoders.runs.load();
+    {
+        AssetHandle<Text> bad = assets.load<Text>("bad.txt");
+        AssetHandle<Text> missing = assets.load<Text>("missing.txt");
+        assets.waitIdle();
+        if (bad.state() != AssetState::Failed) fail("failures: throwing decoder did not fail the asset");
+        if (missing.state() != AssetState::Failed) fail("failures: missing file did not fail the asset");
+        if (!bad.get() || bad->value != "placeholder" || missing.get() != bad.get()) fail("failures: failed assets do not resolve to the placeholder");
+        if (assets.stats().failed != 2) fail("failures: stats().failed is " + std::to_string(assets.stats().failed));
+
+        AssetHandle<Text> retry = assets.load<Text>("bad.txt");
+        assets.waitIdle();
+        if (retry.state() != AssetState::Failed || decoders.runs.load() != runs + 1) {
+            fail("failures: loading a failed path while a handle lives did not return the cached failure");
+        }
+    }
+    // Every handle released: the next load tries again
+    AssetHandle<Text> retry = assets.load<Text>("bad.txt");
+    assets.waitIdle();
+    if (retry.state() != AssetState::Failed || decoders.runs.load() != runs + 2) fail("failures: failed path was not retried after release");
+}
+
+// With the one decode thread held, files read meanwhile wait in the decode queue and must come
+// out highest priority first, including one raised by setPriority while it waited
+void checkPriorityOrder(AssetStreamer& assets, Decoders& decoders) {
+    AssetHandle<Text> gate = assets.load<Text>("gate.txt", 100.0f);
+    decoders.waitForGate();
+    const float priorities[kQueuedPaths] = {1.0f, 5.0f, 3.0f, -2.0f, 4.0f};
+    std::vector<AssetHandle<Text>> queued;
+    for (uint32_t i = 0; i < kQueuedPaths; ++i) queued.push_back(assets.load<Text>("queued/" + std::to_string(i) + ".txt", priorities[i]));
+    const bool read = waitFor([&] {
+        for (const auto& h : queued) {
+            if (h.state() != AssetState::Decoding) return false;
+        }
+        return true;
+    });
+    if (!read) {
+        decoders.open();
+        fail("priority: queued files never reached the decode stage");
+        return;
+    }
+    queued[3].setPriority(10.0f);
+    decoders.open();
+    assets.waitIdle();
+
+    const std::vector<std::string> expected = {"q3", "q1", "q4", "q2", "q0"};
+    std::lock_guard<std::mutex> lock(decoders.mutex);
+    const std::vector<std::string> tail(decoders.order.end() - static_cast<std::ptrdiff_t>(std::min<size_t>(decoders.order.size(), kQueuedPaths)),
+                                        decoders.order.end());
+    if (tail != expected) {
+        std::string got;
+        for (const std::string& name : tail) got += " " + name;
+        fail("priority: decode order" + got);
+    }
+    for (const auto& h : queued) {
+        if (!h.isResident()) fail("priority: " + h.path() + " not resident");
+    }
+}
+
+} // namespace
+
+int main() {
+    std::string packPath;
+    try {
+        packPath = writePack();
+        io::FileSystem files(1);
+        if (!files.mountPack(packPath)) throw std::runtime_error("cannot mount " + packPath);
+        Decoders decoders;
+        AssetStreamer assets(files, 1, 1);
+        assets.registerType<Text>([&](const uint8_t* data, size_t size) { return decoders.decode(data, size); },
+                                  std::make_shared<const Text>(Text{"placeholder"}));
+        checkLifetime(assets);
+        checkFailures(assets, decoders);
+        checkPriorityOrder(assets, decoders);
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+    if (!packPath.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(packPath, ec);
+    }
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("assets: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,320 @@
+// ecs_layout_test: builds archetypes of assorted component sizes and alignments and checks
+// that every column fits its 16 KB chunk, is aligned, and keeps its values across chunks;
+// then the structural paths around it: swap-remove on destroy, stale handles, queries over
+// several archetypes and CommandBuffer playback.
+// Host-only (no window or GPU); registered with CTest.
+#include <aurora/ecs/CommandBuffer.h>
+#include <aurora/ecs/Components.h>
+#include <aurora/ecs/World.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aurora::ecs;
+
+namespace {
+
+template<size_t N, size_t A>
+struct alignas(A) Blob {
+    uint8_t bytes[N] = {};
+};
+
+struct Velocity {
+    float value[3] = {0.0f, 0.0f, 0.0f};
+};
+
+struct Health {
+    int32_t value = 100;
+};
+
+// Not trivially copyable: relocated through moveConstruct/destroy
+struct Name {
+    std::string value;
+};
+
+int failures = 0;
+
+void fail(const std::string& what) {
+    std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+template<typename T>
+void fill(T& value, uint32_t seed) {
+    auto* bytes = reinterpret_cast<uint8_t*>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i) bytes[i] = static_cast<uint8_t>(seed * 31u + i);
+}
+
+// Checks that the entity array and every Cs column of every chunk of the archetype with
+// exactly Cs lie inside the chunk, are aligned and do not overlap the entity array
+template<typename... Cs>
+void checkLayout(const World& world, const char* name) {
+    for (size_t i = 0; i < world.archetypeCount(); ++i) {
+        const Archetype& a = world.archetype(i);
+        if (a.signature().size() != sizeof...(Cs) || ((a.columnIndex(componentId<Cs>()) < 0) || ...)) continue;
+        if (a.chunkCapacity() < 2) fail(std::string(name) + ": chunk capacity below 2");
+        for (uint32_t c = 0; c < a.chunkCount(); ++c) {
+            const auto* entitiesEnd = reinterpret_cast<const uint8_t*>(a.entities(c) + a.chunkCapacity());
+            const auto* chunkEnd = reinterpret_cast<const uint8_t*>(a.entities(c)) + Archetype::kChunkBytes;
+            if (entitiesEnd > chunkEnd) fail(std::string(name) + ": entity array overruns the chunk");
+            auto checkColumn = [&](const uint8_t* begin, size_t size, size_t align) {
+                if (begin < entitiesEnd) fail(std::string(name) + ": column overlaps the entity array");
+                if (begin + size * a.chunkCapacity() > chunkEnd) fail(std::string(name) + ": column overruns the chunk");
+                if (reinterpret_cast<uintptr_t>(begin) % align != 0) fail(std::string(name) + ": misaligned column");
+            };
+            (checkColumn(static_cast<const uint8_t*>(a.column(static_cast<uint32_t>(a.columnIndex(componentId<Cs>())), c)),
+                         sizeof(Cs), alignof(Cs)),
+             ...);
+        }
+        return;
+    }
+    fail(std::string(name) + ": archetype not found");
+}
+
+// Creates enough entities of one component type to fill several chunks, then reads every
+// value back and checks the chunk layout
+template<typename T>
+void checkSingle(const char* name) {
+    try {
+        World world;
+        Entity first = world.create(T{});
+        const Archetype* archetype = nullptr;
+        for (size_t i = 0; i < world.archetypeCount(); ++i) {
+            if (world.archetype(i).size() != 0) archetype = &world.archetype(i);
+        }
+        const uint32_t count = archetype ? archetype->chunkCapacity() * 3 + 1 : 1;
+        std::vector<Entity> entities{first};
+        for (uint32_t i = 1; i < count; ++i) {
+            T value;
+            fill(value, i);
+            entities.push_back(world.create(value));
+        }
+        for (uint32_t i = 1; i < count; ++i) {
+            T expected;
+            fill(expected, i);
+            const T* got = world.get<T>(entities[i]);
+            if (!got || std::memcmp(got, &expected, sizeof(T)) != 0) {
+                fail(std::string(name) + ": value lost at entity " + std::to_string(i));
+                break;
+            }
+            if (reinterpret_cast<uintptr_t>(got) % alignof(T) != 0) {
+                fail(std::string(name) + ": misaligned value at entity " + std::to_string(i));
+                break;
+            }
+        }
+        checkLayout<T>(world, name);
+    } catch (const std::exception& e) {
+        fail(std::string(name) + ": " + e.what());
+    }
+}
+
+template<typename... Cs>
+void checkArchetype(const char* name) {
+    try {
+        World world;
+        for (int i = 0; i < 1000; ++i) world.create(Cs{}...);
+        checkLayout<Cs...>(world, name);
+    } catch (const std::exception& ex) {
+        fail(std::string(name) + ": " + ex.what());
+    }
+}
+
+void check(bool ok, const std::string& what) {
+    if (!ok) fail(what);
+}
+
+// Entity i carries Health{i} and Name{"e<i>"}; whatever was swapped into a destroyed row must
+// still read back its own values
+bool holdsOwnValues(World& world, Entity e, int32_t id) {
+    const Health* h = world.get<Health>(e);
+    const Name* n = world.get<Name>(e);
+    return h && n && h->value == id && n->value == "e" + std::to_string(id);
+}
+
+void checkDestroy() {
+    World world;
+    std::vector<Entity> entities;
+    for (int32_t i = 0; i < 3000; ++i) entities.push_back(world.create(Health{i}, Name{"e" + std::to_string(i)}));
+    // The first, some middles, chunk boundaries and the last row
+    std::set<int32_t> destroyed;
+    for (int32_t i : {0, 1, 7, 500, 1000, 1001, 2047, 2999}) {
+        world.destroy(entities[size_t(i)]);
+        destroyed.insert(i);
+    }
+    for (int32_t i = 100; i < 3000; i += 3) {
+        world.destroy(entities[size_t(i)]);
+        destroyed.insert(i);
+    }
+    check(world.entityCount() == 3000 - destroyed.size(), "destroy: entity count");
+    for (int32_t i = 0; i < 3000; ++i) {
+        const Entity e = entities[size_t(i)];
+        if (destroyed.count(i)) {
+            check(!world.alive(e) && !world.get<Health>(e), "destroy: entity " + std::to_string(i) + " still reachable");
+        } else if (!holdsOwnValues(world, e, i)) {
+            fail("destroy: entity " + std::to_string(i) + " lost its components after a swap-remove");
+            return;
+        }
+    }
+    // Removing a component swap-removes from the old archetype as well
+    for (int32_t i = 2; i < 100; i += 2) world.remove<Name>(entities[size_t(i)]);
+    for (int32_t i = 2; i < 3000; ++i) {
+        const Entity e = entities[size_t(i)];
+        if (destroyed.count(i)) continue;
+        const bool moved = i < 100 && i % 2 == 0;
+        const bool ok = moved ? world.get<Health>(e) && world.get<Health>(e)->value == i && !world.has<Name>(e)
+                              : holdsOwnValues(world, e, i);
+        if (!ok) {
+            fail("remove: entity " + std::to_string(i) + " has wrong components");
+            return;
+        }
+    }
+}
+
+void checkStaleHandles() {
+    World world;
+    const Entity old = world.create(Health{1});
+    world.destroy(old);
+    const Entity reused = world.create(Health{2});
+    check(reused.index == old.index && reused.generation != old.generation, "stale: index not reused with a new generation");
+    check(!world.alive(old) && world.alive(reused), "stale: old handle alive");
+    check(!world.get<Health>(old) && !world.has<Health>(old), "stale: old handle reads the new entity");
+    world.destroy(old); // no-op
+    world.remove<Health>(old);
+    check(world.alive(reused) && world.get<Health>(reused) && world.get<Health>(reused)->value == 2,
+          "stale: destroy/remove through the old handle reached the new entity");
+    bool threw = false;
+    try {
+        world.add(old, Velocity{});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    check(threw && !world.has<Velocity>(reused), "stale: add through the old handle was not rejected");
+}
+
+void checkQueries() {
+    World world;
+    // {Health}, {Health, Velocity}, {Health, Velocity, Name}, {Velocity}
+    for (int32_t i = 0; i < 700; ++i) world.create(Health{i});
+    for (int32_t i = 0; i < 900; ++i) world.create(Health{1000 + i}, Velocity{{float(i), 0.0f, 0.0f}});
+    for (int32_t i = 0; i < 500; ++i) world.create(Health{2000 + i}, Velocity{{float(i), 0.0f, 0.0f}}, Name{"n"});
+    for (int32_t i = 0; i < 300; ++i) world.create(Velocity{});
+
+    auto both = world.query<Health, const Velocity>();
+    check(both.count() == 1400, "query: Health+Velocity count " + std::to_string(both.count()));
+    // Writes through the query land in every matching archetype
+    both.each([](Health& h, const Velocity& v) { h.value = -1 - static_cast<int32_t>(v.value[0]); });
+    size_t visited = 0;
+    bool paired = true;
+    world.query<const Health, const Velocity>().each([&](Entity e, const Health& h, const Velocity& v) {
+        ++visited;
+        paired = paired && h.value == -1 - static_cast<int32_t>(v.value[0]) && world.get<Health>(e) == &h;
+    });
+    check(visited == 1400 && paired, "query: columns of a row belong to the same entity");
+
+    auto withoutName = world.query<const Health, const Velocity>();
+    withoutName.exclude<Name>();
+    check(withoutName.count() == 900, "query: exclude<Name> count " + std::to_string(withoutName.count()));
+    check(world.query<const Health>().count() == 2100, "query: Health count");
+
+    // A cached query picks up archetypes created after its first use
+    world.create(Health{}, Velocity{}, Transform{});
+    check(both.count() == 1401, "query: new archetype not matched");
+
+    bool threw = false;
+    try {
+        both.each([&](Health&, const Velocity&) { world.create(Health{}); });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    check(threw, "query: structural change during iteration not rejected");
+}
+
+void checkPlayback() {
+    World world;
+    std::vector<Entity> entities;
+    for (int32_t i = 0; i < 1000; ++i) entities.push_back(world.create(Health{i}, Name{"e" + std::to_string(i)}));
+    CommandBuffer commands;
+    world.query<const Health>().each([&](Entity e, const Health& h) {
+        if (h.value % 4 == 0) commands.destroy(e);
+        if (h.value % 4 == 1) commands.add(e, Velocity{{float(h.value), 0.0f, 0.0f}});
+        if (h.value % 4 == 2) commands.remove<Name>(e);
+        if (h.value % 100 == 3) commands.create(Health{10000 + h.value}, Name{"spawned"});
+    });
+    // Commands on an entity destroyed earlier in the buffer are dropped
+    commands.add(entities[0], Velocity{});
+    commands.remove<Health>(entities[4]);
+    check(world.entityCount() == 1000, "playback: recording changed the world");
+    world.playback(commands);
+    check(commands.empty(), "playback: buffer not cleared");
+    check(world.entityCount() == 1000 - 250 + 10, "playback: entity count " + std::to_string(world.entityCount()));
+    for (int32_t i = 0; i < 1000; ++i) {
+        const Entity e = entities[size_t(i)];
+        bool ok = true;
+        switch (i % 4) {
+        case 0: ok = !world.alive(e); break;
+        case 1: ok = holdsOwnValues(world, e, i) && world.get<Velocity>(e) && world.get<Velocity>(e)->value[0] == float(i); break;
+        case 2: ok = world.get<Health>(e) && world.get<Health>(e)->value == i && !world.has<Name>(e); break;
+        default: ok = holdsOwnValues(world, e, i) && !world.has<Velocity>(e); break;
+        }
+        if (!ok) {
+            fail("playback: entity " + std::to_string(i) + " has wrong components");
+            return;
+        }
+    }
+    size_t spawned = 0;
+    bool spawnedValues = true;
+    world.query<const Health, const Name>().each([&](const Health& h, const Name& n) {
+        if (n.value != "spawned") return;
+        ++spawned;
+        spawnedValues = spawnedValues && h.value >= 10000 && h.value % 100 == 3;
+    });
+    check(spawned == 10 && spawnedValues, "playback: created entities");
+}
+
+} // namespace
+
+int main() {
+    checkSingle<Blob<1, 1>>("1 byte");
+    checkSingle<Blob<4, 4>>("4 bytes");
+    checkSingle<Blob<12, 4>>("12 bytes");
+    checkSingle<Blob<16, 16>>("16 bytes");
+    checkSingle<Blob<64, 64>>("64 bytes, 64-aligned");
+    checkSingle<Blob<64, 1>>("64 bytes, unaligned");
+    checkSingle<Transform>("Transform");
+    checkSingle<Velocity>("Velocity");
+    checkSingle<Health>("Health");
+    checkArchetype<SceneNode, MeshRenderer>("SceneNode+MeshRenderer");
+    checkArchetype<Transform, MeshRenderer>("Transform+MeshRenderer");
+    checkArchetype<Transform, MeshRenderer, Velocity>("Transform+MeshRenderer+Velocity");
+    checkArchetype<Blob<1, 1>, Blob<12, 4>, Blob<16, 16>, Blob<64, 64>>("mixed alignments");
+
+    // A row that cannot fit a chunk is an error, not an overrun
+    try {
+        World world;
+        world.create(Blob<Archetype::kChunkBytes, 64>{});
+        fail("oversized component: accepted");
+    } catch (const std::runtime_error&) {
+    }
+
+    try {
+        checkDestroy();
+        checkStaleHandles();
+        checkQueries();
+        checkPlayback();
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("ecs: all checks passed\n");
+    return 0;
+}
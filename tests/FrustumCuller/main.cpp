@@ -0,0 +1,148 @@
+// frustum_culler_test: checks scene::FrustumCuller against a brute-force scalar plane test on
+// sphere counts around the 4096-sphere block boundaries, single-threaded and on the job system.
+// Covers block packing with partly visible blocks, fully visible leading blocks whose runs are
+// already in place, and the -infinity radius the engine gives stale nodes.
+// Host-only (no window or GPU); registered with CTest.
+#include <aurora/JobSystem.h>
+#include <aurora/math/Math.h>
+#include <aurora/scene/FrustumCuller.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace aurora;
+
+namespace {
+
+constexpr uint32_t kBlock = 4096; // FrustumCuller's block size
+const size_t kCounts[] = {0, 1, 7, kBlock - 1, kBlock, kBlock + 1, 2 * kBlock + 13, 4 * kBlock, 4 * kBlock + 1, 9 * kBlock + 4095};
+
+int failures = 0;
+
+void fail(const std::string& what) {
+    std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+bool reference(const math::Frustum& frustum, const math::Vec3& center, float radius) {
+    for (const math::Plane& p : frustum.planes) {
+        if (p.distance(center) < -radius) return false;
+    }
+    return true;
+}
+
+// True when rounding could put the sphere on either side of a plane
+bool onEdge(const math::Frustum& frustum, const math::Vec3& center, float radius) {
+    for (const math::Plane& p : frustum.planes) {
+        if (std::fabs(p.distance(center) + radius) < 1e-3f) return true;
+    }
+    return false;
+}
+
+enum class Fill {
+    Random,      // scattered inside and around the frustum
+    AllVisible,  // every block fully visible: each run is already in place
+    LeadVisible, // the first two blocks fully visible, the rest random
+    Stale,       // random, with every fifth sphere stale (radius -inf) at the view centre
+    NoneVisible,
+};
+
+const char* name(Fill fill) {
+    switch (fill) {
+    case Fill::Random: return "random";
+    case Fill::AllVisible: return "all visible";
+    case Fill::LeadVisible: return "leading blocks visible";
+    case Fill::Stale: return "stale nodes";
+    case Fill::NoneVisible: return "none visible";
+    }
+    return "?";
+}
+
+void fill(scene::FrustumCuller& culler, const math::Frustum& frustum, Fill mode, std::mt19937& rng) {
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    const math::Vec3 inside{0.0f, 0.0f, -20.0f}; // well inside: camera at the origin looking down -z
+    for (size_t i = 0; i < culler.size(); ++i) {
+        const bool visible = mode == Fill::AllVisible || (mode == Fill::LeadVisible && i < 2 * kBlock);
+        if (visible) {
+            culler.set(i, inside + math::Vec3{u(rng), u(rng), u(rng)}, 0.5f);
+        } else if (mode == Fill::NoneVisible) {
+            culler.set(i, {u(rng) * 50.0f, u(rng) * 50.0f, 10.0f + 5.0f * u(rng)}, 1.0f); // behind the camera
+        } else if (mode == Fill::Stale && i % 5 == 0) {
+            culler.set(i, inside, -std::numeric_limits<float>::infinity());
+        } else {
+            math::Vec3 c;
+            float r = 0.0f;
+            do {
+                c = {u(rng) * 60.0f, u(rng) * 60.0f, -50.0f + u(rng) * 60.0f};
+                r = 0.5f + 2.0f * std::fabs(u(rng));
+            } while (onEdge(frustum, c, r));
+            culler.set(i, c, r);
+        }
+    }
+}
+
+void check(scene::FrustumCuller& culler, const math::Frustum& frustum, JobSystem* jobs, Fill mode, const std::string& label) {
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < culler.size(); ++i) {
+        const math::Vec3 c{culler.centerX()[i], culler.centerY()[i], culler.centerZ()[i]};
+        if (reference(frustum, c, culler.radius()[i])) expected.push_back(static_cast<uint32_t>(i));
+    }
+    const std::vector<uint32_t>& got = culler.cull(frustum, jobs);
+    const std::string what = label + ", " + name(mode) + ", n=" + std::to_string(culler.size());
+    if (got != expected) {
+        size_t at = 0;
+        while (at < got.size() && at < expected.size() && got[at] == expected[at]) ++at;
+        fail(what + ": " + std::to_string(got.size()) + " visible, expected " + std::to_string(expected.size()) +
+             "; first difference at position " + std::to_string(at));
+        return;
+    }
+    if (culler.stats().tested != culler.size() || culler.stats().visible != expected.size()) fail(what + ": wrong stats");
+    if (mode == Fill::AllVisible && expected.size() != culler.size()) fail(what + ": reference culled a visible sphere");
+    if (mode == Fill::NoneVisible && !expected.empty()) fail(what + ": reference kept an invisible sphere");
+    if (mode == Fill::Stale) {
+        for (uint32_t i : got) {
+            if (i % 5 == 0) {
+                fail(what + ": stale sphere " + std::to_string(i) + " visible");
+                return;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    try {
+        JobSystem jobs;
+        const math::Frustum frustum = math::Frustum::fromMatrix(
+            math::Mat4::perspective(math::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+            math::Mat4::lookAt({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}));
+        std::mt19937 rng(7);
+        // One culler reused across sizes and modes, as the engine reuses its own each frame
+        scene::FrustumCuller culler;
+        for (JobSystem* js : {static_cast<JobSystem*>(nullptr), &jobs}) {
+            const std::string label = js ? "jobs" : "inline";
+            for (size_t n : kCounts) {
+                for (Fill mode : {Fill::Random, Fill::AllVisible, Fill::LeadVisible, Fill::Stale, Fill::NoneVisible}) {
+                    culler.resize(n);
+                    fill(culler, frustum, mode, rng);
+                    check(culler, frustum, js, mode, label);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("frustum culler: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,298 @@
+// render_graph_test: checks RenderGraphPlan, the planning half of the render graph. Covers
+// culling of passes nobody consumes, transients with disjoint lifetimes sharing a memory slot,
+// write->read and read->write hazards getting exactly one barrier per pass, and attachment
+// load/store and final transitions. Needs the Vulkan headers only: no instance, device or
+// window; registered with CTest.
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vulkan/RenderGraphPlan.h"
+
+using vulkan::RenderGraphPlan;
+using Usage = RenderGraphPlan::Usage;
+using PassType = RenderGraphPlan::PassType;
+
+namespace {
+
+int failures = 0;
+
+void fail(const std::string& what) {
+    std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+void expect(bool ok, const std::string& what) {
+    if (!ok) fail(what);
+}
+
+RenderGraphPlan::ResourceDecl backbuffer() {
+    RenderGraphPlan::ResourceDecl d;
+    d.name = "backbuffer";
+    d.isImage = true;
+    d.initialStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    d.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    return d;
+}
+
+RenderGraphPlan::ResourceDecl transient(const char* name) {
+    RenderGraphPlan::ResourceDecl d;
+    d.name = name;
+    d.isImage = true;
+    d.transient = true;
+    return d;
+}
+
+RenderGraphPlan::ResourceDecl buffer(const char* name) {
+    RenderGraphPlan::ResourceDecl d;
+    d.name = name;
+    return d;
+}
+
+void access(RenderGraphPlan& plan, uint32_t pass, RenderGraphPlan::Resource r, Usage usage, bool write, bool clear = false) {
+    RenderGraphPlan::Access a;
+    a.resource = r;
+    a.usage = usage;
+    a.write = write;
+    a.clear = clear;
+    plan.pass(pass).accesses.push_back(a);
+}
+
+// Plans without any aliasing history: each transient in its own slot
+void planAll(RenderGraphPlan& plan) {
+    plan.cull();
+    std::vector<uint32_t> slotOf(plan.transients().size());
+    for (uint32_t i = 0; i < slotOf.size(); ++i) slotOf[i] = i;
+    std::vector<RenderGraphPlan::SlotUse> slotUse(slotOf.size());
+    plan.buildBarriers(slotOf, slotUse);
+}
+
+uint32_t barriersOn(const RenderGraphPlan::PassPlan& p, RenderGraphPlan::Resource r) {
+    uint32_t n = 0;
+    for (const RenderGraphPlan::Barrier& b : p.barriers) n += b.resource == r ? 1u : 0u;
+    return n;
+}
+
+const RenderGraphPlan::Barrier* barrierOn(const RenderGraphPlan::PassPlan& p, RenderGraphPlan::Resource r) {
+    for (const RenderGraphPlan::Barrier& b : p.barriers) {
+        if (b.resource == r) return &b;
+    }
+    return nullptr;
+}
+
+// A pass writing only what nobody reads is culled, and so is its producer; a side-effect pass
+// and the chain into the backbuffer run
+void checkCulling() {
+    RenderGraphPlan plan;
+    const auto bb = plan.addResource(backbuffer());
+    const auto unused = plan.addResource(transient("unused"));
+    const auto feeds = plan.addResource(transient("feeds unused"));
+    const auto scene = plan.addResource(transient("scene"));
+    const auto upload = plan.addResource(buffer("upload"));
+
+    const uint32_t producer = plan.addPass("producer", PassType::Compute);
+    access(plan, producer, feeds, Usage::StorageWriteCompute, true);
+    const uint32_t dead = plan.addPass("dead", PassType::Compute);
+    access(plan, dead, feeds, Usage::StorageReadCompute, false);
+    access(plan, dead, unused, Usage::StorageWriteCompute, true);
+    const uint32_t uploads = plan.addPass("uploads", PassType::Transfer);
+    access(plan, uploads, upload, Usage::TransferWrite, true);
+    plan.pass(uploads).sideEffect = true;
+    const uint32_t draw = plan.addPass("draw", PassType::Graphics);
+    access(plan, draw, scene, Usage::ColorAttachment, true, true);
+    const uint32_t post = plan.addPass("post", PassType::Graphics);
+    access(plan, post, scene, Usage::SampledFragment, false);
+    access(plan, post, bb, Usage::ColorAttachment, true, true);
+    planAll(plan);
+
+    expect(plan.passes()[producer].culled, "culling: producer of a culled pass runs");
+    expect(plan.passes()[dead].culled, "culling: pass with unused output runs");
+    expect(!plan.passes()[uploads].culled, "culling: side-effect pass culled");
+    expect(!plan.passes()[draw].culled && !plan.passes()[post].culled, "culling: backbuffer chain culled");
+    expect(plan.culledPasses() == 2 && plan.executedPasses() == 3, "culling: counts " + std::to_string(plan.culledPasses()));
+    expect(plan.resources()[unused].firstPass == UINT32_MAX && plan.resources()[feeds].firstPass == UINT32_MAX,
+           "culling: resources of culled passes have lifetimes");
+    expect(plan.transients().size() == 1 && plan.transients()[0].resource == scene, "culling: transients of culled passes listed");
+    expect(plan.passes()[dead].barriers.empty() && plan.passes()[dead].srcStages == 0, "culling: culled pass has barriers");
+
+    // A clear ends the need for earlier writers of the same image
+    RenderGraphPlan cleared;
+    const auto out = cleared.addResource(backbuffer());
+    const uint32_t first = cleared.addPass("overwritten", PassType::Graphics);
+    access(cleared, first, out, Usage::ColorAttachment, true, true);
+    const uint32_t second = cleared.addPass("final", PassType::Graphics);
+    access(cleared, second, out, Usage::ColorAttachment, true, true);
+    planAll(cleared);
+    expect(cleared.passes()[first].culled && !cleared.passes()[second].culled, "culling: pass overwritten by a clear runs");
+}
+
+// Lifetimes [0,1] and [2,3] share a slot; [1,2] overlaps both and gets another; memory types
+// that do not intersect never share
+void checkAliasing() {
+    RenderGraphPlan plan;
+    const auto bb = plan.addResource(backbuffer());
+    const auto a = plan.addResource(transient("a"));
+    const auto b = plan.addResource(transient("b"));
+    const auto c = plan.addResource(transient("c"));
+    const uint32_t p0 = plan.addPass("write a", PassType::Graphics);
+    access(plan, p0, a, Usage::ColorAttachment, true, true);
+    const uint32_t p1 = plan.addPass("a to c", PassType::Graphics);
+    access(plan, p1, a, Usage::SampledFragment, false);
+    access(plan, p1, c, Usage::ColorAttachment, true, true);
+    const uint32_t p2 = plan.addPass("c to b", PassType::Graphics);
+    access(plan, p2, c, Usage::SampledFragment, false);
+    access(plan, p2, b, Usage::ColorAttachment, true, true);
+    const uint32_t p3 = plan.addPass("b to backbuffer", PassType::Graphics);
+    access(plan, p3, b, Usage::SampledFragment, false);
+    access(plan, p3, bb, Usage::ColorAttachment, true, true);
+    plan.cull();
+
+    const auto& lifetimes = plan.transients();
+    expect(lifetimes.size() == 3, "aliasing: " + std::to_string(lifetimes.size()) + " transients");
+    if (lifetimes.size() != 3) return;
+    std::vector<VkMemoryRequirements> req(3);
+    req[0] = {1 << 20, 256, 0x3}; // a
+    req[1] = {2 << 20, 4096, 0x6}; // b: larger, placed first
+    req[2] = {1 << 20, 256, 0x3}; // c
+    std::vector<VkMemoryRequirements> slots;
+    const std::vector<uint32_t> slotOf = RenderGraphPlan::assignSlots(lifetimes, req, slots);
+    expect(slots.size() == 2, "aliasing: " + std::to_string(slots.size()) + " slots for a, b, c");
+    expect(slotOf[0] == slotOf[1], "aliasing: a and b do not share a slot");
+    expect(slotOf[2] != slotOf[0], "aliasing: c shares a slot with an overlapping image");
+    if (slots.size() == 2) {
+        const VkMemoryRequirements& shared = slots[slotOf[0]];
+        expect(shared.size == (2 << 20) && shared.alignment == 4096 && shared.memoryTypeBits == 0x2,
+               "aliasing: shared slot does not cover both images");
+    }
+    std::vector<VkMemoryRequirements> disjoint = req;
+    disjoint[1].memoryTypeBits = 0x8;
+    RenderGraphPlan::assignSlots(lifetimes, disjoint, slots);
+    expect(slots.size() == 3, "aliasing: images with disjoint memory types share a slot");
+
+    // b's first use waits for a's last use of the shared memory
+    std::vector<RenderGraphPlan::SlotUse> slotUse(2);
+    plan.buildBarriers(slotOf, slotUse);
+    const RenderGraphPlan::Barrier* first = barrierOn(plan.passes()[p2], b);
+    expect(first && first->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED, "aliasing: aliased image not transitioned from undefined");
+    expect((plan.passes()[p2].srcStages & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) != 0,
+           "aliasing: aliased image does not wait for the previous occupant's reads");
+    expect(slotUse[slotOf[1]].lastStages == VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, "aliasing: slot use not carried to the next frame");
+}
+
+// Buffer: compute write -> indirect + vertex read (one merged barrier) -> read again (none) ->
+// transfer write (one). Image: colour write -> sampled (one transition) -> colour write in a
+// later pass (one).
+void checkHazards() {
+    RenderGraphPlan plan;
+    const auto bb = plan.addResource(backbuffer());
+    const auto args = plan.addResource(buffer("draw args"));
+    const auto color = plan.addResource(transient("color"));
+    const uint32_t cull = plan.addPass("cull", PassType::Compute);
+    access(plan, cull, args, Usage::StorageWriteCompute, true);
+    const uint32_t draw = plan.addPass("draw", PassType::Graphics);
+    access(plan, draw, args, Usage::IndirectRead, false);
+    access(plan, draw, args, Usage::VertexInput, false);
+    access(plan, draw, color, Usage::ColorAttachment, true, true);
+    const uint32_t again = plan.addPass("draw again", PassType::Graphics);
+    access(plan, again, args, Usage::IndirectRead, false);
+    access(plan, again, color, Usage::SampledFragment, false);
+    access(plan, again, bb, Usage::ColorAttachment, true, true);
+    const uint32_t reset = plan.addPass("reset args", PassType::Transfer);
+    access(plan, reset, args, Usage::TransferWrite, true);
+    plan.pass(reset).sideEffect = true;
+    const uint32_t overlay = plan.addPass("overlay", PassType::Graphics);
+    access(plan, overlay, color, Usage::ColorAttachment, true);
+    plan.pass(overlay).sideEffect = true;
+    planAll(plan);
+
+    const auto& p = plan.passes();
+    expect(barriersOn(p[cull], args) == 0, "hazards: first write of an imported buffer has a barrier");
+    expect(barriersOn(p[draw], args) == 1, "hazards: write->read: " + std::to_string(barriersOn(p[draw], args)) + " barriers");
+    if (const RenderGraphPlan::Barrier* b = barrierOn(p[draw], args)) {
+        expect(b->srcAccess == VK_ACCESS_SHADER_WRITE_BIT &&
+                   b->dstAccess == (VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT),
+               "hazards: write->read access masks");
+    }
+    expect((p[draw].srcStages & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) &&
+               (p[draw].dstStages & VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT) && (p[draw].dstStages & VK_PIPELINE_STAGE_VERTEX_INPUT_BIT),
+           "hazards: write->read stage masks");
+    expect(barriersOn(p[again], args) == 0, "hazards: read after an already synchronized read has a barrier");
+    expect(barriersOn(p[reset], args) == 1, "hazards: read->write: " + std::to_string(barriersOn(p[reset], args)) + " barriers");
+    expect((p[reset].srcStages & VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT) && (p[reset].dstStages & VK_PIPELINE_STAGE_TRANSFER_BIT),
+           "hazards: read->write waits for the readers");
+
+    expect(barriersOn(p[draw], color) == 1, "hazards: first colour write");
+    expect(barriersOn(p[again], color) == 1, "hazards: colour write->sampled: " + std::to_string(barriersOn(p[again], color)) + " barriers");
+    if (const RenderGraphPlan::Barrier* b = barrierOn(p[again], color)) {
+        expect(b->oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL && b->newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+                   b->srcAccess == VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+               "hazards: colour write->sampled transition");
+    }
+    expect(barriersOn(p[overlay], color) == 1, "hazards: sampled->colour write: " + std::to_string(barriersOn(p[overlay], color)) + " barriers");
+
+    // Attachments: the first draw clears and keeps color for the sampler; the overlay loads it
+    // and nothing reads it afterwards
+    expect(p[draw].attachments.size() == 1 && !p[draw].attachments[0].load && p[draw].attachments[0].store,
+           "attachments: cleared colour should not load and should store");
+    expect(p[overlay].attachments.size() == 1 && p[overlay].attachments[0].load && !p[overlay].attachments[0].store,
+           "attachments: last colour write should load and not store");
+    expect(p[again].attachments.size() == 1 && p[again].attachments[0].resource == bb && p[again].attachments[0].store,
+           "attachments: backbuffer not stored");
+
+    // The backbuffer ends in its final layout
+    const RenderGraphPlan::Barrier* present = barrierOn(plan.finalTransitions(), bb);
+    expect(barriersOn(plan.finalTransitions(), bb) == 1 && present && present->newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+           "final: backbuffer not transitioned to present");
+    expect(barriersOn(plan.finalTransitions(), args) == 0, "final: non-output buffer transitioned");
+}
+
+void checkErrors() {
+    RenderGraphPlan plan;
+    const auto bb = plan.addResource(backbuffer());
+    const auto d0 = plan.addResource(transient("depth 0"));
+    const auto d1 = plan.addResource(transient("depth 1"));
+    const uint32_t p = plan.addPass("two depths", PassType::Graphics);
+    access(plan, p, bb, Usage::ColorAttachment, true, true);
+    access(plan, p, d0, Usage::DepthAttachment, true, true);
+    access(plan, p, d1, Usage::DepthAttachment, true, true);
+    bool threw = false;
+    try {
+        planAll(plan);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    expect(threw, "errors: two depth attachments accepted");
+
+    plan.reset();
+    const uint32_t q = plan.addPass("undeclared", PassType::Compute);
+    access(plan, q, 7, Usage::StorageReadCompute, false);
+    threw = false;
+    try {
+        plan.cull();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    expect(threw, "errors: undeclared resource accepted");
+}
+
+} // namespace
+
+int main() {
+    try {
+        checkCulling();
+        checkAliasing();
+        checkHazards();
+        checkErrors();
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("render graph: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+// scene_nodes_test: the host-side half of `aurora_bench --nodes`. Builds the bench's binary
+// transform trees with one SceneNode + MeshRenderer entity per node, moves a few percent of the
+// nodes per frame, and walks the entities chunk by chunk in parallel the way the engine builds
+// its draw list, checking each node's world matrix against its parent chain. Also destroys
+// subtrees, re-parents across depths, rejects cycles and reuses node indices, re-checking every
+// world matrix after each change.
+// Host-only (no window or GPU); registered with CTest.
+#include <aurora/JobSystem.h>
+#include <aurora/ecs/Components.h>
+#include <aurora/ecs/World.h>
+#include <aurora/scene/TransformHierarchy.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aurora;
+
+namespace {
+
+constexpr uint32_t kTrees = 16;
+constexpr uint32_t kNodes = 20000;
+constexpr uint32_t kFrames = 8;
+constexpr double kMovePercent = 3.0;
+
+int failures = 0;
+
+void fail(const std::string& what) {
+    std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+bool near(const math::Mat4& a, const math::Mat4& b) {
+    for (int c = 0; c < 4; ++c) {
+        const float d[4] = {a.cols[c].x - b.cols[c].x, a.cols[c].y - b.cols[c].y, a.cols[c].z - b.cols[c].z, a.cols[c].w - b.cols[c].w};
+        for (float v : d) {
+            if (!(std::fabs(v) <= 1e-4f)) return false;
+        }
+    }
+    return true;
+}
+
+// World matrix rebuilt from the local transforms up the parent chain
+math::Mat4 expectedWorld(const scene::TransformHierarchy& transforms, scene::Node node) {
+    const scene::LocalTransform& l = transforms.local(node);
+    const math::Mat4 local = math::Mat4::trs(l.position, l.rotation, l.scale);
+    const scene::Node parent = transforms.parent(node);
+    return parent.valid() ? expectedWorld(transforms, parent) * local : local;
+}
+
+// Same layout as aurora_bench's buildHierarchy: nodes 0..15 are roots and node j parents nodes
+// 2j + 16 and 2j + 17
+void checkBenchHierarchy() {
+    JobSystem jobs;
+    ecs::World world;
+    scene::TransformHierarchy transforms;
+    std::vector<scene::Node> nodes;
+    nodes.reserve(kNodes);
+    for (uint32_t i = 0; i < kNodes; ++i) {
+        scene::LocalTransform local;
+        scene::Node parent;
+        if (i < kTrees) {
+            local.position = {-0.9f + 1.8f * static_cast<float>(i % 4) / 3.0f, -0.9f + 1.8f * static_cast<float>(i / 4) / 3.0f, 0.0f};
+            local.scale = math::Vec3(0.05f);
+        } else {
+            parent = nodes[(i - kTrees) / 2];
+            local.position = {(i & 1) ? 0.6f : -0.6f, 0.8f, 0.0f};
+            local.scale = math::Vec3(0.9f);
+        }
+        nodes.push_back(transforms.create(local, parent));
+        world.create(ecs::SceneNode{nodes.back()}, ecs::MeshRenderer{});
+    }
+    if (world.entityCount() != kNodes) fail("bench hierarchy: entity count " + std::to_string(world.entityCount()));
+
+    auto renderables = world.query<const ecs::SceneNode, const ecs::MeshRenderer>();
+    using NodeView = ecs::ChunkView<const ecs::SceneNode, const ecs::MeshRenderer>;
+    uint32_t rng = 12345;
+    for (uint32_t frame = 0; frame < kFrames; ++frame) {
+        const auto moving = static_cast<uint32_t>(static_cast<double>(nodes.size()) * kMovePercent / 100.0);
+        const math::Quat rot = math::Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 0.3f * std::sin(static_cast<float>(frame) * 0.05f));
+        for (uint32_t k = 0; k < moving; ++k) {
+            rng = rng * 1664525u + 1013904223u;
+            transforms.setRotation(nodes[rng % nodes.size()], rot);
+        }
+        transforms.update(&jobs);
+
+        std::vector<std::atomic<uint32_t>> seen(transforms.indexCapacity());
+        std::atomic<uint32_t> wrong{0};
+        renderables.parallelEachChunk(jobs, [&](const NodeView& v) {
+            const ecs::SceneNode* n = v.column<const ecs::SceneNode>();
+            for (uint32_t i = 0; i < v.count; ++i) {
+                seen[n[i].node.index].fetch_add(1, std::memory_order_relaxed);
+                if (!near(transforms.world(n[i].node), expectedWorld(transforms, n[i].node))) {
+                    wrong.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+        for (const scene::Node node : nodes) {
+            if (seen[node.index].load() != 1) {
+                fail("bench hierarchy: node " + std::to_string(node.index) + " drawn " + std::to_string(seen[node.index].load()) + " times");
+                return;
+            }
+        }
+        if (wrong.load() != 0) {
+            fail("bench hierarchy: frame " + std::to_string(frame) + ": " + std::to_string(wrong.load()) + " stale world matrices");
+            return;
+        }
+    }
+}
+
+// Every live node's world matrix against its parent chain; returns the number that differ
+uint32_t countStale(const scene::TransformHierarchy& transforms, const std::vector<scene::Node>& nodes) {
+    uint32_t wrong = 0;
+    for (const scene::Node node : nodes) {
+        if (transforms.alive(node) && !near(transforms.world(node), expectedWorld(transforms, node))) ++wrong;
+    }
+    return wrong;
+}
+
+// Builds four chains of depth 6 with distinct rotations, then destroys, re-parents and recreates
+// nodes, checking the hierarchy (and every world matrix) after each update
+void checkStructuralChanges() {
+    JobSystem jobs;
+    scene::TransformHierarchy transforms;
+    constexpr uint32_t kChains = 4;
+    constexpr uint32_t kDepth = 6;
+    std::vector<scene::Node> nodes; // chain c, depth k at c * kDepth + k
+    for (uint32_t c = 0; c < kChains; ++c) {
+        scene::Node tip;
+        for (uint32_t k = 0; k < kDepth; ++k) {
+            const float t = static_cast<float>(c * kDepth + k);
+            scene::LocalTransform local{{0.3f + 0.1f * t, 0.5f, -0.2f * t},
+                                        math::Quat::fromAxisAngle(math::normalize(math::Vec3{1.0f, t, 2.0f}), 0.1f * t), math::Vec3(0.9f)};
+            tip = transforms.create(local, tip);
+            nodes.push_back(tip);
+            // A leaf beside each non-root chain node, so destroying one drops a branching subtree
+            if (k != 0) nodes.push_back(transforms.create({{-0.4f, 0.1f * t, 0.0f}, {}, math::Vec3(1.1f)}, transforms.parent(tip)));
+        }
+    }
+    // Chain c's depth-k node (each non-root depth also added a leaf)
+    auto at = [&](uint32_t c, uint32_t k) { return nodes[c * (2 * kDepth - 1) + (k == 0 ? 0 : 2 * k - 1)]; };
+    transforms.update(&jobs);
+    if (transforms.depthCount() != kDepth) fail("structure: " + std::to_string(transforms.depthCount()) + " levels");
+    if (const uint32_t wrong = countStale(transforms, nodes)) fail("structure: " + std::to_string(wrong) + " stale after build");
+
+    // Destroy chain 1 from depth 2 down: that node, the deeper chain nodes and every leaf below
+    const size_t before = transforms.size();
+    const scene::Node cut = at(1, 2);
+    std::set<uint32_t> freed;
+    for (const scene::Node node : nodes) {
+        for (scene::Node a = node; a.valid(); a = transforms.parent(a)) {
+            if (a == cut) {
+                freed.insert(node.index);
+                break;
+            }
+        }
+    }
+    transforms.destroy(cut);
+    if (transforms.size() != before - freed.size()) fail("structure: size " + std::to_string(transforms.size()) + " after destroy");
+    for (const scene::Node node : nodes) {
+        if (transforms.alive(node) == (freed.count(node.index) != 0)) fail("structure: node " + std::to_string(node.index) + " liveness after destroy");
+    }
+    bool threw = false;
+    try {
+        transforms.setPosition(cut, {});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) fail("structure: setter accepted a destroyed node");
+    transforms.update(&jobs);
+    if (!transforms.lastUpdateStats().resorted) fail("structure: destroy did not re-sort");
+    if (const uint32_t wrong = countStale(transforms, nodes)) fail("structure: " + std::to_string(wrong) + " stale after destroy");
+
+    // Re-parent across depths: chain 2's deepest node under root 0 (moving up), and chain 3 from
+    // depth 1 under chain 0's deepest node (moving its subtree down by five levels)
+    transforms.setParent(at(2, kDepth - 1), at(0, 0));
+    transforms.setParent(at(3, 1), at(0, kDepth - 1));
+    transforms.setRotation(at(0, 3), math::Quat::fromAxisAngle({0.0f, 1.0f, 0.0f}, 0.7f));
+    transforms.update(&jobs);
+    if (!transforms.lastUpdateStats().resorted) fail("structure: setParent did not re-sort");
+    if (transforms.parent(at(3, 1)) != at(0, kDepth - 1)) fail("structure: re-parented node has the wrong parent");
+    if (transforms.depthCount() != 2 * kDepth - 1) fail("structure: " + std::to_string(transforms.depthCount()) + " levels after re-parenting");
+    if (const uint32_t wrong = countStale(transforms, nodes)) fail("structure: " + std::to_string(wrong) + " stale after re-parenting");
+
+    // Cycles: under its own descendant (now five levels down) or itself
+    for (const scene::Node target : {at(3, kDepth - 1), at(0, 0)}) {
+        threw = false;
+        try {
+            transforms.setParent(at(0, 0), target);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) fail("structure: setParent accepted a cycle");
+    }
+    if (transforms.parent(at(0, 0)).valid()) fail("structure: rejected setParent changed the parent");
+
+    // New nodes take the destroyed indices with a new generation; the old handles stay dead
+    std::vector<scene::Node> reused;
+    for (size_t i = 0; i < freed.size(); ++i) {
+        reused.push_back(transforms.create({{0.0f, 0.2f, 0.0f}, {}, math::Vec3(1.0f)}, reused.empty() ? at(2, 1) : reused.back()));
+        if (freed.count(reused.back().index) == 0) fail("structure: create did not reuse a freed index");
+    }
+    if (transforms.alive(cut)) fail("structure: stale handle alive after its index was reused");
+    if (transforms.indexCapacity() != nodes.size()) fail("structure: index capacity grew to " + std::to_string(transforms.indexCapacity()));
+    transforms.update(&jobs);
+    nodes.insert(nodes.end(), reused.begin(), reused.end());
+    if (const uint32_t wrong = countStale(transforms, nodes)) fail("structure: " + std::to_string(wrong) + " stale after reuse");
+
+    // Finally a root with everything under it moves; all descendants follow
+    transforms.setPosition(at(0, 0), {2.0f, -1.0f, 0.5f});
+    transforms.update(&jobs);
+    if (const uint32_t wrong = countStale(transforms, nodes)) fail("structure: " + std::to_string(wrong) + " stale after moving a root");
+}
+
+// The README's transform example: the arm follows its parent's rotation
+void checkReadmeExample() {
+    ecs::World world;
+    scene::TransformHierarchy transforms;
+    scene::Node body = transforms.create({{0.0f, 0.0f, 0.0f}, {}, math::Vec3(0.2f)});
+    scene::Node arm = transforms.create({{1.0f, 0.5f, 0.0f}, {}, math::Vec3(1.0f)}, body);
+    world.create(ecs::SceneNode{arm}, ecs::MeshRenderer{});
+    transforms.setRotation(body, math::Quat::fromAxisAngle({0.0f, 0.0f, 1.0f}, 1.5707964f));
+    transforms.update();
+    // 90 degrees about z: (1, 0.5) * 0.2 -> (-0.1, 0.2)
+    const math::Vec3 p = math::transformPoint(transforms.world(arm), {0.0f, 0.0f, 0.0f});
+    if (std::fabs(p.x + 0.1f) > 1e-5f || std::fabs(p.y - 0.2f) > 1e-5f) {
+        fail("readme example: arm at (" + std::to_string(p.x) + ", " + std::to_string(p.y) + ")");
+    }
+    if (world.query<const ecs::SceneNode, const ecs::MeshRenderer>().count() != 1) fail("readme example: entity not drawn");
+}
+
+} // namespace
+
+int main() {
+    try {
+        checkBenchHierarchy();
+        checkStructuralChanges();
+        checkReadmeExample();
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("scene nodes: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+// aurora_pack: bundles directories into one pack file for io::FileSystem.
+//
+//   aurora_pack <out.pak> <dir>[=prefix] ... [--codec none|lz4|zstd] [--level N] [--chunk KiB]
+//
+// Each <dir> is added recursively; with =prefix its files appear under prefix/ in the pack
+// (e.g. build/shaders=shaders). Compression needs the codec to be found at configure time.
+#include "io/Compression.h"
+#include "io/PackWriter.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string outPath;
+    std::vector<std::string> inputs;
+    io::PackWriter::Options pack;
+};
+
+bool parseCodec(const char* v, io::Codec& codec) {
+    if (std::strcmp(v, "none") == 0) { codec = io::Codec::None; return true; }
+    if (std::strcmp(v, "lz4") == 0) { codec = io::Codec::LZ4; return true; }
+    if (std::strcmp(v, "zstd") == 0) { codec = io::Codec::Zstd; return true; }
+    return false;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* a = argv[i];
+        const char* v = nullptr;
+        if (std::strcmp(a, "--codec") == 0 && (v = next()) && parseCodec(v, opt.pack.codec)) continue;
+        if (std::strcmp(a, "--level") == 0 && (v = next())) { opt.pack.level = std::atoi(v); continue; }
+        if (std::strcmp(a, "--chunk") == 0 && (v = next())) { opt.pack.chunkSize = static_cast<uint32_t>(std::strtoul(v, nullptr, 10)) << 10; continue; }
+        if (a[0] != '-') {
+            if (opt.outPath.empty()) opt.outPath = a;
+            else opt.inputs.emplace_back(a);
+            continue;
+        }
+        opt.outPath.clear();
+        break;
+    }
+    if (opt.outPath.empty() || opt.inputs.empty()) {
+        std::cerr << "usage: aurora_pack <out.pak> <dir>[=prefix] ... [--codec none|lz4|zstd] [--level N] [--chunk KiB]\n";
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+    if (!io::codecAvailable(opt.pack.codec)) {
+        std::cerr << "aurora_pack: codec '" << io::codecName(opt.pack.codec)
+                  << "' not available in this build, storing uncompressed\n";
+        opt.pack.codec = io::Codec::None;
+    }
+    try {
+        io::PackWriter writer;
+        for (const auto& in : opt.inputs) {
+            size_t eq = in.find('=');
+            std::string dir = in.substr(0, eq);
+            std::string prefix = eq == std::string::npos ? std::string() : in.substr(eq + 1);
+            writer.addDirectory(dir, prefix);
+        }
+        writer.write(opt.outPath, opt.pack);
+    } catch (const std::exception& e) {
+        std::cerr << "aurora_pack: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}